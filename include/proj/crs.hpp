@@ -141,6 +141,9 @@ class PROJ_GCC_DLL CRS : public common::ObjectUsage {
 
   private:
     PROJ_OPAQUE_PRIVATE_DATA
+
+    PROJ_INTERNAL std::string
+    getIdentificationFingerprint(const std::string &authority) const;
 };
 
 // ---------------------------------------------------------------------------
@@ -157,6 +157,11 @@ std::string toString(int val);
 
 PROJ_FOR_TEST std::string toString(double val, int precision = 15);
 
+void appendToString(std::string &out, int val);
+
+PROJ_FOR_TEST void appendToString(std::string &out, double val,
+                                  int precision = 15);
+
 PROJ_FOR_TEST double
 c_locale_stod(const std::string &s); // throw(std::invalid_argument)
 
@@ -705,6 +705,13 @@ class PROJ_GCC_DLL DatabaseContext {
 
     PROJ_DLL std::vector<std::string> getDatabaseStructure() const;
 
+    PROJ_DLL void setUserInputCacheSize(size_t maxEntries);
+
+    PROJ_DLL size_t getUserInputCacheSize() const;
+
+    PROJ_DLL void getUserInputCacheStatistics(size_t &hits,
+                                              size_t &misses) const;
+
     PROJ_PRIVATE :
         //! @cond Doxygen_Suppress
         PROJ_DLL void *
@@ -743,6 +750,24 @@ class PROJ_GCC_DLL DatabaseContext {
     getNonDeprecated(const std::string &tableName, const std::string &authName,
                      const std::string &code) const;
 
+    PROJ_INTERNAL bool
+    getFromUserInputCache(const std::string &key, util::BaseObjectPtr &obj,
+                          std::list<std::string> &warnings) const;
+
+    PROJ_INTERNAL void
+    insertIntoUserInputCache(const std::string &key,
+                             const util::BaseObjectNNPtr &obj,
+                             const std::list<std::string> &warnings) const;
+
+    PROJ_INTERNAL bool getCRSIdentificationFromCache(
+        const std::string &key,
+        std::list<std::pair<crs::CRSNNPtr, int>> &res) const;
+
+    PROJ_INTERNAL void
+    cacheCRSIdentification(const std::string &key,
+                           const std::list<std::pair<crs::CRSNNPtr, int>> &res)
+        const;
+
     //! @endcond
 
   protected:
@@ -32,6 +32,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -40,6 +41,7 @@
 #endif
 
 #include <algorithm>
+#include <functional>
 #include <limits>
 
 #include "proj.h"
@@ -47,6 +49,7 @@
 #include "proj_internal.h"
 #include "proj_math.h"
 #include "geodesic.h"
+#include "parallel.hpp"
 
 #include "proj/common.hpp"
 #include "proj/coordinateoperation.hpp"
@@ -108,6 +111,59 @@ PJ_COORD proj_geod (const PJ *P, PJ_COORD a, PJ_COORD b) {
 }
 
 
+/* Whether p[0..n) and q[0..n) overlap at different offsets */
+static bool overlap_shifted (const PJ_COORD *p, const PJ_COORD *q, size_t n) {
+    std::less<const PJ_COORD *> before;
+    return p != q && before (p, q + n) && before (q, p + n);
+}
+
+
+/*****************************************************************************/
+int proj_geod_array (const PJ *P, size_t n, const PJ_COORD *a, const PJ_COORD *b, PJ_COORD *out, int nthreads) {
+/******************************************************************************
+    proj_geod() for n pairs of points: out[i] gets the distance and azimuths
+    from a[i] to b[i]. For the legs of a track, pass the track as a, and
+    the track from its second point on as b, with n one less than the
+    number of points. out may be the same array as a or b.
+
+    The chunks of PJ_BATCH_SIZE pairs are spread over up to nthreads
+    threads, or one per hardware thread if nthreads is 0, with the same
+    results whatever the number of threads.
+
+    Returns 0, or EINVAL if P has no ellipsoid to compute geodesics on.
+******************************************************************************/
+    if (nullptr==P || nullptr==P->geod)
+        return EINVAL;
+
+    /* Then a chunk reads what the next one writes, as for the legs of a */
+    /* track computed in place: keep the chunks in order                 */
+    if (overlap_shifted (out, a, n) || overlap_shifted (out, b, n))
+        nthreads = 1;
+
+    pj_run_parallel (nthreads, (n + PJ_BATCH_SIZE - 1) / PJ_BATCH_SIZE, [&](size_t chunk) {
+        double lat1[PJ_BATCH_SIZE] = {}, lon1[PJ_BATCH_SIZE] = {};
+        double lat2[PJ_BATCH_SIZE] = {}, lon2[PJ_BATCH_SIZE] = {};
+        double s12[PJ_BATCH_SIZE], azi1[PJ_BATCH_SIZE], azi2[PJ_BATCH_SIZE];
+        const size_t k = chunk * PJ_BATCH_SIZE;
+        const size_t m = (n - k < PJ_BATCH_SIZE) ? n - k : PJ_BATCH_SIZE;
+        size_t i;
+
+        /* Note: the geodesic code takes arguments in degrees */
+        for (i = 0;  i < m;  i++) {
+            lat1[i] = PJ_TODEG (a[k + i].lpz.phi);
+            lon1[i] = PJ_TODEG (a[k + i].lpz.lam);
+            lat2[i] = PJ_TODEG (b[k + i].lpz.phi);
+            lon2[i] = PJ_TODEG (b[k + i].lpz.lam);
+        }
+        geod_inverse_batch (P->geod, lat1, lon1, lat2, lon2, static_cast<int>(m),
+                            s12, azi1, azi2, 1);
+        for (i = 0;  i < m;  i++)
+            out[k + i] = proj_coord (s12[i], azi1[i], azi2[i], 0);
+    });
+    return 0;
+}
+
+
 /* Geodesic distance (in meter) between two points with angular 2D coordinates */
 double proj_lp_dist (const PJ *P, PJ_COORD a, PJ_COORD b) {
     double s12, azi1, azi2;
@@ -242,6 +298,25 @@ similarly, but prefers the 2D resp. 3D interfaces if available.
 
 
 
+/* Whether proj_trans_array() has a faster way than proj_trans() per coordinate */
+static int has_batch_path (PJ *P, PJ_DIRECTION direction) {
+    if (nullptr==P || !P->alternativeCoordinateOperations.empty())
+        return 0;
+    if (direction != PJ_FWD && direction != PJ_INV)
+        return 0;
+    if (nullptr!=P->trans_array)
+        return 1;
+    if (P->inverted)
+        direction = opposite_direction (direction);
+    if (direction == PJ_FWD)
+        return nullptr==P->fwd4d && (nullptr!=P->fwd3d_batch ||
+               (nullptr!=P->fwd_batch && nullptr==P->fwd3d));
+    return nullptr==P->inv4d && (nullptr!=P->inv3d_batch ||
+           (nullptr!=P->inv_batch && nullptr==P->inv3d));
+}
+
+
+
 /*****************************************************************************/
 int proj_trans_array (PJ *P, PJ_DIRECTION direction, size_t n, PJ_COORD *coord) {
 /******************************************************************************
@@ -252,6 +327,16 @@ int proj_trans_array (PJ *P, PJ_DIRECTION direction, size_t n, PJ_COORD *coord)
 ******************************************************************************/
     size_t i;
 
+    /* Operations providing a batch kernel take the whole array at once */
+    if (has_batch_path (P, direction)) {
+        PJ_DIRECTION dir = P->inverted ? opposite_direction (direction) : direction;
+        if (nullptr!=P->trans_array)
+            return P->trans_array (P, dir, n, coord);
+        if (dir == PJ_FWD)
+            return pj_fwd_array (P, n, coord);
+        return pj_inv_array (P, n, coord);
+    }
+
     for (i = 0;  i < n;  i++) {
         coord[i] = proj_trans (P, direction, coord[i]);
         if (proj_errno(P))
@@ -417,6 +502,93 @@ size_t proj_trans_generic (
 }
 
 
+/*****************************************************************************/
+int proj_trans_grid (PJ *P, PJ_DIRECTION direction,
+                     double x0, double dx, size_t nx,
+                     double y0, double dy, size_t ny,
+                     PJ_COORD *out) {
+/******************************************************************************
+    Transform the regular lattice of nx*ny points (x0 + i*dx, y0 + j*dy),
+    with z = t = 0, into out[j*nx + i], i.e. row by row.
+
+    Unlike with proj_trans_array, a point that fails does not stop the
+    others: it is set to HUGE_VAL and the remaining points are transformed
+    regardless. Returns 0 if all points were transformed without error,
+    otherwise the error number of a failure.
+
+    Projections whose forward is separable in longitude and latitude
+    compute the terms depending on only one of them once per column or
+    row, and operations with a batch path get the points in chunks.
+******************************************************************************/
+    const size_t chunk = 256;
+    PJ_COORD saved[chunk];
+    PJ_DIRECTION dir;
+    size_t i, j, k, m, n;
+    int last_errno, err = 0;
+
+    if (nullptr==P || nullptr==out)
+        return EINVAL;
+    switch (direction) {
+        case PJ_FWD:
+        case PJ_INV:
+        case PJ_IDENT:
+            break;
+        default:
+            proj_errno_set (P, EINVAL);
+            return EINVAL;
+    }
+    if (ny != 0 && nx > SIZE_MAX / ny) {
+        proj_errno_set (P, EINVAL);
+        return EINVAL;
+    }
+    dir = P->inverted ? opposite_direction (direction) : direction;
+    n = nx * ny;
+    last_errno = proj_errno_reset (P);
+
+    if (PJ_FWD==dir && P->alternativeCoordinateOperations.empty() &&
+        pj_fwd_lattice (P, x0, dx, nx, y0, dy, ny, out)) {
+        err = proj_errno (P);
+    }
+    else {
+        for (j = 0;  j < ny;  j++)
+            for (i = 0;  i < nx;  i++)
+                out[j*nx + i] = proj_coord (x0 + i*dx, y0 + j*dy, 0, 0);
+        if (PJ_IDENT==direction) {
+            proj_errno_restore (P, last_errno);
+            return 0;
+        }
+
+        for (k = 0;  k < n;  k += m) {
+            m = (n - k < chunk) ? n - k : chunk;
+
+            /* A chunk with a failure is redone point by point */
+            if (has_batch_path (P, direction)) {
+                memcpy (saved, out + k, m * sizeof (PJ_COORD));
+                if (0==proj_trans_array (P, direction, m, out + k))
+                    continue;
+                proj_errno_reset (P);
+                memcpy (out + k, saved, m * sizeof (PJ_COORD));
+            }
+
+            for (i = k;  i < k + m;  i++) {
+                out[i] = proj_trans (P, direction, out[i]);
+                if (proj_errno (P)) {
+                    err = proj_errno (P);
+                    proj_errno_reset (P);
+                }
+            }
+        }
+    }
+
+    if (err)
+        proj_errno_set (P, err);
+    else
+        proj_errno_restore (P, last_errno);
+    return err;
+}
+
+
+
 /*************************************************************************************/
 PJ_COORD pj_geocentric_latitude (const PJ *P, PJ_DIRECTION direction, PJ_COORD coord) {
 /**************************************************************************************
@@ -1467,6 +1639,23 @@ PJ_PROJ_INFO proj_pj_info(PJ *P) {
 }
 
 
+/*****************************************************************************/
+void proj_pipeline_step_counts(const PJ *P, int *steps, int *optimized_steps) {
+/******************************************************************************
+    Number of steps of a pipeline as defined, and as run after optimization.
+    Both are 1 for anything but a pipeline, and 0 for a null pointer.
+******************************************************************************/
+    int defined = 0, optimized = 0;
+
+    if (nullptr!=P)
+        pj_pipeline_step_counts (P, &defined, &optimized);
+    if (nullptr!=steps)
+        *steps = defined;
+    if (nullptr!=optimized_steps)
+        *optimized_steps = optimized;
+}
+
+
 /*****************************************************************************/
 PJ_GRID_INFO proj_grid_info(const char *gridname) {
 /******************************************************************************
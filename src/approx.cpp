@@ -0,0 +1,653 @@
+/******************************************************************************
+ * Project:  PROJ
+ * Purpose:  Piecewise Chebyshev approximation of a transformation over a
+ *           region, for fast evaluation on dense sets of coordinates.
+ *
+ ******************************************************************************
+ * Copyright (c) 2018, PROJ contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *****************************************************************************/
+
+/*****************************************************************************
+
+    Approximate transformations
+    ---------------------------
+
+    Raster warping and tile rendering transform dense regular grids of
+    coordinates, over which the transformation is smooth. Instead of
+    running the exact transformation for each of them, an approximation
+    object fits it once over a bounding box and then evaluates polynomials.
+
+    The box is split as a quadtree until, in each cell, a tensor product of
+    Chebyshev polynomials of degree APPROX_DEGREE in each direction, fitted
+    to the exact transformation at the Chebyshev nodes of the cell, matches
+    it to within the requested tolerance at a grid of check points (which
+    includes the cell boundary, where the fit is the least accurate). The
+    largest deviation found over all cells is kept as the achieved error.
+
+    Only the horizontal part of the transformation is approximated: the
+    exact transformation is sampled at z = t = 0, and z and t pass through
+    the approximation unchanged. Cells in which the exact transformation
+    fails at a node, even after APPROX_MAX_DEPTH subdivisions, as well as
+    points outside the bounding box, give an error. A cell which still
+    misses the tolerance after APPROX_MAX_DEPTH subdivisions fails the
+    whole fit.
+
+    The result is a PJ with only a forward direction, so proj_trans(),
+    proj_trans_array() and proj_trans_generic() all apply to it. The batch
+    kernel of proj_trans_array() locates the cells of a chunk of points
+    first, then evaluates the polynomials of each run of points in the same
+    cell in lockstep. It can be written to a file and read back, in native
+    byte order:
+
+        char[8]    "PROJAPPX"
+        int32      1 (version, also catching byte order mismatches)
+        int32      degree, left units, right units, cell count, coef count
+        double[5]  xmin, ymin, xmax, ymax, achieved error
+        cells      double[4] x0, y0, x1, y1; int32 children, coefs
+        double[]   coefficients
+
+******************************************************************************/
+
+#define PJ_LIB__
+
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <new>
+#include <vector>
+
+#include "proj.h"
+#include "proj_internal.h"
+
+#define APPROX_DEGREE     7
+#define APPROX_N          (APPROX_DEGREE + 1)
+#define APPROX_CHECKS     9
+#define APPROX_MAX_DEPTH  8
+
+static const char approx_magic[8] = {'P', 'R', 'O', 'J', 'A', 'P', 'P', 'X'};
+
+namespace { // anonymous namespace
+struct approx_cell {
+    double x0, y0, x1, y1;
+    int32_t children;   /* index of the first of 4 children, or -1 for a leaf */
+    int32_t coefs;      /* leaves: index of 2*APPROX_N*APPROX_N coefficients, or -1 */
+};
+
+struct pj_opaque_approx {
+    std::vector<approx_cell> cells;
+    std::vector<double> coefs;
+    double max_error = 0;
+};
+
+/* State only needed while fitting */
+struct approx_fit {
+    PJ *P;
+    PJ_DIRECTION direction;
+    double tolerance;
+    double T[APPROX_N][APPROX_N];   /* T[i][k]: T_i at the k'th Chebyshev node */
+};
+} // anonymous namespace
+
+
+static PJ_XY approx_eval_cell (const double *c, double u, double v) {
+    double Tu[APPROX_N], Tv[APPROX_N];
+    PJ_XY xy = {0, 0};
+    int i, j;
+
+    Tu[0] = Tv[0] = 1;
+    Tu[1] = u;
+    Tv[1] = v;
+    for (i = 2;  i < APPROX_N;  i++) {
+        Tu[i] = 2*u*Tu[i-1] - Tu[i-2];
+        Tv[i] = 2*v*Tv[i-1] - Tv[i-2];
+    }
+
+    for (i = 0;  i < APPROX_N;  i++) {
+        double sx = 0, sy = 0;
+        for (j = 0;  j < APPROX_N;  j++) {
+            sx += c[i*APPROX_N + j] * Tv[j];
+            sy += c[APPROX_N*APPROX_N + i*APPROX_N + j] * Tv[j];
+        }
+        xy.x += sx * Tu[i];
+        xy.y += sy * Tu[i];
+    }
+    return xy;
+}
+
+
+/* The Chebyshev polynomials at n points, by the recurrence of approx_eval_cell */
+static void approx_chebyshev_array (size_t n, const double *u, double T[][PJ_BATCH_SIZE]) {
+    int i;
+    size_t k;
+
+    for (k = 0;  k < n;  k++) {
+        T[0][k] = 1;
+        T[1][k] = u[k];
+    }
+    for (i = 2;  i < APPROX_N;  i++)
+        for (k = 0;  k < n;  k++)
+            T[i][k] = 2*u[k]*T[i-1][k] - T[i-2][k];
+}
+
+
+/* approx_eval_cell for the points k0..k1-1, all in the cell of the */
+/* coefficients c, in the same order of operations                  */
+static void approx_eval_cell_array (const double *c, size_t k0, size_t k1,
+                                    const double Tu[][PJ_BATCH_SIZE], const double Tv[][PJ_BATCH_SIZE],
+                                    double *x, double *y) {
+    double sx[PJ_BATCH_SIZE], sy[PJ_BATCH_SIZE];
+    int i, j;
+    size_t k;
+
+    for (k = k0;  k < k1;  k++)
+        x[k] = y[k] = 0;
+
+    for (i = 0;  i < APPROX_N;  i++) {
+        for (k = k0;  k < k1;  k++)
+            sx[k] = sy[k] = 0;
+        for (j = 0;  j < APPROX_N;  j++) {
+            const double cx = c[i*APPROX_N + j], cy = c[APPROX_N*APPROX_N + i*APPROX_N + j];
+            for (k = k0;  k < k1;  k++) {
+                sx[k] += cx * Tv[j][k];
+                sy[k] += cy * Tv[j][k];
+            }
+        }
+        for (k = k0;  k < k1;  k++) {
+            x[k] += sx[k] * Tu[i][k];
+            y[k] += sy[k] * Tu[i][k];
+        }
+    }
+}
+
+
+/* The leaf of the point (x, y), or nullptr outside the box or in a cell without a fit */
+static const approx_cell *approx_locate (const struct pj_opaque_approx *Q, double x, double y) {
+    const approx_cell *cell = &Q->cells[0];
+
+    if (!(x >= cell->x0 && x <= cell->x1 && y >= cell->y0 && y <= cell->y1))
+        return nullptr;
+
+    while (cell->children >= 0) {
+        int quadrant = (x >= (cell->x0 + cell->x1) / 2) + 2 * (y >= (cell->y0 + cell->y1) / 2);
+        cell = &Q->cells[cell->children + quadrant];
+    }
+    if (cell->coefs < 0)
+        return nullptr;
+    return cell;
+}
+
+
+/* Returns 0 outside the box, or in a cell without a fit */
+static int approx_eval (const struct pj_opaque_approx *Q, PJ_COORD *coo) {
+    double x = coo->xy.x, y = coo->xy.y;
+    const approx_cell *cell = approx_locate (Q, x, y);
+
+    if (nullptr==cell)
+        return 0;
+
+    coo->xy = approx_eval_cell (&Q->coefs[cell->coefs],
+                                (2*x - cell->x0 - cell->x1) / (cell->x1 - cell->x0),
+                                (2*y - cell->y0 - cell->y1) / (cell->y1 - cell->y0));
+    return 1;
+}
+
+
+static PJ_COORD approx_forward_4d (PJ_COORD coo, PJ *P) {
+    if (!approx_eval (static_cast<struct pj_opaque_approx*>(P->opaque), &coo)) {
+        proj_errno_set (P, PJD_ERR_INVALID_X_OR_Y);
+        return proj_coord_error ();
+    }
+    return coo;
+}
+
+
+static int approx_trans_array (PJ *P, PJ_DIRECTION direction, size_t n, PJ_COORD *coord) {
+    const struct pj_opaque_approx *Q = static_cast<struct pj_opaque_approx*>(P->opaque);
+    int last_errno;
+    size_t i, j, k, m;
+
+    if (direction != PJ_FWD) {
+        proj_errno_set (P, EINVAL);
+        return EINVAL;
+    }
+
+    last_errno = proj_errno_reset (P);
+    for (k = 0;  k < n;  k += m) {
+        const approx_cell *cells[PJ_BATCH_SIZE];
+        double u[PJ_BATCH_SIZE] = {}, v[PJ_BATCH_SIZE] = {};
+        double Tu[APPROX_N][PJ_BATCH_SIZE], Tv[APPROX_N][PJ_BATCH_SIZE];
+        double x[PJ_BATCH_SIZE], y[PJ_BATCH_SIZE];
+        PJ_COORD *c = coord + k;
+        size_t located;
+
+        m = (n - k < PJ_BATCH_SIZE) ? n - k : PJ_BATCH_SIZE;
+
+        /* Up to the first point without a fit, where the transformation stops */
+        for (located = 0;  located < m;  located++) {
+            const approx_cell *cell = approx_locate (Q, c[located].xy.x, c[located].xy.y);
+            if (nullptr==cell)
+                break;
+            cells[located] = cell;
+            u[located] = (2*c[located].xy.x - cell->x0 - cell->x1) / (cell->x1 - cell->x0);
+            v[located] = (2*c[located].xy.y - cell->y0 - cell->y1) / (cell->y1 - cell->y0);
+        }
+
+        approx_chebyshev_array (located, u, Tu);
+        approx_chebyshev_array (located, v, Tv);
+        for (i = 0;  i < located;  i = j) {
+            for (j = i + 1;  j < located && cells[j] == cells[i];  j++)
+                ;
+            approx_eval_cell_array (&Q->coefs[cells[i]->coefs], i, j, Tu, Tv, x, y);
+        }
+        for (i = 0;  i < located;  i++) {
+            c[i].xy.x = x[i];
+            c[i].xy.y = y[i];
+        }
+
+        if (located < m) {
+            c[located] = proj_coord_error ();
+            proj_errno_set (P, PJD_ERR_INVALID_X_OR_Y);
+            return PJD_ERR_INVALID_X_OR_Y;
+        }
+    }
+    proj_errno_restore (P, last_errno);
+    return proj_errno (P);
+}
+
+
+static PJ *approx_destructor (PJ *P, int errlev) {
+    if (nullptr==P)
+        return nullptr;
+    delete static_cast<struct pj_opaque_approx*>(P->opaque);
+    P->opaque = nullptr;
+    return pj_default_destructor (P, errlev);
+}
+
+
+static PJ *approx_new (PJ_CONTEXT *ctx) {
+    PJ *A = pj_new ();
+    if (nullptr==A) {
+        proj_context_errno_set (ctx, ENOMEM);
+        return nullptr;
+    }
+    A->opaque = new (std::nothrow) pj_opaque_approx ();
+    if (nullptr==A->opaque) {
+        delete A;
+        proj_context_errno_set (ctx, ENOMEM);
+        return nullptr;
+    }
+    A->ctx = ctx;
+    A->descr = "Approximate transformation";
+    A->destructor = approx_destructor;
+    A->fwd4d = approx_forward_4d;
+    A->trans_array = approx_trans_array;
+    A->to_meter = A->fr_meter = A->vto_meter = A->vfr_meter = 1.0;
+
+    /* The exact transformation did all of that while fitting */
+    A->skip_fwd_prepare  = 1;
+    A->skip_fwd_finalize = 1;
+    A->skip_inv_prepare  = 1;
+    A->skip_inv_finalize = 1;
+    return A;
+}
+
+
+/* The exact transformation at (x, y) of the cell, in cell coordinates */
+static int approx_exact (struct approx_fit *F, const approx_cell *cell, double u, double v, PJ_XY *xy) {
+    PJ_COORD coo = proj_coord ((cell->x0 + cell->x1) / 2 + u * (cell->x1 - cell->x0) / 2,
+                               (cell->y0 + cell->y1) / 2 + v * (cell->y1 - cell->y0) / 2, 0, 0);
+    proj_errno_reset (F->P);
+    coo = proj_trans (F->P, F->direction, coo);
+    if (HUGE_VAL==coo.v[0] || HUGE_VAL==coo.v[1] || proj_errno (F->P))
+        return 0;
+    *xy = coo.xy;
+    return 1;
+}
+
+
+/* Fit one cell, returning the error found at the check points, or -1 if the fit failed */
+static double approx_fit_cell (struct approx_fit *F, const approx_cell *cell, double *c) {
+    PJ_XY f[APPROX_N][APPROX_N];
+    double err = 0;
+    int i, j, k, l;
+
+    for (k = 0;  k < APPROX_N;  k++)
+        for (l = 0;  l < APPROX_N;  l++)
+            if (!approx_exact (F, cell, F->T[1][k], F->T[1][l], &f[k][l]))
+                return -1;
+
+    /* Discrete orthogonality of the Chebyshev polynomials at their nodes */
+    for (i = 0;  i < APPROX_N;  i++)
+        for (j = 0;  j < APPROX_N;  j++) {
+            double sx = 0, sy = 0, w;
+            for (k = 0;  k < APPROX_N;  k++)
+                for (l = 0;  l < APPROX_N;  l++) {
+                    w = F->T[i][k] * F->T[j][l];
+                    sx += w * f[k][l].x;
+                    sy += w * f[k][l].y;
+                }
+            w = 4.0 / (APPROX_N * APPROX_N);
+            if (0==i)
+                w /= 2;
+            if (0==j)
+                w /= 2;
+            c[i*APPROX_N + j] = w * sx;
+            c[APPROX_N*APPROX_N + i*APPROX_N + j] = w * sy;
+        }
+
+    for (k = 0;  k < APPROX_CHECKS;  k++)
+        for (l = 0;  l < APPROX_CHECKS;  l++) {
+            double u = -1 + 2.0 * k / (APPROX_CHECKS - 1);
+            double v = -1 + 2.0 * l / (APPROX_CHECKS - 1);
+            PJ_XY exact, approx;
+            if (!approx_exact (F, cell, u, v, &exact))
+                return -1;
+            approx = approx_eval_cell (c, u, v);
+            err = fmax (err, hypot (approx.x - exact.x, approx.y - exact.y));
+        }
+    return err;
+}
+
+
+static int approx_fit_tree (struct approx_fit *F, struct pj_opaque_approx *Q, size_t index, int depth) {
+    double c[2*APPROX_N*APPROX_N];
+    double err = approx_fit_cell (F, &Q->cells[index], c);
+    int i;
+
+    if (depth < APPROX_MAX_DEPTH && (err < 0 || err > F->tolerance)) {
+        approx_cell parent = Q->cells[index];
+        double xm = (parent.x0 + parent.x1) / 2, ym = (parent.y0 + parent.y1) / 2;
+        size_t first = Q->cells.size ();
+
+        Q->cells[index].children = static_cast<int32_t>(first);
+        Q->cells.push_back ({parent.x0, parent.y0, xm,        ym,        -1, -1});
+        Q->cells.push_back ({xm,        parent.y0, parent.x1, ym,        -1, -1});
+        Q->cells.push_back ({parent.x0, ym,        xm,        parent.y1, -1, -1});
+        Q->cells.push_back ({xm,        ym,        parent.x1, parent.y1, -1, -1});
+        for (i = 0;  i < 4;  i++)
+            if (!approx_fit_tree (F, Q, first + i, depth + 1))
+                return 0;
+        return 1;
+    }
+
+    /* A leaf. Without a fit, points in it are errors */
+    if (err < 0)
+        return 1;
+    if (err > F->tolerance)
+        return 0;
+    Q->cells[index].coefs = static_cast<int32_t>(Q->coefs.size ());
+    Q->coefs.insert (Q->coefs.end (), c, c + 2*APPROX_N*APPROX_N);
+    Q->max_error = fmax (Q->max_error, err);
+    return 1;
+}
+
+
+/*****************************************************************************/
+PJ *proj_create_approximation (PJ_CONTEXT *ctx, PJ *P, PJ_DIRECTION direction,
+                               double xmin, double ymin, double xmax, double ymax,
+                               double tolerance) {
+/******************************************************************************
+    Fit an approximation of the transformation P in the given direction over
+    the box xmin..xmax, ymin..ymax (in the input units of P in that
+    direction), to within tolerance (in its output units, hence in radians
+    for angular output). P is not needed once the approximation is built.
+
+    Returns the approximation as a PJ with only a forward direction, or a
+    null pointer on error, including when a cell still misses the tolerance
+    after the maximum subdivision. proj_approximation_max_error() gives the largest
+    deviation from P found while fitting.
+******************************************************************************/
+    struct approx_fit F;
+    struct pj_opaque_approx *Q;
+    PJ *A;
+    int i, k, last_errno, fitted;
+
+    if (nullptr==ctx)
+        ctx = pj_get_default_ctx ();
+    if (nullptr==P || (direction != PJ_FWD && direction != PJ_INV) ||
+        !(xmin < xmax) || !(ymin < ymax) || !(tolerance > 0)) {
+        proj_context_errno_set (ctx, PJD_ERR_INVALID_ARG);
+        return nullptr;
+    }
+
+    A = approx_new (ctx);
+    if (nullptr==A)
+        return nullptr;
+    if (direction == PJ_FWD) {
+        A->left  = pj_left (P);
+        A->right = pj_right (P);
+    } else {
+        A->left  = pj_right (P);
+        A->right = pj_left (P);
+    }
+
+    F.P = P;
+    F.direction = direction;
+    F.tolerance = tolerance;
+    for (i = 0;  i < APPROX_N;  i++)
+        for (k = 0;  k < APPROX_N;  k++)
+            F.T[i][k] = cos (i * M_PI * (k + 0.5) / APPROX_N);
+
+    Q = static_cast<struct pj_opaque_approx*>(A->opaque);
+    last_errno = proj_errno_reset (P);
+    try {
+        Q->cells.push_back ({xmin, ymin, xmax, ymax, -1, -1});
+        fitted = approx_fit_tree (&F, Q, 0, 0);
+    } catch (const std::bad_alloc &) {
+        proj_errno_reset (P);
+        proj_errno_restore (P, last_errno);
+        return approx_destructor (A, ENOMEM);
+    }
+
+    /* Failures of P while fitting are part of the result, not errors */
+    proj_errno_reset (P);
+    proj_errno_restore (P, last_errno);
+
+    if (!fitted) {
+        proj_log_error (A, "Approximation: the tolerance cannot be met, even at the maximum subdivision");
+        return approx_destructor (A, PJD_ERR_TOLERANCE_CONDITION);
+    }
+    if (Q->coefs.empty ()) {
+        proj_log_error (A, "Approximation: the transformation fails all over the box");
+        return approx_destructor (A, PJD_ERR_INVALID_X_OR_Y);
+    }
+    proj_log_trace (A, "Approximation: %d cells, max error %g",
+                    static_cast<int>(Q->cells.size ()), Q->max_error);
+    return A;
+}
+
+
+static int is_approximation (const PJ *P) {
+    return nullptr!=P && P->fwd4d == approx_forward_4d;
+}
+
+
+/*****************************************************************************/
+double proj_approximation_max_error (const PJ *P) {
+/******************************************************************************
+    The largest deviation from the exact transformation found while fitting
+    the approximation P, or -1 if P is not an approximation.
+******************************************************************************/
+    if (!is_approximation (P))
+        return -1;
+    return static_cast<const struct pj_opaque_approx*>(P->opaque)->max_error;
+}
+
+
+/*****************************************************************************/
+int proj_approximation_write (const PJ *P, const char *filename) {
+/******************************************************************************
+    Write the approximation P to a file, to be read back by
+    proj_create_approximation_from_file(). The file is opened through the
+    file API of the context of P, as when reading it, so a context with a
+    file API of its own cannot write it. Returns 1 on success, 0 on error.
+******************************************************************************/
+    const struct pj_opaque_approx *Q;
+    int32_t header[6];
+    double box[5];
+    PJ_CONTEXT *ctx;
+    PAFile f;
+    int ok;
+
+    if (!is_approximation (P) || nullptr==filename)
+        return 0;
+    Q = static_cast<const struct pj_opaque_approx*>(P->opaque);
+    ctx = P->ctx;
+
+    f = pj_ctx_get_fileapi (ctx) == pj_get_default_fileapi () ?
+        pj_ctx_fopen (ctx, filename, "wb") : nullptr;
+    if (nullptr==f) {
+        proj_log_error (const_cast<PJ*>(P), "Approximation: cannot write %s", filename);
+        return 0;
+    }
+
+    header[0] = 1;
+    header[1] = APPROX_DEGREE;
+    header[2] = P->left;
+    header[3] = P->right;
+    header[4] = static_cast<int32_t>(Q->cells.size ());
+    header[5] = static_cast<int32_t>(Q->coefs.size ());
+    box[0] = Q->cells[0].x0;
+    box[1] = Q->cells[0].y0;
+    box[2] = Q->cells[0].x1;
+    box[3] = Q->cells[0].y1;
+    box[4] = Q->max_error;
+
+    ok = pj_ctx_fwrite (ctx, approx_magic, sizeof (approx_magic), 1, f) == 1 &&
+         pj_ctx_fwrite (ctx, header, sizeof (header), 1, f) == 1 &&
+         pj_ctx_fwrite (ctx, box, sizeof (box), 1, f) == 1;
+    for (const auto &cell: Q->cells) {
+        double bounds[4] = {cell.x0, cell.y0, cell.x1, cell.y1};
+        int32_t links[2] = {cell.children, cell.coefs};
+        ok = ok && pj_ctx_fwrite (ctx, bounds, sizeof (bounds), 1, f) == 1 &&
+                   pj_ctx_fwrite (ctx, links, sizeof (links), 1, f) == 1;
+    }
+    ok = ok && pj_ctx_fwrite (ctx, Q->coefs.data (), sizeof (double), Q->coefs.size (), f) == Q->coefs.size ();
+
+    if (0!=pj_ctx_fflush (ctx, f))
+        ok = 0;
+    pj_ctx_fclose (ctx, f);
+    if (!ok)
+        proj_log_error (const_cast<PJ*>(P), "Approximation: failed writing %s", filename);
+    return ok;
+}
+
+
+/* Check what a file claims before trusting it for evaluation */
+static int approx_is_consistent (const struct pj_opaque_approx *Q) {
+    const size_t ncells = Q->cells.size (), ncoefs = Q->coefs.size ();
+    size_t i;
+
+    if (0==ncells || 0!=ncoefs % (2*APPROX_N*APPROX_N))
+        return 0;
+    for (i = 0;  i < ncells;  i++) {
+        const approx_cell &cell = Q->cells[i];
+        if (!(cell.x0 < cell.x1) || !(cell.y0 < cell.y1))
+            return 0;
+        /* children always follow their parent, so descending terminates */
+        if (cell.children >= 0 &&
+            (static_cast<size_t>(cell.children) <= i || static_cast<size_t>(cell.children) + 4 > ncells))
+            return 0;
+        if (cell.coefs >= 0 &&
+            (cell.children >= 0 || 0!=cell.coefs % (2*APPROX_N*APPROX_N) ||
+             static_cast<size_t>(cell.coefs) >= ncoefs))
+            return 0;
+    }
+    return 1;
+}
+
+
+/*****************************************************************************/
+PJ *proj_create_approximation_from_file (PJ_CONTEXT *ctx, const char *filename) {
+/******************************************************************************
+    Read an approximation written by proj_approximation_write(). Returns a
+    null pointer if the file cannot be read or was not written by this
+    version of PROJ on a platform of the same byte order.
+******************************************************************************/
+    struct pj_opaque_approx *Q;
+    char magic[sizeof (approx_magic)];
+    int32_t header[6];
+    double box[5];
+    PAFile f;
+    PJ *A;
+    int ok;
+
+    if (nullptr==ctx)
+        ctx = pj_get_default_ctx ();
+    if (nullptr==filename) {
+        proj_context_errno_set (ctx, PJD_ERR_INVALID_ARG);
+        return nullptr;
+    }
+
+    f = pj_ctx_fopen (ctx, filename, "rb");
+    if (nullptr==f) {
+        proj_context_errno_set (ctx, ENOENT);
+        return nullptr;
+    }
+
+    A = approx_new (ctx);
+    if (nullptr==A) {
+        pj_ctx_fclose (ctx, f);
+        return nullptr;
+    }
+    Q = static_cast<struct pj_opaque_approx*>(A->opaque);
+
+    ok = pj_ctx_fread (ctx, magic, sizeof (magic), 1, f) == 1 &&
+         0==memcmp (magic, approx_magic, sizeof (magic)) &&
+         pj_ctx_fread (ctx, header, sizeof (header), 1, f) == 1 &&
+         1==header[0] && APPROX_DEGREE==header[1] &&
+         header[2] >= PJ_IO_UNITS_WHATEVER && header[2] <= PJ_IO_UNITS_RADIANS &&
+         header[3] >= PJ_IO_UNITS_WHATEVER && header[3] <= PJ_IO_UNITS_RADIANS &&
+         header[4] > 0 && header[5] >= 0 &&
+         pj_ctx_fread (ctx, box, sizeof (box), 1, f) == 1;
+
+    if (ok) {
+        try {
+            Q->cells.resize (header[4]);
+            Q->coefs.resize (header[5]);
+        } catch (const std::bad_alloc &) {
+            ok = 0;
+        }
+    }
+    for (size_t i = 0;  ok && i < Q->cells.size ();  i++) {
+        double bounds[4];
+        int32_t links[2];
+        ok = pj_ctx_fread (ctx, bounds, sizeof (bounds), 1, f) == 1 &&
+             pj_ctx_fread (ctx, links, sizeof (links), 1, f) == 1;
+        if (ok)
+            Q->cells[i] = {bounds[0], bounds[1], bounds[2], bounds[3], links[0], links[1]};
+    }
+    ok = ok && pj_ctx_fread (ctx, Q->coefs.data (), sizeof (double), Q->coefs.size (), f) == Q->coefs.size ();
+    pj_ctx_fclose (ctx, f);
+
+    if (!ok || !approx_is_consistent (Q)) {
+        proj_log_error (A, "Approximation: %s is not a valid approximation file", filename);
+        return approx_destructor (A, PJD_ERR_INVALID_ARG);
+    }
+
+    A->left  = static_cast<enum pj_io_units>(header[2]);
+    A->right = static_cast<enum pj_io_units>(header[3]);
+    Q->max_error = box[4];
+    return A;
+}
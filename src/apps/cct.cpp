@@ -72,17 +72,87 @@ Thomas Knudsen, thokn@sdfe.dk, 2016-05-25/2017-10-26
 ***********************************************************************/
 
 #include <ctype.h>
+#include <errno.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdarg.h>
+#include <stdint.h>
+
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#else
+#define CCT_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include "proj.h"
 #include "proj_internal.h"
 #include "proj_strtod.h"
 #include "proj_internal.h"
 #include "optargpm.h"
+#include "ordered_pipeline.h"
+
+/* Lines of text handed to a thread at a time with -j */
+#define TEXT_CHUNK_LINES 4096
+
+/* How a line of text input is read and written */
+typedef struct {
+    int *columns_xyzt;
+    int comment_column;     /* first column after the coordinates */
+    double fixed_z, fixed_time;
+    int decimals_angles, decimals_distances;
+    const char *progname;
+} TEXT_FORMAT;
+
+/* A run of input lines, and what they become */
+struct TEXT_CHUNK {
+    std::string lines;                  /* each one terminated by a '\0' */
+    std::vector<size_t> start;
+    std::vector<int> record_index;
+    std::vector<const char *> filename;
+    std::string out, err;
+};
+
+/* Records handled at a time in binary mode */
+#define BINARY_BLOCK 16384
+
+/* Layout and state of the binary mode */
+typedef struct {
+    size_t stride;          /* bytes per record */
+    long   offset[4];       /* byte offsets of x, y, z, t in a record, -1 if absent */
+    double fixed_z, fixed_time;
+    unsigned char *buf;     /* BINARY_BLOCK records */
+    PJ_COORD *coord;        /* and their coordinates */
+    long   failures;        /* records which could not be transformed */
+} BINARY_IO;
+
+/* Rows handled at a time in CSV mode */
+#define CSV_BLOCK 4096
+
+/* Size of a column name in the columnar container, NUL padding included */
+#define COLUMNAR_NAME 32
+
+/* Column selection and state of the CSV and columnar modes */
+struct TABLE_IO {
+    std::string column[4];  /* x, y, z, t by name or number, empty if not given */
+    int required[4];        /* whether the column must be present */
+    double fixed_z, fixed_time;
+    int decimals_angles, decimals_distances;
+    int skip_lines;
+    PJ_COORD *coord;        /* BINARY_BLOCK coordinates */
+    long failures;          /* rows which could not be transformed */
+    const char *progname;
+};
 
 
 static void logger(void *data, int level, const char *msg);
@@ -91,6 +161,15 @@ static void print(PJ_LOG_LEVEL log_level, const char *fmt, ...);
 /* Prototypes from functions in this file */
 char *column (char *buf, int n);
 PJ_COORD parse_input_line (char *buf, int *columns, double fixed_height, double fixed_time);
+static void transform_line (PJ *P, const TEXT_FORMAT *fmt, char *buf, int record_index,
+                            const char *filename, std::string &out, std::string &err);
+static void process_text_threaded (PJ *P, OPTARGS *o, const TEXT_FORMAT *fmt, char *buf,
+                                   int skip_lines, int nthreads);
+static int parse_layout (const char *arg, BINARY_IO *io);
+static int process_binary (PJ *P, OPTARGS *o, BINARY_IO *io);
+static int parse_table_columns (const char *arg, TABLE_IO *io);
+static int process_csv (PJ *P, OPTARGS *o, TABLE_IO *io);
+static int process_columnar (PJ *P, OPTARGS *o, TABLE_IO *io);
 
 
 static const char usage[] = {
@@ -109,6 +188,9 @@ static const char usage[] = {
     "    -s n              Skip n first lines of a infile\n"
     "    -v                Verbose: Provide non-essential informational output.\n"
     "                      Repeat -v for more verbosity (e.g. -vv)\n"
+    "    -j n              Transform text input on n threads\n"
+    "    -b                Binary input and output: records of little-endian\n"
+    "                      float64 x, y, z, t\n"
     "--------------------------------------------------------------------------------\n"
     "Long Options:\n"
     "--------------------------------------------------------------------------------\n"
@@ -120,6 +202,18 @@ static const char usage[] = {
     "    --verbose         Alias for -v\n"
     "    --inverse         Alias for -I\n"
     "    --skip-lines      Alias for -s\n"
+    "    --jobs            Alias for -j\n"
+    "    --binary          Alias for -b\n"
+    "    --layout=n,x,y[,z[,t]]\n"
+    "                      Binary records of n bytes, with x, y (and z, t) as\n"
+    "                      float64 at the given byte offsets. Other bytes are\n"
+    "                      copied to the output unchanged. Implies -b\n"
+    "    --mmap            Map binary input files into memory instead of reading\n"
+    "    --csv             Comma separated input and output, each file with a\n"
+    "                      header line. -c gives the x, y (and z, t) columns by\n"
+    "                      name or number, by default x,y,z,t\n"
+    "    --columnar        Input and output in cct's columnar container: row\n"
+    "                      groups of named float64 columns. -c as for --csv\n"
     "    --help            Alias for -h\n"
     "    --version         Print version number\n"
     "--------------------------------------------------------------------------------\n"
@@ -150,6 +244,10 @@ static const char usage[] = {
     "    cct -c 5,2,1,4  +proj=utm +ellps=GRS80 +zone=32\n"
     "4. as (1) but specify fixed height and time, hence needing only 2 cols in input:\n"
     "    cct -t 0 -z 0  +proj=utm  +ellps=GRS80  +zone=32\n"
+    "5. as (1) but for a point cloud of records with 3 float64 and an 8 byte colour:\n"
+    "    cct --layout=32,0,8,16 -t 0  +proj=utm  +ellps=GRS80  +zone=32  cloud.bin\n"
+    "6. as (1) but for a CSV file with lon, lat and name columns:\n"
+    "    cct --csv -c lon,lat  +proj=utm  +ellps=GRS80  +zone=32  places.csv\n"
     "--------------------------------------------------------------------------------\n"
 };
 
@@ -203,20 +301,16 @@ static void print(PJ_LOG_LEVEL log_level, const char *fmt, ...) {
 
 int main(int argc, char **argv) {
     PJ *P;
-    PJ_COORD point;
     PJ_PROJ_INFO info;
     OPTARGS *o;
-    char blank_comment[] = "";
-    char whitespace[] = " ";
-    char *comment;
-    char *comment_delimiter;
+    TEXT_FORMAT fmt;
     char *buf;
-    int i, nfields = 4, skip_lines = 0, verbose;
+    int i, nfields = 4, skip_lines = 0, verbose, binary, nthreads = 1;
     double fixed_z = HUGE_VAL, fixed_time = HUGE_VAL;
     int decimals_angles = 10;
     int decimals_distances = 4;
     int columns_xyzt[] = {1, 2, 3, 4};
-    const char *longflags[]  = {"v=verbose", "h=help", "I=inverse", "version", nullptr};
+    const char *longflags[]  = {"v=verbose", "h=help", "I=inverse", "b=binary", "mmap", "csv", "columnar", "version", nullptr};
     const char *longkeys[]   = {
         "o=output",
         "c=columns",
@@ -224,11 +318,16 @@ int main(int argc, char **argv) {
         "z=height",
         "t=time",
         "s=skip-lines",
+        "j=jobs",
+        "layout",
         nullptr};
+    BINARY_IO io = {32, {0, 8, 16, 24}, HUGE_VAL, HUGE_VAL, nullptr, nullptr, 0};
+    TABLE_IO table;
+    int csv, columnar;
 
     fout = stdout;
 
-    o = opt_parse (argc, argv, "hvI", "cdozts", longflags, longkeys);
+    o = opt_parse (argc, argv, "hvIb", "cdoztsj", longflags, longkeys);
     if (nullptr==o)
         return 0;
 
@@ -248,8 +347,11 @@ int main(int argc, char **argv) {
         return 0;
     }
 
+    binary = opt_given (o, "b") || opt_given (o, "layout");
+    csv = opt_given (o, "csv");
+    columnar = opt_given (o, "columnar");
     if (opt_given (o, "o"))
-        fout = fopen (opt_arg (o, "output"), "wt");
+        fout = fopen (opt_arg (o, "output"), (binary || columnar)? "wb": "wt");
     if (nullptr==fout) {
         print (PJ_LOG_ERROR, "%s: Cannot open '%s' for output\n", o->progname, opt_arg (o, "output"));
         free (o);
@@ -278,7 +380,55 @@ int main(int argc, char **argv) {
         skip_lines = atoi (opt_arg(o, "s"));
     }
 
-    if (opt_given (o, "c")) {
+    if (opt_given (o, "j")) {
+        nthreads = atoi (opt_arg (o, "j"));
+        if (nthreads < 1)
+            nthreads = 1;
+    }
+
+    if (binary && (opt_given (o, "c") || opt_given (o, "s"))) {
+        print (PJ_LOG_ERROR, "%s: -c and -s do not apply to binary input, see --layout\n", o->progname);
+        free (o);
+        if (stdout != fout)
+            fclose (fout);
+        return 1;
+    }
+
+    if (binary + csv + columnar > 1) {
+        print (PJ_LOG_ERROR, "%s: Only one of -b, --csv and --columnar can be given\n", o->progname);
+        free (o);
+        if (stdout != fout)
+            fclose (fout);
+        return 1;
+    }
+
+    if (columnar && opt_given (o, "s")) {
+        print (PJ_LOG_ERROR, "%s: -s does not apply to columnar input\n", o->progname);
+        free (o);
+        if (stdout != fout)
+            fclose (fout);
+        return 1;
+    }
+
+    table.fixed_z = fixed_z;
+    table.fixed_time = fixed_time;
+    if ((csv || columnar) && !parse_table_columns (opt_given (o, "c")? opt_arg (o, "c"): nullptr, &table)) {
+        print (PJ_LOG_ERROR, "%s: Bad column selection: '%s'\n", o->progname, opt_arg (o, "c"));
+        free (o);
+        if (stdout != fout)
+            fclose (fout);
+        return 1;
+    }
+
+    if (opt_given (o, "layout") && !parse_layout (opt_arg (o, "layout"), &io)) {
+        print (PJ_LOG_ERROR, "%s: Bad record layout: '%s'\n", o->progname, opt_arg (o, "layout"));
+        free (o);
+        if (stdout != fout)
+            fclose (fout);
+        return 1;
+    }
+
+    if (opt_given (o, "c") && !csv && !columnar) {
         int ncols;
         /* reset column numbers to ease comment output later on */
         for (i=0; i<4; i++)
@@ -320,7 +470,37 @@ int main(int argc, char **argv) {
         /* We have no API call for inverting an operation, so we brute force it. */
         P->inverted = !(P->inverted);
     }
-    direction = PJ_FWD;
+
+    if (binary) {
+        int ret;
+        io.fixed_z = fixed_z;
+        io.fixed_time = fixed_time;
+        ret = process_binary (P, o, &io);
+        if (io.failures)
+            print (PJ_LOG_ERROR, "%s: %ld records could not be transformed\n", o->progname, io.failures);
+        proj_destroy (P);
+        if (stdout != fout)
+            fclose (fout);
+        free (o);
+        return ret;
+    }
+
+    if (csv || columnar) {
+        int ret;
+        table.decimals_angles = decimals_angles;
+        table.decimals_distances = decimals_distances;
+        table.skip_lines = skip_lines;
+        table.failures = 0;
+        table.progname = o->progname;
+        ret = csv? process_csv (P, o, &table): process_columnar (P, o, &table);
+        if (table.failures)
+            print (PJ_LOG_ERROR, "%s: %ld rows could not be transformed\n", o->progname, table.failures);
+        proj_destroy (P);
+        if (stdout != fout)
+            fclose (fout);
+        free (o);
+        return ret;
+    }
 
     /* Allocate input buffer */
     buf = static_cast<char*>(calloc (1, 10000));
@@ -334,80 +514,41 @@ int main(int argc, char **argv) {
     }
 
 
+    fmt.columns_xyzt = columns_xyzt;
+    fmt.comment_column = nfields+1;
+    if (opt_given(o, "c")) {
+        /* what number is the last coordinate column in the input data? */
+        int colmax = 0;
+        for (i=0; i<4; i++)
+            colmax = MAX(colmax, columns_xyzt[i]);
+        fmt.comment_column = colmax+1;
+    }
+    fmt.fixed_z = fixed_z;
+    fmt.fixed_time = fixed_time;
+    fmt.decimals_angles = decimals_angles;
+    fmt.decimals_distances = decimals_distances;
+    fmt.progname = o->progname;
+
+    if (nthreads > 1)
+        process_text_threaded (P, o, &fmt, buf, skip_lines, nthreads);
+
     /* Loop over all records of all input files */
-    while (opt_input_loop (o, optargs_file_format_text)) {
-        int err;
+    while (nthreads <= 1 && opt_input_loop (o, optargs_file_format_text)) {
+        std::string out, err;
         void *ret = fgets (buf, 10000, o->input);
-        char *c = column (buf, 1);
         opt_eof_handler (o);
         if (nullptr==ret) {
             print (PJ_LOG_ERROR, "Read error in record %d\n", (int) o->record_index);
             continue;
         }
-        point = parse_input_line (buf, columns_xyzt, fixed_z, fixed_time);
         if (skip_lines > 0) {
             skip_lines--;
             continue;
         }
 
-        /* if it's a comment or blank line, we reflect it */
-        if (c && ((*c=='\0') || (*c=='#'))) {
-            fprintf (fout, "%s", buf);
-            continue;
-        }
-
-        if (HUGE_VAL==point.xyzt.x) {
-            /* otherwise, it must be a syntax error */
-            print (PJ_LOG_NONE, "# Record %d UNREADABLE: %s", (int) o->record_index, buf);
-            print (PJ_LOG_ERROR, "%s: Could not parse file '%s' line %d\n", o->progname, opt_filename (o), opt_record (o));
-            continue;
-        }
-
-        if (proj_angular_input (P, direction)) {
-            point.lpzt.lam = proj_torad (point.lpzt.lam);
-            point.lpzt.phi = proj_torad (point.lpzt.phi);
-        }
-        err = proj_errno_reset (P);
-        point = proj_trans (P, direction, point);
-
-        if (HUGE_VAL==point.xyzt.x) {
-            /* transformation error */
-            print (PJ_LOG_NONE, "# Record %d TRANSFORMATION ERROR: %s (%s)",
-                   (int) o->record_index, buf, pj_strerrno (proj_errno(P)));
-            proj_errno_restore (P, err);
-            continue;
-        }
-        proj_errno_restore (P, err);
-
-        /* handle comment string */
-        comment = column(buf, nfields+1);
-        if (opt_given(o, "c")) {
-            /* what number is the last coordinate column in the input data? */
-            int colmax = 0;
-            for (i=0; i<4; i++)
-                colmax = MAX(colmax, columns_xyzt[i]);
-            comment = column(buf, colmax+1);
-        }
-        comment_delimiter = (comment && *comment) ? whitespace : blank_comment;
-
-        /* Time to print the result */
-        if (proj_angular_output (P, direction)) {
-            point.lpzt.lam = proj_todeg (point.lpzt.lam);
-            point.lpzt.phi = proj_todeg (point.lpzt.phi);
-            print (PJ_LOG_NONE, "%14.*f  %14.*f  %12.*f  %12.4f%s%s\n",
-                   decimals_angles, point.xyzt.x,
-                   decimals_angles, point.xyzt.y,
-                   decimals_distances, point.xyzt.z,
-                   point.xyzt.t, comment_delimiter, comment
-            );
-        }
-        else
-            print (PJ_LOG_NONE, "%13.*f  %13.*f  %12.*f  %12.4f%s%s\n",
-                   decimals_distances, point.xyzt.x,
-                   decimals_distances, point.xyzt.y,
-                   decimals_distances, point.xyzt.z,
-                   point.xyzt.t, comment_delimiter, comment
-            );
+        transform_line (P, &fmt, buf, o->record_index, opt_filename (o), out, err);
+        fputs (out.c_str(), fout);
+        fputs (err.c_str(), stderr);
     }
 
     proj_destroy(P);
@@ -472,3 +613,873 @@ PJ_COORD parse_input_line (char *buf, int *columns, double fixed_height, double
     errno = prev_errno;
     return result;
 }
+
+
+
+/* Append x as "%*.*f" */
+static void append_fixed (std::string &out, double x, int width, int precision) {
+    char buf[64];
+    int n = pj_format_fixed (buf, sizeof buf, x, width, precision, 0);
+    if (n < (int) sizeof buf)
+        out.append (buf, n);
+    else
+        appendf (out, "%*.*f", width, precision, x);
+}
+
+
+/* Transform one line of text input, appending the result to out and messages to err */
+static void transform_line (PJ *P, const TEXT_FORMAT *fmt, char *buf, int record_index,
+                            const char *filename, std::string &out, std::string &err) {
+    PJ_COORD point;
+    char *comment;
+    const char *comment_delimiter;
+    char *c = column (buf, 1);
+    int errlev;
+
+    /* if it's a comment or blank line, we reflect it */
+    if (c && ((*c=='\0') || (*c=='#'))) {
+        out += buf;
+        return;
+    }
+
+    point = parse_input_line (buf, fmt->columns_xyzt, fmt->fixed_z, fmt->fixed_time);
+    if (HUGE_VAL==point.xyzt.x) {
+        /* otherwise, it must be a syntax error */
+        appendf (out, "# Record %d UNREADABLE: %s", record_index, buf);
+        appendf (err, "%s: Could not parse file '%s' line %d\n", fmt->progname, filename, record_index + 1);
+        return;
+    }
+
+    if (proj_angular_input (P, PJ_FWD)) {
+        point.lpzt.lam = proj_torad (point.lpzt.lam);
+        point.lpzt.phi = proj_torad (point.lpzt.phi);
+    }
+    errlev = proj_errno_reset (P);
+    point = proj_trans (P, PJ_FWD, point);
+
+    if (HUGE_VAL==point.xyzt.x) {
+        /* transformation error */
+        appendf (out, "# Record %d TRANSFORMATION ERROR: %s (%s)",
+                 record_index, buf, pj_strerrno (proj_errno(P)));
+        proj_errno_restore (P, errlev);
+        return;
+    }
+    proj_errno_restore (P, errlev);
+
+    /* handle comment string */
+    comment = column(buf, fmt->comment_column);
+    comment_delimiter = (comment && *comment) ? " " : "";
+
+    /* Time to print the result: "%14.*f  %14.*f  %12.*f  %12.4f" for angles, */
+    /* "%13.*f  %13.*f  %12.*f  %12.4f" otherwise, then the comment           */
+    if (proj_angular_output (P, PJ_FWD)) {
+        point.lpzt.lam = proj_todeg (point.lpzt.lam);
+        point.lpzt.phi = proj_todeg (point.lpzt.phi);
+        append_fixed (out, point.xyzt.x, 14, fmt->decimals_angles);
+        out += "  ";
+        append_fixed (out, point.xyzt.y, 14, fmt->decimals_angles);
+    }
+    else {
+        append_fixed (out, point.xyzt.x, 13, fmt->decimals_distances);
+        out += "  ";
+        append_fixed (out, point.xyzt.y, 13, fmt->decimals_distances);
+    }
+    out += "  ";
+    append_fixed (out, point.xyzt.z, 12, fmt->decimals_distances);
+    out += "  ";
+    append_fixed (out, point.xyzt.t, 12, 4);
+    out += comment_delimiter;
+    out += comment;
+    out += '\n';
+}
+
+
+/* Text mode with -j: chunks of lines are transformed on nthreads threads */
+static void process_text_threaded (PJ *P, OPTARGS *o, const TEXT_FORMAT *fmt, char *buf,
+                                   int skip_lines, int nthreads) {
+    int i;
+    bool more = true;
+
+    /* Each thread transforms with its own copy of P, in its own context */
+    std::vector<PJ *> workers (1, P);
+    for (i = 1;  i < nthreads;  i++) {
+        PJ_CONTEXT *ctx = proj_context_create ();
+        PJ *Q = ctx? proj_create_argv (ctx, o->pargc, o->pargv): nullptr;
+        if (nullptr==Q) {
+            proj_context_destroy (ctx);
+            break;
+        }
+        Q->inverted = P->inverted;
+        workers.push_back (Q);
+    }
+
+    ordered_pipeline<TEXT_CHUNK> ((int) workers.size(),
+        [&](TEXT_CHUNK &chunk) {
+            chunk.lines.clear ();
+            chunk.start.clear ();
+            chunk.record_index.clear ();
+            chunk.filename.clear ();
+            chunk.out.clear ();
+            chunk.err.clear ();
+            /* opt_input_loop must not be called again once it is done */
+            while (more && chunk.start.size() < TEXT_CHUNK_LINES && (more = opt_input_loop (o, optargs_file_format_text))) {
+                void *ret = fgets (buf, 10000, o->input);
+                opt_eof_handler (o);
+                if (nullptr==ret) {
+                    print (PJ_LOG_ERROR, "Read error in record %d\n", (int) o->record_index);
+                    continue;
+                }
+                if (skip_lines > 0) {
+                    skip_lines--;
+                    continue;
+                }
+                chunk.start.push_back (chunk.lines.size());
+                chunk.lines.append (buf, strlen (buf) + 1);
+                chunk.record_index.push_back (o->record_index);
+                chunk.filename.push_back (opt_filename (o));
+            }
+            return !chunk.start.empty();
+        },
+        [&](TEXT_CHUNK &chunk, int worker) {
+            for (size_t j = 0;  j < chunk.start.size();  j++)
+                transform_line (workers[worker], fmt, &chunk.lines[chunk.start[j]],
+                                chunk.record_index[j], chunk.filename[j], chunk.out, chunk.err);
+        },
+        [&](TEXT_CHUNK &chunk) {
+            fwrite (chunk.out.data(), 1, chunk.out.size(), fout);
+            fputs (chunk.err.c_str(), stderr);
+        });
+
+    for (i = 1;  i < (int) workers.size();  i++) {
+        PJ_CONTEXT *ctx = workers[i]->ctx;
+        proj_destroy (workers[i]);
+        proj_context_destroy (ctx);
+    }
+}
+
+
+/* "n,x,y[,z[,t]]": the record size, and the byte offsets of the coordinates */
+static int parse_layout (const char *arg, BINARY_IO *io) {
+    long stride, offset[4] = {-1, -1, -1, -1};
+    int i, n;
+
+    /* cppcheck-suppress invalidscanf */
+    n = sscanf (arg, "%ld,%ld,%ld,%ld,%ld", &stride, offset, offset+1, offset+2, offset+3);
+    if (n < 3 || stride <= 0)
+        return 0;
+    for (i = 0;  i < 4;  i++) {
+        if (i < n - 1 && (offset[i] < 0 || offset[i] + 8 > stride))
+            return 0;
+        io->offset[i] = offset[i];
+    }
+    io->stride = static_cast<size_t>(stride);
+    return 1;
+}
+
+
+static int little_endian (void) {
+    const unsigned short one = 1;
+    return 1 == *reinterpret_cast<const unsigned char *>(&one);
+}
+
+/* float64 in little-endian byte order, at any alignment */
+static double get_double (const unsigned char *p) {
+    unsigned char b[8];
+    double d;
+    int i;
+    for (i = 0;  i < 8;  i++)
+        b[i] = little_endian ()? p[i]: p[7 - i];
+    memcpy (&d, b, 8);
+    return d;
+}
+
+static void put_double (unsigned char *p, double d) {
+    unsigned char b[8];
+    int i;
+    memcpy (b, &d, 8);
+    for (i = 0;  i < 8;  i++)
+        p[i] = little_endian ()? b[i]: b[7 - i];
+}
+
+
+/* Transform n coordinates in place, with angles in degrees, going on past */
+/* failures. Returns the number of coordinates which failed.              */
+static long transform_block (PJ *P, PJ_COORD *coord, size_t n) {
+    int angular_input = proj_angular_input (P, PJ_FWD);
+    int angular_output = proj_angular_output (P, PJ_FWD);
+    long failures = 0;
+    size_t i;
+
+    if (angular_input) {
+        for (i = 0;  i < n;  i++) {
+            coord[i].lpzt.lam = proj_torad (coord[i].lpzt.lam);
+            coord[i].lpzt.phi = proj_torad (coord[i].lpzt.phi);
+        }
+    }
+
+    /* proj_trans_array does not tell which records failed, and may leave */
+    /* the block half transformed: then redo it a record at a time       */
+    std::vector<PJ_COORD> input (coord, coord + n);
+    int err = proj_errno_reset (P);
+    if (0 != proj_trans_array (P, PJ_FWD, n, coord)) {
+        for (i = 0;  i < n;  i++) {
+            proj_errno_reset (P);
+            coord[i] = proj_trans (P, PJ_FWD, input[i]);
+            if (proj_errno (P))
+                failures++;
+        }
+    }
+    proj_errno_restore (P, err);
+
+    if (angular_output) {
+        for (i = 0;  i < n;  i++) {
+            if (HUGE_VAL == coord[i].xyzt.x)
+                continue;
+            coord[i].lpzt.lam = proj_todeg (coord[i].lpzt.lam);
+            coord[i].lpzt.phi = proj_todeg (coord[i].lpzt.phi);
+        }
+    }
+    return failures;
+}
+
+
+/* Transform n records of io->buf in place */
+static void transform_records (PJ *P, BINARY_IO *io, size_t n) {
+    size_t i;
+    int j;
+
+    for (i = 0;  i < n;  i++) {
+        const unsigned char *record = io->buf + i * io->stride;
+        PJ_COORD *c = io->coord + i;
+        for (j = 0;  j < 4;  j++)
+            c->v[j] = io->offset[j] < 0? 0: get_double (record + io->offset[j]);
+        if (HUGE_VAL != io->fixed_z)
+            c->xyzt.z = io->fixed_z;
+        if (HUGE_VAL != io->fixed_time)
+            c->xyzt.t = io->fixed_time;
+    }
+
+    io->failures += transform_block (P, io->coord, n);
+
+    for (i = 0;  i < n;  i++) {
+        unsigned char *record = io->buf + i * io->stride;
+        PJ_COORD *c = io->coord + i;
+        for (j = 0;  j < 4;  j++)
+            if (io->offset[j] >= 0)
+                put_double (record + io->offset[j], c->v[j]);
+    }
+}
+
+
+/* Read records from a stream, which may be a pipe, a block at a time */
+static int binary_stream (PJ *P, BINARY_IO *io, FILE *in) {
+    size_t have = 0, got, n;
+    const size_t size = io->stride * BINARY_BLOCK;
+
+    do {
+        got = fread (io->buf + have, 1, size - have, in);
+        have += got;
+        n = have / io->stride;
+        if (0==n)
+            continue;
+        transform_records (P, io, n);
+        if (fwrite (io->buf, io->stride, n, fout) != n)
+            return 1;
+        have -= n * io->stride;
+        memmove (io->buf, io->buf + n * io->stride, have);
+    } while (got > 0);
+
+    if (have)
+        print (PJ_LOG_ERROR, "Ignoring %d bytes of an incomplete last record\n", (int) have);
+    return ferror (in)? 1: 0;
+}
+
+
+#ifdef CCT_MMAP
+/* Map a regular, non-empty file into memory; nullptr if it cannot be mapped */
+static const unsigned char *map_file (const char *name, size_t *size) {
+    struct stat st;
+    void *map;
+    int fd = open (name, O_RDONLY);
+
+    if (fd < 0)
+        return nullptr;
+    if (0 != fstat (fd, &st) || !S_ISREG (st.st_mode) || 0==st.st_size) {
+        close (fd);
+        return nullptr;
+    }
+    *size = static_cast<size_t>(st.st_size);
+    map = mmap (nullptr, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close (fd);
+    if (MAP_FAILED == map)
+        return nullptr;
+#ifdef MADV_SEQUENTIAL
+    madvise (map, *size, MADV_SEQUENTIAL);
+#endif
+    return static_cast<const unsigned char *>(map);
+}
+
+
+/* Process a file mapped into memory; returns -1 if it cannot be mapped */
+static int binary_mapped (PJ *P, BINARY_IO *io, const char *name) {
+    const unsigned char *map;
+    size_t size = 0, pos, n;
+    int ret = 0;
+
+    map = map_file (name, &size);
+    if (nullptr==map)
+        return -1;
+
+    for (pos = 0;  pos + io->stride <= size;  pos += n * io->stride) {
+        n = (size - pos) / io->stride;
+        if (n > BINARY_BLOCK)
+            n = BINARY_BLOCK;
+        memcpy (io->buf, map + pos, n * io->stride);
+        transform_records (P, io, n);
+        if (fwrite (io->buf, io->stride, n, fout) != n) {
+            ret = 1;
+            break;
+        }
+    }
+    if (0==ret && pos < size)
+        print (PJ_LOG_ERROR, "Ignoring %d bytes of an incomplete last record\n", (int) (size - pos));
+    munmap (const_cast<unsigned char *>(map), size);
+    return ret;
+}
+#endif
+
+
+/* Binary mode: all input files, or stdin, to fout */
+static int process_binary (PJ *P, OPTARGS *o, BINARY_IO *io) {
+    int i, ret = 0;
+
+    io->buf = static_cast<unsigned char *>(malloc (io->stride * BINARY_BLOCK));
+    io->coord = static_cast<PJ_COORD *>(malloc (BINARY_BLOCK * sizeof (PJ_COORD)));
+    if (nullptr==io->buf || nullptr==io->coord) {
+        print (PJ_LOG_ERROR, "%s: Out of memory\n", o->progname);
+        free (io->buf);
+        free (io->coord);
+        return 1;
+    }
+
+#if defined(_WIN32)
+    _setmode (_fileno (stdin), _O_BINARY);
+    if (stdout==fout)
+        _setmode (_fileno (stdout), _O_BINARY);
+#endif
+
+    if (0==o->fargc)
+        ret = binary_stream (P, io, stdin);
+
+    for (i = 0;  i < o->fargc && 0==ret;  i++) {
+        FILE *in;
+#ifdef CCT_MMAP
+        if (opt_given (o, "mmap")) {
+            ret = binary_mapped (P, io, o->fargv[i]);
+            if (ret >= 0)
+                continue;
+            ret = 0;
+        }
+#endif
+        in = fopen (o->fargv[i], "rb");
+        if (nullptr==in) {
+            print (PJ_LOG_ERROR, "%s: Cannot open '%s'\n", o->progname, o->fargv[i]);
+            continue;
+        }
+        ret = binary_stream (P, io, in);
+        fclose (in);
+    }
+
+    if (ret)
+        print (PJ_LOG_ERROR, "%s: I/O error\n", o->progname);
+    free (io->buf);
+    free (io->coord);
+    return ret;
+}
+
+
+/* Column selection of the CSV and columnar modes: 2 to 4 comma separated */
+/* column names or numbers, for x, y and those of z and t not given by    */
+/* -z and -t. Without -c, the columns named x and y, and z and t if any   */
+static int parse_table_columns (const char *arg, TABLE_IO *io) {
+    static const char *const xyzt[] = {"x", "y", "z", "t"};
+    int j;
+
+    for (j = 0;  j < 4;  j++) {
+        io->column[j].clear ();
+        io->required[j] = 0;
+    }
+
+    if (nullptr==arg) {
+        for (j = 0;  j < 4;  j++) {
+            io->column[j] = xyzt[j];
+            io->required[j] = j < 2;
+        }
+        return 1;
+    }
+
+    for (j = 0;  j < 4 && *arg;  j++) {
+        const char *end;
+        if ((2==j && HUGE_VAL != io->fixed_z) || (3==j && HUGE_VAL != io->fixed_time))
+            continue;
+        end = strchr (arg, ',');
+        if (nullptr==end)
+            end = arg + strlen (arg);
+        if (end==arg)
+            return 0;
+        io->column[j].assign (arg, end - arg);
+        io->required[j] = 1;
+        arg = end;
+        if (',' == *arg && 0 == *++arg)
+            return 0;
+    }
+    return 0==*arg && io->required[0] && io->required[1];
+}
+
+
+/* Index of a column given by name, or by number from 1; -1 if there is none */
+static int find_column (const std::vector<std::string> &names, const std::string &column) {
+    size_t i;
+    if (std::string::npos == column.find_first_not_of ("0123456789")) {
+        int n = atoi (column.c_str ());
+        return (n >= 1 && n <= (int) names.size())? n - 1: -1;
+    }
+    for (i = 0;  i < names.size();  i++)
+        if (names[i]==column)
+            return (int) i;
+    return -1;
+}
+
+/* Indices of the x, y, z, t columns, -1 for those not read */
+static int table_columns (const TABLE_IO *io, const std::vector<std::string> &names,
+                          const char *filename, int index[4]) {
+    int j;
+    for (j = 0;  j < 4;  j++) {
+        index[j] = io->column[j].empty()? -1: find_column (names, io->column[j]);
+        if (index[j] < 0 && io->required[j]) {
+            print (PJ_LOG_ERROR, "%s: No column '%s' in '%s'\n", io->progname, io->column[j].c_str(), filename);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* Coordinates neither read nor given: z is 0, and t unknown */
+static double absent_coordinate (const TABLE_IO *io, int j) {
+    if (2==j)
+        return HUGE_VAL==io->fixed_z? 0: io->fixed_z;
+    if (3==j)
+        return io->fixed_time;
+    return 0;
+}
+
+
+/* Read a line, without its line ending. Returns 0 at end of file */
+static int read_csv_line (FILE *in, std::string &line) {
+    char chunk[4096];
+    line.clear ();
+    while (fgets (chunk, sizeof chunk, in)) {
+        line += chunk;
+        if ('\n' == line.back())
+            break;
+    }
+    if (line.empty())
+        return 0;
+    while (!line.empty() && ('\n' == line.back() || '\r' == line.back()))
+        line.pop_back ();
+    return 1;
+}
+
+/* Split a CSV line into fields: offsets of the first character of each one, */
+/* and of the one after its last. Quoted fields may hold commas             */
+static void split_csv (const char *line, std::vector<size_t> &fields) {
+    size_t i = 0;
+    fields.clear ();
+    for (;;) {
+        fields.push_back (i);
+        if ('"' == line[i]) {
+            for (i++;  line[i];  i++) {
+                if ('"' != line[i])
+                    continue;
+                if ('"' != line[i + 1]) {
+                    i++;
+                    break;
+                }
+                i++;
+            }
+        }
+        while (line[i] && ',' != line[i])
+            i++;
+        fields.push_back (i);
+        if (0 == line[i])
+            return;
+        i++;
+    }
+}
+
+/* Text of a field, without surrounding blanks and quotes */
+static std::string csv_field (const char *begin, const char *end) {
+    std::string s;
+    while (begin < end && isspace (*begin))
+        begin++;
+    while (end > begin && isspace (end[-1]))
+        end--;
+    if (end - begin < 2 || '"' != *begin || '"' != end[-1])
+        return std::string (begin, end);
+    for (begin++, end--;  begin < end;  begin++) {
+        s += *begin;
+        if ('"' == *begin && begin + 1 < end && '"' == begin[1])
+            begin++;
+    }
+    return s;
+}
+
+/* Numeric value of a field, HUGE_VAL if it is not a number */
+static double csv_number (const char *begin, const char *end) {
+    std::string s = csv_field (begin, end);
+    char *endp;
+    double d;
+    int prev_errno = errno;
+
+    errno = 0;
+    d = proj_strtod (s.c_str(), &endp);
+    if (0 != errno || endp == s.c_str() || 0 != *endp)
+        d = HUGE_VAL;
+    errno = prev_errno;
+    return d;
+}
+
+/* The coordinates of a row; 0 if they cannot be read */
+static int csv_coord (const TABLE_IO *io, const std::string &row, const std::vector<size_t> &fields,
+                      const int index[4], PJ_COORD *c) {
+    int j;
+    for (j = 0;  j < 4;  j++) {
+        size_t k = 2 * (size_t) index[j];
+        if (index[j] < 0 || (2==j && HUGE_VAL != io->fixed_z) || (3==j && HUGE_VAL != io->fixed_time)) {
+            c->v[j] = absent_coordinate (io, j);
+            continue;
+        }
+        if (k >= fields.size())
+            return 0;
+        c->v[j] = csv_number (row.c_str() + fields[k], row.c_str() + fields[k + 1]);
+        if (HUGE_VAL == c->v[j])
+            return 0;
+    }
+    return 1;
+}
+
+/* A row with its coordinate columns replaced, and empty if c is nullptr */
+static void csv_row (std::string &out, const std::string &row, const std::vector<size_t> &fields,
+                     const int index[4], const int decimals[4], const PJ_COORD *c) {
+    size_t k;
+    int j;
+    for (k = 0;  k < fields.size();  k += 2) {
+        if (k)
+            out += ',';
+        for (j = 0;  j < 4 && index[j] != (int) (k / 2);  j++)
+            ;
+        if (j == 4)
+            out.append (row, fields[k], fields[k + 1] - fields[k]);
+        else if (nullptr != c)
+            append_fixed (out, c->v[j], 0, decimals[j]);
+    }
+    out += '\n';
+}
+
+
+/* Transform a CSV file a block of rows at a time. The header of the first */
+/* file is written, before its first row                                    */
+static int csv_file (PJ *P, TABLE_IO *io, FILE *in, const char *filename, bool *header_written) {
+    std::string header, out;
+    std::vector<std::string> names, rows (CSV_BLOCK);
+    std::vector<std::vector<size_t> > fields (CSV_BLOCK);
+    std::vector<int> slot (CSV_BLOCK);
+    int index[4], decimals[4], skip = io->skip_lines;
+    long line = 0;
+    size_t k;
+
+    /* The header is the first line after those skipped */
+    do {
+        if (!read_csv_line (in, header))
+            return ferror (in)? 1: 0;
+        line++;
+    } while (skip-- > 0);
+
+    split_csv (header.c_str(), fields[0]);
+    for (k = 0;  k < fields[0].size();  k += 2)
+        names.push_back (csv_field (header.c_str() + fields[0][k], header.c_str() + fields[0][k + 1]));
+    if (!table_columns (io, names, filename, index))
+        return 1;
+    if (!*header_written) {
+        header += '\n';
+        fputs (header.c_str(), fout);
+        *header_written = true;
+    }
+
+    decimals[0] = decimals[1] = proj_angular_output (P, PJ_FWD)? io->decimals_angles: io->decimals_distances;
+    decimals[2] = io->decimals_distances;
+    decimals[3] = 4;
+
+    for (;;) {
+        size_t n = 0, ncoord = 0, i;
+
+        /* Read a block of rows, then transform their coordinates at once */
+        while (n < CSV_BLOCK && read_csv_line (in, rows[n])) {
+            line++;
+            slot[n] = -1;
+            split_csv (rows[n].c_str(), fields[n]);
+            if (!rows[n].empty()) {
+                if (csv_coord (io, rows[n], fields[n], index, io->coord + ncoord))
+                    slot[n] = (int) ncoord++;
+                else {
+                    print (PJ_LOG_ERROR, "%s: Could not parse file '%s' line %ld\n", io->progname, filename, line);
+                    io->failures++;
+                }
+            }
+            n++;
+        }
+        if (0==n)
+            break;
+        io->failures += transform_block (P, io->coord, ncoord);
+
+        out.clear ();
+        for (i = 0;  i < n;  i++) {
+            const PJ_COORD *c = slot[i] < 0? nullptr: io->coord + slot[i];
+            if (rows[i].empty())
+                out += '\n';
+            else
+                csv_row (out, rows[i], fields[i], index, decimals, (c && HUGE_VAL != c->xyzt.x)? c: nullptr);
+        }
+        if (fwrite (out.data(), 1, out.size(), fout) != out.size()) {
+            print (PJ_LOG_ERROR, "%s: I/O error\n", io->progname);
+            return 1;
+        }
+        if (n < CSV_BLOCK)
+            break;
+    }
+    return ferror (in)? 1: 0;
+}
+
+
+/* CSV mode: all input files, or stdin, to fout */
+static int process_csv (PJ *P, OPTARGS *o, TABLE_IO *io) {
+    bool header_written = false;
+    int i, ret = 0;
+
+    io->coord = static_cast<PJ_COORD *>(malloc (CSV_BLOCK * sizeof (PJ_COORD)));
+    if (nullptr==io->coord) {
+        print (PJ_LOG_ERROR, "%s: Out of memory\n", o->progname);
+        return 1;
+    }
+
+    if (0==o->fargc)
+        ret = csv_file (P, io, stdin, "stdin", &header_written);
+
+    for (i = 0;  i < o->fargc && 0==ret;  i++) {
+        FILE *in = fopen (o->fargv[i], "rt");
+        if (nullptr==in) {
+            print (PJ_LOG_ERROR, "%s: Cannot open '%s'\n", o->progname, o->fargv[i]);
+            continue;
+        }
+        ret = csv_file (P, io, in, o->fargv[i], &header_written);
+        fclose (in);
+    }
+
+    free (io->coord);
+    return ret;
+}
+
+
+/*****************************************************************************
+
+    The columnar container of --columnar, with all numbers little-endian:
+
+        offset  size
+        0       8       "PROJCOL1"
+        8       4       number of columns, n (uint32)
+        12      4       rows per row group, g (uint32)
+        16      8       number of rows (uint64)
+        24      32*n    column names, NUL padded
+
+    then the row groups: g rows each, the last one possibly fewer, stored
+    as the float64 values of the first column, then those of the second
+    one and so on. The header and the row groups are multiples of 8 bytes,
+    so the values of a file mapped into memory are aligned. Output has the
+    header and layout of the input.
+
+*****************************************************************************/
+
+#define COLUMNAR_MAGIC "PROJCOL1"
+#define COLUMNAR_HEADER 24
+
+/* Columnar input: a stream, or a file mapped into memory */
+typedef struct {
+    FILE *in;
+    const unsigned char *map;
+    size_t size, pos;
+} COLUMNAR_SOURCE;
+
+static size_t columnar_read (COLUMNAR_SOURCE *src, unsigned char *buf, size_t n) {
+    if (nullptr==src->map)
+        return fread (buf, 1, n, src->in);
+    if (n > src->size - src->pos)
+        n = src->size - src->pos;
+    memcpy (buf, src->map + src->pos, n);
+    src->pos += n;
+    return n;
+}
+
+/* Unsigned little-endian integer of n bytes */
+static uint64_t get_uint (const unsigned char *p, int n) {
+    uint64_t v = 0;
+    while (n-- > 0)
+        v = (v << 8) | p[n];
+    return v;
+}
+
+
+/* Transform a columnar container, a row group at a time, and in each  */
+/* one a column at a time: no more than BINARY_BLOCK rows at once      */
+static int columnar_stream (PJ *P, TABLE_IO *io, COLUMNAR_SOURCE *src, const char *filename) {
+    unsigned char head[COLUMNAR_HEADER];
+    std::vector<unsigned char> raw, group_buf;
+    std::vector<std::string> names;
+    size_t ncols, group, i, k;
+    uint64_t nrows, done;
+    int index[4], j;
+
+    if (columnar_read (src, head, sizeof head) != sizeof head || 0 != memcmp (head, COLUMNAR_MAGIC, 8)) {
+        print (PJ_LOG_ERROR, "%s: '%s' is not a columnar file\n", io->progname, filename);
+        return 1;
+    }
+    ncols = (size_t) get_uint (head + 8, 4);
+    group = (size_t) get_uint (head + 12, 4);
+    nrows = get_uint (head + 16, 8);
+    if (0==ncols || ncols > 65536 || 0==group) {
+        print (PJ_LOG_ERROR, "%s: Bad columnar header in '%s'\n", io->progname, filename);
+        return 1;
+    }
+    if (group > nrows)
+        group = (size_t) nrows;
+
+    raw.resize (ncols * COLUMNAR_NAME);
+    if (columnar_read (src, raw.data(), raw.size()) != raw.size()) {
+        print (PJ_LOG_ERROR, "%s: '%s' is truncated\n", io->progname, filename);
+        return 1;
+    }
+    for (i = 0;  i < ncols;  i++) {
+        const char *name = reinterpret_cast<const char *>(&raw[i * COLUMNAR_NAME]);
+        names.push_back (std::string (name, strnlen (name, COLUMNAR_NAME)));
+    }
+    if (!table_columns (io, names, filename, index))
+        return 1;
+
+    if (group > (size_t) -1 / 8 / ncols) {
+        print (PJ_LOG_ERROR, "%s: Out of memory\n", io->progname);
+        return 1;
+    }
+    try {
+        group_buf.resize (group * ncols * 8);
+    } catch (const std::bad_alloc &) {
+        print (PJ_LOG_ERROR, "%s: Out of memory\n", io->progname);
+        return 1;
+    }
+
+    if (fwrite (head, 1, sizeof head, fout) != sizeof head ||
+        fwrite (raw.data(), 1, raw.size(), fout) != raw.size()) {
+        print (PJ_LOG_ERROR, "%s: I/O error\n", io->progname);
+        return 1;
+    }
+
+    for (done = 0;  done < nrows;  done += group) {
+        size_t m = nrows - done < group? (size_t) (nrows - done): group;
+        size_t bytes = m * ncols * 8;
+        if (columnar_read (src, group_buf.data(), bytes) != bytes) {
+            print (PJ_LOG_ERROR, "%s: '%s' is truncated\n", io->progname, filename);
+            return 1;
+        }
+
+        for (k = 0;  k < m;  k += BINARY_BLOCK) {
+            size_t n = m - k < BINARY_BLOCK? m - k: BINARY_BLOCK;
+            for (j = 0;  j < 4;  j++) {
+                if (index[j] < 0 || (2==j && HUGE_VAL != io->fixed_z) || (3==j && HUGE_VAL != io->fixed_time)) {
+                    double d = absent_coordinate (io, j);
+                    for (i = 0;  i < n;  i++)
+                        io->coord[i].v[j] = d;
+                }
+                else {
+                    const unsigned char *col = group_buf.data() + (index[j] * m + k) * 8;
+                    for (i = 0;  i < n;  i++)
+                        io->coord[i].v[j] = get_double (col + 8 * i);
+                }
+            }
+
+            io->failures += transform_block (P, io->coord, n);
+
+            for (j = 0;  j < 4;  j++) {
+                unsigned char *col;
+                if (index[j] < 0)
+                    continue;
+                col = group_buf.data() + (index[j] * m + k) * 8;
+                for (i = 0;  i < n;  i++)
+                    put_double (col + 8 * i, io->coord[i].v[j]);
+            }
+        }
+
+        if (fwrite (group_buf.data(), 1, bytes, fout) != bytes) {
+            print (PJ_LOG_ERROR, "%s: I/O error\n", io->progname);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+/* Columnar mode: a single input file, or stdin, to fout */
+static int process_columnar (PJ *P, OPTARGS *o, TABLE_IO *io) {
+    COLUMNAR_SOURCE src = {stdin, nullptr, 0, 0};
+    const char *filename = "stdin";
+    int ret;
+
+    if (o->fargc > 1) {
+        print (PJ_LOG_ERROR, "%s: --columnar takes a single input file\n", o->progname);
+        return 1;
+    }
+
+    io->coord = static_cast<PJ_COORD *>(malloc (BINARY_BLOCK * sizeof (PJ_COORD)));
+    if (nullptr==io->coord) {
+        print (PJ_LOG_ERROR, "%s: Out of memory\n", o->progname);
+        return 1;
+    }
+
+#if defined(_WIN32)
+    _setmode (_fileno (stdin), _O_BINARY);
+    if (stdout==fout)
+        _setmode (_fileno (stdout), _O_BINARY);
+#endif
+
+    if (1==o->fargc) {
+        filename = o->fargv[0];
+#ifdef CCT_MMAP
+        if (opt_given (o, "mmap"))
+            src.map = map_file (filename, &src.size);
+#endif
+        src.in = src.map? nullptr: fopen (filename, "rb");
+        if (nullptr==src.map && nullptr==src.in) {
+            print (PJ_LOG_ERROR, "%s: Cannot open '%s'\n", o->progname, filename);
+            free (io->coord);
+            return 1;
+        }
+    }
+
+    ret = columnar_stream (P, io, &src, filename);
+
+#ifdef CCT_MMAP
+    if (src.map)
+        munmap (const_cast<unsigned char *>(src.map), src.size);
+#endif
+    if (src.in && stdin != src.in)
+        fclose (src.in);
+    free (io->coord);
+    return ret;
+}
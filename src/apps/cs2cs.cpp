@@ -37,6 +37,7 @@
 
 #include <cassert>
 #include <string>
+#include <vector>
 
 #include <proj/internal/internal.hpp>
 
@@ -45,12 +46,19 @@
 #include "proj.h"
 #include "proj_internal.h"
 #include "emess.h"
+#include "ordered_pipeline.h"
 // clang-format on
 
 #define MAX_LINE 1000
 
+/* Lines handed to a thread at a time with -j */
+#define CHUNK_LINES 4096
+
 static PJ *transformation = nullptr;
 
+/* With -j: one transformation per thread, the first one being transformation */
+static std::vector<PJ *> transformations;
+
 static bool srcIsGeog = false;
 static double srcToRadians = 0.0;
 
@@ -68,141 +76,231 @@ static const char *oform =
 static char oform_buffer[16]; /* buffer for oform when using -d */
 static const char *oterr = "*\t*"; /* output line for unprojectable input */
 static const char *usage =
-    "%s\nusage: %s [ -dDeEfIlrstvwW [args] ] [ +opts[=arg] ]\n"
+    "%s\nusage: %s [ -dDeEfIjlrstvwW [args] ] [ +opts[=arg] ]\n"
     "                   [+to [+opts[=arg] [ files ]\n";
 
-static double (*informat)(const char *,
+static double (*informat)(projCtx_t *, const char *,
                           char **); /* input data deformatter function */
 
 /************************************************************************/
-/*                              process()                               */
+/*                           append_double()                            */
 /*                                                                      */
-/*      File processing function.                                       */
+/*      Append x formatted with format, the plain fixed point formats   */
+/*      without the C library.                                          */
 /************************************************************************/
-static void process(FILE *fid)
+static void append_double(std::string &out, const char *format, double x)
 
 {
-    char line[MAX_LINE + 3], *s, pline[40];
-    PJ_UV data;
+    char buf[64];
+    int n = pj_format_double(buf, sizeof buf, format, x);
+    if (n < static_cast<int>(sizeof buf))
+        out.append(buf, n);
+    else
+        appendf(out, format, x);
+}
 
-    for (;;) {
-        double z;
+/************************************************************************/
+/*                             strtod_ctx()                             */
+/*                                                                      */
+/*      pj_strtod with the signature of dmstor_ctx.                     */
+/************************************************************************/
+static double strtod_ctx(projCtx_t *, const char *s, char **rs)
 
-        ++emess_dat.File_line;
-        if (!(s = fgets(line, MAX_LINE, fid)))
-            break;
-        if (!strchr(s, '\n')) { /* overlong line */
-            int c;
-            (void)strcat(s, "\n");
-            /* gobble up to newline */
-            while ((c = fgetc(fid)) != EOF && c != '\n')
-                ;
-        }
-        if (*s == tag) {
-            fputs(line, stdout);
-            continue;
-        }
+{
+    return pj_strtod(s, rs);
+}
 
-        if (reversein) {
-            data.v = (*informat)(s, &s);
-            data.u = (*informat)(s, &s);
-        } else {
-            data.u = (*informat)(s, &s);
-            data.v = (*informat)(s, &s);
-        }
+/************************************************************************/
+/*                           transform_line()                           */
+/*                                                                      */
+/*      Transform one line of input, appending the result to out.       */
+/************************************************************************/
+static void transform_line(PJ *P, char *line, std::string &out)
 
-        z = strtod(s, &s);
+{
+    char *s = line, pline[40];
+    PJ_UV data;
+    double z;
 
-        if (data.v == HUGE_VAL)
-            data.u = HUGE_VAL;
+    if (*s == tag) {
+        out += line;
+        return;
+    }
 
-        if (!*s && (s > line))
-            --s; /* assumed we gobbled \n */
+    if (reversein) {
+        data.v = (*informat)(P->ctx, s, &s);
+        data.u = (*informat)(P->ctx, s, &s);
+    } else {
+        data.u = (*informat)(P->ctx, s, &s);
+        data.v = (*informat)(P->ctx, s, &s);
+    }
 
-        if (echoin) {
-            char t;
-            t = *s;
-            *s = '\0';
-            (void)fputs(line, stdout);
-            *s = t;
-            putchar('\t');
-        }
+    z = pj_strtod(s, &s);
 
-        if (data.u != HUGE_VAL) {
+    if (data.v == HUGE_VAL)
+        data.u = HUGE_VAL;
 
-            if (srcIsGeog) {
-                /* dmstor gives values to radians. Convert now to the SRS unit
-                 */
-                data.u /= srcToRadians;
-                data.v /= srcToRadians;
-            }
+    if (!*s && (s > line))
+        --s; /* assumed we gobbled \n */
+
+    if (echoin) {
+        char t;
+        t = *s;
+        *s = '\0';
+        out += line;
+        *s = t;
+        out += '\t';
+    }
+
+    if (data.u != HUGE_VAL) {
 
-            PJ_COORD coord;
-            coord.xyzt.x = data.u;
-            coord.xyzt.y = data.v;
-            coord.xyzt.z = z;
-            coord.xyzt.t = HUGE_VAL;
-            coord = proj_trans(transformation, PJ_FWD, coord);
-            data.u = coord.xyz.x;
-            data.v = coord.xyz.y;
-            z = coord.xyz.z;
+        if (srcIsGeog) {
+            /* dmstor gives values to radians. Convert now to the SRS unit
+             */
+            data.u /= srcToRadians;
+            data.v /= srcToRadians;
         }
 
-        if (data.u == HUGE_VAL) /* error output */
-            fputs(oterr, stdout);
+        PJ_COORD coord;
+        coord.xyzt.x = data.u;
+        coord.xyzt.y = data.v;
+        coord.xyzt.z = z;
+        coord.xyzt.t = HUGE_VAL;
+        coord = proj_trans(P, PJ_FWD, coord);
+        data.u = coord.xyz.x;
+        data.v = coord.xyz.y;
+        z = coord.xyz.z;
+    }
 
-        else if (destIsGeog && !oform) { /*ascii DMS output */
+    if (data.u == HUGE_VAL) /* error output */
+        out += oterr;
 
-            // rtodms() expect radians: convert from the output SRS unit
-            data.u *= destToRadians;
-            data.v *= destToRadians;
+    else if (destIsGeog && !oform) { /*ascii DMS output */
 
-            if (destIsLatLong) {
-                if (reverseout) {
-                    fputs(rtodms(pline, data.v, 'E', 'W'), stdout);
-                    putchar('\t');
-                    fputs(rtodms(pline, data.u, 'N', 'S'), stdout);
-                } else {
-                    fputs(rtodms(pline, data.u, 'N', 'S'), stdout);
-                    putchar('\t');
-                    fputs(rtodms(pline, data.v, 'E', 'W'), stdout);
-                }
-            } else if (reverseout) {
-                fputs(rtodms(pline, data.v, 'N', 'S'), stdout);
-                putchar('\t');
-                fputs(rtodms(pline, data.u, 'E', 'W'), stdout);
-            } else {
-                fputs(rtodms(pline, data.u, 'E', 'W'), stdout);
-                putchar('\t');
-                fputs(rtodms(pline, data.v, 'N', 'S'), stdout);
-            }
+        // rtodms() expect radians: convert from the output SRS unit
+        data.u *= destToRadians;
+        data.v *= destToRadians;
 
-        } else { /* x-y or decimal degree ascii output */
-            if (destIsGeog) {
-                data.v *= destToRadians * RAD_TO_DEG;
-                data.u *= destToRadians * RAD_TO_DEG;
-            }
+        if (destIsLatLong) {
             if (reverseout) {
-                printf(oform, data.v);
-                putchar('\t');
-                printf(oform, data.u);
+                out += rtodms(pline, data.v, 'E', 'W');
+                out += '\t';
+                out += rtodms(pline, data.u, 'N', 'S');
             } else {
-                printf(oform, data.u);
-                putchar('\t');
-                printf(oform, data.v);
+                out += rtodms(pline, data.u, 'N', 'S');
+                out += '\t';
+                out += rtodms(pline, data.v, 'E', 'W');
             }
+        } else if (reverseout) {
+            out += rtodms(pline, data.v, 'N', 'S');
+            out += '\t';
+            out += rtodms(pline, data.u, 'E', 'W');
+        } else {
+            out += rtodms(pline, data.u, 'E', 'W');
+            out += '\t';
+            out += rtodms(pline, data.v, 'N', 'S');
+        }
+
+    } else { /* x-y or decimal degree ascii output */
+        if (destIsGeog) {
+            data.v *= destToRadians * RAD_TO_DEG;
+            data.u *= destToRadians * RAD_TO_DEG;
+        }
+        if (reverseout) {
+            append_double(out, oform, data.v);
+            out += '\t';
+            append_double(out, oform, data.u);
+        } else {
+            append_double(out, oform, data.u);
+            out += '\t';
+            append_double(out, oform, data.v);
         }
+    }
+
+    out += ' ';
+    if (oform != nullptr)
+        append_double(out, oform, z);
+    else
+        append_double(out, "%.3f", z);
+    if (s)
+        out += s;
+    else
+        out += '\n';
+}
 
-        putchar(' ');
-        if (oform != nullptr)
-            printf(oform, z);
-        else
-            printf("%.3f", z);
-        if (s)
-            printf("%s", s);
-        else
-            printf("\n");
+/************************************************************************/
+/*                             read_line()                              */
+/*                                                                      */
+/*      Read a line of input, overlong ones cut short. Returns false    */
+/*      at the end of the file.                                         */
+/************************************************************************/
+static bool read_line(FILE *fid, char *line)
+
+{
+    ++emess_dat.File_line;
+    if (!fgets(line, MAX_LINE, fid))
+        return false;
+    if (!strchr(line, '\n')) { /* overlong line */
+        int c;
+        (void)strcat(line, "\n");
+        /* gobble up to newline */
+        while ((c = fgetc(fid)) != EOF && c != '\n')
+            ;
     }
+    return true;
+}
+
+/* A run of input lines, and what they become */
+struct Chunk {
+    std::string lines; /* each one terminated by a '\0' */
+    std::vector<size_t> start;
+    std::string out;
+};
+
+/************************************************************************/
+/*                              process()                               */
+/*                                                                      */
+/*      File processing function.                                       */
+/************************************************************************/
+static void process(FILE *fid)
+
+{
+    char line[MAX_LINE + 3];
+
+    if (transformations.size() <= 1) {
+        std::string out;
+        while (read_line(fid, line)) {
+            transform_line(transformation, line, out);
+            fputs(out.c_str(), stdout);
+            out.clear();
+        }
+        return;
+    }
+
+    /* Chunks of lines are transformed on as many threads as there are */
+    /* transformations, and written in the order they were read.       */
+    bool more = true;
+    ordered_pipeline<Chunk>(
+        static_cast<int>(transformations.size()),
+        [&](Chunk &chunk) {
+            chunk.lines.clear();
+            chunk.start.clear();
+            chunk.out.clear();
+            while (more && chunk.start.size() < CHUNK_LINES &&
+                   (more = read_line(fid, line))) {
+                chunk.start.push_back(chunk.lines.size());
+                chunk.lines.append(line, strlen(line) + 1);
+            }
+            return !chunk.start.empty();
+        },
+        [&](Chunk &chunk, int worker) {
+            for (size_t i = 0; i < chunk.start.size(); i++)
+                transform_line(transformations[worker],
+                               &chunk.lines[chunk.start[i]], chunk.out);
+        },
+        [&](Chunk &chunk) {
+            fwrite(chunk.out.data(), 1, chunk.out.size(), stdout);
+        });
 }
 
 /************************************************************************/
@@ -320,6 +418,7 @@ int main(int argc, char **argv) {
     int eargc = 0, mon = 0;
     int have_to_flag = 0, inverse = 0;
     int use_env_locale = 0;
+    int nthreads = 1;
 
     /* This is just to check that pj_init() is locale-safe */
     /* Used by nad/testvarious */
@@ -346,7 +445,7 @@ int main(int argc, char **argv) {
     for (int i = 1; i < argc; i++) {
         if (argv[i][0] == '-') {
             if (argv[i][1] == 'f' || argv[i][1] == 'e' || argv[i][1] == 'd' ||
-                argv[i][1] == 'D' ) {
+                argv[i][1] == 'D' || argv[i][1] == 'j' ) {
                 i++;
             }
         } else {
@@ -484,6 +583,11 @@ int main(int argc, char **argv) {
                     sprintf(oform_buffer, "%%.%df", atoi(*++argv));
                     oform = oform_buffer;
                     break;
+                case 'j': /* number of threads */
+                    if (--argc <= 0)
+                        goto noargument;
+                    nthreads = atoi(*++argv);
+                    break;
                 default:
                     emess(1, "invalid option: -%c", *arg);
                     break;
@@ -602,14 +706,34 @@ int main(int argc, char **argv) {
 
     /* set input formatting control */
     if (!srcIsGeog)
-        informat = strtod;
+        informat = strtod_ctx;
     else {
-        informat = dmstor;
+        informat = dmstor_ctx;
     }
 
     if (!destIsGeog && !oform)
         oform = "%.2f";
 
+    /* Each thread transforms and parses its input with its own copy, */
+    /* in its own context, logging like the main one                   */
+    transformations.push_back(transformation);
+    for (int i = 1; i < nthreads; i++) {
+        PJ_CONTEXT *ctx = proj_context_create();
+        if (ctx) {
+            ctx->logger = transformation->ctx->logger;
+            ctx->logger_app_data = transformation->ctx->logger_app_data;
+            ctx->debug_level = transformation->ctx->debug_level;
+        }
+        PJ *P = ctx ? proj_create_crs_to_crs(ctx, fromStr.c_str(),
+                                             toStr.c_str(), nullptr)
+                    : nullptr;
+        if (!P) {
+            proj_context_destroy(ctx);
+            break;
+        }
+        transformations.push_back(P);
+    }
+
     /* process input file list */
     for (; eargc--; ++eargv) {
         if (**eargv == '-') {
@@ -629,6 +753,11 @@ int main(int argc, char **argv) {
         emess_dat.File_name = nullptr;
     }
 
+    for (size_t i = 1; i < transformations.size(); i++) {
+        PJ_CONTEXT *ctx = transformations[i]->ctx;
+        proj_destroy(transformations[i]);
+        proj_context_destroy(ctx);
+    }
     proj_destroy(transformation);
 
     pj_deallocate_grids();
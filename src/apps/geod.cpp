@@ -8,6 +8,8 @@
 # include <stdio.h>
 # include <string.h>
 
+# include <vector>
+
 # define MAXLINE 200
 # define MAX_PARGS 50
 # define TAB putchar('\t')
@@ -15,20 +17,32 @@
 fullout = 0,	/* output full set of geodesic values */
 tag = '#',	/* beginning of line tag character */
 pos_azi = 0,	/* output azimuths as positive values */
-inverse = 0;	/* != 0 then inverse geodesic */
+inverse = 0,	/* != 0 then inverse geodesic */
+matrix = 0,	/* distance matrix of two point files */
+knn = 0;	/* != 0 then this many nearest neighbours */
 
 static const char *oform = nullptr; /* output format for decimal degrees */
 static const char *osform = "%.3f"; /* output format for S */
 
 static char pline[50];              /* work string */
 static const char *usage =
-"%s\nusage: %s [ -afFIlptwW [args] ] [ +opts[=arg] ] [ files ]\n";
+"%s\nusage: %s [ -afFIlptwW [args] ] [ +opts[=arg] ] [ files ]\n"
+"       %s -M | -K k [ -F fmt ] [ -t tag ] [ +opts[=arg] ] file1 file2\n";
 
+/* printf(format, x), the plain fixed point formats without the C library */
+	static void
+print_double(const char *format, double x) {
+	char buf[64];
+	if (pj_format_double(buf, sizeof buf, format, x) < (int)sizeof buf)
+		(void)fputs(buf, stdout);
+	else
+		(void)printf(format, x);
+}
 	static void
 printLL(double p, double l) {
 	if (oform) {
-		(void)printf(oform, p * RAD_TO_DEG); TAB;
-		(void)printf(oform, l * RAD_TO_DEG);
+		print_double(oform, p * RAD_TO_DEG); TAB;
+		print_double(oform, l * RAD_TO_DEG);
 	} else {
 		(void)fputs(rtodms(pline, p, 'N', 'S'),stdout); TAB;
 		(void)fputs(rtodms(pline, l, 'E', 'W'),stdout);
@@ -85,7 +99,7 @@ process(FILE *fid) {
 			geod_inv();
 		} else {
 			al12 = dmstor(s, &s);
-			geod_S = strtod(s, &s) * to_meter;
+			geod_S = pj_strtod(s, &s) * to_meter;
 			geod_pre();
 			geod_for();
 		}
@@ -98,28 +112,28 @@ process(FILE *fid) {
 			printLL(phi1, lam1); TAB;
 			printLL(phi2, lam2); TAB;
 			if (oform) {
-				(void)printf(oform, al12 * RAD_TO_DEG); TAB;
-				(void)printf(oform, al21 * RAD_TO_DEG); TAB;
-				(void)printf(osform, geod_S * fr_meter);
+				print_double(oform, al12 * RAD_TO_DEG); TAB;
+				print_double(oform, al21 * RAD_TO_DEG); TAB;
+				print_double(osform, geod_S * fr_meter);
 			}  else {
 				(void)fputs(rtodms(pline, al12, 0, 0), stdout); TAB;
 				(void)fputs(rtodms(pline, al21, 0, 0), stdout); TAB;
-				(void)printf(osform, geod_S * fr_meter);
+				print_double(osform, geod_S * fr_meter);
 			}
 		} else if (inverse)
 			if (oform) {
-				(void)printf(oform, al12 * RAD_TO_DEG); TAB;
-				(void)printf(oform, al21 * RAD_TO_DEG); TAB;
-				(void)printf(osform, geod_S * fr_meter);
+				print_double(oform, al12 * RAD_TO_DEG); TAB;
+				print_double(oform, al21 * RAD_TO_DEG); TAB;
+				print_double(osform, geod_S * fr_meter);
 			} else {
 				(void)fputs(rtodms(pline, al12, 0, 0), stdout); TAB;
 				(void)fputs(rtodms(pline, al21, 0, 0), stdout); TAB;
-				(void)printf(osform, geod_S * fr_meter);
+				print_double(osform, geod_S * fr_meter);
 			}
 		else {
 			printLL(phi2, lam2); TAB;
 			if (oform)
-				(void)printf(oform, al21 * RAD_TO_DEG);
+				print_double(oform, al21 * RAD_TO_DEG);
 			else
 				(void)fputs(rtodms(pline, al21, 0, 0), stdout);
 		}
@@ -127,6 +141,89 @@ process(FILE *fid) {
 	}
 }
 
+	static void	/* read the lat/long pairs of a point file, in degrees */
+read_points(FILE *fid, std::vector<double> &lat, std::vector<double> &lon) {
+	char line[MAXLINE+3], *s;
+
+	while ((s = fgets(line, MAXLINE, fid)) != nullptr) {
+		++emess_dat.File_line;
+		if (!strchr(s, '\n')) { /* overlong line */
+			int c;
+			while ((c = fgetc(fid)) != EOF && c != '\n') ;
+		}
+		if (*s == tag)
+			continue;
+		while (isspace(*s)) ++s;
+		if (!*s)
+			continue;
+		lat.push_back(dmstor(s, &s) * RAD_TO_DEG);
+		lon.push_back(dmstor(s, &s) * RAD_TO_DEG);
+	}
+}
+	static void	/* read the two point files of the matrix and k-NN modes */
+read_point_file(const char *name, std::vector<double> &lat, std::vector<double> &lon) {
+	FILE *fid;
+
+	if (!strcmp(name, "-")) {
+		fid = stdin;
+		emess_dat.File_name = const_cast<char*>("<stdin>");
+	} else {
+		if ((fid = fopen(name, "r")) == nullptr)
+			emess(1, "cannot open input file %s", name);
+		emess_dat.File_name = const_cast<char*>(name);
+	}
+	emess_dat.File_line = 0;
+	read_points(fid, lat, lon);
+	if (fid != stdin)
+		(void)fclose(fid);
+	emess_dat.File_name = (char *)nullptr;
+}
+	static void	/* distances from each point of file1 to each of file2 */
+do_matrix(const char *file1, const char *file2) {
+	std::vector<double> lat1, lon1, lat2, lon2;
+	size_t i, j, n1, n2;
+
+	read_point_file(file1, lat1, lon1);
+	read_point_file(file2, lat2, lon2);
+	n1 = lat1.size();
+	n2 = lat2.size();
+	std::vector<double> s12(n1 * n2);
+	geod_distance_matrix(&GlobalGeodesic, lat1.data(), lon1.data(), (int)n1,
+		lat2.data(), lon2.data(), (int)n2, s12.data(), 0);
+	for (i = 0; i < n1; ++i) {
+		for (j = 0; j < n2; ++j) {
+			if (j) TAB;
+			print_double(osform, s12[i * n2 + j] * fr_meter);
+		}
+		putchar('\n');
+	}
+}
+	static void	/* the knn nearest points of file2 to each point of file1 */
+do_knn(const char *file1, const char *file2) {
+	std::vector<double> qlat, qlon, lat, lon;
+	size_t i, n, nq;
+	int j;
+
+	read_point_file(file1, qlat, qlon);
+	read_point_file(file2, lat, lon);
+	n = lat.size();
+	nq = qlat.size();
+	std::vector<int> idx(nq * knn);
+	std::vector<double> s12(nq * knn);
+	if (geod_knn(&GlobalGeodesic, lat.data(), lon.data(), (int)n,
+			qlat.data(), qlon.data(), (int)nq, knn, idx.data(), s12.data(), 0))
+		emess(1, "out of memory");
+	/* points of file2 are numbered from 1, in their order in the file */
+	for (i = 0; i < nq; ++i) {
+		for (j = 0; j < knn && idx[i * knn + j] >= 0; ++j) {
+			if (j) TAB;
+			(void)printf("%d", idx[i * knn + j] + 1); TAB;
+			print_double(osform, s12[i * knn + j] * fr_meter);
+		}
+		putchar('\n');
+	}
+}
+
 static char *pargv[MAX_PARGS];
 static int   pargc = 0;
 
@@ -140,7 +237,7 @@ int main(int argc, char **argv) {
 	inverse = ! strncmp(emess_dat.Prog_name, "inv", 3);
 	if (argc <= 1 ) {
 		(void)fprintf(stderr, usage, pj_get_release(),
-                              emess_dat.Prog_name);
+                              emess_dat.Prog_name, emess_dat.Prog_name);
 		exit (0);
 	}
 		/* process run line arguments */
@@ -156,6 +253,14 @@ int main(int argc, char **argv) {
 			case 'I': /* alt. inverse spec. */
 				inverse = 1;
 				continue;
+			case 'M': /* distance matrix of two point files */
+				matrix = 1;
+				continue;
+			case 'K': /* nearest neighbours in the second point file */
+				if (--argc <= 0) goto noargument;
+				if ((knn = atoi(*++argv)) <= 0)
+					emess(1, "-K argument must be a positive integer");
+				continue;
 			case 't': /* set col. one char */
 				if (arg[1]) tag = *++arg;
 				else emess(1,"missing -t col. 1 tag");
@@ -213,7 +318,13 @@ noargument:		   emess(1,"missing argument for -%c",*arg);
 	geod_set(pargc, pargv); /* setup projection */
 	if ((n_alpha || n_S) && eargc)
 		emess(1,"files specified for arc/geodesic mode");
-	if (n_alpha)
+	if ((matrix || knn) && eargc != 2)
+		emess(1,"-M and -K need two point files");
+	if (matrix)
+		do_matrix(eargv[0], eargv[1]);
+	else if (knn)
+		do_knn(eargv[0], eargv[1]);
+	else if (n_alpha)
 		do_arc();
 	else if (n_S)
 		do_geod();
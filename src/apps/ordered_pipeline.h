@@ -0,0 +1,183 @@
+/******************************************************************************
+ * Project:  PROJ
+ * Purpose:  Order preserving, multithreaded processing of chunks of input,
+ *           for the command line applications.
+ *
+ ******************************************************************************
+ * Copyright (c) 2018, PROJ contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *****************************************************************************/
+
+/*****************************************************************************
+
+    ordered_pipeline (nthreads, read, work, write)
+
+    The calling thread reads the input a chunk at a time with read(chunk),
+    until it returns false. Each chunk is then handed to work(chunk, worker)
+    on one of nthreads threads, the calling one included, and finally to
+    write(chunk) on the calling thread, in the order the chunks were read.
+
+    worker is the number, from 0 to nthreads-1, of the thread doing the work,
+    so it can be used to pick per thread state, such as a PJ object and its
+    context. The calling thread is always worker 0.
+
+    At most 2*nthreads chunks are in flight at a time, and chunk objects are
+    reused, so read() must reset whatever it does not overwrite.
+
+    Without thread support, or when no thread can be started, all of the work
+    is done by the calling thread.
+
+*****************************************************************************/
+
+#ifndef ORDERED_PIPELINE_H
+#define ORDERED_PIPELINE_H
+
+#include <stdarg.h>
+#include <stdio.h>
+
+#include <string>
+#include <vector>
+
+#if defined(MUTEX_pthread) || (defined(_WIN32) && !defined(MUTEX_stub))
+#define ORDERED_PIPELINE_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <system_error>
+#include <thread>
+#endif
+
+/* Append printf style formatted text to a string */
+static inline void appendf (std::string &s, const char *fmt, ...) {
+    char buf[256];
+    va_list args;
+    int n;
+
+    va_start (args, fmt);
+    n = vsnprintf (buf, sizeof buf, fmt, args);
+    va_end (args);
+    if (n < 0)
+        return;
+    if (n < (int) sizeof buf) {
+        s.append (buf, n);
+        return;
+    }
+
+    std::vector<char> big (n + 1);
+    va_start (args, fmt);
+    vsnprintf (big.data(), big.size(), fmt, args);
+    va_end (args);
+    s.append (big.data(), n);
+}
+
+
+template <class Chunk, class Read, class Work, class Write>
+static void ordered_pipeline (int nthreads, Read read, Work work, Write write) {
+#ifndef ORDERED_PIPELINE_THREADS
+    Chunk chunk;
+    (void) nthreads;
+    while (read (chunk)) {
+        work (chunk, 0);
+        write (chunk);
+    }
+#else
+    if (nthreads < 1)
+        nthreads = 1;
+    const size_t nslots = 2 * static_cast<size_t>(nthreads);
+    std::vector<Chunk> chunks (nslots);
+    std::vector<char> done (nslots);
+
+    /* Chunks head up to tail are in flight, and those from next on wait */
+    /* for a worker. Slot i % nslots holds chunk i.                      */
+    size_t head = 0, next = 0, tail = 0;
+    bool quit = false;
+    std::mutex mutex;
+    std::condition_variable work_ready, work_done;
+
+    /* Do the next waiting chunk; lock is held on entry and on return */
+    auto do_next = [&](std::unique_lock<std::mutex> &lock, int worker) {
+        size_t i = next++;
+        lock.unlock ();
+        work (chunks[i % nslots], worker);
+        lock.lock ();
+        done[i % nslots] = 1;
+        work_done.notify_one ();
+    };
+
+    std::vector<std::thread> threads;
+    for (int worker = 1;  worker < nthreads;  worker++) {
+        /* Whatever threads could not be started, the others make up for */
+        try {
+            threads.emplace_back ([&, worker]() {
+                std::unique_lock<std::mutex> lock (mutex);
+                for (;;) {
+                    work_ready.wait (lock, [&]() { return quit || next < tail; });
+                    if (next == tail)
+                        return;
+                    do_next (lock, worker);
+                }
+            });
+        } catch (const std::system_error &) {
+            break;
+        } catch (const std::bad_alloc &) {
+            break;
+        }
+    }
+
+    bool more = true;
+    for (;;) {
+        /* Fill the free slots. Chunk tail is not seen by the workers yet */
+        while (more && tail - head < nslots) {
+            more = read (chunks[tail % nslots]);
+            if (!more)
+                break;
+            std::lock_guard<std::mutex> lock (mutex);
+            done[tail % nslots] = 0;
+            tail++;
+            work_ready.notify_one ();
+        }
+        if (head == tail)
+            break;
+
+        /* Wait for the oldest chunk, lending a hand meanwhile */
+        {
+            std::unique_lock<std::mutex> lock (mutex);
+            while (!done[head % nslots]) {
+                if (next < tail)
+                    do_next (lock, 0);
+                else
+                    work_done.wait (lock);
+            }
+        }
+        write (chunks[head % nslots]);
+        head++;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock (mutex);
+        quit = true;
+    }
+    work_ready.notify_all ();
+    for (auto &thread : threads)
+        thread.join ();
+#endif
+}
+
+#endif /* ORDERED_PIPELINE_H */
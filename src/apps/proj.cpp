@@ -53,6 +53,15 @@ static PJ_FACTORS facs;
 static double (*informat)(const char *, char **), /* input data deformatter function */
               fscale = 0.;                        /* cartesian scale factor */
 
+/* printf(format, x), the plain fixed point formats without the C library */
+static void print_double(const char *format, double x) {
+    char buf[64];
+    if (pj_format_double(buf, sizeof buf, format, x) < (int)sizeof buf)
+        (void)fputs(buf, stdout);
+    else
+        (void)printf(format, x);
+}
+
 /* file processing function */
 static void process(FILE *fid) {
     char line[MAX_LINE+3], *s = nullptr, pline[40];
@@ -153,11 +162,11 @@ static void process(FILE *fid) {
             }
 
             if (reverseout) {
-                (void)printf(oform, data.uv.v); putchar('\t');
-                (void)printf(oform, data.uv.u);
+                print_double(oform, data.uv.v); putchar('\t');
+                print_double(oform, data.uv.u);
             } else {
-                (void)printf(oform, data.uv.u); putchar('\t');
-                (void)printf(oform, data.uv.v);
+                print_double(oform, data.uv.u); putchar('\t');
+                print_double(oform, data.uv.v);
             }
         }
 
@@ -220,8 +229,8 @@ static void vprocess(FILE *fid) {
                 emess(-1,"inverse for this projection not avail.\n");
                 continue;
             }
-            dat_xy.x = strtod(s, &s);
-            dat_xy.y = strtod(s, &s);
+            dat_xy.x = pj_strtod(s, &s);
+            dat_xy.y = pj_strtod(s, &s);
             if (dat_xy.x == HUGE_VAL || dat_xy.y == HUGE_VAL) {
                 emess(-1,"lon-lat input conversion failure\n");
                 continue;
@@ -274,9 +283,9 @@ static void vprocess(FILE *fid) {
         (void)fputs(proj_rtodms(pline, dat_ll.phi, 'N', 'S'), stdout);
         (void)printf(" [ %.11g ]\n", dat_ll.phi * RAD_TO_DEG);
         (void)fputs("Easting (x):   ", stdout);
-        (void)printf(oform, dat_xy.x); putchar('\n');
+        print_double(oform, dat_xy.x); putchar('\n');
         (void)fputs("Northing (y):  ", stdout);
-        (void)printf(oform, dat_xy.y); putchar('\n');
+        print_double(oform, dat_xy.y); putchar('\n');
         (void)printf("Meridian scale (h) : %.8f  ( %.4g %% error )\n", facs.meridional_scale, (facs.meridional_scale-1.)*100.);
         (void)printf("Parallel scale (k) : %.8f  ( %.4g %% error )\n", facs.parallel_scale, (facs.parallel_scale-1.)*100.);
         (void)printf("Areal scale (s):     %.8f  ( %.4g %% error )\n", facs.areal_scale, (facs.areal_scale-1.)*100.);
@@ -509,7 +518,7 @@ int main(int argc, char **argv) {
     }
 
     if (inverse)
-        informat = strtod;
+        informat = pj_strtod;
     else {
         informat = proj_dmstor;
         if (!oform)
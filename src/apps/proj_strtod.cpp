@@ -93,6 +93,75 @@ Thomas Knudsen, thokn@sdfe.dk, 2017-01-17/2017-09-18
 #include <ctype.h>
 #include <float.h>  /* for HUGE_VAL */
 #include <math.h>   /* for pow() */
+#include <stdint.h>
+
+
+/* Plain numbers, "[+-]ddd.ddd[e[+-]dd]" without underscores, of at most 15
+   significant digits, and a power of ten small enough to be exact, are by far
+   the most common. For those the general code below amounts to one
+   correctly rounded multiplication or division of the digits by the power of
+   ten, which is done here directly. Zeros, and anything else, are left to
+   the general code, so the results are the same either way. */
+static int plain_strtod (const char *str, char **endptr, double *value) {
+    static const double pow10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,
+        1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19};
+    const char *p = str;
+    uint64_t w = 0;
+    int q = 0, ndigits = 0, nsignificant = 0, negative = 0;
+
+    while (isspace (*p))
+        p++;
+    if ('-'==*p || '+'==*p)
+        negative = '-'==*p++;
+
+    for (;  *p >= '0' && *p <= '9';  p++, ndigits++) {
+        if (0==w && '0'==*p)
+            continue;
+        if (++nsignificant > 15)
+            return 0;
+        w = 10 * w + (*p - '0');
+    }
+    if ('.'==*p) {
+        for (p++;  *p >= '0' && *p <= '9';  p++, ndigits++) {
+            q--;
+            if (0==w && '0'==*p)
+                continue;
+            if (++nsignificant > 15)
+                return 0;
+            w = 10 * w + (*p - '0');
+        }
+    }
+    if (0==w || '_'==*p)
+        return 0;
+
+    if ('e'==*p || 'E'==*p) {
+        const char *e = p + 1;
+        int exponent = 0, negative_exponent = 0;
+        if ('-'==*e || '+'==*e)
+            negative_exponent = '-'==*e++;
+        if (*e < '0' || *e > '9')
+            return 0;
+        for (;  *e >= '0' && *e <= '9';  e++) {
+            if (exponent > 100)
+                return 0;
+            exponent = 10 * exponent + (*e - '0');
+        }
+        if ('_'==*e)
+            return 0;
+        q += negative_exponent? -exponent: exponent;
+        p = e;
+    }
+    if (q < -19 || q > 19)
+        return 0;
+
+    *value = q < 0? (double) w / pow10[-q]: (double) w * pow10[q];
+    if (negative)
+        *value = -*value;
+    if (endptr)
+        *endptr = (char *) p;
+    return 1;
+}
 
 
 double proj_strtod(const char *str, char **endptr) {
@@ -106,6 +175,9 @@ double proj_strtod(const char *str, char **endptr) {
     int num_digits_after_comma  = 0;
     int num_prefixed_zeros      = 0;
 
+    if (nullptr!=str && plain_strtod (str, endptr, &number))
+        return number;
+
     if (nullptr==str) {
         errno = EFAULT;
         if (endptr)
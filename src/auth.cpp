@@ -35,3 +35,13 @@ pj_authlat(double beta, double *APA) {
 	double t = beta+beta;
 	return(beta + APA[0] * sin(t) + APA[1] * sin(t+t) + APA[2] * sin(t+t+t));
 }
+
+	void
+pj_authlat_array(size_t n, const double *beta, double *APA, double *phi) {
+	const double a0 = APA[0], a1 = APA[1], a2 = APA[2];
+
+	for (size_t i = 0; i < n; i++) {
+		const double t = beta[i]+beta[i];
+		phi[i] = beta[i] + a0 * sin(t) + a1 * sin(t+t) + a2 * sin(t+t+t);
+	}
+}
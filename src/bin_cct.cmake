@@ -1,10 +1,10 @@
 set(CCT_SRC apps/cct.cpp apps/proj_strtod.cpp apps/proj_strtod.h)
-set(CCT_INCLUDE apps/optargpm.h)
+set(CCT_INCLUDE apps/optargpm.h apps/ordered_pipeline.h)
 
 source_group("Source Files\\Bin" FILES ${CCT_SRC})
 
 add_executable(cct ${CCT_SRC} ${CCT_INCLUDE})
-target_link_libraries(cct ${PROJ_LIBRARIES})
+target_link_libraries(cct ${PROJ_LIBRARIES} ${CMAKE_THREAD_LIBS_INIT})
 install(TARGETS cct
 	RUNTIME DESTINATION ${BINDIR})
 
@@ -1,11 +1,12 @@
 set(CS2CS_SRC apps/cs2cs.cpp
               apps/emess.cpp
 )
+set(CS2CS_INCLUDE apps/ordered_pipeline.h)
 
 source_group("Source Files\\Bin" FILES ${CS2CS_SRC})
 
 add_executable(cs2cs ${CS2CS_SRC} ${CS2CS_INCLUDE})
-target_link_libraries(cs2cs ${PROJ_LIBRARIES})
+target_link_libraries(cs2cs ${PROJ_LIBRARIES} ${CMAKE_THREAD_LIBS_INIT})
 install(TARGETS cs2cs 
         RUNTIME DESTINATION ${BINDIR})
 
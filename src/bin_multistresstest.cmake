@@ -0,0 +1,14 @@
+set(MULTISTRESSTEST_SRC tests/multistresstest.cpp )
+set(MULTISTRESSTEST_INCLUDE tests/synthetic_grids.h)
+
+source_group("Source Files\\Bin" FILES ${MULTISTRESSTEST_SRC} ${MULTISTRESSTEST_INCLUDE})
+
+#Executable
+# Only built on request, with "make multistresstest"
+add_executable(multistresstest EXCLUDE_FROM_ALL ${MULTISTRESSTEST_SRC} ${MULTISTRESSTEST_INCLUDE})
+target_link_libraries(multistresstest ${PROJ_LIBRARIES} ${CMAKE_THREAD_LIBS_INIT})
+# Do not install
+
+if(MSVC AND BUILD_LIBPROJ_SHARED)
+    target_compile_definitions(multistresstest PRIVATE PROJ_MSVC_DLL_IMPORT=1)
+endif()
@@ -0,0 +1,14 @@
+set(PROJ_BENCH_SRC tests/proj_bench.cpp )
+set(PROJ_BENCH_INCLUDE tests/synthetic_grids.h)
+
+source_group("Source Files\\Bin" FILES ${PROJ_BENCH_SRC} ${PROJ_BENCH_INCLUDE})
+
+#Executable
+# Only built on request, with "make proj_bench"
+add_executable(proj_bench EXCLUDE_FROM_ALL ${PROJ_BENCH_SRC} ${PROJ_BENCH_INCLUDE})
+target_link_libraries(proj_bench ${PROJ_LIBRARIES})
+# Do not install
+
+if(MSVC AND BUILD_LIBPROJ_SHARED)
+    target_compile_definitions(proj_bench PRIVATE PROJ_MSVC_DLL_IMPORT=1)
+endif()
@@ -161,6 +161,29 @@ static PJ_COORD reverse_4d(PJ_COORD coo, PJ *P) {
 }
 
 
+static int get_affine_map(PJ *P, PJ_DIRECTION direction, PJ_AFFINE_MAP *A) {
+    struct pj_opaque *Q = (struct pj_opaque *) P->opaque;
+    unsigned int i;
+
+    /* Unused axis slots are left at 4-7, and their coordinates untouched */
+    pj_affine_map_set_identity (A);
+    for (i=0; i<4; i++) {
+        if (Q->axis[i] > 3)
+            continue;
+        A->m[i][i] = 0.0;
+    }
+    for (i=0; i<4; i++) {
+        if (Q->axis[i] > 3)
+            continue;
+        if (direction == PJ_FWD)
+            A->m[i][Q->axis[i]] = Q->sign[i];
+        else
+            A->m[Q->axis[i]][i] = Q->sign[i];
+    }
+    return 1;
+}
+
+
 /***********************************************************************/
 PJ *CONVERSION(axisswap,0) {
 /***********************************************************************/
@@ -280,6 +303,7 @@ PJ *CONVERSION(axisswap,0) {
         proj_log_error(P, "swapaxis: bad axis order");
         return pj_default_destructor(P, PJD_ERR_AXIS);
     }
+    P->get_affine_map = get_affine_map;
 
     if (pj_param(P->ctx, P->params, "tangularunits").i) {
         P->left  = PJ_IO_UNITS_RADIANS;
@@ -68,27 +68,29 @@ PROJ_HEAD(cart,    "Geodetic/cartesian conversions");
 
     (WP, below).
 
-    The cartesian-to-geodetic conversion is based on Bowring's
-    celebrated method:
+    The cartesian-to-geodetic conversion uses the closed form
+    solution of:
 
-    B. R. Bowring:
-    Transformation from spatial to geographical coordinates
-    Survey Review 23(181), pp. 323-327, 1976
+    Hugues Vermeille:
+    Direct transformation from geocentric coordinates to geodetic
+    coordinates
+    Journal of Geodesy 76(8), pp. 451-454, 2002
 
-    (BB, below),
+    (HV, below),
 
-    but could probably use some TLC from a newer and faster
-    algorithm:
+    which is exact, and has no singularity at the poles. It does
+    not apply within the evolute of the ellipsoid, some 40 km from
+    the centre of the Earth, where Bowring's celebrated method is
+    used instead:
 
-    Toshio Fukushima:
-    Transformation from Cartesian to Geodetic Coordinates
-    Accelerated by Halley’s Method
-    Journal of Geodesy, February 2006
+    B. R. Bowring:
+    Transformation from spatial to geographical coordinates
+    Survey Review 23(181), pp. 323-327, 1976
 
-    (TF, below).
+    (BB, below).
 
-    Close to the poles, we avoid singularities by switching to an
-    approximation requiring knowledge of the geocentric radius
+    Close to the poles, BB is kept clear of singularities by switching
+    to an approximation requiring knowledge of the geocentric radius
     at the given latitude. For this, we use an adaptation of the
     formula given in:
 
@@ -108,13 +110,12 @@ PROJ_HEAD(cart,    "Geodetic/cartesian conversions");
 
 
 /*********************************************************************/
-static double normal_radius_of_curvature (double a, double es, double phi) {
+static double normal_radius_of_curvature (double a, double es, double sinphi) {
 /*********************************************************************/
-    double s = sin(phi);
     if (es==0)
         return a;
     /* This is from WP.  HM formula 2-149 gives an a,b version */
-    return a / sqrt (1 - es*s*s);
+    return a / sqrt (1 - es*sinphi*sinphi);
 }
 
 /*********************************************************************/
@@ -131,49 +132,67 @@ static double geocentric_radius (double a, double b, double phi) {
 
 
 /*********************************************************************/
-static PJ_XYZ cartesian (PJ_LPZ geod,  PJ *P) {
-/*********************************************************************/
-    double N, cosphi = cos(geod.phi);
+static inline PJ_XYZ cartesian (PJ_LPZ geod, double a, double es) {
+/*********************************************************************
+    The body of pj_cart_cartesian(), also run by cartesian_batch()
+    with the ellipsoid parameters hoisted out of its loop
+***********************************************************************/
+    double N, cosphi = cos(geod.phi), sinphi = sin(geod.phi);
     PJ_XYZ xyz;
 
-    N   =  normal_radius_of_curvature(P->a, P->es, geod.phi);
+    N   =  normal_radius_of_curvature(a, es, sinphi);
 
     /* HM formula 5-27 (z formula follows WP) */
     xyz.x = (N + geod.z) * cosphi      * cos(geod.lam);
     xyz.y = (N + geod.z) * cosphi      * sin(geod.lam);
-    xyz.z = (N * (1 - P->es) + geod.z) * sin(geod.phi);
+    xyz.z = (N * (1 - es) + geod.z) * sinphi;
 
     return xyz;
 }
 
 
 /*********************************************************************/
-static PJ_LPZ geodetic (PJ_XYZ cart,  PJ *P) {
+PJ_XYZ pj_cart_cartesian (PJ_LPZ geod,  PJ *P) {
 /*********************************************************************/
-    double N, p, theta, c, s;
+    return cartesian (geod, P->a, P->es);
+}
+
+
+/*********************************************************************/
+static PJ_LPZ geodetic_bowring (PJ_XYZ cart,  PJ *P) {
+/*********************************************************************/
+    double N, p, r, y, x, c, s;
     PJ_LPZ lpz;
 
     /* Perpendicular distance from point to Z-axis (HM eq. 5-28) */
     p = hypot (cart.x, cart.y);
 
-    /* HM eq. (5-37) */
-    theta  =  atan2 (cart.z * P->a,  p * P->b);
+    /* HM eq. (5-37): theta = atan2 (z*a, p*b), of which only the */
+    /* sine and cosine are needed                                 */
+    y  =  cart.z * P->a;
+    x  =  p * P->b;
+    r  =  sqrt (x*x + y*y);
+    c  =  r == 0 ? 1 : x / r;
+    s  =  r == 0 ? 0 : y / r;
 
     /* HM eq. (5-36) (from BB, 1976) */
-    c  =  cos(theta);
-    s  =  sin(theta);
-    lpz.phi  =  atan2 (cart.z + P->e2s*P->b*s*s*s,  p - P->es*P->a*c*c*c);
+    y  =  cart.z + P->e2s*P->b*s*s*s;
+    x  =  p - P->es*P->a*c*c*c;
+    lpz.phi  =  atan2 (y, x);
     lpz.lam  =  atan2 (cart.y, cart.x);
-    N        =  normal_radius_of_curvature (P->a, P->es, lpz.phi);
 
+    /* ...and the sine and cosine of phi follow the same way */
+    r  =  sqrt (x*x + y*y);
+    c  =  r == 0 ? 1 : x / r;
+    s  =  r == 0 ? 0 : y / r;
+    N  =  normal_radius_of_curvature (P->a, P->es, s);
 
-    c  =  cos(lpz.phi);
     if (fabs(c) < 1e-6) {
         /* poleward of 89.99994 deg, we avoid division by zero   */
         /* by computing the height as the cartesian z value      */
         /* minus the geocentric radius of the Earth at the given */
         /* latitude                                              */
-        double r = geocentric_radius (P->a, P->b, lpz.phi);
+        r = geocentric_radius (P->a, P->b, lpz.phi);
         lpz.z = fabs (cart.z) - r;
     }
     else
@@ -183,6 +202,89 @@ static PJ_LPZ geodetic (PJ_XYZ cart,  PJ *P) {
 }
 
 
+/*********************************************************************/
+static inline PJ_LPZ geodetic (PJ_XYZ cart, double a, double es, PJ *P) {
+/*********************************************************************
+    The body of pj_cart_geodetic(), also run by geodetic_batch()
+    with the ellipsoid parameters hoisted out of its loop. P is only
+    used by the Bowring fallback
+***********************************************************************/
+    double e4 = es * es, p2, p, q, r, s, t, u, v, w, k, D, c, N;
+    PJ_LPZ lpz;
+
+    /* HV, in units of the semimajor axis */
+    p2 = (cart.x*cart.x + cart.y*cart.y) / (a*a);
+    q  = (1 - es) * cart.z*cart.z / (a*a);
+    r  = (p2 + q - e4) / 6;
+    if (!(r > 0))
+        return geodetic_bowring (cart, P);
+
+    s  = e4 * p2 * q / (4 * r*r*r);
+    t  = cbrt (1 + s + sqrt (s * (2 + s)));
+    u  = r * (1 + t + 1 / t);
+    v  = sqrt (u*u + e4 * q);
+    w  = es * (u + v - q) / (2 * v);
+    k  = sqrt (u + v + w*w) - w;
+
+    /* D is the distance from the Z-axis, scaled to the ellipsoid */
+    p  = hypot (cart.x, cart.y);
+    D  = k * p / (k + es);
+    lpz.lam = atan2 (cart.y, cart.x);
+    lpz.phi = atan2 (cart.z, D);
+
+    /* The height along the normal, which HV's own formula gets with */
+    /* less precision: from the distance to the Z-axis, or to the    */
+    /* equator near the poles, so no special case is needed          */
+    r  = hypot (D, cart.z);
+    c  = D / r;
+    s  = cart.z / r;
+    N  = normal_radius_of_curvature (a, es, s);
+    lpz.z = fabs (c) > fabs (s) ? p / c - N : cart.z / s - N * (1 - es);
+    return lpz;
+}
+
+
+/*********************************************************************/
+PJ_LPZ pj_cart_geodetic (PJ_XYZ cart,  PJ *P) {
+/*********************************************************************/
+    return geodetic (cart, P->a, P->es, P);
+}
+
+
+/* fwd3d on n points at once, in place: lam, phi, h in, x, y, z out */
+static void cartesian_batch (PJ *P, size_t n, double *lam, double *phi, double *z) {
+    const double a = P->a, es = P->es;
+    for (size_t i = 0;  i < n;  i++) {
+        PJ_LPZ geod;
+        PJ_XYZ xyz;
+        geod.lam = lam[i];
+        geod.phi = phi[i];
+        geod.z   = z[i];
+        xyz = cartesian (geod, a, es);
+        lam[i] = xyz.x;
+        phi[i] = xyz.y;
+        z[i]   = xyz.z;
+    }
+}
+
+
+/* inv3d on n points at once, in place: x, y, z in, lam, phi, h out */
+static void geodetic_batch (PJ *P, size_t n, double *x, double *y, double *z) {
+    const double a = P->a, es = P->es;
+    for (size_t i = 0;  i < n;  i++) {
+        PJ_XYZ cart;
+        PJ_LPZ lpz;
+        cart.x = x[i];
+        cart.y = y[i];
+        cart.z = z[i];
+        lpz = geodetic (cart, a, es, P);
+        x[i] = lpz.lam;
+        y[i] = lpz.phi;
+        z[i] = lpz.z;
+    }
+}
+
+
 
 /* In effect, 2 cartesian coordinates of a point on the ellipsoid. Rather pointless, but... */
 static PJ_XY cart_forward (PJ_LP lp, PJ *P) {
@@ -190,7 +292,7 @@ static PJ_XY cart_forward (PJ_LP lp, PJ *P) {
     point.lp = lp;
     point.lpz.z = 0;
 
-    point.xyz = cartesian (point.lpz, P);
+    point.xyz = pj_cart_cartesian (point.lpz, P);
     return point.xy;
 }
 
@@ -200,7 +302,7 @@ static PJ_LP cart_reverse (PJ_XY xy, PJ *P) {
     point.xy = xy;
     point.xyz.z = 0;
 
-    point.lpz = geodetic (point.xyz, P);
+    point.lpz = pj_cart_geodetic (point.xyz, P);
     return point.lp;
 }
 
@@ -209,8 +311,10 @@ static PJ_LP cart_reverse (PJ_XY xy, PJ *P) {
 /*********************************************************************/
 PJ *CONVERSION(cart,1) {
 /*********************************************************************/
-    P->fwd3d  =  cartesian;
-    P->inv3d  =  geodetic;
+    P->fwd3d  =  pj_cart_cartesian;
+    P->inv3d  =  pj_cart_geodetic;
+    P->fwd3d_batch = cartesian_batch;
+    P->inv3d_batch = geodetic_batch;
     P->fwd    =  cart_forward;
     P->inv    =  cart_reverse;
     P->left   =  PJ_IO_UNITS_RADIANS;
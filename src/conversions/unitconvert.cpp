@@ -386,6 +386,27 @@ static PJ_COORD reverse_4d(PJ_COORD obs, PJ *P) {
     return out;
 }
 
+/***********************************************************************/
+static int get_affine_map(PJ *P, PJ_DIRECTION direction, PJ_AFFINE_MAP *A) {
+/************************************************************************
+    Scaling of the physical dimensions, as long as time is untouched
+************************************************************************/
+    struct pj_opaque_unitconvert *Q = (struct pj_opaque_unitconvert *) P->opaque;
+
+    if (Q->t_in_id >= 0 || Q->t_out_id >= 0)
+        return 0;
+
+    pj_affine_map_set_identity (A);
+    if (direction == PJ_FWD) {
+        A->m[0][0] = A->m[1][1] = Q->xy_factor;
+        A->m[2][2] = Q->z_factor;
+    } else {
+        A->m[0][0] = A->m[1][1] = 1 / Q->xy_factor;
+        A->m[2][2] = 1 / Q->z_factor;
+    }
+    return 1;
+}
+
 /***********************************************************************/
 static double get_unit_conversion_factor(const char* name,
                                          int* p_is_linear,
@@ -454,6 +475,7 @@ PJ *CONVERSION(unitconvert,0) {
     P->inv3d  = reverse_3d;
     P->fwd    = forward_2d;
     P->inv    = reverse_2d;
+    P->get_affine_map = get_affine_map;
 
     P->left  = PJ_IO_UNITS_WHATEVER;
     P->right = PJ_IO_UNITS_WHATEVER;
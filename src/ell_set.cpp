@@ -488,6 +488,11 @@ void pj_inherit_ellipsoid_def (const PJ *src, PJ *dst) {
     /* es and a before any +proj related adjustment */
     dst->es_orig = src->es_orig;
     dst->a_orig  = src->a_orig;
+
+    /* Conformal latitude series */
+    dst->conformal_e = src->conformal_e;
+    for (int i = 0; i < 6; i++)
+        dst->conformal_cgb[i] = src->conformal_cgb[i];
 }
 
 
@@ -562,6 +567,8 @@ int pj_calc_ellipsoid_params (PJ *P, double a, double es) {
 
     P->rone_es = 1./P->one_es;
 
+    pj_phi2_setup (P);
+
     return 0;
 }
 
@@ -176,6 +176,29 @@ void   pj_ctx_fclose(projCtx ctx, PAFile file)
     ctx->fileapi->FClose(file);
 }
 
+/************************************************************************/
+/*                            pj_ctx_fwrite()                           */
+/*                                                                      */
+/*      projFileAPI has no write hook, so only files opened through     */
+/*      the default stdio implementation can be written.                */
+/************************************************************************/
+size_t pj_ctx_fwrite(projCtx ctx, const void *buffer, size_t size, size_t nmemb, PAFile file)
+{
+    if (ctx->fileapi != &default_fileapi)
+        return 0;
+    return fwrite(buffer, size, nmemb, ((stdio_pafile *) file)->fp);
+}
+
+/************************************************************************/
+/*                            pj_ctx_fflush()                           */
+/************************************************************************/
+int    pj_ctx_fflush(projCtx ctx, PAFile file)
+{
+    if (ctx->fileapi != &default_fileapi)
+        return EOF;
+    return fflush(((stdio_pafile *) file)->fp);
+}
+
 /************************************************************************/
 /*                            pj_ctx_fgets()                            */
 /*                                                                      */
@@ -0,0 +1,217 @@
+/******************************************************************************
+ * Project:  PROJ
+ * Purpose:  Fixed point formatting of doubles, as printf's "%.*f" does it,
+ *           without the C library for the common cases.
+ *
+ ******************************************************************************
+ * Copyright (c) 2018, PROJ contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *****************************************************************************/
+
+/*****************************************************************************
+
+    The command line applications spend much of their time printing
+    coordinates with "%.*f". printf() does that exactly: the decimal
+    expansion of the binary value is rounded to the requested number of
+    decimals, ties to even. For the usual magnitudes and precisions the
+    scaled value, x * 10^precision, is at most a 117 bit integer times a
+    power of two, so that exact rounding can be done in 128 bit integer
+    arithmetic, and the digits written directly, giving the same text as
+    printf() in the C locale.
+
+    Anything else, infinities, NaN, values of more than 64 bits once
+    scaled, or compilers without a 128 bit integer type, goes to
+    snprintf(). So does all of it on Windows, whose C library rounds
+    differently, to keep the output as it was.
+
+*****************************************************************************/
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "proj.h"
+#include "proj_internal.h"
+
+#if defined(__SIZEOF_INT128__) && !defined(_WIN32)
+#define FAST_FIXED_FORMAT
+#endif
+
+#ifdef FAST_FIXED_FORMAT
+
+static const uint64_t pow10_64[] = {
+    UINT64_C(1),
+    UINT64_C(10),
+    UINT64_C(100),
+    UINT64_C(1000),
+    UINT64_C(10000),
+    UINT64_C(100000),
+    UINT64_C(1000000),
+    UINT64_C(10000000),
+    UINT64_C(100000000),
+    UINT64_C(1000000000),
+    UINT64_C(10000000000),
+    UINT64_C(100000000000),
+    UINT64_C(1000000000000),
+    UINT64_C(10000000000000),
+    UINT64_C(100000000000000),
+    UINT64_C(1000000000000000),
+    UINT64_C(10000000000000000),
+    UINT64_C(100000000000000000),
+    UINT64_C(1000000000000000000),
+    UINT64_C(10000000000000000000)};
+
+/* |x| * 10^precision rounded to an integer, ties to even, if it fits 64 bits */
+static bool scaled_integer(double x, int precision, uint64_t *n) {
+    typedef unsigned __int128 uint128;
+    uint64_t bits, m;
+    int biased, e;
+    uint128 p;
+
+    memcpy(&bits, &x, sizeof(bits));
+    biased = static_cast<int>((bits >> 52) & 0x7FF);
+    m = bits & ((UINT64_C(1) << 52) - 1);
+    if (biased == 0x7FF)
+        return false;
+    if (biased == 0)
+        e = -1074;
+    else {
+        m |= UINT64_C(1) << 52;
+        e = biased - 1075;
+    }
+
+    /* |x| * 10^precision = p * 2^e, with p < 2^117 */
+    p = static_cast<uint128>(m) * pow10_64[precision];
+    if (e >= 0) {
+        if (e >= 64 || (p >> (64 - e)) != 0)
+            return false;
+        *n = static_cast<uint64_t>(p << e);
+        return true;
+    }
+
+    if (-e >= 118) {
+        /* less than half a unit */
+        *n = 0;
+        return true;
+    }
+    uint128 q = p >> -e;
+    uint128 r = p - (q << -e);
+    uint128 half = static_cast<uint128>(1) << (-e - 1);
+    if (r > half || (r == half && (q & 1)))
+        q++;
+    if (q >> 64)
+        return false;
+    *n = static_cast<uint64_t>(q);
+    return true;
+}
+
+#endif
+
+/************************************************************************/
+/*                          pj_format_fixed()                           */
+/************************************************************************/
+
+/**
+ * Formats a double as snprintf(s, size, "%*.*f", width, precision, x), or
+ * with "%0*.*f" if zero_pad is set, in the C locale.
+ *
+ * @return The length of the formatted value, which was truncated to size-1
+ * characters if that is not less than size, as for snprintf().
+ */
+int pj_format_fixed(char *s, size_t size, double x, int width, int precision,
+                    int zero_pad) {
+#ifdef FAST_FIXED_FORMAT
+    uint64_t n;
+    if (precision >= 0 && precision <= 19 &&
+        scaled_integer(x, precision, &n)) {
+        char digits[24], text[64];
+        int ndigits = 0, len = 0, pad, total;
+
+        do {
+            digits[ndigits++] = static_cast<char>('0' + n % 10);
+            n /= 10;
+        } while (n);
+        while (ndigits <= precision)
+            digits[ndigits++] = '0';
+
+        if (signbit(x))
+            text[len++] = '-';
+        while (ndigits > precision)
+            text[len++] = digits[--ndigits];
+        if (precision > 0) {
+            text[len++] = '.';
+            while (ndigits > 0)
+                text[len++] = digits[--ndigits];
+        }
+
+        /* Padding goes after the sign when it is zeros, before otherwise */
+        pad = width > len ? width - len : 0;
+        total = len + pad;
+        if (size > 0) {
+            int sign = zero_pad && text[0] == '-' ? 1 : 0;
+            int i = 0, j;
+            for (j = 0; j < sign && i < (int)size - 1; j++)
+                s[i++] = text[j];
+            for (j = 0; j < pad && i < (int)size - 1; j++)
+                s[i++] = zero_pad ? '0' : ' ';
+            for (j = sign; j < len && i < (int)size - 1; j++)
+                s[i++] = text[j];
+            s[i] = '\0';
+        }
+        return total;
+    }
+#endif
+    return snprintf(s, size, zero_pad ? "%0*.*f" : "%*.*f", width, precision,
+                    x);
+}
+
+/************************************************************************/
+/*                          pj_format_double()                          */
+/************************************************************************/
+
+/**
+ * Formats a double as snprintf(s, size, format, x), where format has a
+ * single conversion, of a double. Plain fixed point formats, "%[0][w][.p]f",
+ * are done by pj_format_fixed().
+ *
+ * @return As for snprintf().
+ */
+int pj_format_double(char *s, size_t size, const char *format, double x) {
+    const char *p = format;
+    int width = 0, precision = 6, zero_pad = 0;
+
+    if (*p++ != '%')
+        return snprintf(s, size, format, x);
+    if (*p == '0') {
+        zero_pad = 1;
+        p++;
+    }
+    while (*p >= '0' && *p <= '9' && width < 1000)
+        width = 10 * width + (*p++ - '0');
+    if (*p == '.') {
+        precision = 0;
+        for (p++; *p >= '0' && *p <= '9' && precision < 1000; p++)
+            precision = 10 * precision + (*p - '0');
+    }
+    if (p[0] != 'f' || p[1] != '\0')
+        return snprintf(s, size, format, x);
+    return pj_format_fixed(s, size, x, width, precision, zero_pad);
+}
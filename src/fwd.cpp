@@ -30,6 +30,10 @@
 
 #include <errno.h>
 #include <math.h>
+#include <string.h>
+
+#include <new>
+#include <vector>
 
 #include "proj_internal.h"
 #include "proj_math.h"
@@ -39,119 +43,250 @@
 #define OUTPUT_UNITS P->right
 
 
-static PJ_COORD fwd_prepare (PJ *P, PJ_COORD coo) {
-    if (HUGE_VAL==coo.v[0] || HUGE_VAL==coo.v[1] || HUGE_VAL==coo.v[2])
-        return proj_coord_error ();
+/*****************************************************************************
 
-    /* The helmert datum shift will choke unless it gets a sensible 4D coordinate */
-    if (HUGE_VAL==coo.v[2] && P->helmert) coo.v[2] = 0.0;
-    if (HUGE_VAL==coo.v[3] && P->helmert) coo.v[3] = 0.0;
+    Stages of the forward preparation and finalization. Which of them a PJ
+    needs is fixed once its setup is complete, so fwd_plan_compile() picks
+    them once, and pj_fwd/pj_fwd3d/pj_fwd4d only run the selected ones.
 
-    /* Check validity of angular input coordinates */
-    if (INPUT_UNITS==PJ_IO_UNITS_RADIANS) {
-        double t;
+******************************************************************************/
 
-        /* check for latitude or longitude over-range */
-        t = (coo.lp.phi < 0  ?  -coo.lp.phi  :  coo.lp.phi) - M_HALFPI;
-        if (t > PJ_EPS_LAT  ||  coo.lp.lam > 10  ||  coo.lp.lam < -10) {
-            proj_errno_set (P, PJD_ERR_LAT_OR_LON_EXCEED_LIMIT);
-            return proj_coord_error ();
-        }
+static int prepare_check_input (PJ *P, PJ_COORD *coo) {
+    (void) P;
+    if (HUGE_VAL==coo->v[0] || HUGE_VAL==coo->v[1] || HUGE_VAL==coo->v[2]) {
+        *coo = proj_coord_error ();
+        return 0;
+    }
+    return 1;
+}
 
-        /* Clamp latitude to -90..90 degree range */
-        if (coo.lp.phi > M_HALFPI)
-            coo.lp.phi = M_HALFPI;
-        if (coo.lp.phi < -M_HALFPI)
-            coo.lp.phi = -M_HALFPI;
-
-        /* If input latitude is geocentrical, convert to geographical */
-        if (P->geoc)
-            coo = pj_geocentric_latitude (P, PJ_INV, coo);
-
-        /* Ensure longitude is in the -pi:pi range */
-        if (0==P->over)
-            coo.lp.lam = adjlon(coo.lp.lam);
-
-        if (P->hgridshift)
-            coo = proj_trans (P->hgridshift, PJ_INV, coo);
-        else if (P->helmert || (P->cart_wgs84 != nullptr && P->cart != nullptr)) {
-            coo = proj_trans (P->cart_wgs84, PJ_FWD, coo); /* Go cartesian in WGS84 frame */
-            if( P->helmert )
-                coo = proj_trans (P->helmert,    PJ_INV, coo); /* Step into local frame */
-            coo = proj_trans (P->cart,       PJ_INV, coo); /* Go back to angular using local ellps */
-        }
-        if (coo.lp.lam==HUGE_VAL)
-            return coo;
-        if (P->vgridshift)
-            coo = proj_trans (P->vgridshift, PJ_FWD, coo); /* Go orthometric from geometric */
 
-        /* Distance from central meridian, taking system zero meridian into account */
-        coo.lp.lam = (coo.lp.lam - P->from_greenwich) - P->lam0;
+/* The helmert datum shift will choke unless it gets a sensible 4D coordinate */
+static int prepare_helmert_defaults (PJ *P, PJ_COORD *coo) {
+    (void) P;
+    if (HUGE_VAL==coo->v[2]) coo->v[2] = 0.0;
+    if (HUGE_VAL==coo->v[3]) coo->v[3] = 0.0;
+    return 1;
+}
+
 
-        /* Ensure longitude is in the -pi:pi range */
-        if (0==P->over)
-            coo.lp.lam = adjlon(coo.lp.lam);
+/* Check validity of angular input coordinates */
+static int prepare_check_angular (PJ *P, PJ_COORD *coo) {
+    double t;
 
-        return coo;
+    /* check for latitude or longitude over-range */
+    t = (coo->lp.phi < 0  ?  -coo->lp.phi  :  coo->lp.phi) - M_HALFPI;
+    if (t > PJ_EPS_LAT  ||  coo->lp.lam > 10  ||  coo->lp.lam < -10) {
+        proj_errno_set (P, PJD_ERR_LAT_OR_LON_EXCEED_LIMIT);
+        *coo = proj_coord_error ();
+        return 0;
     }
 
+    /* Clamp latitude to -90..90 degree range */
+    if (coo->lp.phi > M_HALFPI)
+        coo->lp.phi = M_HALFPI;
+    if (coo->lp.phi < -M_HALFPI)
+        coo->lp.phi = -M_HALFPI;
+    return 1;
+}
+
+
+/* If input latitude is geocentrical, convert to geographical */
+static int prepare_geocentric_latitude (PJ *P, PJ_COORD *coo) {
+    *coo = pj_geocentric_latitude (P, PJ_INV, *coo);
+    return 1;
+}
+
+
+/* Ensure longitude is in the -pi:pi range */
+static int prepare_adjlon (PJ *P, PJ_COORD *coo) {
+    (void) P;
+    coo->lp.lam = adjlon(coo->lp.lam);
+    return 1;
+}
+
+
+static int prepare_hgridshift (PJ *P, PJ_COORD *coo) {
+    *coo = proj_trans (P->hgridshift, PJ_INV, *coo);
+    return coo->lp.lam != HUGE_VAL;
+}
+
+
+static int prepare_datum_shift (PJ *P, PJ_COORD *coo) {
+    *coo = proj_trans (P->cart_wgs84, PJ_FWD, *coo); /* Go cartesian in WGS84 frame */
+    if( P->helmert )
+        *coo = proj_trans (P->helmert,    PJ_INV, *coo); /* Step into local frame */
+    *coo = proj_trans (P->cart,       PJ_INV, *coo); /* Go back to angular using local ellps */
+    return coo->lp.lam != HUGE_VAL;
+}
+
+
+static int prepare_vgridshift (PJ *P, PJ_COORD *coo) {
+    *coo = proj_trans (P->vgridshift, PJ_FWD, *coo); /* Go orthometric from geometric */
+    return 1;
+}
+
 
-    /* We do not support gridshifts on cartesian input */
-    if (INPUT_UNITS==PJ_IO_UNITS_CARTESIAN && P->helmert)
-            return proj_trans (P->helmert, PJ_INV, coo);
-    return coo;
+/* Distance from central meridian, taking system zero meridian into account */
+static int prepare_central_meridian (PJ *P, PJ_COORD *coo) {
+    coo->lp.lam = (coo->lp.lam - P->from_greenwich) - P->lam0;
+    return 1;
 }
 
 
-static PJ_COORD fwd_finalize (PJ *P, PJ_COORD coo) {
+/* We do not support gridshifts on cartesian input */
+static int prepare_cartesian_helmert (PJ *P, PJ_COORD *coo) {
+    *coo = proj_trans (P->helmert, PJ_INV, *coo);
+    return 1;
+}
 
-    switch (OUTPUT_UNITS) {
 
-    /* Handle false eastings/northings and non-metric linear units */
-    case PJ_IO_UNITS_CARTESIAN:
+static int finalize_geocent (PJ *P, PJ_COORD *coo) {
+    *coo = proj_trans (P->cart, PJ_FWD, *coo);
+    return 1;
+}
 
-        if (P->is_geocent) {
-            coo = proj_trans (P->cart, PJ_FWD, coo);
+
+static int finalize_cartesian_units (PJ *P, PJ_COORD *coo) {
+    coo->xyz.x *= P->fr_meter;
+    coo->xyz.y *= P->fr_meter;
+    coo->xyz.z *= P->fr_meter;
+    return 1;
+}
+
+
+/* Classic proj.4 functions return plane coordinates in units of the semimajor axis */
+static int finalize_classic_units (PJ *P, PJ_COORD *coo) {
+    coo->xy.x *= P->a;
+    coo->xy.y *= P->a;
+    return 1;
+}
+
+
+/* Handle false eastings/northings and non-metric linear units */
+static int finalize_projected_units (PJ *P, PJ_COORD *coo) {
+    coo->xyz.x = P->fr_meter  * (coo->xyz.x + P->x0);
+    coo->xyz.y = P->fr_meter  * (coo->xyz.y + P->y0);
+    coo->xyz.z = P->vfr_meter * (coo->xyz.z + P->z0);
+    return 1;
+}
+
+
+static int finalize_angular_height (PJ *P, PJ_COORD *coo) {
+    coo->lpz.z = P->vfr_meter * (coo->lpz.z + P->z0);
+    return 1;
+}
+
+
+static int finalize_long_wrap (PJ *P, PJ_COORD *coo) {
+    if( coo->lpz.lam != HUGE_VAL ) {
+        coo->lpz.lam  = P->long_wrap_center +
+                        adjlon(coo->lpz.lam - P->long_wrap_center);
+    }
+    return 1;
+}
+
+
+static int finalize_axisswap (PJ *P, PJ_COORD *coo) {
+    *coo = proj_trans (P->axisswap, PJ_FWD, *coo);
+    return 1;
+}
+
+
+static void fwd_plan_compile (PJ *P) {
+    PJ_IO_PLAN *plan = &P->fwd_plan;
+    int n = 0;
+
+    if (!P->skip_fwd_prepare) {
+        plan->prepare[n++] = prepare_check_input;
+        if (P->helmert)
+            plan->prepare[n++] = prepare_helmert_defaults;
+
+        if (INPUT_UNITS==PJ_IO_UNITS_RADIANS) {
+            plan->prepare[n++] = prepare_check_angular;
+            if (P->geoc)
+                plan->prepare[n++] = prepare_geocentric_latitude;
+            if (0==P->over)
+                plan->prepare[n++] = prepare_adjlon;
+            if (P->hgridshift)
+                plan->prepare[n++] = prepare_hgridshift;
+            else if (P->helmert || (P->cart_wgs84 != nullptr && P->cart != nullptr))
+                plan->prepare[n++] = prepare_datum_shift;
+            if (P->vgridshift)
+                plan->prepare[n++] = prepare_vgridshift;
+            /* subtracting zero leaves any value, -0 included, as it is */
+            if (P->from_greenwich != 0.0 || P->lam0 != 0.0)
+                plan->prepare[n++] = prepare_central_meridian;
+            if (0==P->over)
+                plan->prepare[n++] = prepare_adjlon;
         }
-        coo.xyz.x *= P->fr_meter;
-        coo.xyz.y *= P->fr_meter;
-        coo.xyz.z *= P->fr_meter;
-
-        break;
-
-    /* Classic proj.4 functions return plane coordinates in units of the semimajor axis */
-    case PJ_IO_UNITS_CLASSIC:
-        coo.xy.x *= P->a;
-        coo.xy.y *= P->a;
-
-    /* Falls through */ /* (<-- GCC warning silencer) */
-    /* to continue processing in common with PJ_IO_UNITS_PROJECTED */
-    case PJ_IO_UNITS_PROJECTED:
-        coo.xyz.x = P->fr_meter  * (coo.xyz.x + P->x0);
-        coo.xyz.y = P->fr_meter  * (coo.xyz.y + P->y0);
-        coo.xyz.z = P->vfr_meter * (coo.xyz.z + P->z0);
-        break;
-
-    case PJ_IO_UNITS_WHATEVER:
-        break;
-
-    case PJ_IO_UNITS_RADIANS:
-        coo.lpz.z = P->vfr_meter * (coo.lpz.z + P->z0);
-
-        if( P->is_long_wrap_set ) {
-            if( coo.lpz.lam != HUGE_VAL ) {
-                coo.lpz.lam  = P->long_wrap_center +
-                               adjlon(coo.lpz.lam - P->long_wrap_center);
-            }
+        else if (INPUT_UNITS==PJ_IO_UNITS_CARTESIAN && P->helmert)
+            plan->prepare[n++] = prepare_cartesian_helmert;
+    }
+    plan->n_prepare = n;
+
+    n = 0;
+    if (!P->skip_fwd_finalize) {
+        switch (OUTPUT_UNITS) {
+        case PJ_IO_UNITS_CARTESIAN:
+            if (P->is_geocent)
+                plan->finalize[n++] = finalize_geocent;
+            /* scaling by 1 is exact, so it can be skipped altogether */
+            if (P->fr_meter != 1.0)
+                plan->finalize[n++] = finalize_cartesian_units;
+            break;
+        case PJ_IO_UNITS_CLASSIC:
+            plan->finalize[n++] = finalize_classic_units;
+            plan->finalize[n++] = finalize_projected_units;
+            break;
+        case PJ_IO_UNITS_PROJECTED:
+            /* even with unit scale and no offsets: adding the zero offsets turns -0 into 0 */
+            plan->finalize[n++] = finalize_projected_units;
+            break;
+        case PJ_IO_UNITS_WHATEVER:
+            break;
+        case PJ_IO_UNITS_RADIANS:
+            plan->finalize[n++] = finalize_angular_height;
+            if( P->is_long_wrap_set )
+                plan->finalize[n++] = finalize_long_wrap;
+            break;
         }
-
-        break;
+        if (P->axisswap)
+            plan->finalize[n++] = finalize_axisswap;
+    }
+    plan->n_finalize = n;
+
+    /* Unit scale and zero offsets leave the final stages nothing to do but */
+    /* turn -0 into 0                                                       */
+    plan->checks_only = 1;
+    for (int i = 0;  i < plan->n_prepare;  i++)
+        if (plan->prepare[i] != prepare_check_input)
+            plan->checks_only = 0;
+    for (int i = 0;  i < plan->n_finalize;  i++) {
+        if (plan->finalize[i] == finalize_projected_units &&
+            P->fr_meter == 1.0 && P->vfr_meter == 1.0 &&
+            P->x0 == 0.0 && P->y0 == 0.0 && P->z0 == 0.0)
+            plan->zero_sign[0] = plan->zero_sign[1] = plan->zero_sign[2] = 1;
+        else if (plan->finalize[i] == finalize_angular_height &&
+                 P->vfr_meter == 1.0 && P->z0 == 0.0)
+            plan->zero_sign[2] = 1;
+        else
+            plan->checks_only = 0;
     }
 
-    if (P->axisswap)
-        coo = proj_trans (P->axisswap, PJ_FWD, coo);
+    plan->compiled = 1;
+}
+
 
-    return coo;
+/*****************************************************************************/
+const PJ_IO_PLAN *pj_fwd_plan (PJ *P) {
+/******************************************************************************
+    Return the forward preparation/finalization plan of P, compiling it on
+    first use. P must be fully set up at that point.
+******************************************************************************/
+    if (!P->fwd_plan.compiled)
+        fwd_plan_compile (P);
+    return &P->fwd_plan;
 }
 
 
@@ -166,13 +301,14 @@ static PJ_COORD error_or_coord(PJ *P, PJ_COORD coord, int last_errno) {
 
 PJ_XY pj_fwd(PJ_LP lp, PJ *P) {
     int last_errno;
+    const PJ_IO_PLAN *plan;
     PJ_COORD coo = {{0,0,0,0}};
     coo.lp = lp;
 
     last_errno = proj_errno_reset(P);
 
-    if (!P->skip_fwd_prepare)
-        coo = fwd_prepare (P, coo);
+    plan = pj_fwd_plan (P);
+    coo = pj_io_plan_run (P, plan->prepare, plan->n_prepare, coo);
     if (HUGE_VAL==coo.v[0] || HUGE_VAL==coo.v[1])
         return proj_coord_error ().xy;
 
@@ -190,8 +326,7 @@ PJ_XY pj_fwd(PJ_LP lp, PJ *P) {
     if (HUGE_VAL==coo.v[0])
         return proj_coord_error ().xy;
 
-    if (!P->skip_fwd_finalize)
-        coo = fwd_finalize (P, coo);
+    coo = pj_io_plan_run (P, plan->finalize, plan->n_finalize, coo);
 
     return error_or_coord(P, coo, last_errno).xy;
 }
@@ -200,13 +335,14 @@ PJ_XY pj_fwd(PJ_LP lp, PJ *P) {
 
 PJ_XYZ pj_fwd3d(PJ_LPZ lpz, PJ *P) {
     int last_errno;
+    const PJ_IO_PLAN *plan;
     PJ_COORD coo = {{0,0,0,0}};
     coo.lpz = lpz;
 
     last_errno = proj_errno_reset(P);
 
-    if (!P->skip_fwd_prepare)
-        coo = fwd_prepare (P, coo);
+    plan = pj_fwd_plan (P);
+    coo = pj_io_plan_run (P, plan->prepare, plan->n_prepare, coo);
     if (HUGE_VAL==coo.v[0])
         return proj_coord_error ().xyz;
 
@@ -224,8 +360,7 @@ PJ_XYZ pj_fwd3d(PJ_LPZ lpz, PJ *P) {
     if (HUGE_VAL==coo.v[0])
         return proj_coord_error ().xyz;
 
-    if (!P->skip_fwd_finalize)
-        coo = fwd_finalize (P, coo);
+    coo = pj_io_plan_run (P, plan->finalize, plan->n_finalize, coo);
 
     return error_or_coord(P, coo, last_errno).xyz;
 }
@@ -234,9 +369,9 @@ PJ_XYZ pj_fwd3d(PJ_LPZ lpz, PJ *P) {
 
 PJ_COORD pj_fwd4d (PJ_COORD coo, PJ *P) {
     int last_errno = proj_errno_reset(P);
+    const PJ_IO_PLAN *plan = pj_fwd_plan (P);
 
-    if (!P->skip_fwd_prepare)
-        coo = fwd_prepare (P, coo);
+    coo = pj_io_plan_run (P, plan->prepare, plan->n_prepare, coo);
     if (HUGE_VAL==coo.v[0])
         return proj_coord_error ();
 
@@ -254,8 +389,153 @@ PJ_COORD pj_fwd4d (PJ_COORD coo, PJ *P) {
     if (HUGE_VAL==coo.v[0])
         return proj_coord_error ();
 
-    if (!P->skip_fwd_finalize)
-        coo = fwd_finalize (P, coo);
+    coo = pj_io_plan_run (P, plan->finalize, plan->n_finalize, coo);
 
     return error_or_coord(P, coo, last_errno);
 }
+
+
+
+/* Stages acting on the longitude and the latitude independently */
+static int is_separable_stage (PJ_IO_STEP step) {
+    return step == prepare_check_input || step == prepare_check_angular ||
+           step == prepare_geocentric_latitude || step == prepare_adjlon ||
+           step == prepare_central_meridian;
+}
+
+
+/*****************************************************************************/
+int pj_fwd_lattice (PJ *P, double lam0, double dlam, size_t nlam,
+                    double phi0, double dphi, size_t nphi, PJ_COORD *out) {
+/******************************************************************************
+    Forward transform the lattice of points (lam0 + i*dlam, phi0 + j*dphi)
+    into out[j*nlam + i], with the same results as pj_fwd4d would give one
+    by one, for projections with a fwd_lattice kernel and a preparation
+    that acts on longitude and latitude independently. Each longitude and
+    latitude is then only prepared once, and the kernel can compute the
+    terms depending on only one of them once per column or row.
+
+    Points that fail are set to HUGE_VAL, with errno set. Returns 0, without
+    touching out, if P does not qualify.
+******************************************************************************/
+    const PJ_IO_PLAN *plan;
+    std::vector<double> lam, phi;
+    std::vector<char> lam_ok, phi_ok;
+    size_t i, j;
+
+    if (nullptr==P->fwd_lattice || nullptr!=P->fwd4d || nullptr!=P->fwd3d || nullptr==P->fwd)
+        return 0;
+    plan = pj_fwd_plan (P);
+    for (i = 0;  i < static_cast<size_t>(plan->n_prepare);  i++)
+        if (!is_separable_stage (plan->prepare[i]))
+            return 0;
+
+    try {
+        lam.resize (nlam);
+        phi.resize (nphi);
+        lam_ok.resize (nlam);
+        phi_ok.resize (nphi);
+    } catch (const std::bad_alloc &) {
+        return 0;
+    }
+
+    /* Points of a failing column or row are errors, the kernel gets zeros there */
+    for (i = 0;  i < nlam;  i++) {
+        PJ_COORD coo = proj_coord (lam0 + i*dlam, 0, 0, 0);
+        coo = pj_io_plan_run (P, plan->prepare, plan->n_prepare, coo);
+        lam_ok[i] = HUGE_VAL != coo.v[0];
+        lam[i] = lam_ok[i] ? coo.lp.lam : 0;
+    }
+    for (j = 0;  j < nphi;  j++) {
+        PJ_COORD coo = proj_coord (0, phi0 + j*dphi, 0, 0);
+        coo = pj_io_plan_run (P, plan->prepare, plan->n_prepare, coo);
+        phi_ok[j] = HUGE_VAL != coo.v[0];
+        phi[j] = phi_ok[j] ? coo.lp.phi : 0;
+    }
+
+    for (i = 0;  i < nlam*nphi;  i++)
+        out[i] = proj_coord (0, 0, 0, 0);
+    P->fwd_lattice (P, lam.data (), nlam, phi.data (), nphi, out);
+
+    for (j = 0;  j < nphi;  j++) {
+        PJ_COORD *row = out + j*nlam;
+        for (i = 0;  i < nlam;  i++) {
+            if (!phi_ok[j] || !lam_ok[i] || HUGE_VAL==row[i].v[0]) {
+                row[i] = proj_coord_error ();
+                continue;
+            }
+            row[i] = pj_io_plan_run (P, plan->finalize, plan->n_finalize, row[i]);
+            if (HUGE_VAL==row[i].v[0])
+                row[i] = proj_coord_error ();
+        }
+    }
+    return 1;
+}
+
+
+
+/*****************************************************************************/
+int pj_fwd_array (PJ *P, size_t n, PJ_COORD *coord) {
+/******************************************************************************
+    Forward transform an array of coordinates through the fwd3d_batch or
+    fwd_batch kernel of P,
+    with the outcome of proj_trans_array(): the same coordinates and
+    errors as pj_fwd4d() one by one, stopping at the first error. P must
+    not have a 4D kernel, nor a 3D kernel without a 3D batch kernel.
+
+    The preparation and finalization run per coordinate, and the kernel
+    gets chunks of PJ_BATCH_SIZE. A chunk where an error shows up is
+    restored and redone one coordinate at a time, so errors, which are
+    rare, stop at the right place.
+******************************************************************************/
+    const PJ_IO_PLAN *plan = pj_fwd_plan (P);
+    PJ_COORD saved[PJ_BATCH_SIZE];
+    double a[PJ_BATCH_SIZE], b[PJ_BATCH_SIZE], z[PJ_BATCH_SIZE];
+    int last_errno = proj_errno_reset (P);
+    size_t i, k, m;
+
+    for (k = 0;  k < n;  k += m) {
+        PJ_COORD *c = coord + k;
+        m = (n - k < PJ_BATCH_SIZE) ? n - k : PJ_BATCH_SIZE;
+        memcpy (saved, c, m * sizeof (PJ_COORD));
+
+        for (i = 0;  i < m;  i++) {
+            c[i] = pj_io_plan_run (P, plan->prepare, plan->n_prepare, c[i]);
+            /* The kernel gets zeros where the preparation failed */
+            a[i] = HUGE_VAL==c[i].v[0] ? 0 : c[i].lp.lam;
+            b[i] = HUGE_VAL==c[i].v[0] ? 0 : c[i].lp.phi;
+            z[i] = HUGE_VAL==c[i].v[0] ? 0 : c[i].v[2];
+        }
+
+        if (0==proj_errno (P)) {
+            if (nullptr!=P->fwd3d_batch)
+                P->fwd3d_batch (P, m, a, b, z);
+            else
+                P->fwd_batch (P, m, a, b);
+            for (i = 0;  i < m;  i++) {
+                if (HUGE_VAL==c[i].v[0] || HUGE_VAL==a[i]) {
+                    c[i] = proj_coord_error ();
+                    continue;
+                }
+                c[i].xy.x = a[i];
+                c[i].xy.y = b[i];
+                if (nullptr!=P->fwd3d_batch)
+                    c[i].v[2] = z[i];
+                c[i] = pj_io_plan_run (P, plan->finalize, plan->n_finalize, c[i]);
+            }
+        }
+        if (0==proj_errno (P))
+            continue;
+
+        proj_errno_reset (P);
+        memcpy (c, saved, m * sizeof (PJ_COORD));
+        for (i = 0;  i < m;  i++) {
+            c[i] = pj_fwd4d (c[i], P);
+            if (proj_errno (P))
+                return proj_errno (P);
+        }
+    }
+
+    proj_errno_restore (P, last_errno);
+    return 0;
+}
@@ -102,3 +102,50 @@ PJ_LP pj_inv_gauss(projCtx ctx, PJ_LP slp, const void *data) {
         pj_ctx_set_errno(ctx, PJD_ERR_NON_CONV_INV_MERI_DIST);
     return (elp);
 }
+
+/* pj_gauss() of n points, in place */
+void pj_gauss_array(size_t n, double *lam, double *phi, const void *data) {
+    const struct GAUSS *en = (const struct GAUSS *)data;
+    const double C = en->C, K = en->K, e = en->e, ratexp = en->ratexp;
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        phi[i] = 2. * atan( K *
+            pow(tan(.5 * phi[i] + M_FORTPI), C) *
+            srat(e * sin(phi[i]), ratexp) ) - M_HALFPI;
+        lam[i] = C * lam[i];
+    }
+}
+
+/* pj_inv_gauss() of n <= PJ_BATCH_SIZE points, in place, iterating all of */
+/* them in lockstep: a point is no longer updated once it converged        */
+void pj_inv_gauss_array(projCtx ctx, size_t n, double *lam, double *phi,
+                        const void *data) {
+    const struct GAUSS *en = (const struct GAUSS *)data;
+    const double C = en->C, K = en->K, e = en->e;
+    const double inv_C = 1./C, ratexp = -.5 * e;
+    double num[PJ_BATCH_SIZE];
+    unsigned char done[PJ_BATCH_SIZE];
+    size_t i, left = n;
+    int iter;
+
+    for (i = 0; i < n; i++) {
+        lam[i] = lam[i] / C;
+        num[i] = pow(tan(.5 * phi[i] + M_FORTPI)/K, inv_C);
+        done[i] = 0;
+    }
+    for (iter = MAX_ITER; iter && left; --iter) {
+        left = 0;
+        for (i = 0; i < n; i++) {
+            const double p = 2. * atan(num[i] * srat(e * sin(phi[i]), ratexp))
+                - M_HALFPI;
+            const int converged = fabs(p - phi[i]) < DEL_TOL;
+            phi[i] = done[i] ? phi[i] : p;
+            done[i] |= converged;
+            left += !done[i];
+        }
+    }
+    /* convergence failed */
+    if (left)
+        pj_ctx_set_errno(ctx, PJD_ERR_NON_CONV_INV_MERI_DIST);
+}
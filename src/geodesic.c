@@ -1928,6 +1928,27 @@ void geod_polygon_addedge(const struct geod_geodesic* g,
   }
 }
 
+void geod_polygon_merge(const struct geod_geodesic* g,
+                        struct geod_polygon* p,
+                        const struct geod_polygon* q) {
+  if (q->num == 0) return;
+  if (p->num == 0) {
+    *p = *q;
+    return;
+  }
+  /* The edge joining the two, as geod_polygon_addpoint() would add it */
+  geod_polygon_addpoint(g, p, q->lat0, q->lon0);
+  accadd(p->P, q->P[0]);
+  accadd(p->P, q->P[1]);
+  if (!p->polyline) {
+    accadd(p->A, q->A[0]);
+    accadd(p->A, q->A[1]);
+    p->crossings += q->crossings;
+  }
+  p->lat = q->lat; p->lon = q->lon;
+  p->num += q->num - 1;
+}
+
 unsigned geod_polygon_compute(const struct geod_geodesic* g,
                               const struct geod_polygon* p,
                               boolx reverse, boolx sign,
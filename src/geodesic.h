@@ -400,6 +400,123 @@ extern "C" {
                          double* pm12, double* pM12, double* pM21,
                          double* pS12);
 
+  /**
+   * Solve the direct geodesic problem for an array of geodesics.
+   *
+   * @param[in] g a pointer to the geod_geodesic object specifying the
+   *   ellipsoid.
+   * @param[in] lat1 array of latitudes of point 1 (degrees).
+   * @param[in] lon1 array of longitudes of point 1 (degrees).
+   * @param[in] azi1 array of azimuths at point 1 (degrees).
+   * @param[in] s12 array of distances from point 1 to point 2 (meters).
+   * @param[in] n the number of geodesics.
+   * @param[out] lat2 array of latitudes of point 2 (degrees).
+   * @param[out] lon2 array of longitudes of point 2 (degrees).
+   * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+   * @param[in] nthreads the largest number of threads to use, or 0 for one
+   *   per hardware thread.
+   *
+   * This gives the same results as calling geod_direct() for each element
+   * in turn, whatever the number of threads.  A run of consecutive
+   * elements with the same point 1 and azimuth, such as a sequence of
+   * distances along one geodesic, shares a single geod_geodesicline, so
+   * that the coefficients of the series are computed once for the run.
+   * Any of the output arrays may be replaced by 0, if you do not need some
+   * quantities computed.  Without thread support in the library, \e
+   * nthreads is ignored.
+   **********************************************************************/
+  void GEOD_DLL geod_direct_batch(const struct geod_geodesic* g,
+                         const double lat1[], const double lon1[],
+                         const double azi1[], const double s12[], int n,
+                         double lat2[], double lon2[], double azi2[],
+                         int nthreads);
+
+  /**
+   * Solve the inverse geodesic problem for an array of pairs of points.
+   *
+   * @param[in] g a pointer to the geod_geodesic object specifying the
+   *   ellipsoid.
+   * @param[in] lat1 array of latitudes of point 1 (degrees).
+   * @param[in] lon1 array of longitudes of point 1 (degrees).
+   * @param[in] lat2 array of latitudes of point 2 (degrees).
+   * @param[in] lon2 array of longitudes of point 2 (degrees).
+   * @param[in] n the number of pairs.
+   * @param[out] s12 array of distances from point 1 to point 2 (meters).
+   * @param[out] azi1 array of azimuths at point 1 (degrees).
+   * @param[out] azi2 array of (forward) azimuths at point 2 (degrees).
+   * @param[in] nthreads the largest number of threads to use, or 0 for one
+   *   per hardware thread.
+   *
+   * This gives the same results as calling geod_inverse() for each element
+   * in turn, whatever the number of threads.  Any of the output arrays may
+   * be replaced by 0, if you do not need some quantities computed.
+   * Without thread support in the library, \e nthreads is ignored.
+   **********************************************************************/
+  void GEOD_DLL geod_inverse_batch(const struct geod_geodesic* g,
+                          const double lat1[], const double lon1[],
+                          const double lat2[], const double lon2[], int n,
+                          double s12[], double azi1[], double azi2[],
+                          int nthreads);
+
+  /**
+   * The matrix of geodesic distances between two sets of points.
+   *
+   * @param[in] g a pointer to the geod_geodesic object specifying the
+   *   ellipsoid.
+   * @param[in] lat1 array of latitudes of the first set (degrees).
+   * @param[in] lon1 array of longitudes of the first set (degrees).
+   * @param[in] n1 the number of points in the first set.
+   * @param[in] lat2 array of latitudes of the second set (degrees).
+   * @param[in] lon2 array of longitudes of the second set (degrees).
+   * @param[in] n2 the number of points in the second set.
+   * @param[out] s12 array of \e n1 &times; \e n2 distances (meters); the
+   *   distance from point \e i of the first set to point \e j of the
+   *   second one is at s12[\e i &times; \e n2 + \e j].
+   * @param[in] nthreads the largest number of threads to use, or 0 for one
+   *   per hardware thread.
+   *
+   * The distances are those of geod_inverse(), whatever the number of
+   * threads.  Without thread support in the library, \e nthreads is
+   * ignored.
+   **********************************************************************/
+  void GEOD_DLL geod_distance_matrix(const struct geod_geodesic* g,
+                            const double lat1[], const double lon1[], int n1,
+                            const double lat2[], const double lon2[], int n2,
+                            double s12[], int nthreads);
+
+  /**
+   * The k nearest neighbours, along geodesics, of query points in a set of
+   * points.
+   *
+   * @param[in] g a pointer to the geod_geodesic object specifying the
+   *   ellipsoid.
+   * @param[in] lat array of latitudes of the set (degrees).
+   * @param[in] lon array of longitudes of the set (degrees).
+   * @param[in] n the number of points in the set.
+   * @param[in] qlat array of latitudes of the query points (degrees).
+   * @param[in] qlon array of longitudes of the query points (degrees).
+   * @param[in] nq the number of query points.
+   * @param[in] k the number of neighbours wanted per query point.
+   * @param[out] idx array of \e nq &times; \e k indices into the set; those
+   *   of query point \e i start at idx[\e i &times; \e k].
+   * @param[out] s12 array of the \e nq &times; \e k corresponding distances
+   *   (meters).
+   * @param[in] nthreads the largest number of threads to use, or 0 for one
+   *   per hardware thread.
+   * @return 0, or 1 if there was not enough memory, in which case the output
+   *   is incomplete.
+   *
+   * The neighbours of each query point are ordered by increasing distance,
+   * and by index for equal distances.  If \e k exceeds \e n, the missing
+   * neighbours have index &minus;1 and distance HUGE_VAL.  Only candidates
+   * that the chord between the points cannot rule out get their geodesic
+   * solved, so that is usually a small part of the set.
+   **********************************************************************/
+  int GEOD_DLL geod_knn(const struct geod_geodesic* g,
+               const double lat[], const double lon[], int n,
+               const double qlat[], const double qlon[], int nq,
+               int k, int idx[], double s12[], int nthreads);
+
   /**
    * Initialize a geod_geodesicline object.
    *
@@ -744,6 +861,30 @@ extern "C" {
                             struct geod_polygon* p,
                             double azi, double s);
 
+  /**
+   * Append the points of one polygon or polyline to another.
+   *
+   * @param[in] g a pointer to the geod_geodesic object specifying the
+   *   ellipsoid.
+   * @param[in,out] p a pointer to the geod_polygon object specifying the
+   *   polygon.
+   * @param[in] q a pointer to the geod_polygon object holding the points
+   *   which follow those of \e p.
+   *
+   * This leaves \e p as if the points (and edges) added to \e q had been
+   * added to \e p instead: the edge from the last point of \e p to the first
+   * point of \e q is added, and the perimeter, area and crossings of the
+   * prime meridian of \e q are added to those of \e p.  The sums are kept
+   * with the same extended precision as geod_polygon_addpoint() keeps them,
+   * and the crossings are counted exactly, so a long ring can be split in
+   * consecutive ranges of points, accumulated independently (e.g., on
+   * separate threads), and merged in order.  \e p and \e q must both be
+   * polygons or both be polylines, and \e q is not changed.
+   **********************************************************************/
+  void GEOD_DLL geod_polygon_merge(const struct geod_geodesic* g,
+                          struct geod_polygon* p,
+                          const struct geod_polygon* q);
+
   /**
    * Return the results for a polygon.
    *
@@ -891,6 +1032,37 @@ extern "C" {
                         double lats[], double lons[], int n,
                         double* pA, double* pP);
 
+  /**
+   * The areas and perimeters of many polygons at once.
+   *
+   * @param[in] g a pointer to the geod_geodesic object specifying the
+   *   ellipsoid.
+   * @param[in] lats array of latitudes of the vertices of all the polygons
+   *   (degrees).
+   * @param[in] lons array of longitudes of the vertices of all the polygons
+   *   (degrees).
+   * @param[in] offsets array of \e n + 1 indices into \e lats and \e lons;
+   *   the vertices of polygon \e i are those from offsets[\e i] up to, but
+   *   not including, offsets[\e i + 1].
+   * @param[in] n the number of polygons.
+   * @param[out] A array of the \e n areas (meters<sup>2</sup>).
+   * @param[out] P array of the \e n perimeters (meters).
+   * @param[in] nthreads the largest number of threads to use, or 0 for one
+   *   per hardware thread.
+   * @return 0, or 1 if there was not enough memory, in which case \e A and
+   *   \e P are not set.
+   *
+   * Each polygon is handled as by geod_polygonarea().  Long rings are split
+   * in ranges of vertices, which are accumulated in parallel and merged with
+   * geod_polygon_merge(), so even a single polygon uses all the threads.
+   * Either of \e A and \e P may be replaced by 0.  Without thread support in
+   * the library, \e nthreads is ignored.
+   **********************************************************************/
+  int GEOD_DLL geod_polygonarea_batch(const struct geod_geodesic* g,
+                             const double lats[], const double lons[],
+                             const int offsets[], int n,
+                             double A[], double P[], int nthreads);
+
   /**
    * mask values for the \e caps argument to geod_lineinit().
    **********************************************************************/
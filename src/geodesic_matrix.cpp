@@ -0,0 +1,329 @@
+/******************************************************************************
+ * Project:  PROJ
+ * Purpose:  Batches of direct and inverse geodesics, geodesic distance
+ *           matrices, nearest neighbour queries and polygon areas over
+ *           arrays, on top of the geodesic library.
+ *
+ ******************************************************************************
+ * Copyright (c) 2018, PROJ contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *****************************************************************************/
+
+/*****************************************************************************
+
+    Batches, distance matrices, nearest neighbours and polygon areas
+    ----------------------------------------------------------------
+
+    geod_direct_batch() and geod_inverse_batch() solve their geodesics in
+    chunks of BATCH_CHUNK elements. Within a chunk, a run of direct
+    geodesics from the same point and azimuth shares one
+    geod_geodesicline.
+
+    geod_distance_matrix() fills an n1 x n2 matrix of geodesic distances in
+    square tiles of MATRIX_TILE x MATRIX_TILE entries. The tiles are the
+    units of work handed to the threads, and keep the coordinates of both
+    sides of a tile in cache while it is filled.
+
+    geod_knn() finds the k points of a set nearest to each query point.
+    The straight line between two points on the ellipsoid is never longer
+    than the geodesic between them, so the chord, which costs a handful of
+    multiplications once the points are in cartesian form, is a lower
+    bound of the geodesic distance. The candidates are taken in order of
+    increasing chord, a batch at a time, and the exact geodesic is only
+    solved until the chord of the next candidate exceeds the k-th smallest
+    distance found so far. For clustered data that is a small fraction of
+    the set.
+
+    geod_polygonarea_batch() computes the areas of polygons given as one
+    flat array of vertices. Rings are cut into ranges of at most
+    POLYGON_RANGE vertices, each accumulated in its own geod_polygon, and
+    the ranges of a ring are then joined in order with geod_polygon_merge().
+    Many small polygons and a single huge one thus spread over the threads
+    alike.
+
+    All of them split their work over threads when libproj is built with thread
+    support. Each thread only reads the geod_geodesic and the inputs, and
+    writes its own part of the output, so the results do not depend on the
+    number of threads.
+
+*****************************************************************************/
+
+#include <math.h>
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "proj_internal.h"
+#include "geodesic.h"
+#include "parallel.hpp"
+
+/* Side of the tiles of the distance matrix */
+#define MATRIX_TILE 64
+
+/* Geodesics per task of the direct and inverse batches */
+#define BATCH_CHUNK 256
+
+/* Largest number of vertices of a ring accumulated as one piece */
+#define POLYGON_RANGE 4096
+
+/* Tolerance on the chord, as a lower bound, for the rounding of both it and */
+/* the geodesic distances (meters)                                            */
+#define CHORD_SLACK 1e-6
+
+namespace {
+
+struct Cartesian {
+    double x, y, z;
+};
+
+/* Point on the ellipsoid, in meters from its centre */
+Cartesian cartesian(const struct geod_geodesic *g, double lat, double lon) {
+    double e2 = g->f * (2 - g->f);
+    double sinphi = sin(lat * DEG_TO_RAD), cosphi = cos(lat * DEG_TO_RAD);
+    double N = g->a / sqrt(1 - e2 * sinphi * sinphi);
+    Cartesian c;
+    c.x = N * cosphi * cos(lon * DEG_TO_RAD);
+    c.y = N * cosphi * sin(lon * DEG_TO_RAD);
+    c.z = N * (1 - e2) * sinphi;
+    return c;
+}
+
+double chord(const Cartesian &p, const Cartesian &q) {
+    double dx = p.x - q.x, dy = p.y - q.y, dz = p.z - q.z;
+    return sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+typedef std::pair<double, int> Neighbour; /* distance, index */
+
+/* The k nearest of points to (qlat, qlon), with their distances, in order */
+void knn_query(const struct geod_geodesic *g, const double lat[],
+               const double lon[], const std::vector<Cartesian> &points,
+               double qlat, double qlon, int k, int idx[], double s12[],
+               std::vector<Neighbour> &candidates,
+               std::vector<Neighbour> &best) {
+    const int n = static_cast<int>(points.size());
+    const Cartesian q = cartesian(g, qlat, qlon);
+
+    candidates.resize(n);
+    for (int j = 0; j < n; j++)
+        candidates[j] = Neighbour(chord(q, points[j]), j);
+
+    /* best is a max-heap of the k nearest so far */
+    best.clear();
+    const int batch = 2 * k + 16;
+    for (int begin = 0; begin < n;) {
+        int end = std::min(n, begin + batch);
+        if (end < n)
+            std::nth_element(candidates.begin() + begin,
+                             candidates.begin() + end, candidates.end());
+        std::sort(candidates.begin() + begin, candidates.begin() + end);
+
+        for (; begin < end; begin++) {
+            const Neighbour &c = candidates[begin];
+            if (static_cast<int>(best.size()) == k &&
+                c.first - CHORD_SLACK > best.front().first)
+                break;
+            double s;
+            geod_inverse(g, qlat, qlon, lat[c.second], lon[c.second], &s,
+                         nullptr, nullptr);
+            Neighbour b(s, c.second);
+            if (static_cast<int>(best.size()) < k) {
+                best.push_back(b);
+                std::push_heap(best.begin(), best.end());
+            } else if (b < best.front()) {
+                std::pop_heap(best.begin(), best.end());
+                best.back() = b;
+                std::push_heap(best.begin(), best.end());
+            }
+        }
+        if (begin < end)
+            break;
+    }
+
+    std::sort_heap(best.begin(), best.end());
+    for (int i = 0; i < k; i++) {
+        bool found = i < static_cast<int>(best.size());
+        idx[i] = found ? best[i].second : -1;
+        s12[i] = found ? best[i].first : HUGE_VAL;
+    }
+}
+
+} // namespace
+
+/*****************************************************************************/
+void geod_direct_batch(const struct geod_geodesic *g, const double lat1[],
+                       const double lon1[], const double azi1[],
+                       const double s12[], int n, double lat2[],
+                       double lon2[], double azi2[], int nthreads) {
+    /*************************************************************************/
+    const unsigned outmask = (lat2 ? GEOD_LATITUDE : GEOD_NONE) |
+                             (lon2 ? GEOD_LONGITUDE : GEOD_NONE) |
+                             (azi2 ? GEOD_AZIMUTH : GEOD_NONE);
+    if (n <= 0)
+        return;
+
+    pj_run_parallel(nthreads, (n + BATCH_CHUNK - 1) / BATCH_CHUNK,
+                    [&](int task) {
+        struct geod_geodesicline l;
+        int i0 = task * BATCH_CHUNK, i1 = std::min(n, i0 + BATCH_CHUNK);
+        for (int i = i0; i < i1; i++) {
+            /* Start a new line unless point 1 and azi1 are those of the */
+            /* last one                                                  */
+            if (i == i0 || lat1[i] != lat1[i - 1] || lon1[i] != lon1[i - 1] ||
+                azi1[i] != azi1[i - 1])
+                geod_lineinit(&l, g, lat1[i], lon1[i], azi1[i],
+                              outmask | GEOD_DISTANCE_IN);
+            geod_genposition(&l, GEOD_NOFLAGS, s12[i],
+                             lat2 ? lat2 + i : nullptr,
+                             lon2 ? lon2 + i : nullptr,
+                             azi2 ? azi2 + i : nullptr, nullptr, nullptr,
+                             nullptr, nullptr, nullptr);
+        }
+    });
+}
+
+/*****************************************************************************/
+void geod_inverse_batch(const struct geod_geodesic *g, const double lat1[],
+                        const double lon1[], const double lat2[],
+                        const double lon2[], int n, double s12[],
+                        double azi1[], double azi2[], int nthreads) {
+    /*************************************************************************/
+    if (n <= 0)
+        return;
+
+    pj_run_parallel(nthreads, (n + BATCH_CHUNK - 1) / BATCH_CHUNK,
+                    [&](int task) {
+        int i0 = task * BATCH_CHUNK, i1 = std::min(n, i0 + BATCH_CHUNK);
+        for (int i = i0; i < i1; i++)
+            geod_inverse(g, lat1[i], lon1[i], lat2[i], lon2[i],
+                         s12 ? s12 + i : nullptr, azi1 ? azi1 + i : nullptr,
+                         azi2 ? azi2 + i : nullptr);
+    });
+}
+
+/*****************************************************************************/
+void geod_distance_matrix(const struct geod_geodesic *g, const double lat1[],
+                          const double lon1[], int n1, const double lat2[],
+                          const double lon2[], int n2, double s12[],
+                          int nthreads) {
+    /*************************************************************************/
+    if (n1 <= 0 || n2 <= 0)
+        return;
+    const int rows = (n1 + MATRIX_TILE - 1) / MATRIX_TILE;
+    const int cols = (n2 + MATRIX_TILE - 1) / MATRIX_TILE;
+
+    pj_run_parallel(nthreads, rows * cols, [&](int tile) {
+        int i0 = (tile / cols) * MATRIX_TILE, j0 = (tile % cols) * MATRIX_TILE;
+        int i1 = std::min(n1, i0 + MATRIX_TILE);
+        int j1 = std::min(n2, j0 + MATRIX_TILE);
+        for (int i = i0; i < i1; i++)
+            for (int j = j0; j < j1; j++)
+                geod_inverse(g, lat1[i], lon1[i], lat2[j], lon2[j],
+                             s12 + static_cast<size_t>(i) * n2 + j, nullptr,
+                             nullptr);
+    });
+}
+
+/*****************************************************************************/
+int geod_knn(const struct geod_geodesic *g, const double lat[],
+             const double lon[], int n, const double qlat[],
+             const double qlon[], int nq, int k, int idx[], double s12[],
+             int nthreads) {
+    /*************************************************************************/
+    if (nq <= 0 || k <= 0)
+        return 0;
+    if (n < 0)
+        n = 0;
+
+    /* Queries per task: enough to amortize the scratch space */
+    const int chunk = 16;
+    std::vector<Cartesian> points;
+    std::atomic<bool> failed(false);
+    try {
+        points.resize(n);
+    } catch (const std::bad_alloc &) {
+        return 1;
+    }
+    for (int j = 0; j < n; j++)
+        points[j] = cartesian(g, lat[j], lon[j]);
+
+    pj_run_parallel(nthreads, (nq + chunk - 1) / chunk, [&](int task) {
+        std::vector<Neighbour> candidates, best;
+        int i1 = std::min(nq, (task + 1) * chunk);
+        try {
+            best.reserve(k);
+            for (int i = task * chunk; i < i1; i++)
+                knn_query(g, lat, lon, points, qlat[i], qlon[i], k,
+                          idx + static_cast<size_t>(i) * k,
+                          s12 + static_cast<size_t>(i) * k, candidates, best);
+        } catch (const std::bad_alloc &) {
+            failed = true;
+        }
+    });
+    return failed ? 1 : 0;
+}
+
+/*****************************************************************************/
+int geod_polygonarea_batch(const struct geod_geodesic *g, const double lats[],
+                           const double lons[], const int offsets[], int n,
+                           double A[], double P[], int nthreads) {
+    /*************************************************************************/
+    if (n <= 0)
+        return 0;
+
+    /* The pieces of polygon i are first[i] up to first[i + 1] */
+    std::vector<int> first;
+    std::vector<struct geod_polygon> pieces;
+    try {
+        first.resize(n + 1);
+        int count = 0;
+        for (int i = 0; i < n; i++) {
+            first[i] = count;
+            int m = offsets[i + 1] - offsets[i];
+            count += m > 0 ? (m + POLYGON_RANGE - 1) / POLYGON_RANGE : 1;
+        }
+        first[n] = count;
+        pieces.resize(count);
+    } catch (const std::bad_alloc &) {
+        return 1;
+    }
+
+    /* Accumulate the pieces, then merge and close the rings */
+    pj_run_parallel(nthreads, first[n], [&](int j) {
+        int i = static_cast<int>(
+            std::upper_bound(first.begin(), first.end(), j) - first.begin() - 1);
+        int k = offsets[i] + (j - first[i]) * POLYGON_RANGE;
+        int end = std::min(offsets[i + 1], k + POLYGON_RANGE);
+        geod_polygon_init(&pieces[j], 0);
+        for (; k < end; k++)
+            geod_polygon_addpoint(g, &pieces[j], lats[k], lons[k]);
+    });
+    pj_run_parallel(nthreads, n, [&](int i) {
+        struct geod_polygon &p = pieces[first[i]];
+        for (int j = first[i] + 1; j < first[i + 1]; j++)
+            geod_polygon_merge(g, &p, &pieces[j]);
+        geod_polygon_compute(g, &p, 0, 1, A ? A + i : nullptr,
+                             P ? P + i : nullptr);
+    });
+    return 0;
+}
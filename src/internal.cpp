@@ -136,6 +136,20 @@ Check if a a PJ has an inverse.
              ( P->inv || P->inv3d || P->inv4d) );
 }
 
+/**************************************************************************************/
+void pj_affine_map_set_identity (PJ_AFFINE_MAP *A) {
+/***************************************************************************************
+Reset an affine map to the identity, as a starting point for get_affine_map.
+***************************************************************************************/
+    int i, j;
+    for (i = 0;  i < 4;  i++) {
+        for (j = 0;  j < 4;  j++)
+            A->m[i][j] = (i == j) ? 1.0 : 0.0;
+        A->offset[i] = 0.0;
+        A->zero_sign[i] = 0;
+    }
+}
+
 
 /* Move P to a new context - or to the default context if 0 is specified */
 void proj_context_set (PJ *P, PJ_CONTEXT *ctx) {
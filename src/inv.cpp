@@ -29,6 +29,7 @@
  *****************************************************************************/
 #include <errno.h>
 #include <math.h>
+#include <string.h>
 
 #include "proj_internal.h"
 #include "proj_math.h"
@@ -37,98 +38,218 @@
 #define INPUT_UNITS  P->right
 #define OUTPUT_UNITS P->left
 
-static PJ_COORD inv_prepare (PJ *P, PJ_COORD coo) {
-    if (coo.v[0] == HUGE_VAL || coo.v[1] == HUGE_VAL || coo.v[2] == HUGE_VAL) {
+/*****************************************************************************
+
+    Stages of the inverse preparation and finalization. Which of them a PJ
+    needs is fixed once its setup is complete, so inv_plan_compile() picks
+    them once, and pj_inv/pj_inv3d/pj_inv4d only run the selected ones.
+
+******************************************************************************/
+
+static int prepare_check_input (PJ *P, PJ_COORD *coo) {
+    if (coo->v[0] == HUGE_VAL || coo->v[1] == HUGE_VAL || coo->v[2] == HUGE_VAL) {
         proj_errno_set (P, PJD_ERR_INVALID_X_OR_Y);
-        return proj_coord_error ();
+        *coo = proj_coord_error ();
+        return 0;
     }
+    return 1;
+}
 
-    /* The helmert datum shift will choke unless it gets a sensible 4D coordinate */
-    if (HUGE_VAL==coo.v[2] && P->helmert) coo.v[2] = 0.0;
-    if (HUGE_VAL==coo.v[3] && P->helmert) coo.v[3] = 0.0;
-
-    if (P->axisswap)
-        coo = proj_trans (P->axisswap, PJ_INV, coo);
-
-    /* Handle remaining possible input types */
-    switch (INPUT_UNITS) {
-    case PJ_IO_UNITS_WHATEVER:
-        return coo;
-
-    /* de-scale and de-offset */
-    case PJ_IO_UNITS_CARTESIAN:
-        coo.xyz.x *= P->to_meter;
-        coo.xyz.y *= P->to_meter;
-        coo.xyz.z *= P->to_meter;
-        if (P->is_geocent) {
-            coo = proj_trans (P->cart, PJ_INV, coo);
-        }
 
-        return coo;
-
-    case PJ_IO_UNITS_PROJECTED:
-    case PJ_IO_UNITS_CLASSIC:
-        coo.xyz.x = P->to_meter  * coo.xyz.x - P->x0;
-        coo.xyz.y = P->to_meter  * coo.xyz.y - P->y0;
-        coo.xyz.z = P->vto_meter * coo.xyz.z - P->z0;
-        if (INPUT_UNITS==PJ_IO_UNITS_PROJECTED)
-            return coo;
-
-        /* Classic proj.4 functions expect plane coordinates in units of the semimajor axis  */
-        /* Multiplying by ra, rather than dividing by a because the CalCOFI projection       */
-        /* stomps on a and hence (apparently) depends on this to roundtrip correctly         */
-        /* (CalCOFI avoids further scaling by stomping - but a better solution is possible)  */
-        coo.xyz.x *= P->ra;
-        coo.xyz.y *= P->ra;
-        return coo;
-
-    case PJ_IO_UNITS_RADIANS:
-        coo.lpz.z = P->vto_meter * coo.lpz.z - P->z0;
-        break;
-    }
+/* The helmert datum shift will choke unless it gets a sensible 4D coordinate */
+static int prepare_helmert_defaults (PJ *P, PJ_COORD *coo) {
+    (void) P;
+    if (HUGE_VAL==coo->v[2]) coo->v[2] = 0.0;
+    if (HUGE_VAL==coo->v[3]) coo->v[3] = 0.0;
+    return 1;
+}
+
+
+static int prepare_axisswap (PJ *P, PJ_COORD *coo) {
+    *coo = proj_trans (P->axisswap, PJ_INV, *coo);
+    return 1;
+}
+
+
+/* de-scale cartesian input */
+static int prepare_cartesian_units (PJ *P, PJ_COORD *coo) {
+    coo->xyz.x *= P->to_meter;
+    coo->xyz.y *= P->to_meter;
+    coo->xyz.z *= P->to_meter;
+    return 1;
+}
+
+
+static int prepare_geocent (PJ *P, PJ_COORD *coo) {
+    *coo = proj_trans (P->cart, PJ_INV, *coo);
+    return 1;
+}
+
+
+/* de-scale and de-offset */
+static int prepare_projected_units (PJ *P, PJ_COORD *coo) {
+    coo->xyz.x = P->to_meter  * coo->xyz.x - P->x0;
+    coo->xyz.y = P->to_meter  * coo->xyz.y - P->y0;
+    coo->xyz.z = P->vto_meter * coo->xyz.z - P->z0;
+    return 1;
+}
 
-    /* Should not happen, so we could return pj_coord_err here */
-    return coo;
+
+/* Classic proj.4 functions expect plane coordinates in units of the semimajor axis  */
+/* Multiplying by ra, rather than dividing by a because the CalCOFI projection       */
+/* stomps on a and hence (apparently) depends on this to roundtrip correctly         */
+/* (CalCOFI avoids further scaling by stomping - but a better solution is possible)  */
+static int prepare_classic_units (PJ *P, PJ_COORD *coo) {
+    coo->xyz.x *= P->ra;
+    coo->xyz.y *= P->ra;
+    return 1;
 }
 
 
+static int prepare_angular_height (PJ *P, PJ_COORD *coo) {
+    coo->lpz.z = P->vto_meter * coo->lpz.z - P->z0;
+    return 1;
+}
+
 
-static PJ_COORD inv_finalize (PJ *P, PJ_COORD coo) {
-    if (coo.xyz.x == HUGE_VAL) {
+static int finalize_check_output (PJ *P, PJ_COORD *coo) {
+    if (coo->xyz.x == HUGE_VAL) {
         proj_errno_set (P, PJD_ERR_INVALID_X_OR_Y);
-        return proj_coord_error ();
+        *coo = proj_coord_error ();
+        return 0;
     }
+    return 1;
+}
+
+
+/* Distance from central meridian, taking system zero meridian into account */
+static int finalize_central_meridian (PJ *P, PJ_COORD *coo) {
+    coo->lp.lam = coo->lp.lam + P->from_greenwich + P->lam0;
+    return 1;
+}
+
+
+/* adjust longitude to central meridian */
+static int finalize_adjlon (PJ *P, PJ_COORD *coo) {
+    (void) P;
+    coo->lpz.lam = adjlon(coo->lpz.lam);
+    return 1;
+}
 
-    if (OUTPUT_UNITS==PJ_IO_UNITS_RADIANS) {
-
-        /* Distance from central meridian, taking system zero meridian into account */
-        coo.lp.lam = coo.lp.lam + P->from_greenwich + P->lam0;
-
-        /* adjust longitude to central meridian */
-        if (0==P->over)
-            coo.lpz.lam = adjlon(coo.lpz.lam);
-
-        if (P->vgridshift)
-            coo = proj_trans (P->vgridshift, PJ_INV, coo); /* Go geometric from orthometric */
-        if (coo.lp.lam==HUGE_VAL)
-            return coo;
-        if (P->hgridshift)
-            coo = proj_trans (P->hgridshift, PJ_FWD, coo);
-        else if (P->helmert || (P->cart_wgs84 != nullptr && P->cart != nullptr)) {
-            coo = proj_trans (P->cart,       PJ_FWD, coo); /* Go cartesian in local frame */
-            if( P->helmert )
-                coo = proj_trans (P->helmert,    PJ_FWD, coo); /* Step into WGS84 */
-            coo = proj_trans (P->cart_wgs84, PJ_INV, coo); /* Go back to angular using WGS84 ellps */
-        }
-        if (coo.lp.lam==HUGE_VAL)
-            return coo;
 
-        /* If input latitude was geocentrical, convert back to geocentrical */
-        if (P->geoc)
-            coo = pj_geocentric_latitude (P, PJ_FWD, coo);
+static int finalize_vgridshift (PJ *P, PJ_COORD *coo) {
+    *coo = proj_trans (P->vgridshift, PJ_INV, *coo); /* Go geometric from orthometric */
+    return coo->lp.lam != HUGE_VAL;
+}
+
+
+static int finalize_hgridshift (PJ *P, PJ_COORD *coo) {
+    *coo = proj_trans (P->hgridshift, PJ_FWD, *coo);
+    return coo->lp.lam != HUGE_VAL;
+}
+
+
+static int finalize_datum_shift (PJ *P, PJ_COORD *coo) {
+    *coo = proj_trans (P->cart,       PJ_FWD, *coo); /* Go cartesian in local frame */
+    if( P->helmert )
+        *coo = proj_trans (P->helmert,    PJ_FWD, *coo); /* Step into WGS84 */
+    *coo = proj_trans (P->cart_wgs84, PJ_INV, *coo); /* Go back to angular using WGS84 ellps */
+    return coo->lp.lam != HUGE_VAL;
+}
+
+
+/* If input latitude was geocentrical, convert back to geocentrical */
+static int finalize_geocentric_latitude (PJ *P, PJ_COORD *coo) {
+    *coo = pj_geocentric_latitude (P, PJ_FWD, *coo);
+    return 1;
+}
+
+
+static void inv_plan_compile (PJ *P) {
+    PJ_IO_PLAN *plan = &P->inv_plan;
+    int n = 0;
+
+    if (!P->skip_inv_prepare) {
+        plan->prepare[n++] = prepare_check_input;
+        if (P->helmert)
+            plan->prepare[n++] = prepare_helmert_defaults;
+        if (P->axisswap)
+            plan->prepare[n++] = prepare_axisswap;
+
+        switch (INPUT_UNITS) {
+        case PJ_IO_UNITS_WHATEVER:
+            break;
+        case PJ_IO_UNITS_CARTESIAN:
+            /* scaling by 1 is exact, so it can be skipped altogether */
+            if (P->to_meter != 1.0)
+                plan->prepare[n++] = prepare_cartesian_units;
+            if (P->is_geocent)
+                plan->prepare[n++] = prepare_geocent;
+            break;
+        case PJ_IO_UNITS_PROJECTED:
+            /* scaling by 1 and subtracting zero leave any value, -0 included, as it is */
+            if (P->to_meter != 1.0 || P->vto_meter != 1.0 ||
+                P->x0 != 0.0 || P->y0 != 0.0 || P->z0 != 0.0)
+                plan->prepare[n++] = prepare_projected_units;
+            break;
+        case PJ_IO_UNITS_CLASSIC:
+            plan->prepare[n++] = prepare_projected_units;
+            plan->prepare[n++] = prepare_classic_units;
+            break;
+        case PJ_IO_UNITS_RADIANS:
+            if (P->vto_meter != 1.0 || P->z0 != 0.0)
+                plan->prepare[n++] = prepare_angular_height;
+            break;
+        }
+    }
+    plan->n_prepare = n;
+
+    n = 0;
+    if (!P->skip_inv_finalize) {
+        plan->finalize[n++] = finalize_check_output;
+        if (OUTPUT_UNITS==PJ_IO_UNITS_RADIANS) {
+            /* even when both are zero: adding them turns -0 into 0 */
+            plan->finalize[n++] = finalize_central_meridian;
+            if (0==P->over)
+                plan->finalize[n++] = finalize_adjlon;
+            if (P->vgridshift)
+                plan->finalize[n++] = finalize_vgridshift;
+            if (P->hgridshift)
+                plan->finalize[n++] = finalize_hgridshift;
+            else if (P->helmert || (P->cart_wgs84 != nullptr && P->cart != nullptr))
+                plan->finalize[n++] = finalize_datum_shift;
+            if (P->geoc)
+                plan->finalize[n++] = finalize_geocentric_latitude;
+        }
+    }
+    plan->n_finalize = n;
+
+    plan->checks_only = 1;
+    for (int i = 0;  i < plan->n_prepare;  i++)
+        if (plan->prepare[i] != prepare_check_input)
+            plan->checks_only = 0;
+    for (int i = 0;  i < plan->n_finalize;  i++) {
+        /* Adding a zero central meridian only turns -0 into 0 */
+        if (plan->finalize[i] == finalize_central_meridian &&
+            P->from_greenwich == 0.0 && P->lam0 == 0.0)
+            plan->zero_sign[0] = 1;
+        else if (plan->finalize[i] != finalize_check_output)
+            plan->checks_only = 0;
     }
 
-    return coo;
+    plan->compiled = 1;
+}
+
+
+/*****************************************************************************/
+const PJ_IO_PLAN *pj_inv_plan (PJ *P) {
+/******************************************************************************
+    Return the inverse preparation/finalization plan of P, compiling it on
+    first use. P must be fully set up at that point.
+******************************************************************************/
+    if (!P->inv_plan.compiled)
+        inv_plan_compile (P);
+    return &P->inv_plan;
 }
 
 
@@ -143,13 +264,14 @@ static PJ_COORD error_or_coord(PJ *P, PJ_COORD coord, int last_errno) {
 
 PJ_LP pj_inv(PJ_XY xy, PJ *P) {
     int last_errno;
+    const PJ_IO_PLAN *plan;
     PJ_COORD coo = {{0,0,0,0}};
     coo.xy = xy;
 
     last_errno = proj_errno_reset(P);
 
-    if (!P->skip_inv_prepare)
-        coo = inv_prepare (P, coo);
+    plan = pj_inv_plan (P);
+    coo = pj_io_plan_run (P, plan->prepare, plan->n_prepare, coo);
     if (HUGE_VAL==coo.v[0])
         return proj_coord_error ().lp;
 
@@ -167,8 +289,7 @@ PJ_LP pj_inv(PJ_XY xy, PJ *P) {
     if (HUGE_VAL==coo.v[0])
         return proj_coord_error ().lp;
 
-    if (!P->skip_inv_finalize)
-        coo = inv_finalize (P, coo);
+    coo = pj_io_plan_run (P, plan->finalize, plan->n_finalize, coo);
 
     return error_or_coord(P, coo, last_errno).lp;
 }
@@ -177,13 +298,14 @@ PJ_LP pj_inv(PJ_XY xy, PJ *P) {
 
 PJ_LPZ pj_inv3d (PJ_XYZ xyz, PJ *P) {
     int last_errno;
+    const PJ_IO_PLAN *plan;
     PJ_COORD coo = {{0,0,0,0}};
     coo.xyz = xyz;
 
     last_errno = proj_errno_reset(P);
 
-    if (!P->skip_inv_prepare)
-        coo = inv_prepare (P, coo);
+    plan = pj_inv_plan (P);
+    coo = pj_io_plan_run (P, plan->prepare, plan->n_prepare, coo);
     if (HUGE_VAL==coo.v[0])
         return proj_coord_error ().lpz;
 
@@ -201,8 +323,7 @@ PJ_LPZ pj_inv3d (PJ_XYZ xyz, PJ *P) {
     if (HUGE_VAL==coo.v[0])
         return proj_coord_error ().lpz;
 
-    if (!P->skip_inv_finalize)
-        coo = inv_finalize (P, coo);
+    coo = pj_io_plan_run (P, plan->finalize, plan->n_finalize, coo);
 
     return error_or_coord(P, coo, last_errno).lpz;
 }
@@ -211,9 +332,9 @@ PJ_LPZ pj_inv3d (PJ_XYZ xyz, PJ *P) {
 
 PJ_COORD pj_inv4d (PJ_COORD coo, PJ *P) {
     int last_errno = proj_errno_reset(P);
+    const PJ_IO_PLAN *plan = pj_inv_plan (P);
 
-    if (!P->skip_inv_prepare)
-        coo = inv_prepare (P, coo);
+    coo = pj_io_plan_run (P, plan->prepare, plan->n_prepare, coo);
     if (HUGE_VAL==coo.v[0])
         return proj_coord_error ();
 
@@ -231,8 +352,75 @@ PJ_COORD pj_inv4d (PJ_COORD coo, PJ *P) {
     if (HUGE_VAL==coo.v[0])
         return proj_coord_error ();
 
-    if (!P->skip_inv_finalize)
-        coo = inv_finalize (P, coo);
+    coo = pj_io_plan_run (P, plan->finalize, plan->n_finalize, coo);
 
     return error_or_coord(P, coo, last_errno);
 }
+
+
+
+/*****************************************************************************/
+int pj_inv_array (PJ *P, size_t n, PJ_COORD *coord) {
+/******************************************************************************
+    Inverse transform an array of coordinates through the inv3d_batch or
+    inv_batch kernel of P,
+    with the outcome of proj_trans_array(): the same coordinates and
+    errors as pj_inv4d() one by one, stopping at the first error. P must
+    not have a 4D kernel, nor a 3D kernel without a 3D batch kernel.
+
+    The preparation and finalization run per coordinate, and the kernel
+    gets chunks of PJ_BATCH_SIZE. A chunk where an error shows up is
+    restored and redone one coordinate at a time, so errors, which are
+    rare, stop at the right place.
+******************************************************************************/
+    const PJ_IO_PLAN *plan = pj_inv_plan (P);
+    PJ_COORD saved[PJ_BATCH_SIZE];
+    double a[PJ_BATCH_SIZE], b[PJ_BATCH_SIZE], z[PJ_BATCH_SIZE];
+    int last_errno = proj_errno_reset (P);
+    size_t i, k, m;
+
+    for (k = 0;  k < n;  k += m) {
+        PJ_COORD *c = coord + k;
+        m = (n - k < PJ_BATCH_SIZE) ? n - k : PJ_BATCH_SIZE;
+        memcpy (saved, c, m * sizeof (PJ_COORD));
+
+        for (i = 0;  i < m;  i++) {
+            c[i] = pj_io_plan_run (P, plan->prepare, plan->n_prepare, c[i]);
+            /* The kernel gets zeros where the preparation failed */
+            a[i] = HUGE_VAL==c[i].v[0] ? 0 : c[i].xy.x;
+            b[i] = HUGE_VAL==c[i].v[0] ? 0 : c[i].xy.y;
+            z[i] = HUGE_VAL==c[i].v[0] ? 0 : c[i].v[2];
+        }
+
+        if (0==proj_errno (P)) {
+            if (nullptr!=P->inv3d_batch)
+                P->inv3d_batch (P, m, a, b, z);
+            else
+                P->inv_batch (P, m, a, b);
+            for (i = 0;  i < m;  i++) {
+                if (HUGE_VAL==c[i].v[0] || HUGE_VAL==a[i]) {
+                    c[i] = proj_coord_error ();
+                    continue;
+                }
+                c[i].lp.lam = a[i];
+                c[i].lp.phi = b[i];
+                if (nullptr!=P->inv3d_batch)
+                    c[i].v[2] = z[i];
+                c[i] = pj_io_plan_run (P, plan->finalize, plan->n_finalize, c[i]);
+            }
+        }
+        if (0==proj_errno (P))
+            continue;
+
+        proj_errno_reset (P);
+        memcpy (c, saved, m * sizeof (PJ_COORD));
+        for (i = 0;  i < m;  i++) {
+            c[i] = pj_inv4d (c[i], P);
+            if (proj_errno (P))
+                return proj_errno (P);
+        }
+    }
+
+    proj_errno_restore (P, last_errno);
+    return 0;
+}
@@ -255,6 +255,68 @@ const char *proj_context_get_database_metadata(PJ_CONTEXT *ctx,
 
 // ---------------------------------------------------------------------------
 
+/** \brief Enable or disable the cache of objects built from user input.
+ *
+ * When enabled, proj_create() and proj_create_from_wkt() on a WKT or PROJ
+ * string that has already been parsed with the same options return the
+ * previously built object instead of parsing the text again.
+ *
+ * The cache is attached to the database of the context, and is thus reset
+ * when proj_context_set_database_path() is called.
+ *
+ * @param ctx PROJ context, or NULL for default context
+ * @param max_entries Maximum number of cached objects, or 0 to disable the
+ * cache (default)
+ * @return TRUE in case of success
+ */
+int proj_context_set_user_input_cache_size(PJ_CONTEXT *ctx,
+                                           size_t max_entries) {
+    SANITIZE_CTX(ctx);
+    try {
+        getDBcontext(ctx)->setUserInputCacheSize(max_entries);
+        return true;
+    } catch (const std::exception &e) {
+        proj_log_error(ctx, __FUNCTION__, e.what());
+        return false;
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+/** \brief Return the number of hits and misses of the cache of objects built
+ * from user input.
+ *
+ * Counters are reset by proj_context_set_user_input_cache_size().
+ *
+ * @param ctx PROJ context, or NULL for default context
+ * @param out_hits Pointer to the number of lookups served from the cache, or
+ * NULL
+ * @param out_misses Pointer to the number of lookups that required a full
+ * parse, or NULL
+ * @return TRUE in case of success
+ */
+int proj_context_get_user_input_cache_stats(PJ_CONTEXT *ctx, size_t *out_hits,
+                                            size_t *out_misses) {
+    SANITIZE_CTX(ctx);
+    try {
+        size_t hits = 0;
+        size_t misses = 0;
+        getDBcontext(ctx)->getUserInputCacheStatistics(hits, misses);
+        if (out_hits) {
+            *out_hits = hits;
+        }
+        if (out_misses) {
+            *out_misses = misses;
+        }
+        return true;
+    } catch (const std::exception &e) {
+        proj_log_error(ctx, __FUNCTION__, e.what());
+        return false;
+    }
+}
+
+// ---------------------------------------------------------------------------
+
 /** \brief Guess the "dialect" of the WKT string.
  *
  * @param ctx PROJ context, or NULL for default context
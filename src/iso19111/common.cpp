@@ -829,6 +829,10 @@ bool IdentifiedObject::_isEquivalentTo(
 bool IdentifiedObject::_isEquivalentTo(const IdentifiedObject *otherIdObj,
                                        util::IComparable::Criterion criterion)
     PROJ_PURE_DEFN {
+    if (&nameStr() == &otherIdObj->nameStr()) {
+        // Shared name identifier, as done by AuthorityFactory
+        return true;
+    }
     if (criterion == util::IComparable::Criterion::STRICT) {
         if (!ci_equal(nameStr(), otherIdObj->nameStr())) {
             return false;
@@ -6178,9 +6178,7 @@ TransformationNNPtr Transformation::create(
         accuracies);
     conv->assignSelf(conv);
     conv->setProperties(properties);
-    std::string name;
-    if (properties.getStringValue(common::IdentifiedObject::NAME_KEY, name) &&
-        ci_find(name, "ballpark") != std::string::npos) {
+    if (ci_find(conv->nameStr(), "ballpark") != std::string::npos) {
         conv->setHasBallparkTransformation(true);
     }
     return conv;
@@ -619,9 +619,56 @@ CRSNNPtr CRS::alterId(const std::string &authName,
  */
 std::list<std::pair<CRSNNPtr, int>>
 CRS::identify(const io::AuthorityFactoryPtr &authorityFactory) const {
-    return _identify(authorityFactory);
+    if (!authorityFactory) {
+        return _identify(authorityFactory);
+    }
+
+    // Bulk identification (typically of .prj files) tends to submit the
+    // same definitions over and over. Probe the database context for the
+    // result of a previous identification of an object with the same
+    // fingerprint before running the full database search.
+    const auto &dbContext = authorityFactory->databaseContext();
+    const std::string key(getIdentificationFingerprint(
+        authorityFactory->getAuthority()));
+    std::list<std::pair<CRSNNPtr, int>> res;
+    if (!key.empty() && dbContext->getCRSIdentificationFromCache(key, res)) {
+        return res;
+    }
+    res = _identify(authorityFactory);
+    if (!key.empty()) {
+        dbContext->cacheCRSIdentification(key, res);
+    }
+    return res;
+}
+
+// ---------------------------------------------------------------------------
+
+//! @cond Doxygen_Suppress
+
+// Return a string that captures everything _identify() depends on: the
+// authority of the factory, the hidden CRS flags, and a normalized WKT2
+// export of the object (numeric values rounded to 15 significant digits).
+// Return an empty string if the object cannot be exported.
+std::string
+CRS::getIdentificationFingerprint(const std::string &authority) const {
+    std::string key("identify:");
+    key += authority;
+    key += d->implicitCS_ ? "\n1\n" : "\n0\n";
+    key += d->extensionProj4_;
+    key += '\n';
+    try {
+        auto formatter = io::WKTFormatter::create(
+            io::WKTFormatter::Convention::WKT2_2018, nullptr);
+        formatter->setMultiLine(false);
+        key += exportToWKT(formatter.get());
+    } catch (const std::exception &) {
+        return std::string();
+    }
+    return key;
 }
 
+//! @endcond
+
 // ---------------------------------------------------------------------------
 
 /** \brief Return CRSs that are non-deprecated substitutes for the current CRS.
@@ -391,6 +391,9 @@ void PrimeMeridian::_exportToPROJString(
 bool PrimeMeridian::_isEquivalentTo(
     const util::IComparable *other,
     util::IComparable::Criterion criterion) const {
+    if (other == this) {
+        return true;
+    }
     auto otherPM = dynamic_cast<const PrimeMeridian *>(other);
     if (otherPM == nullptr ||
         !IdentifiedObject::_isEquivalentTo(other, criterion)) {
@@ -864,6 +867,9 @@ EllipsoidNNPtr Ellipsoid::identify() const {
 //! @cond Doxygen_Suppress
 bool Ellipsoid::_isEquivalentTo(const util::IComparable *other,
                                 util::IComparable::Criterion criterion) const {
+    if (other == this) {
+        return true;
+    }
     auto otherEllipsoid = dynamic_cast<const Ellipsoid *>(other);
     if (otherEllipsoid == nullptr ||
         (criterion == util::IComparable::Criterion::STRICT &&
@@ -1156,6 +1162,9 @@ void GeodeticReferenceFrame::_exportToWKT(
 bool GeodeticReferenceFrame::_isEquivalentTo(
     const util::IComparable *other,
     util::IComparable::Criterion criterion) const {
+    if (other == this) {
+        return true;
+    }
     auto otherGRF = dynamic_cast<const GeodeticReferenceFrame *>(other);
     if (otherGRF == nullptr || !Datum::_isEquivalentTo(other, criterion)) {
         return false;
@@ -53,6 +53,7 @@
 #include <memory>
 #include <sstream> // std::ostringstream
 #include <string>
+#include <unordered_map>
 
 #include "proj_constants.h"
 
@@ -226,6 +227,9 @@ struct DatabaseContext::Private {
     // cppcheck-suppress functionStatic
     void cache(const std::string &code, const GridInfoCache &info);
 
+    // cppcheck-suppress functionStatic
+    metadata::IdentifierNNPtr getInternedName(const std::string &name);
+
   private:
     friend class DatabaseContext;
 
@@ -251,6 +255,23 @@ struct DatabaseContext::Private {
     lru11::Cache<std::string, std::vector<operation::CoordinateOperationNNPtr>>
         cacheCRSToCrsCoordOp_{CACHE_SIZE};
     lru11::Cache<std::string, GridInfoCache> cacheGridInfo_{CACHE_SIZE};
+    lru11::Cache<std::string, std::list<std::pair<crs::CRSNNPtr, int>>>
+        cacheCRSIdentification_{CACHE_SIZE};
+
+    // Name identifiers shared by all the objects instantiated from the
+    // database, so that repeated names ("WGS 84", "unnamed", ...) are stored
+    // only once and can be compared by address.
+    std::unordered_map<std::string, metadata::IdentifierNNPtr>
+        mapInternedNames_{};
+
+    struct UserInputCacheEntry {
+        util::BaseObjectPtr obj{};
+        std::list<std::string> warnings{};
+    };
+    std::unique_ptr<lru11::Cache<std::string, UserInputCacheEntry>>
+        cacheUserInput_{};
+    size_t userInputCacheHits_ = 0;
+    size_t userInputCacheMisses_ = 0;
 
     static void insertIntoCache(LRUCacheOfObjects &cache,
                                 const std::string &code,
@@ -358,6 +379,21 @@ void DatabaseContext::Private::cache(
 
 // ---------------------------------------------------------------------------
 
+metadata::IdentifierNNPtr
+DatabaseContext::Private::getInternedName(const std::string &name) {
+    auto iter = mapInternedNames_.find(name);
+    if (iter != mapInternedNames_.end()) {
+        return iter->second;
+    }
+    auto id = metadata::Identifier::create(
+        std::string(),
+        util::PropertyMap().set(metadata::Identifier::DESCRIPTION_KEY, name));
+    mapInternedNames_.emplace(name, id);
+    return id;
+}
+
+// ---------------------------------------------------------------------------
+
 crs::CRSPtr DatabaseContext::Private::getCRSFromCache(const std::string &code) {
     util::BaseObjectPtr obj;
     getFromCache(cacheCRS_, code, obj);
@@ -929,8 +965,109 @@ const char *DatabaseContext::getMetadata(const char *key) const {
 
 // ---------------------------------------------------------------------------
 
+/** \brief Set the maximum number of entries of the user input cache.
+ *
+ * When enabled, the objects built by createFromUserInput() and
+ * WKTParser::createFromWKT() (when this database context is attached to the
+ * parser) from WKT and PROJ strings are memoized, keyed by the exact input
+ * text and the parser flags that may influence the result. Parsing again the
+ * same text then only costs a hash lookup. The returned objects are shared
+ * between callers, which is fine given that they are immutable.
+ *
+ * The cache uses a least-recently-used eviction policy.
+ *
+ * @param maxEntries Maximum number of cached objects, or 0 to disable the
+ * cache (default).
+ */
+void DatabaseContext::setUserInputCacheSize(size_t maxEntries) {
+    if (maxEntries == 0) {
+        d->cacheUserInput_.reset();
+    } else if (!d->cacheUserInput_ ||
+               d->cacheUserInput_->getMaxSize() != maxEntries) {
+        d->cacheUserInput_.reset(
+            new lru11::Cache<std::string, Private::UserInputCacheEntry>(
+                maxEntries, 0));
+    }
+    d->userInputCacheHits_ = 0;
+    d->userInputCacheMisses_ = 0;
+}
+
+// ---------------------------------------------------------------------------
+
+/** \brief Return the maximum number of entries of the user input cache, or 0
+ * if it is disabled.
+ */
+size_t DatabaseContext::getUserInputCacheSize() const {
+    return d->cacheUserInput_ ? d->cacheUserInput_->getMaxSize() : 0;
+}
+
+// ---------------------------------------------------------------------------
+
+/** \brief Return the number of hits and misses of the user input cache since
+ * it has been enabled with setUserInputCacheSize().
+ *
+ * @param hits Output number of lookups that returned a cached object.
+ * @param misses Output number of lookups that required a full parse.
+ */
+void DatabaseContext::getUserInputCacheStatistics(size_t &hits,
+                                                  size_t &misses) const {
+    hits = d->userInputCacheHits_;
+    misses = d->userInputCacheMisses_;
+}
+
+// ---------------------------------------------------------------------------
+
 //! @cond Doxygen_Suppress
 
+bool DatabaseContext::getFromUserInputCache(
+    const std::string &key, util::BaseObjectPtr &obj,
+    std::list<std::string> &warnings) const {
+    if (!d->cacheUserInput_) {
+        return false;
+    }
+    Private::UserInputCacheEntry entry;
+    if (!d->cacheUserInput_->tryGet(key, entry)) {
+        d->userInputCacheMisses_++;
+        return false;
+    }
+    d->userInputCacheHits_++;
+    obj = std::move(entry.obj);
+    warnings = std::move(entry.warnings);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+void DatabaseContext::insertIntoUserInputCache(
+    const std::string &key, const util::BaseObjectNNPtr &obj,
+    const std::list<std::string> &warnings) const {
+    if (!d->cacheUserInput_) {
+        return;
+    }
+    Private::UserInputCacheEntry entry;
+    entry.obj = obj.as_nullable();
+    entry.warnings = warnings;
+    d->cacheUserInput_->insert(key, entry);
+}
+
+// ---------------------------------------------------------------------------
+
+bool DatabaseContext::getCRSIdentificationFromCache(
+    const std::string &key,
+    std::list<std::pair<crs::CRSNNPtr, int>> &res) const {
+    return d->cacheCRSIdentification_.tryGet(key, res);
+}
+
+// ---------------------------------------------------------------------------
+
+void DatabaseContext::cacheCRSIdentification(
+    const std::string &key,
+    const std::list<std::pair<crs::CRSNNPtr, int>> &res) const {
+    d->cacheCRSIdentification_.insert(key, res);
+}
+
+// ---------------------------------------------------------------------------
+
 DatabaseContextNNPtr DatabaseContext::create(void *sqlite_handle) {
     auto ctxt = DatabaseContext::nn_make_shared<DatabaseContext>();
     ctxt->getPrivate()->setHandle(static_cast<sqlite3 *>(sqlite_handle));
@@ -1268,10 +1405,14 @@ AuthorityFactory::Private::createUnitOfMeasure(const std::string &auth_name,
 util::PropertyMap AuthorityFactory::Private::createProperties(
     const std::string &code, const std::string &name, bool deprecated,
     const metadata::ExtentPtr &extent) {
-    auto props = util::PropertyMap()
-                     .set(metadata::Identifier::CODESPACE_KEY, authority())
-                     .set(metadata::Identifier::CODE_KEY, code)
-                     .set(common::IdentifiedObject::NAME_KEY, name);
+    const auto nameId(context()->getPrivate()->getInternedName(name));
+    auto props =
+        util::PropertyMap()
+            .set(metadata::Identifier::CODESPACE_KEY, authority())
+            .set(metadata::Identifier::CODE_KEY, code)
+            .set(common::IdentifiedObject::NAME_KEY,
+                 NN_NO_CHECK(std::static_pointer_cast<util::BaseObject>(
+                     nameId.as_nullable())));
     if (deprecated) {
         props.set(common::IdentifiedObject::DEPRECATED_KEY, true);
     }
@@ -1496,7 +1637,7 @@ AuthorityFactory::createExtent(const std::string &code) const {
         if (row[1].empty()) {
             auto extent = metadata::Extent::create(
                 util::optional<std::string>(name), {}, {}, {});
-            d->context()->d->cache(code, extent);
+            d->context()->d->cache(cacheKey, extent);
             return extent;
         }
         double south_lat = c_locale_stod(row[1]);
@@ -1511,7 +1652,7 @@ AuthorityFactory::createExtent(const std::string &code) const {
             std::vector<metadata::GeographicExtentNNPtr>{bbox},
             std::vector<metadata::VerticalExtentNNPtr>(),
             std::vector<metadata::TemporalExtentNNPtr>());
-        d->context()->d->cache(code, extent);
+        d->context()->d->cache(cacheKey, extent);
         return extent;
 
     } catch (const std::exception &ex) {
@@ -2318,6 +2459,12 @@ AuthorityFactory::createConversion(const std::string &code) const {
 
 crs::ProjectedCRSNNPtr
 AuthorityFactory::createProjectedCRS(const std::string &code) const {
+    const auto cacheKey(d->authority() + code);
+    auto crs = std::dynamic_pointer_cast<crs::ProjectedCRS>(
+        d->context()->d->getCRSFromCache(cacheKey));
+    if (crs) {
+        return NN_NO_CHECK(crs);
+    }
     auto res = d->runWithCodeParam(
         "SELECT name, coordinate_system_auth_name, "
         "coordinate_system_code, geodetic_crs_auth_name, geodetic_crs_code, "
@@ -2397,8 +2544,10 @@ AuthorityFactory::createProjectedCRS(const std::string &code) const {
 
         auto cartesianCS = util::nn_dynamic_pointer_cast<cs::CartesianCS>(cs);
         if (cartesianCS) {
-            return crs::ProjectedCRS::create(props, baseCRS, conv,
-                                             NN_NO_CHECK(cartesianCS));
+            auto crsRet = crs::ProjectedCRS::create(props, baseCRS, conv,
+                                                    NN_NO_CHECK(cartesianCS));
+            d->context()->d->cache(cacheKey, crsRet);
+            return crsRet;
         }
         throw FactoryException("unsupported CS type for projectedCRS: " +
                                cs->getWKT2Type(true));
@@ -32,7 +32,10 @@
 
 #include "proj/internal/internal.hpp"
 
+#include <algorithm>
+#include <clocale>
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
 #ifdef _MSC_VER
 #include <string.h>
@@ -298,59 +301,109 @@ std::vector<std::string> split(const std::string &str, char separator) {
 
 // ---------------------------------------------------------------------------
 
+// Large enough for any %.17g formatted double
+constexpr int DOUBLE_BUF_SIZE = 32;
+
 #ifdef _WIN32
 
 // For some reason, sqlite3_snprintf() in the sqlite3 builds used on AppVeyor
 // doesn't round identically to the Unix builds, and thus breaks a number of
 // unit test. So to avoid this, use the stdlib formatting
 
-std::string toString(int val) {
+#ifdef _MSC_VER
+
+// std::ostringstream of the MSVC runtime ends up calling sprintf_s() with
+// the same format, so call it directly with a C locale, to avoid the cost
+// of constructing and imbuing a stream for each number.
+static _locale_t getCLocale() {
+    static _locale_t cLocale = _create_locale(LC_NUMERIC, "C");
+    return cLocale;
+}
+
+static void formatInt(char *szBuffer, int bufSize, int val) {
+    _snprintf_s_l(szBuffer, bufSize, _TRUNCATE, "%d", getCLocale(), val);
+}
+
+static void formatDouble(char *szBuffer, int bufSize, double val,
+                         int precision) {
+    _snprintf_s_l(szBuffer, bufSize, _TRUNCATE, "%.*g", getCLocale(),
+                  precision, val);
+}
+
+#else
+
+static void copyToBuffer(char *szBuffer, int bufSize, const std::string &str) {
+    const size_t len = std::min(str.size(), static_cast<size_t>(bufSize - 1));
+    memcpy(szBuffer, str.data(), len);
+    szBuffer[len] = 0;
+}
+
+static void formatInt(char *szBuffer, int bufSize, int val) {
     std::ostringstream buffer;
     buffer.imbue(std::locale::classic());
     buffer << val;
-    return buffer.str();
+    copyToBuffer(szBuffer, bufSize, buffer.str());
 }
 
-std::string toString(double val, int precision) {
+static void formatDouble(char *szBuffer, int bufSize, double val,
+                         int precision) {
     std::ostringstream buffer;
     buffer.imbue(std::locale::classic());
     buffer << std::setprecision(precision);
     buffer << val;
-    auto str = buffer.str();
-    if (precision == 15 && str.find("9999999999") != std::string::npos) {
-        buffer.str("");
-        buffer.clear();
-        buffer << std::setprecision(14);
-        buffer << val;
-        return buffer.str();
-    }
-    return str;
+    copyToBuffer(szBuffer, bufSize, buffer.str());
 }
 
+#endif
+
 #else
 
-std::string toString(int val) {
-    // use sqlite3 API that is slightly faster than std::ostringstream
-    // with forcing the C locale. sqlite3_snprintf() emulates a C locale.
+// use sqlite3 API that is slightly faster than std::ostringstream
+// with forcing the C locale. sqlite3_snprintf() emulates a C locale.
+
+static void formatInt(char *szBuffer, int bufSize, int val) {
+    sqlite3_snprintf(bufSize, szBuffer, "%d", val);
+}
+
+static void formatDouble(char *szBuffer, int bufSize, double val,
+                         int precision) {
+    sqlite3_snprintf(bufSize, szBuffer, "%.*g", precision, val);
+}
+
+#endif
+
+/** Append the representation of val to out, without intermediate string. */
+void appendToString(std::string &out, int val) {
     constexpr int BUF_SIZE = 16;
     char szBuffer[BUF_SIZE];
-    sqlite3_snprintf(BUF_SIZE, szBuffer, "%d", val);
-    return szBuffer;
+    formatInt(szBuffer, BUF_SIZE, val);
+    out += szBuffer;
 }
 
-std::string toString(double val, int precision) {
-    // use sqlite3 API that is slightly faster than std::ostringstream
-    // with forcing the C locale. sqlite3_snprintf() emulates a C locale.
-    constexpr int BUF_SIZE = 32;
-    char szBuffer[BUF_SIZE];
-    sqlite3_snprintf(BUF_SIZE, szBuffer, "%.*g", precision, val);
+/** Append the representation of val to out, without intermediate string.
+ *
+ * Same formatting rules as toString(double, int).
+ */
+void appendToString(std::string &out, double val, int precision) {
+    char szBuffer[DOUBLE_BUF_SIZE];
+    formatDouble(szBuffer, DOUBLE_BUF_SIZE, val, precision);
     if (precision == 15 && strstr(szBuffer, "9999999999")) {
-        sqlite3_snprintf(BUF_SIZE, szBuffer, "%.14g", val);
+        formatDouble(szBuffer, DOUBLE_BUF_SIZE, val, 14);
     }
-    return szBuffer;
+    out += szBuffer;
 }
 
-#endif
+std::string toString(int val) {
+    std::string res;
+    appendToString(res, val);
+    return res;
+}
+
+std::string toString(double val, int precision) {
+    std::string res;
+    appendToString(res, val, precision);
+    return res;
+}
 
 // ---------------------------------------------------------------------------
 
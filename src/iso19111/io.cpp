@@ -35,6 +35,7 @@
 #include <cctype>
 #include <cmath>
 #include <cstring>
+#include <iterator>
 #include <list>
 #include <locale>
 #include <map>
@@ -160,6 +161,7 @@ struct WKTFormatter::Private {
     void addIndentation();
     // cppcheck-suppress functionStatic
     void startNewChild();
+    void addQuotedString(const char *str, size_t len);
 };
 //! @endcond
 
@@ -349,7 +351,7 @@ void WKTFormatter::Private::addNewLine() { result_ += '\n'; }
 // ---------------------------------------------------------------------------
 
 void WKTFormatter::Private::addIndentation() {
-    result_ += std::string(indentLevel_ * params_.indentWidth_, ' ');
+    result_.append(indentLevel_ * params_.indentWidth_, ' ');
 }
 
 // ---------------------------------------------------------------------------
@@ -454,15 +456,35 @@ void WKTFormatter::Private::startNewChild() {
 
 // ---------------------------------------------------------------------------
 
+void WKTFormatter::Private::addQuotedString(const char *str, size_t len) {
+    // Double quotes are escaped by doubling them
+    result_ += '"';
+    while (true) {
+        const char *quote =
+            static_cast<const char *>(std::memchr(str, '"', len));
+        if (quote == nullptr) {
+            result_.append(str, len);
+            break;
+        }
+        const size_t count = static_cast<size_t>(quote - str) + 1;
+        result_.append(str, count);
+        result_ += '"';
+        str += count;
+        len -= count;
+    }
+    result_ += '"';
+}
+
+// ---------------------------------------------------------------------------
+
 void WKTFormatter::addQuotedString(const char *str) {
-    addQuotedString(std::string(str));
+    d->startNewChild();
+    d->addQuotedString(str, strlen(str));
 }
 
 void WKTFormatter::addQuotedString(const std::string &str) {
     d->startNewChild();
-    d->result_ += '"';
-    d->result_ += replaceAll(str, "\"", "\"\"");
-    d->result_ += '"';
+    d->addQuotedString(str.data(), str.size());
 }
 
 // ---------------------------------------------------------------------------
@@ -476,34 +498,28 @@ void WKTFormatter::add(const std::string &str) {
 
 void WKTFormatter::add(int number) {
     d->startNewChild();
-    d->result_ += internal::toString(number);
+    internal::appendToString(d->result_, number);
 }
 
 // ---------------------------------------------------------------------------
 
+// Fix in place the number serialized in str from offset start.
 #ifdef __MINGW32__
-static std::string normalizeExponent(const std::string &in) {
+static void normalizeExponent(std::string &str, size_t start) {
     // mingw will output 1e-0xy instead of 1e-xy. Fix that
-    auto pos = in.find("e-0");
+    auto pos = str.find("e-0", start);
     if (pos == std::string::npos) {
-        return in;
+        return;
     }
-    if (pos + 4 < in.size() && isdigit(in[pos + 3]) && isdigit(in[pos + 4])) {
-        return in.substr(0, pos + 2) + in.substr(pos + 3);
+    if (pos + 4 < str.size() && isdigit(str[pos + 3]) &&
+        isdigit(str[pos + 4])) {
+        str.erase(pos + 2, 1);
     }
-    return in;
 }
 #else
-static inline std::string normalizeExponent(const std::string &in) {
-    return in;
-}
+static inline void normalizeExponent(std::string &, size_t) {}
 #endif
 
-static inline std::string normalizeSerializedString(const std::string &in) {
-    auto ret(normalizeExponent(in));
-    return ret;
-}
-
 // ---------------------------------------------------------------------------
 
 void WKTFormatter::add(double number, int precision) {
@@ -515,11 +531,20 @@ void WKTFormatter::add(double number, int precision) {
             d->result_ += '0';
         }
     } else {
-        std::string val(
-            normalizeSerializedString(internal::toString(number, precision)));
-        d->result_ += replaceAll(val, "e", "E");
-        if (d->params_.useESRIDialect_ && val.find('.') == std::string::npos) {
-            d->result_ += ".0";
+        auto &result = d->result_;
+        const size_t start = result.size();
+        internal::appendToString(result, number, precision);
+        normalizeExponent(result, start);
+        bool hasDot = false;
+        for (size_t i = start; i < result.size(); ++i) {
+            if (result[i] == 'e') {
+                result[i] = 'E';
+            } else if (result[i] == '.') {
+                hasDot = true;
+            }
+        }
+        if (d->params_.useESRIDialect_ && !hasDot) {
+            result += ".0";
         }
     }
 }
@@ -4321,14 +4346,31 @@ static BaseObjectNNPtr createFromUserInput(const std::string &text,
         text.find(" +init=") != std::string::npos ||
         text.find(" init=") != std::string::npos ||
         strncmp(textWithoutPlusPrefix, "title=", strlen("title=")) == 0) {
-        return PROJStringParser()
-            .attachDatabaseContext(dbContext)
-            .attachContext(ctx)
-            .setUsePROJ4InitRules(ctx != nullptr
-                                      ? (proj_context_get_use_proj4_init_rules(
-                                             ctx, false) == TRUE)
-                                      : usePROJ4InitRules)
-            .createFromPROJString(text);
+        const bool proj4InitRules =
+            ctx != nullptr
+                ? (proj_context_get_use_proj4_init_rules(ctx, false) == TRUE)
+                : usePROJ4InitRules;
+        std::string cacheKey;
+        if (dbContext && dbContext->getUserInputCacheSize() > 0) {
+            cacheKey = proj4InitRules ? "PROJ/proj4_init_rules:" : "PROJ:";
+            cacheKey += text;
+            BaseObjectPtr cachedObj;
+            std::list<std::string> cachedWarnings;
+            if (dbContext->getFromUserInputCache(cacheKey, cachedObj,
+                                                 cachedWarnings)) {
+                return NN_NO_CHECK(cachedObj);
+            }
+        }
+        auto obj = PROJStringParser()
+                       .attachDatabaseContext(dbContext)
+                       .attachContext(ctx)
+                       .setUsePROJ4InitRules(proj4InitRules)
+                       .createFromPROJString(text);
+        if (!cacheKey.empty()) {
+            dbContext->insertIntoUserInputCache(cacheKey, obj,
+                                                std::list<std::string>());
+        }
+        return obj;
     }
 
     auto tokens = split(text, ':');
@@ -4524,6 +4566,22 @@ BaseObjectNNPtr createFromUserInput(const std::string &text, PJ_CONTEXT *ctx) {
  * @throw ParsingException
  */
 BaseObjectNNPtr WKTParser::createFromWKT(const std::string &wkt) {
+    std::string cacheKey;
+    if (d->dbContext_ && d->dbContext_->getUserInputCacheSize() > 0) {
+        cacheKey = d->strict_ ? "WKT/strict:" : "WKT/lax:";
+        cacheKey += wkt;
+        BaseObjectPtr cachedObj;
+        std::list<std::string> cachedWarnings;
+        if (d->dbContext_->getFromUserInputCache(cacheKey, cachedObj,
+                                                 cachedWarnings)) {
+            d->warningList_.insert(d->warningList_.end(),
+                                   cachedWarnings.begin(),
+                                   cachedWarnings.end());
+            return NN_NO_CHECK(cachedObj);
+        }
+    }
+    const auto warningCountBefore = d->warningList_.size();
+
     WKTNodeNNPtr root = WKTNode::createFrom(wkt);
     auto obj = d->build(root);
 
@@ -4542,6 +4600,14 @@ BaseObjectNNPtr WKTParser::createFromWKT(const std::string &wkt) {
         }
     }
 
+    if (!cacheKey.empty()) {
+        auto iter = d->warningList_.begin();
+        std::advance(iter, warningCountBefore);
+        d->dbContext_->insertIntoUserInputCache(
+            cacheKey, obj,
+            std::list<std::string>(iter, d->warningList_.end()));
+    }
+
     return obj;
 }
 
@@ -4760,6 +4826,8 @@ struct PROJStringFormatter::Private {
 
     // cppcheck-suppress functionStatic
     void addStep();
+
+    void addParam(const std::string &paramName, std::string &&val);
 };
 
 //! @endcond
@@ -5604,16 +5672,20 @@ void PROJStringFormatter::addParam(const std::string &paramName) {
 // ---------------------------------------------------------------------------
 
 void PROJStringFormatter::addParam(const char *paramName, int val) {
-    addParam(std::string(paramName), val);
+    std::string value;
+    internal::appendToString(value, val);
+    d->addParam(paramName, std::move(value));
 }
 
 void PROJStringFormatter::addParam(const std::string &paramName, int val) {
-    addParam(paramName, internal::toString(val));
+    std::string value;
+    internal::appendToString(value, val);
+    d->addParam(paramName, std::move(value));
 }
 
 // ---------------------------------------------------------------------------
 
-static std::string formatToString(double val) {
+static void appendFormatted(std::string &out, double val) {
     if (std::abs(val * 10 - std::round(val * 10)) < 1e-8) {
         // For the purpose of
         // https://www.epsg-registry.org/export.htm?wkt=urn:ogc:def:crs:EPSG::27561
@@ -5622,17 +5694,23 @@ static std::string formatToString(double val) {
         // 49.5 deg
         val = std::round(val * 10) / 10;
     }
-    return normalizeSerializedString(internal::toString(val));
+    const size_t start = out.size();
+    internal::appendToString(out, val);
+    normalizeExponent(out, start);
 }
 
 // ---------------------------------------------------------------------------
 
 void PROJStringFormatter::addParam(const char *paramName, double val) {
-    addParam(std::string(paramName), val);
+    std::string value;
+    appendFormatted(value, val);
+    d->addParam(paramName, std::move(value));
 }
 
 void PROJStringFormatter::addParam(const std::string &paramName, double val) {
-    addParam(paramName, formatToString(val));
+    std::string value;
+    appendFormatted(value, val);
+    d->addParam(paramName, std::move(value));
 }
 
 // ---------------------------------------------------------------------------
@@ -5644,35 +5722,44 @@ void PROJStringFormatter::addParam(const char *paramName,
         if (i > 0) {
             paramValue += ',';
         }
-        paramValue += formatToString(vals[i]);
+        appendFormatted(paramValue, vals[i]);
     }
-    addParam(paramName, paramValue);
+    d->addParam(paramName, std::move(paramValue));
 }
 
 // ---------------------------------------------------------------------------
 
 void PROJStringFormatter::addParam(const char *paramName, const char *val) {
-    addParam(std::string(paramName), val);
+    d->addParam(paramName, std::string(val));
 }
 
 void PROJStringFormatter::addParam(const char *paramName,
                                    const std::string &val) {
-    addParam(std::string(paramName), val);
+    d->addParam(paramName, std::string(val));
 }
 
 void PROJStringFormatter::addParam(const std::string &paramName,
                                    const char *val) {
-    addParam(paramName, std::string(val));
+    d->addParam(paramName, std::string(val));
 }
 
 // ---------------------------------------------------------------------------
 
 void PROJStringFormatter::addParam(const std::string &paramName,
                                    const std::string &val) {
-    if (d->steps_.empty()) {
-        d->addStep();
+    d->addParam(paramName, std::string(val));
+}
+
+// ---------------------------------------------------------------------------
+
+void PROJStringFormatter::Private::addParam(const std::string &paramName,
+                                            std::string &&val) {
+    if (steps_.empty()) {
+        addStep();
     }
-    d->steps_.back().paramValues.push_back(Step::KeyValue(paramName, val));
+    auto &paramValues = steps_.back().paramValues;
+    paramValues.emplace_back(paramName);
+    paramValues.back().value = std::move(val);
 }
 
 // ---------------------------------------------------------------------------
@@ -1175,6 +1175,9 @@ std::string Identifier::canonicalizeName(const std::string &str) {
  * { or } character from them, and comparing in a case insensitive way.
  */
 bool Identifier::isEquivalentName(const char *a, const char *b) noexcept {
+    if (a == b) {
+        return true;
+    }
     size_t i = 0;
     size_t j = 0;
     char lastValidA = 0;
@@ -199,7 +199,7 @@ SET(SRC_LIBPROJ_ISO19111
 )
 
 SET(SRC_LIBPROJ_CORE
-        pj_list.h proj_internal.h proj_math.h
+        pj_list.h proj_internal.h proj_math.h parallel.hpp
         aasincos.cpp adjlon.cpp
         dmstor.cpp auth.cpp
         deriv.cpp ell_set.cpp ellps.cpp errno.cpp
@@ -215,8 +215,8 @@ SET(SRC_LIBPROJ_CORE
         apply_gridshift.cpp datums.cpp datum_set.cpp transform.cpp
         geocent.cpp geocent.h utils.cpp gridinfo.cpp gridlist.cpp
         jniproj.cpp mutex.cpp initcache.cpp apply_vgridshift.cpp geodesic.c
-        strtod.cpp math.cpp
-        4D_api.cpp pipeline.cpp
+        strtod.cpp fixed_format.cpp math.cpp
+        4D_api.cpp pipeline.cpp approx.cpp geodesic_matrix.cpp
         internal.cpp
         wkt_parser.hpp wkt_parser.cpp
         wkt1_parser.h wkt1_parser.cpp
@@ -39,8 +39,14 @@
 #define ACCEPT_USE_OF_DEPRECATED_PROJ_API_H
 #endif
 #include "proj_api.h"
+void PROJ_DLL pj_lock_statistics(unsigned long long *acquisitions,
+                                 unsigned long long *contended,
+                                 double *wait_seconds, int reset);
 #endif
 
+#include <atomic>
+#include <chrono>
+
 /* on win32 we always use win32 mutexes, even if pthreads are available */
 #if defined(_WIN32) && !defined(MUTEX_stub)
 #ifndef MUTEX_win32
@@ -53,6 +59,66 @@
 #  define MUTEX_stub
 #endif
 
+/************************************************************************/
+/* ==================================================================== */
+/*                        contention statistics                         */
+/* ==================================================================== */
+/*                                                                      */
+/*      Every acquisition of the lock is counted. Those which find it   */
+/*      held by another thread are timed, from the failed attempt to    */
+/*      take it to the time it is obtained.                             */
+/************************************************************************/
+
+static std::atomic<unsigned long long> lock_acquisitions(0);
+static std::atomic<unsigned long long> lock_contended(0);
+static std::atomic<unsigned long long> lock_wait_ns(0);
+
+#ifndef MUTEX_stub
+typedef std::chrono::steady_clock lock_clock;
+
+static void pj_count_wait(lock_clock::time_point start)
+{
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  lock_clock::now() - start).count();
+    lock_contended.fetch_add(1, std::memory_order_relaxed);
+    lock_wait_ns.fetch_add(static_cast<unsigned long long>(ns),
+                           std::memory_order_relaxed);
+}
+#endif
+
+/************************************************************************/
+/*                         pj_lock_statistics()                         */
+/*                                                                      */
+/*      Number of acquisitions of the lock, how many of them had to     */
+/*      wait for another thread, and the total time waited, since       */
+/*      the start or the last call with reset set.                      */
+/************************************************************************/
+
+void pj_lock_statistics(unsigned long long *acquisitions,
+                        unsigned long long *contended,
+                        double *wait_seconds, int reset)
+{
+    unsigned long long a, c, ns;
+    if( reset )
+    {
+        a = lock_acquisitions.exchange(0);
+        c = lock_contended.exchange(0);
+        ns = lock_wait_ns.exchange(0);
+    }
+    else
+    {
+        a = lock_acquisitions.load();
+        c = lock_contended.load();
+        ns = lock_wait_ns.load();
+    }
+    if( acquisitions )
+        *acquisitions = a;
+    if( contended )
+        *contended = c;
+    if( wait_seconds )
+        *wait_seconds = ns * 1e-9;
+}
+
 /************************************************************************/
 /* ==================================================================== */
 /*                      stub mutex implementation                       */
@@ -69,6 +135,7 @@
 
 void pj_acquire_lock()
 {
+    lock_acquisitions.fetch_add(1, std::memory_order_relaxed);
 }
 
 /************************************************************************/
@@ -151,7 +218,13 @@ void pj_acquire_lock()
     }
 #endif
 
-    pthread_mutex_lock( &core_lock);
+    if( pthread_mutex_trylock( &core_lock ) != 0 )
+    {
+        lock_clock::time_point start = lock_clock::now();
+        pthread_mutex_lock( &core_lock );
+        pj_count_wait( start );
+    }
+    lock_acquisitions.fetch_add(1, std::memory_order_relaxed);
 }
 
 /************************************************************************/
@@ -231,7 +304,13 @@ void pj_acquire_lock()
     if( mutex_lock == NULL )
         pj_init_lock();
 
-    WaitForSingleObject( mutex_lock, INFINITE );
+    if( WaitForSingleObject( mutex_lock, 0 ) == WAIT_TIMEOUT )
+    {
+        lock_clock::time_point start = lock_clock::now();
+        WaitForSingleObject( mutex_lock, INFINITE );
+        pj_count_wait( start );
+    }
+    lock_acquisitions.fetch_add(1, std::memory_order_relaxed);
 }
 
 /************************************************************************/
@@ -0,0 +1,80 @@
+/******************************************************************************
+ * Project:  PROJ
+ * Purpose:  Spread independent pieces of work over threads.
+ *
+ ******************************************************************************
+ * Copyright (c) 2018, PROJ contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *****************************************************************************/
+
+#ifndef PROJ_PARALLEL_HPP
+#define PROJ_PARALLEL_HPP
+
+//! @cond Doxygen_Suppress
+
+#include <atomic>
+#include <new>
+#include <vector>
+
+#if defined(MUTEX_pthread) || (defined(_WIN32) && !defined(MUTEX_stub))
+#define PROJ_PARALLEL_THREADS
+#include <system_error>
+#include <thread>
+#endif
+
+/* Run task(i) for i in [0, n), on up to nthreads threads, the calling one */
+/* included. nthreads < 1 means one per hardware thread. Without thread   */
+/* support in the library, everything runs in the calling thread.         */
+template <class Index, class Task>
+void pj_run_parallel(int nthreads, Index n, const Task &task) {
+    std::atomic<Index> next(0);
+    auto worker = [&]() {
+        for (Index i = next++; i < n; i = next++)
+            task(i);
+    };
+
+#ifdef PROJ_PARALLEL_THREADS
+    if (nthreads < 1)
+        nthreads = static_cast<int>(std::thread::hardware_concurrency());
+    if (n < static_cast<Index>(nthreads))
+        nthreads = static_cast<int>(n);
+    std::vector<std::thread> threads;
+    for (int i = 1; i < nthreads; i++) {
+        /* Whatever threads could not be started, the others make up for */
+        try {
+            threads.emplace_back(worker);
+        } catch (const std::system_error &) {
+            break;
+        } catch (const std::bad_alloc &) {
+            break;
+        }
+    }
+    worker();
+    for (auto &thread : threads)
+        thread.join();
+#else
+    (void)nthreads;
+    worker();
+#endif
+}
+
+//! @endcond
+
+#endif /* PROJ_PARALLEL_HPP */
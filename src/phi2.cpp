@@ -45,3 +45,101 @@ by Snyder (1987), Eqs. (7-9) - (7-11)
         pj_ctx_set_errno(ctx, PJD_ERR_NON_CON_INV_PHI2);
     return Phi;
 }
+
+
+/* Largest third flattening for which the 6th order series below is used.  */
+/* The truncation error is then below 1e-12 radians, well below the         */
+/* tolerance of the iterative scheme.                                       */
+static const double CONFORMAL_SERIES_MAX_N = 0.01;
+
+/*****************************************************************************/
+void pj_phi2_setup(PJ *P) {
+/******************************************************************************
+Precompute, for the ellipsoid of P, the coefficients of the trigonometric
+series giving the geographic latitude from the conformal latitude chi:
+  phi = chi + sum_{k=1..6} cgb[k-1] * sin(2*k*chi)
+The coefficients are expressed in terms of the third flattening n, following
+Engsager and Poder, ICC 2007 (same as the Gaussian -> geodetic latitude
+conversion of the exact Transverse Mercator).
+*******************************************************************************/
+    const double n = P->n;
+    double np;
+
+    P->conformal_e = -1.0;
+    if (!(fabs(n) <= CONFORMAL_SERIES_MAX_N))
+        return;
+
+    np = n;
+    P->conformal_cgb[0] = n*( 2 + n*(-2/3.0  + n*(-2      + n*(116/45.0 +
+                          n*(26/45.0 + n*(-2854/675.0 ))))));
+    np *= n;
+    P->conformal_cgb[1] = np*(7/3.0 + n*( -8/5.0  + n*(-227/45.0 +
+                          n*(2704/315.0 + n*( 2323/945.0)))));
+    np *= n;
+    P->conformal_cgb[2] = np*( 56/15.0  + n*(-136/35.0 + n*(-1262/105.0 +
+                          n*( 73814/2835.0))));
+    np *= n;
+    P->conformal_cgb[3] = np*(4279/630.0 + n*(-332/35.0 +
+                          n*(-399572/14175.0)));
+    np *= n;
+    P->conformal_cgb[4] = np*(4174/315.0 + n*(-144838/6237.0 ));
+    np *= n;
+    P->conformal_cgb[5] = np*(601676/22275.0 );
+    P->conformal_e = P->e;
+}
+
+/* Latitude from ts through the conformal latitude series of pj_phi2_setup() */
+static inline double conformal_phi2(const double *c, double ts) {
+    /* sin(chi) and cos(chi) from t = tan(pi/4 - chi/2) */
+    double sin_chi, cos_chi;
+    if (ts <= 1) {
+        const double t2 = ts * ts;
+        sin_chi = (1 - t2) / (1 + t2);
+        cos_chi = 2 * ts / (1 + t2);
+    } else {
+        const double u = 1 / ts;
+        const double u2 = u * u;
+        sin_chi = (u2 - 1) / (u2 + 1);
+        cos_chi = 2 * u / (u2 + 1);
+    }
+    const double chi = M_HALFPI - 2. * atan(ts);
+    const double sin_2chi = 2 * sin_chi * cos_chi;
+    const double two_cos_2chi = 2 * (cos_chi - sin_chi) * (cos_chi + sin_chi);
+
+    /* Clenshaw summation of the series */
+    double h = 0, h1 = c[5], h2 = 0;
+    for (int i = 4; i >= 0; i--) {
+        h = -h2 + two_cos_2chi * h1 + c[i];
+        h2 = h1;
+        h1 = h;
+    }
+    return chi + h * sin_2chi;
+}
+
+/*****************************************************************************/
+double pj_phi2(const PJ *P, double ts) {
+/******************************************************************************
+Same as pj_phi2(P->ctx, ts, P->e), but without iterations when the series
+set up by pj_phi2_setup() applies to the ellipsoid of P: the conformal
+latitude is chi = pi/2 - 2*atan(ts), and its double angle is obtained
+algebraically from ts, so the cost is one atan() and a Clenshaw summation.
+*******************************************************************************/
+    if (P->conformal_e != P->e)
+        return pj_phi2(P->ctx, ts, P->e);
+    return conformal_phi2(P->conformal_cgb, ts);
+}
+
+/*****************************************************************************/
+void pj_phi2_array(const PJ *P, size_t n, const double *ts, double *phi) {
+/******************************************************************************
+phi[i] = pj_phi2(P, ts[i]) for i < n.
+*******************************************************************************/
+    size_t i;
+    if (P->conformal_e != P->e) {
+        for (i = 0; i < n; i++)
+            phi[i] = pj_phi2(P->ctx, ts[i], P->e);
+        return;
+    }
+    for (i = 0; i < n; i++)
+        phi[i] = conformal_phi2(P->conformal_cgb, ts[i]);
+}
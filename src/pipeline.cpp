@@ -119,6 +119,22 @@ struct pj_opaque {
     char **current_argv;
     PJ **pipeline;
     std::stack<double> *stack[4];
+    int optimized_steps;
+    PJ **optimized;     /* steps actually run, cf. optimize_pipeline() */
+};
+
+/* A run of affine steps fused into one. Index 0 is forward, 1 reverse */
+struct pj_opaque_fused {
+    PJ_AFFINE_MAP map[2];
+    int ncols[2][4];
+    int cols[2][4][4];
+};
+
+/* A proj=cart step, an affine run and an inverted proj=cart step, fused */
+struct pj_opaque_geodetic_shift {
+    PJ *src;                        /* the proj=cart step, owned by the pipeline */
+    PJ *dst;                        /* the inverted one, likewise */
+    struct pj_opaque_fused shift;
 };
 
 struct pj_opaque_pushpop {
@@ -136,6 +152,11 @@ static PJ_XYZ    pipeline_forward_3d (PJ_LPZ lpz, PJ *P);
 static PJ_LPZ    pipeline_reverse_3d (PJ_XYZ xyz, PJ *P);
 static PJ_XY     pipeline_forward (PJ_LP lp, PJ *P);
 static PJ_LP     pipeline_reverse (PJ_XY xy, PJ *P);
+static PJ_COORD fused_forward_4d (PJ_COORD point, PJ *P);
+static PJ_COORD geodetic_shift_forward_4d (PJ_COORD point, PJ *P);
+static int is_optimizer_step (PJ *Q);
+static PJ_COORD push(PJ_COORD point, PJ *P);
+static PJ_COORD pop(PJ_COORD point, PJ *P);
 
 
 
@@ -144,10 +165,10 @@ static PJ_COORD pipeline_forward_4d (PJ_COORD point, PJ *P) {
     int i, first_step, last_step;
 
     first_step = 1;
-    last_step  = static_cast<struct pj_opaque*>(P->opaque)->steps + 1;
+    last_step  = static_cast<struct pj_opaque*>(P->opaque)->optimized_steps + 1;
 
     for (i = first_step;  i != last_step;  i++)
-        point = proj_trans (static_cast<struct pj_opaque*>(P->opaque)->pipeline[i], PJ_FWD, point);
+        point = proj_trans (static_cast<struct pj_opaque*>(P->opaque)->optimized[i], PJ_FWD, point);
 
     return point;
 }
@@ -156,11 +177,11 @@ static PJ_COORD pipeline_forward_4d (PJ_COORD point, PJ *P) {
 static PJ_COORD pipeline_reverse_4d (PJ_COORD point, PJ *P) {
     int i, first_step, last_step;
 
-    first_step = static_cast<struct pj_opaque*>(P->opaque)->steps;
+    first_step = static_cast<struct pj_opaque*>(P->opaque)->optimized_steps;
     last_step  =  0;
 
     for (i = first_step;  i != last_step;  i--)
-        point = proj_trans (static_cast<struct pj_opaque*>(P->opaque)->pipeline[i], PJ_INV, point);
+        point = proj_trans (static_cast<struct pj_opaque*>(P->opaque)->optimized[i], PJ_INV, point);
 
     return point;
 }
@@ -173,8 +194,8 @@ static PJ_XYZ pipeline_forward_3d (PJ_LPZ lpz, PJ *P) {
     int i;
     point.lpz = lpz;
 
-    for (i = 1;  i <= static_cast<struct pj_opaque*>(P->opaque)->steps;  i++)
-        point = pj_approx_3D_trans (static_cast<struct pj_opaque*>(P->opaque)->pipeline[i], PJ_FWD, point);
+    for (i = 1;  i <= static_cast<struct pj_opaque*>(P->opaque)->optimized_steps;  i++)
+        point = pj_approx_3D_trans (static_cast<struct pj_opaque*>(P->opaque)->optimized[i], PJ_FWD, point);
 
     return point.xyz;
 }
@@ -185,8 +206,8 @@ static PJ_LPZ pipeline_reverse_3d (PJ_XYZ xyz, PJ *P) {
     int i;
     point.xyz = xyz;
 
-    for (i = static_cast<struct pj_opaque*>(P->opaque)->steps;  i > 0 ;  i--)
-        point = pj_approx_3D_trans (static_cast<struct pj_opaque*>(P->opaque)->pipeline[i], PJ_INV, point);
+    for (i = static_cast<struct pj_opaque*>(P->opaque)->optimized_steps;  i > 0 ;  i--)
+        point = pj_approx_3D_trans (static_cast<struct pj_opaque*>(P->opaque)->optimized[i], PJ_INV, point);
 
     return point.lpz;
 }
@@ -199,8 +220,8 @@ static PJ_XY pipeline_forward (PJ_LP lp, PJ *P) {
     int i;
     point.lp = lp;
 
-    for (i = 1;  i <= static_cast<struct pj_opaque*>(P->opaque)->steps;  i++)
-        point = pj_approx_2D_trans (static_cast<struct pj_opaque*>(P->opaque)->pipeline[i], PJ_FWD, point);
+    for (i = 1;  i <= static_cast<struct pj_opaque*>(P->opaque)->optimized_steps;  i++)
+        point = pj_approx_2D_trans (static_cast<struct pj_opaque*>(P->opaque)->optimized[i], PJ_FWD, point);
 
     return point.xy;
 }
@@ -210,8 +231,8 @@ static PJ_LP pipeline_reverse (PJ_XY xy, PJ *P) {
     PJ_COORD point = {{0,0,0,0}};
     int i;
     point.xy = xy;
-    for (i = static_cast<struct pj_opaque*>(P->opaque)->steps;  i > 0 ;  i--)
-        point = pj_approx_2D_trans (static_cast<struct pj_opaque*>(P->opaque)->pipeline[i], PJ_INV, point);
+    for (i = static_cast<struct pj_opaque*>(P->opaque)->optimized_steps;  i > 0 ;  i--)
+        point = pj_approx_2D_trans (static_cast<struct pj_opaque*>(P->opaque)->optimized[i], PJ_INV, point);
 
     return point.lp;
 }
@@ -227,6 +248,15 @@ static PJ *destructor (PJ *P, int errlev) {
     if (nullptr==P->opaque)
         return pj_default_destructor (P, errlev);
 
+    /* Deallocate the fused steps, which are the only ones owned by the optimized array */
+    if (nullptr!=static_cast<struct pj_opaque*>(P->opaque)->optimized)
+        for (i = 0;  i < static_cast<struct pj_opaque*>(P->opaque)->optimized_steps; i++) {
+            PJ *Q = static_cast<struct pj_opaque*>(P->opaque)->optimized[i+1];
+            if (is_optimizer_step (Q))
+                proj_destroy (Q);
+        }
+    pj_dealloc (static_cast<struct pj_opaque*>(P->opaque)->optimized);
+
     /* Deallocate each pipeline step, then pipeline array */
     if (nullptr!=static_cast<struct pj_opaque*>(P->opaque)->pipeline)
         for (i = 0;  i < static_cast<struct pj_opaque*>(P->opaque)->steps; i++)
@@ -371,6 +401,590 @@ static enum pj_io_units get_next_non_whatever_unit(void *pipeline_data, int step
 
 
 
+/*****************************************************************************
+
+    Pipeline optimization
+    ---------------------
+
+    Pipelines produced from CRS definitions often contain runs of steps that
+    are each a constant affine map of the coordinate tuple: axis swaps, unit
+    conversions, static Helmert and affine transformations. Once the steps
+    are set up, each such run is replaced by a single step applying the
+    composite map (runs reducing to the identity are dropped altogether).
+    All the entry points, 2D, 3D and 4D, run the optimized steps, so they
+    agree with each other on any pipeline.
+
+    A step is only considered if, in addition to describing itself through
+    get_affine_map, its preparation and finalization stages do nothing but
+    validate the coordinates. The fused step keeps that validation if any of
+    the steps it replaces had it.
+
+    The most common datum shift, proj=cart followed by a Helmert and an
+    inverted proj=cart, is then fused once more: the resulting step runs
+    the preparation and finalization of both cart steps as before, but
+    calls their kernels and the composite map directly, and comes with a
+    batch form for proj_trans_array().
+
+******************************************************************************/
+
+static PJ_COORD apply_fused (const struct pj_opaque_fused *Q, int dir, PJ_COORD in) {
+    const PJ_AFFINE_MAP *A = &(Q->map[dir]);
+    PJ_COORD out;
+    int i, k;
+
+    /* Only non-zero coefficients take part, so that HUGE_VAL or NaN in   */
+    /* a coordinate merely passed on by an axis swap does not spread out. */
+    for (i = 0;  i < 4;  i++) {
+        const int *cols = Q->cols[dir][i];
+        const int n = Q->ncols[dir][i];
+        double v;
+
+        if (0==n) {
+            out.v[i] = A->offset[i];
+            continue;
+        }
+        v = A->m[i][cols[0]] * in.v[cols[0]];
+        for (k = 1;  k < n;  k++)
+            v += A->m[i][cols[k]] * in.v[cols[k]];
+        if (A->offset[i] != 0.0)
+            v += A->offset[i];
+        /* Sign a zero as the steps one by one would */
+        if (0.0 == v && 0 != A->zero_sign[i])
+            v = (A->zero_sign[i] > 0) ? 0.0 : -0.0;
+        out.v[i] = v;
+    }
+    return out;
+}
+
+
+static PJ_COORD fused_forward_4d (PJ_COORD point, PJ *P) {
+    return apply_fused (static_cast<struct pj_opaque_fused*>(P->opaque), 0, point);
+}
+
+
+static PJ_COORD fused_reverse_4d (PJ_COORD point, PJ *P) {
+    return apply_fused (static_cast<struct pj_opaque_fused*>(P->opaque), 1, point);
+}
+
+
+/* Same outcome as pj_fwd4d/pj_inv4d on each coordinate: only the input  */
+/* check can fail, and as there, it sets errno in the inverse direction.  */
+static int fused_trans_array (PJ *P, PJ_DIRECTION direction, size_t n, PJ_COORD *coord) {
+    const struct pj_opaque_fused *Q = static_cast<struct pj_opaque_fused*>(P->opaque);
+    const int dir = (direction == PJ_FWD) ? 0 : 1;
+    const int check = (direction == PJ_FWD) ? pj_fwd_plan (P)->n_prepare : pj_inv_plan (P)->n_prepare;
+    size_t i;
+
+    for (i = 0;  i < n;  i++) {
+        PJ_COORD *c = coord + i;
+        if (check && (HUGE_VAL==c->v[0] || HUGE_VAL==c->v[1] || HUGE_VAL==c->v[2])) {
+            *c = proj_coord_error ();
+            if (direction == PJ_INV)
+                return proj_errno_set (P, PJD_ERR_INVALID_X_OR_Y);
+            continue;
+        }
+        *c = apply_fused (Q, dir, *c);
+        if (HUGE_VAL==c->v[0])
+            *c = proj_coord_error ();
+    }
+    return 0;
+}
+
+
+/* C = B applied after A. Zero coefficients are skipped for the same reason as in apply_fused */
+static void compose_affine_maps (const PJ_AFFINE_MAP *B, const PJ_AFFINE_MAP *A, PJ_AFFINE_MAP *C) {
+    PJ_AFFINE_MAP R;
+    int i, j, k, n, from = 0;
+
+    for (i = 0;  i < 4;  i++) {
+        /* A zero B merely scales keeps the sign A gave it, times that of the scale */
+        R.zero_sign[i] = B->zero_sign[i];
+        for (n = 0, k = 0;  k < 4;  k++)
+            if (B->m[i][k] != 0.0)
+                n++, from = k;
+        if (0 == R.zero_sign[i] && 1 == n && 0.0 == B->offset[i])
+            R.zero_sign[i] = (B->m[i][from] > 0) ? A->zero_sign[from] : -A->zero_sign[from];
+
+        for (j = 0;  j < 4;  j++) {
+            R.m[i][j] = 0.0;
+            for (k = 0;  k < 4;  k++)
+                if (B->m[i][k] != 0.0 && A->m[k][j] != 0.0)
+                    R.m[i][j] += B->m[i][k] * A->m[k][j];
+        }
+        R.offset[i] = B->offset[i];
+        for (k = 0;  k < 4;  k++)
+            if (B->m[i][k] != 0.0 && A->offset[k] != 0.0)
+                R.offset[i] += B->m[i][k] * A->offset[k];
+    }
+    *C = R;
+}
+
+
+static int is_identity (const PJ_AFFINE_MAP *A) {
+    int i, j;
+    for (i = 0;  i < 4;  i++) {
+        if (A->offset[i] != 0.0 || A->zero_sign[i] != 0)
+            return 0;
+        for (j = 0;  j < 4;  j++)
+            if (A->m[i][j] != ((i == j) ? 1.0 : 0.0))
+                return 0;
+    }
+    return 1;
+}
+
+
+/* A zero the finalization of the step turns into 0 is 0 whatever the kernel gives */
+static void add_plan_zero_signs (const PJ_IO_PLAN *plan, PJ_AFFINE_MAP *A) {
+    int i;
+    for (i = 0;  i < 4;  i++)
+        if (plan->zero_sign[i])
+            A->zero_sign[i] = 1;
+}
+
+
+/* Get the maps a pipeline step applies when the pipeline runs forward and in reverse */
+static int get_step_maps (PJ *Q, PJ_AFFINE_MAP *fwd, PJ_AFFINE_MAP *inv) {
+    PJ_DIRECTION dir = Q->inverted ? PJ_INV : PJ_FWD;
+    const PJ_IO_PLAN *fwd_plan = pj_fwd_plan (Q), *inv_plan = pj_inv_plan (Q);
+
+    if (nullptr==Q->get_affine_map)
+        return 0;
+    if (!fwd_plan->checks_only || !inv_plan->checks_only)
+        return 0;
+    if (!Q->get_affine_map (Q, dir, fwd))
+        return 0;
+    if (!Q->get_affine_map (Q, static_cast<PJ_DIRECTION>(-dir), inv))
+        return 0;
+    add_plan_zero_signs (dir == PJ_FWD ? fwd_plan : inv_plan, fwd);
+    add_plan_zero_signs (dir == PJ_FWD ? inv_plan : fwd_plan, inv);
+    return 1;
+}
+
+
+static int step_validates_coordinates (PJ *Q) {
+    return pj_fwd_plan (Q)->n_prepare > 0 || pj_fwd_plan (Q)->n_finalize > 0 ||
+           pj_inv_plan (Q)->n_prepare > 0 || pj_inv_plan (Q)->n_finalize > 0;
+}
+
+
+/* Whether the step rejects HUGE_VAL input, which an identity map would let through */
+static int step_checks_input (PJ *Q) {
+    return pj_fwd_plan (Q)->n_prepare > 0 || pj_inv_plan (Q)->n_prepare > 0;
+}
+
+
+static void set_fused_maps (struct pj_opaque_fused *Q, const PJ_AFFINE_MAP *fwd, const PJ_AFFINE_MAP *inv) {
+    int dir, i, j;
+
+    Q->map[0] = *fwd;
+    Q->map[1] = *inv;
+    for (dir = 0;  dir < 2;  dir++)
+        for (i = 0;  i < 4;  i++) {
+            Q->ncols[dir][i] = 0;
+            for (j = 0;  j < 4;  j++)
+                if (Q->map[dir].m[i][j] != 0.0)
+                    Q->cols[dir][i][Q->ncols[dir][i]++] = j;
+        }
+}
+
+
+/* A bare PJ owned by the pipeline P, running the given 4D operators */
+static PJ *create_optimizer_step (PJ *P, const char *descr, size_t opaque_size, PJ_OPERATOR fwd4d, PJ_OPERATOR inv4d) {
+    PJ *F = pj_new ();
+
+    if (nullptr==F)
+        return nullptr;
+    F->opaque = pj_calloc (1, opaque_size);
+    if (nullptr==F->opaque) {
+        delete F;
+        return nullptr;
+    }
+    F->ctx = P->ctx;
+    F->parent = P;
+    F->descr = descr;
+    F->destructor = pj_default_destructor;
+    F->fwd4d = fwd4d;
+    F->inv4d = inv4d;
+    F->to_meter = F->fr_meter = F->vto_meter = F->vfr_meter = 1.0;
+    return F;
+}
+
+
+static PJ *create_fused_step (PJ *P, const PJ_AFFINE_MAP *fwd, const PJ_AFFINE_MAP *inv, int validate) {
+    PJ *F = create_optimizer_step (P, "Fused affine pipeline steps", sizeof (struct pj_opaque_fused),
+                                   fused_forward_4d, fused_reverse_4d);
+
+    if (nullptr==F)
+        return nullptr;
+
+    if (validate) {
+        F->left  = PJ_IO_UNITS_CARTESIAN;
+        F->right = PJ_IO_UNITS_CARTESIAN;
+    } else {
+        F->skip_fwd_prepare  = 1;
+        F->skip_fwd_finalize = 1;
+        F->skip_inv_prepare  = 1;
+        F->skip_inv_finalize = 1;
+    }
+
+    set_fused_maps (static_cast<struct pj_opaque_fused*>(F->opaque), fwd, inv);
+    F->trans_array = fused_trans_array;
+    return F;
+}
+
+
+/* One of the cart steps of a geodetic shift, with its own preparation and finalization */
+static PJ_COORD cart_leg (PJ *C, const PJ_IO_PLAN *plan, int to_cartesian, PJ_COORD coo) {
+    coo = pj_io_plan_run (C, plan->prepare, plan->n_prepare, coo);
+    if (HUGE_VAL==coo.v[0])
+        return proj_coord_error ();
+
+    if (to_cartesian)
+        coo.xyz = pj_cart_cartesian (coo.lpz, C);
+    else
+        coo.lpz = pj_cart_geodetic (coo.xyz, C);
+    if (HUGE_VAL==coo.v[0])
+        return proj_coord_error ();
+
+    return pj_io_plan_run (C, plan->finalize, plan->n_finalize, coo);
+}
+
+
+static PJ_COORD geodetic_shift_forward_4d (PJ_COORD point, PJ *P) {
+    struct pj_opaque_geodetic_shift *Q = static_cast<struct pj_opaque_geodetic_shift*>(P->opaque);
+
+    point = cart_leg (Q->src, pj_fwd_plan (Q->src), 1, point);
+    /* As in the unfused pipeline, the input check of the last leg sets errno */
+    if (HUGE_VAL==point.v[0])
+        return cart_leg (Q->dst, pj_inv_plan (Q->dst), 0, point);
+    point = apply_fused (&Q->shift, 0, point);
+    return cart_leg (Q->dst, pj_inv_plan (Q->dst), 0, point);
+}
+
+
+static PJ_COORD geodetic_shift_reverse_4d (PJ_COORD point, PJ *P) {
+    struct pj_opaque_geodetic_shift *Q = static_cast<struct pj_opaque_geodetic_shift*>(P->opaque);
+
+    point = cart_leg (Q->dst, pj_fwd_plan (Q->dst), 1, point);
+    /* As in the unfused pipeline, the input check of the last leg sets errno */
+    if (HUGE_VAL==point.v[0])
+        return cart_leg (Q->src, pj_inv_plan (Q->src), 0, point);
+    point = apply_fused (&Q->shift, 1, point);
+    return cart_leg (Q->src, pj_inv_plan (Q->src), 0, point);
+}
+
+
+/*****************************************************************************/
+static int geodetic_shift_trans_array (PJ *P, PJ_DIRECTION direction, size_t n, PJ_COORD *coord) {
+/******************************************************************************
+    The batch form of a geodetic shift, with the same outcome as running
+    proj_trans() on each coordinate, as proj_trans_array() would. Each chunk
+    of coordinates goes through the stages in turn: the cart preparation,
+    the batch kernel of the cart step, its finalization and the composite
+    map, then likewise for the inverted cart step. A chunk where a stage
+    fails is restored and redone one coordinate at a time.
+******************************************************************************/
+    struct pj_opaque_geodetic_shift *Q = static_cast<struct pj_opaque_geodetic_shift*>(P->opaque);
+    const int dir = (direction == PJ_FWD) ? 0 : 1;
+    PJ *first = dir ? Q->dst : Q->src, *last = dir ? Q->src : Q->dst;
+    const PJ_IO_PLAN *to_cartesian = pj_fwd_plan (first), *to_geodetic = pj_inv_plan (last);
+    PJ_OPERATOR op = dir ? geodetic_shift_reverse_4d : geodetic_shift_forward_4d;
+    PJ_COORD saved[PJ_BATCH_SIZE];
+    double x[PJ_BATCH_SIZE] = {}, y[PJ_BATCH_SIZE] = {}, z[PJ_BATCH_SIZE] = {};
+    int last_errno = proj_errno_reset (P);
+    size_t i, k, m;
+
+    for (k = 0;  k < n;  k += m) {
+        PJ_COORD *c = coord + k;
+        int failed = 0;
+        m = (n - k < PJ_BATCH_SIZE) ? n - k : PJ_BATCH_SIZE;
+        memcpy (saved, c, m * sizeof (PJ_COORD));
+
+        for (i = 0;  i < m;  i++) {
+            c[i] = pj_io_plan_run (first, to_cartesian->prepare, to_cartesian->n_prepare, c[i]);
+            failed |= HUGE_VAL==c[i].v[0];
+            x[i] = c[i].v[0];
+            y[i] = c[i].v[1];
+            z[i] = c[i].v[2];
+        }
+
+        if (!failed) {
+            first->fwd3d_batch (first, m, x, y, z);
+            for (i = 0;  i < m;  i++) {
+                c[i].v[0] = x[i];
+                c[i].v[1] = y[i];
+                c[i].v[2] = z[i];
+                failed |= HUGE_VAL==x[i];
+                c[i] = pj_io_plan_run (first, to_cartesian->finalize, to_cartesian->n_finalize, c[i]);
+                c[i] = apply_fused (&Q->shift, dir, c[i]);
+                c[i] = pj_io_plan_run (last, to_geodetic->prepare, to_geodetic->n_prepare, c[i]);
+                failed |= HUGE_VAL==c[i].v[0];
+                x[i] = c[i].v[0];
+                y[i] = c[i].v[1];
+                z[i] = c[i].v[2];
+            }
+        }
+
+        if (!failed) {
+            last->inv3d_batch (last, m, x, y, z);
+            for (i = 0;  i < m;  i++) {
+                c[i].v[0] = x[i];
+                c[i].v[1] = y[i];
+                c[i].v[2] = z[i];
+                failed |= HUGE_VAL==x[i];
+                c[i] = pj_io_plan_run (last, to_geodetic->finalize, to_geodetic->n_finalize, c[i]);
+            }
+        }
+
+        if (!failed && 0==proj_context_errno (P->ctx))
+            continue;
+
+        /* Redo the chunk a coordinate at a time, stopping at the failing one */
+        memcpy (c, saved, m * sizeof (PJ_COORD));
+        proj_errno_reset (P);
+        for (i = 0;  i < m;  i++) {
+            c[i] = op (c[i], P);
+            if (proj_errno (P))
+                return proj_errno (P);
+        }
+    }
+
+    proj_errno_restore (P, last_errno);
+    return proj_errno (P);
+}
+
+
+static PJ *create_geodetic_shift_step (PJ *P, PJ *src, PJ *dst, const PJ_AFFINE_MAP *fwd, const PJ_AFFINE_MAP *inv) {
+    struct pj_opaque_geodetic_shift *Q;
+    PJ *F = create_optimizer_step (P, "Fused geodetic datum shift", sizeof (struct pj_opaque_geodetic_shift),
+                                   geodetic_shift_forward_4d, geodetic_shift_reverse_4d);
+
+    if (nullptr==F)
+        return nullptr;
+    F->trans_array = geodetic_shift_trans_array;
+    F->left  = PJ_IO_UNITS_RADIANS;
+    F->right = PJ_IO_UNITS_RADIANS;
+
+    /* The cart steps prepare and finalize for themselves */
+    F->skip_fwd_prepare  = 1;
+    F->skip_fwd_finalize = 1;
+    F->skip_inv_prepare  = 1;
+    F->skip_inv_finalize = 1;
+
+    Q = static_cast<struct pj_opaque_geodetic_shift*>(F->opaque);
+    Q->src = src;
+    Q->dst = dst;
+    set_fused_maps (&Q->shift, fwd, inv);
+    return F;
+}
+
+
+static int is_optimizer_step (PJ *Q) {
+    return Q->fwd4d == fused_forward_4d || Q->fwd4d == geodetic_shift_forward_4d;
+}
+
+
+static int is_cart_step (PJ *Q) {
+    return Q->fwd3d == pj_cart_cartesian && nullptr==Q->fwd4d;
+}
+
+
+/* Replace proj=cart, an optional affine step, and proj=cart +inv by a geodetic shift step */
+static int fuse_geodetic_shifts (PJ *P) {
+    struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
+    int nsteps = Q->optimized_steps;
+    int i, k, n = 0;
+
+    for (i = 1;  i <= nsteps;  i++) {
+        PJ *src = Q->optimized[i], *mid = nullptr, *dst = nullptr, *F;
+        PJ_AFFINE_MAP fwd, inv;
+
+        k = i + 1;
+        if (k <= nsteps && !is_cart_step (Q->optimized[k]))
+            mid = Q->optimized[k++];
+        if (k <= nsteps)
+            dst = Q->optimized[k];
+
+        if (!is_cart_step (src) || src->inverted || nullptr==dst || !is_cart_step (dst) || !dst->inverted) {
+            Q->optimized[++n] = src;
+            continue;
+        }
+
+        if (nullptr==mid) {
+            pj_affine_map_set_identity (&fwd);
+            pj_affine_map_set_identity (&inv);
+        }
+        else if (mid->fwd4d == fused_forward_4d) {
+            fwd = static_cast<struct pj_opaque_fused*>(mid->opaque)->map[0];
+            inv = static_cast<struct pj_opaque_fused*>(mid->opaque)->map[1];
+        }
+        else if (!get_step_maps (mid, &fwd, &inv)) {
+            Q->optimized[++n] = src;
+            continue;
+        }
+
+        F = create_geodetic_shift_step (P, src, dst, &fwd, &inv);
+        if (nullptr==F) {
+            /* Leave the optimized steps in a state the destructor can handle */
+            for (;  i <= nsteps;  i++)
+                Q->optimized[++n] = Q->optimized[i];
+            Q->optimized_steps = n;
+            return 0;
+        }
+        if (nullptr!=mid && is_optimizer_step (mid))
+            proj_destroy (mid);
+        proj_log_trace (P, "Pipeline: geodetic datum shift fused");
+        Q->optimized[++n] = F;
+        i = k;
+    }
+
+    Q->optimized_steps = n;
+    return 1;
+}
+
+
+static int optimize_pipeline (PJ *P) {
+    struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
+    PJ **pipeline = Q->pipeline;
+    int nsteps = Q->steps;
+    int i = 1, j, n = 0;
+
+    Q->optimized = static_cast<PJ**>(pj_calloc (nsteps + 2, sizeof(PJ *)));
+    if (nullptr==Q->optimized)
+        return 0;
+
+    while (i <= nsteps) {
+        PJ_AFFINE_MAP fwd, inv, step_fwd, step_inv;
+        int validate, check_input;
+
+        if (!get_step_maps (pipeline[i], &fwd, &inv)) {
+            Q->optimized[++n] = pipeline[i++];
+            continue;
+        }
+        validate = step_validates_coordinates (pipeline[i]);
+        check_input = step_checks_input (pipeline[i]);
+
+        /* Extend the run as far as possible. In reverse, later steps run first */
+        for (j = i + 1;  j <= nsteps;  j++) {
+            if (!get_step_maps (pipeline[j], &step_fwd, &step_inv))
+                break;
+            compose_affine_maps (&step_fwd, &fwd, &fwd);
+            compose_affine_maps (&inv, &step_inv, &inv);
+            validate |= step_validates_coordinates (pipeline[j]);
+            check_input |= step_checks_input (pipeline[j]);
+        }
+
+        /* An identity is dropped, unless it must still reject HUGE_VAL input */
+        if (is_identity (&fwd) && is_identity (&inv) && !check_input)
+            proj_log_trace (P, "Pipeline: steps %d-%d reduce to the identity", i, j - 1);
+        else if (j - i == 1)
+            Q->optimized[++n] = pipeline[i];
+        else {
+            PJ *F = create_fused_step (P, &fwd, &inv, validate);
+            if (nullptr==F) {
+                Q->optimized_steps = n;
+                return 0;
+            }
+            proj_log_trace (P, "Pipeline: steps %d-%d fused", i, j - 1);
+            Q->optimized[++n] = F;
+        }
+        i = j;
+    }
+
+    Q->optimized_steps = n;
+    return fuse_geodetic_shifts (P);
+}
+
+
+/* Whether running the steps one chunk of coordinates at a time pays off.  */
+/* push and pop keep a stack per coordinate, so they rule it out.          */
+static int has_batch_steps (PJ *P) {
+    struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
+    int i, batch = 0;
+
+    for (i = 1;  i <= Q->optimized_steps;  i++) {
+        PJ *S = Q->optimized[i];
+        if (S->fwd4d == push || S->fwd4d == pop)
+            return 0;
+        if (nullptr!=S->trans_array || nullptr!=S->fwd_batch || nullptr!=S->inv_batch ||
+            nullptr!=S->fwd3d_batch || nullptr!=S->inv3d_batch)
+            batch = 1;
+    }
+    return batch;
+}
+
+
+/*****************************************************************************/
+static int pipeline_trans_array (PJ *P, PJ_DIRECTION direction, size_t n, PJ_COORD *coord) {
+/******************************************************************************
+    The batch form of a pipeline. A single step with a batch kernel gets the
+    whole array. Otherwise, the steps take chunks of coordinates in turn, so
+    each of them can use its own batch path. A chunk where an error shows up
+    is restored and redone one coordinate at a time, so the transformation
+    stops at the failing coordinate, as proj_trans_array() does.
+******************************************************************************/
+    struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
+    PJ_COORD saved[PJ_BATCH_SIZE];
+    int i, err, last_errno;
+    size_t j, k, m;
+
+    if (1==Q->optimized_steps && nullptr!=Q->optimized[1]->trans_array) {
+        PJ *S = Q->optimized[1];
+        if (S->inverted)
+            direction = static_cast<PJ_DIRECTION>(-direction);
+        return S->trans_array (S, direction, n, coord);
+    }
+
+    last_errno = proj_errno_reset (P);
+    for (k = 0;  k < n;  k += m) {
+        PJ_COORD *c = coord + k;
+        m = (n - k < PJ_BATCH_SIZE) ? n - k : PJ_BATCH_SIZE;
+        memcpy (saved, c, m * sizeof (PJ_COORD));
+
+        err = 0;
+        if (direction == PJ_FWD)
+            for (i = 1;  i <= Q->optimized_steps && 0==err;  i++)
+                err = proj_trans_array (Q->optimized[i], PJ_FWD, m, c);
+        else
+            for (i = Q->optimized_steps;  i >= 1 && 0==err;  i--)
+                err = proj_trans_array (Q->optimized[i], PJ_INV, m, c);
+
+        if (0==err) {
+            for (j = 0;  j < m;  j++)
+                if (HUGE_VAL==c[j].v[0])
+                    c[j] = proj_coord_error ();
+            continue;
+        }
+
+        proj_errno_reset (P);
+        memcpy (c, saved, m * sizeof (PJ_COORD));
+        for (j = 0;  j < m;  j++) {
+            c[j] = (direction == PJ_FWD) ? pj_fwd4d (c[j], P) : pj_inv4d (c[j], P);
+            if (proj_errno (P))
+                return proj_errno (P);
+        }
+    }
+
+    proj_errno_restore (P, last_errno);
+    return 0;
+}
+
+
+/*****************************************************************************/
+void pj_pipeline_step_counts (const PJ *P, int *defined, int *optimized) {
+/******************************************************************************
+    Number of steps of a pipeline as defined, and as run after
+    optimization. Both are 1 for anything but a pipeline.
+******************************************************************************/
+    *defined = *optimized = 1;
+    if (nullptr==P || !P->is_pipeline || nullptr==P->opaque)
+        return;
+    *defined   = static_cast<const struct pj_opaque*>(P->opaque)->steps;
+    *optimized = static_cast<const struct pj_opaque*>(P->opaque)->optimized_steps;
+}
+
+
+
 PJ *OPERATION(pipeline,0) {
     int i, nsteps = 0, argc;
     int i_pipeline = -1, i_first_step = -1, i_current_step;
@@ -567,6 +1181,13 @@ PJ *OPERATION(pipeline,0) {
 
     /* Now, correspondingly determine forward output (= reverse input) data type */
     P->right = pj_right (static_cast<struct pj_opaque*>(P->opaque)->pipeline[nsteps]);
+
+    if (!optimize_pipeline (P))
+        return destructor (P, ENOMEM);
+    if (nullptr!=P->inv4d && has_batch_steps (P))
+        P->trans_array = pipeline_trans_array;
+    proj_log_trace (P, "Pipeline: %d steps run after optimization",
+                    static_cast<struct pj_opaque*>(P->opaque)->optimized_steps);
     return P;
 }
 
@@ -391,6 +391,19 @@ size_t PROJ_DLL proj_trans_generic (
     double *t, size_t st, size_t nt
 );
 
+int PROJ_DLL proj_trans_grid (PJ *P, PJ_DIRECTION direction,
+                              double x0, double dx, size_t nx,
+                              double y0, double dy, size_t ny,
+                              PJ_COORD *out);
+
+/* Approximate transformations, fitted over a region for fast evaluation */
+PJ PROJ_DLL *proj_create_approximation (PJ_CONTEXT *ctx, PJ *P, PJ_DIRECTION direction,
+                                        double xmin, double ymin, double xmax, double ymax,
+                                        double tolerance);
+PJ PROJ_DLL *proj_create_approximation_from_file (PJ_CONTEXT *ctx, const char *filename);
+int PROJ_DLL proj_approximation_write (const PJ *P, const char *filename);
+double PROJ_DLL proj_approximation_max_error (const PJ *P);
+
 
 /* Initializers */
 PJ_COORD PROJ_DLL proj_coord (double x, double y, double z, double t);
@@ -412,6 +425,7 @@ double PROJ_DLL proj_xyz_dist (PJ_COORD a, PJ_COORD b);
 
 /* Geodesic distance (in meter) + fwd and rev azimuth between two points on the ellipsoid */
 PJ_COORD PROJ_DLL proj_geod (const PJ *P, PJ_COORD a, PJ_COORD b);
+int PROJ_DLL proj_geod_array (const PJ *P, size_t n, const PJ_COORD *a, const PJ_COORD *b, PJ_COORD *out, int nthreads);
 
 
 /* Set or read error level */
@@ -431,6 +445,7 @@ PJ_FACTORS PROJ_DLL proj_factors(PJ *P, PJ_COORD lp);
 /* Info functions - get information about various PROJ.4 entities */
 PJ_INFO PROJ_DLL proj_info(void);
 PJ_PROJ_INFO PROJ_DLL proj_pj_info(PJ *P);
+void PROJ_DLL proj_pipeline_step_counts(const PJ *P, int *steps, int *optimized_steps);
 PJ_GRID_INFO PROJ_DLL proj_grid_info(const char *gridname);
 PJ_INIT_INFO PROJ_DLL proj_init_info(const char *initname);
 
@@ -763,6 +778,13 @@ const char PROJ_DLL *proj_context_get_database_path(PJ_CONTEXT *ctx);
 const char PROJ_DLL *proj_context_get_database_metadata(PJ_CONTEXT* ctx,
                                                         const char* key);
 
+int PROJ_DLL proj_context_set_user_input_cache_size(PJ_CONTEXT *ctx,
+                                                    size_t max_entries);
+
+int PROJ_DLL proj_context_get_user_input_cache_stats(PJ_CONTEXT *ctx,
+                                                     size_t *out_hits,
+                                                     size_t *out_misses);
+
 
 PJ_GUESSED_WKT_DIALECT PROJ_DLL proj_context_guess_wkt_dialect(PJ_CONTEXT *ctx,
                                                                const char *wkt);
@@ -196,9 +196,27 @@ void PROJ_DLL proj_context_delete_cpp_context(struct projCppContext* cppContext)
 PJ_COORD pj_fwd4d (PJ_COORD coo, PJ *P);
 PJ_COORD pj_inv4d (PJ_COORD coo, PJ *P);
 
+struct PJ_IO_PLAN;
+const PJ_IO_PLAN *pj_fwd_plan (PJ *P);
+const PJ_IO_PLAN *pj_inv_plan (PJ *P);
+
+void pj_pipeline_step_counts (const PJ *P, int *defined, int *optimized);
+int pj_fwd_lattice (PJ *P, double lam0, double dlam, size_t nlam,
+                    double phi0, double dphi, size_t nphi, PJ_COORD *out);
+
+/* Largest number of coordinates handed to the fwd_batch/inv_batch kernels */
+#define PJ_BATCH_SIZE 256
+int pj_fwd_array (PJ *P, size_t n, PJ_COORD *coord);
+int pj_inv_array (PJ *P, size_t n, PJ_COORD *coord);
+
 PJ_COORD PROJ_DLL pj_approx_2D_trans (PJ *P, PJ_DIRECTION direction, PJ_COORD coo);
 PJ_COORD PROJ_DLL pj_approx_3D_trans (PJ *P, PJ_DIRECTION direction, PJ_COORD coo);
 
+/* Contention statistics of pj_acquire_lock(), see mutex.cpp */
+void PROJ_DLL pj_lock_statistics (unsigned long long *acquisitions,
+                                  unsigned long long *contended,
+                                  double *wait_seconds, int reset);
+
 
 /* Grid functionality */
 int             proj_vgrid_init(PJ *P, const char *grids);
@@ -220,6 +238,10 @@ int pj_calc_ellipsoid_params (PJ *P, double a, double es);
 /* Geographical to geocentric latitude - another of the "simple, but useful" */
 PJ_COORD pj_geocentric_latitude (const PJ *P, PJ_DIRECTION direction, PJ_COORD coord);
 
+/* The proj=cart kernels, also run by the fused geodetic datum shift of pipelines */
+PJ_XYZ pj_cart_cartesian (PJ_LPZ geod, PJ *P);
+PJ_LPZ pj_cart_geodetic (PJ_XYZ cart, PJ *P);
+
 char  PROJ_DLL *pj_chomp (char *c);
 char  PROJ_DLL *pj_shrink (char *c);
 size_t pj_trim_argc (char *args);
@@ -288,13 +310,57 @@ PJ_OPERATOR:
     A function taking a PJ_COORD and a pointer-to-PJ as args, applying the
     PJ to the PJ_COORD, and returning the resulting PJ_COORD.
 
+PJ_IO_STEP:
+
+    A function taking a pointer-to-PJ and a pointer-to-PJ_COORD as args,
+    applying one stage of the pj_fwd/pj_inv coordinate preparation or
+    finalization in place. Returns 0 when the remaining stages must be
+    skipped (on error, or when a datum shift step failed).
+
 *****************************************************************************/
 typedef    PJ       *(* PJ_CONSTRUCTOR) (PJ *);
 typedef    PJ       *(* PJ_DESTRUCTOR)  (PJ *, int);
 typedef    PJ_COORD  (* PJ_OPERATOR)    (PJ_COORD, PJ *);
+typedef    int       (* PJ_IO_STEP)     (PJ *, PJ_COORD *);
 /****************************************************************************/
 
 
+/* The stages of pj_fwd/pj_inv coordinate preparation and finalization      */
+/* that a given PJ needs, selected once from its I/O units and cs2cs-style  */
+/* helper PJs instead of being re-tested for every coordinate.              */
+#define PJ_IO_PLAN_MAX_STEPS 10
+
+struct PJ_IO_PLAN {
+    int compiled = 0;
+    int checks_only = 0;    /* 1 if no stage alters a valid coordinate, */
+    int zero_sign[4] = {};  /* but for turning -0 into 0 where set      */
+    int n_prepare = 0;
+    int n_finalize = 0;
+    PJ_IO_STEP prepare[PJ_IO_PLAN_MAX_STEPS] = {};
+    PJ_IO_STEP finalize[PJ_IO_PLAN_MAX_STEPS] = {};
+};
+
+/* A constant affine map of the coordinate tuple: out = m * in + offset.   */
+/* Operations that act as one describe themselves through get_affine_map, */
+/* which lets the pipeline optimizer fuse them with their neighbours.     */
+/* zero_sign tells how the operation signs a zero result: kernels summing  */
+/* terms give +0 (+1), sign changes and scalings keep that of the input (0) */
+struct PJ_AFFINE_MAP {
+    double m[4][4];
+    double offset[4];
+    int zero_sign[4];
+};
+
+void pj_affine_map_set_identity (PJ_AFFINE_MAP *A);
+
+/* Run n stages of a PJ_IO_PLAN on coo, stopping at the first that asks to */
+inline PJ_COORD pj_io_plan_run (PJ *P, const PJ_IO_STEP *steps, int n, PJ_COORD coo) {
+    for (int i = 0;  i < n  &&  steps[i] (P, &coo);  i++)
+        ;
+    return coo;
+}
+
+
 /* datum_type values */
 #define PJD_UNKNOWN   0
 #define PJD_3PARAM    1
@@ -359,6 +425,32 @@ struct PJconsts {
 
     PJ_DESTRUCTOR destructor = nullptr;
 
+    /* Optional: fill in the affine map applied in the given direction and  */
+    /* return 1, or return 0 if the operation currently is not affine.      */
+    int (*get_affine_map)(PJ *, PJ_DIRECTION, PJ_AFFINE_MAP *) = nullptr;
+
+    /* Optional: transform an array of coordinates in one go, as documented */
+    /* for proj_trans_array(). The direction is that of the operation, the  */
+    /* inverted flag has already been accounted for. On error, the failing  */
+    /* coordinate is set to HUGE_VAL, and the ones after it are untouched.  */
+    int (*trans_array)(PJ *, PJ_DIRECTION, size_t, PJ_COORD *) = nullptr;
+
+    /* Optional, for projections whose forward is separable in lam and phi: */
+    /* set out[j*nlam + i].xy to what fwd gives for (lam[i], phi[j]), or to */
+    /* HUGE_VAL (with errno set) where fwd would fail.                      */
+    void (*fwd_lattice)(PJ *, const double *lam, size_t nlam,
+                        const double *phi, size_t nphi, PJ_COORD *out) = nullptr;
+
+    /* Optional: fwd and inv for n <= PJ_BATCH_SIZE coordinates, in place:  */
+    /* a and b hold lam and phi (resp. x and y) on input, and the results   */
+    /* of fwd (resp. inv) on output. Where fwd or inv would set errno, so   */
+    /* do these, and the caller then falls back to one point at a time.    */
+    void (*fwd_batch)(PJ *, size_t n, double *a, double *b) = nullptr;
+    void (*inv_batch)(PJ *, size_t n, double *a, double *b) = nullptr;
+    /* Likewise for fwd3d and inv3d, with c holding z on input and output. */
+    void (*fwd3d_batch)(PJ *, size_t n, double *a, double *b, double *c) = nullptr;
+    void (*inv3d_batch)(PJ *, size_t n, double *a, double *b, double *c) = nullptr;
+
 
     /*************************************************************************************
 
@@ -414,6 +506,12 @@ struct PJconsts {
     double  es_orig = 0.0;    /* es and a before any +proj related adjustment */
     double  a_orig = 0.0;
 
+    /* Coefficients of the series giving the geodetic latitude from the     */
+    /* conformal latitude, used by pj_phi2(PJ *, double). Only set up when  */
+    /* the series is accurate for the ellipsoid, i.e. conformal_e == e.    */
+    double  conformal_e = -1.0;
+    double  conformal_cgb[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+
 
     /*************************************************************************************
 
@@ -443,6 +541,10 @@ struct PJconsts {
     PJ *hgridshift = nullptr;
     PJ *vgridshift = nullptr;
 
+    /* Compiled on first use by pj_fwd_plan()/pj_inv_plan() */
+    PJ_IO_PLAN fwd_plan{};
+    PJ_IO_PLAN inv_plan{};
+
 
     /*************************************************************************************
 
@@ -846,10 +948,18 @@ double  pj_qsfn(double, double, double);
 double  pj_tsfn(double, double, double);
 double  pj_msfn(double, double, double);
 double  PROJ_DLL pj_phi2(projCtx_t *, double, double);
+void    pj_phi2_setup(PJ *);
+double  pj_phi2(const PJ *, double);
 double  pj_qsfn_(double, PJ *);
 double *pj_authset(double);
 double  pj_authlat(double, double *);
 
+/* Array forms of the above, for the fwd_batch/inv_batch kernels */
+void    pj_qsfn_array(size_t n, const double *sinphi, double e, double one_es, double *q);
+void    pj_tsfn_array(size_t n, const double *phi, const double *sinphi, double e, double *ts);
+void    pj_phi2_array(const PJ *, size_t n, const double *ts, double *phi);
+void    pj_authlat_array(size_t n, const double *beta, double *APA, double *phi);
+
 COMPLEX pj_zpoly1(COMPLEX, const COMPLEX *, int);
 COMPLEX pj_zpolyd1(COMPLEX, const COMPLEX *, int, COMPLEX *);
 
@@ -912,6 +1022,8 @@ double proj_inv_mdist(projCtx_t *ctx, double, const void *);
 void  *pj_gauss_ini(double, double, double *,double *);
 PJ_LP     pj_gauss(projCtx_t *, PJ_LP, const void *);
 PJ_LP     pj_inv_gauss(projCtx_t *, PJ_LP, const void *);
+void      pj_gauss_array(size_t n, double *lam, double *phi, const void *);
+void      pj_inv_gauss_array(projCtx_t *, size_t n, double *lam, double *phi, const void *);
 
 struct PJ_DATUMS           PROJ_DLL *pj_get_datums_ref( void );
 
@@ -919,7 +1031,9 @@ PJ *pj_new(void);
 PJ *pj_default_destructor (PJ *P, int errlev);
 
 double PROJ_DLL pj_atof( const char* nptr );
-double pj_strtod( const char *nptr, char **endptr );
+double PROJ_DLL pj_strtod( const char *nptr, char **endptr );
+int    PROJ_DLL pj_format_fixed( char *s, size_t size, double x, int width, int precision, int zero_pad );
+int    PROJ_DLL pj_format_double( char *s, size_t size, const char *format, double x );
 void   pj_freeup_plain (PJ *P);
 
 PJ* pj_init_ctx_with_allow_init_epsg( projCtx_t *ctx, int argc, char **argv, int allow_init_epsg );
@@ -933,4 +1047,8 @@ PJ *pj_create_argv_internal (PJ_CONTEXT *ctx, int argc, char **argv);
 /* classic public API */
 #include "proj_api.h"
 
+/* Writing through the file API of a context, supported by the default one only */
+size_t pj_ctx_fwrite(projCtx ctx, const void *buffer, size_t size, size_t nmemb, PAFile file);
+int    pj_ctx_fflush(projCtx ctx, PAFile file);
+
 #endif /* ndef PROJ_INTERNAL_H */
@@ -2,6 +2,8 @@
 #ifndef PROJ_SYMBOL_RENAME_H
 #define PROJ_SYMBOL_RENAME_H
 #define geod_direct internal_geod_direct
+#define geod_direct_batch internal_geod_direct_batch
+#define geod_distance_matrix internal_geod_distance_matrix
 #define geod_directline internal_geod_directline
 #define geod_gendirect internal_geod_gendirect
 #define geod_gendirectline internal_geod_gendirectline
@@ -10,14 +12,18 @@
 #define geod_gensetdistance internal_geod_gensetdistance
 #define geod_init internal_geod_init
 #define geod_inverse internal_geod_inverse
+#define geod_inverse_batch internal_geod_inverse_batch
 #define geod_inverseline internal_geod_inverseline
+#define geod_knn internal_geod_knn
 #define geod_lineinit internal_geod_lineinit
 #define geod_polygon_addedge internal_geod_polygon_addedge
 #define geod_polygon_addpoint internal_geod_polygon_addpoint
 #define geod_polygonarea internal_geod_polygonarea
+#define geod_polygonarea_batch internal_geod_polygonarea_batch
 #define geod_polygon_clear internal_geod_polygon_clear
 #define geod_polygon_compute internal_geod_polygon_compute
 #define geod_polygon_init internal_geod_polygon_init
+#define geod_polygon_merge internal_geod_polygon_merge
 #define geod_polygon_testedge internal_geod_polygon_testedge
 #define geod_polygon_testpoint internal_geod_polygon_testpoint
 #define geod_position internal_geod_position
@@ -87,6 +93,8 @@
 #define proj_alter_name internal_proj_alter_name
 #define proj_angular_input internal_proj_angular_input
 #define proj_angular_output internal_proj_angular_output
+#define proj_approximation_max_error internal_proj_approximation_max_error
+#define proj_approximation_write internal_proj_approximation_write
 #define proj_area_create internal_proj_area_create
 #define proj_area_destroy internal_proj_area_destroy
 #define proj_area_set_bbox internal_proj_area_set_bbox
@@ -100,10 +108,12 @@
 #define proj_context_get_database_metadata internal_proj_context_get_database_metadata
 #define proj_context_get_database_path internal_proj_context_get_database_path
 #define proj_context_get_use_proj4_init_rules internal_proj_context_get_use_proj4_init_rules
+#define proj_context_get_user_input_cache_stats internal_proj_context_get_user_input_cache_stats
 #define proj_context_guess_wkt_dialect internal_proj_context_guess_wkt_dialect
 #define proj_context_set_database_path internal_proj_context_set_database_path
 #define proj_context_set_file_finder internal_proj_context_set_file_finder
 #define proj_context_set_search_paths internal_proj_context_set_search_paths
+#define proj_context_set_user_input_cache_size internal_proj_context_set_user_input_cache_size
 #define proj_context_use_proj4_init_rules internal_proj_context_use_proj4_init_rules
 #define proj_convert_conversion_to_other_method internal_proj_convert_conversion_to_other_method
 #define proj_coord internal_proj_coord
@@ -117,6 +127,8 @@
 #define proj_coordoperation_get_towgs84_values internal_proj_coordoperation_get_towgs84_values
 #define proj_coordoperation_is_instantiable internal_proj_coordoperation_is_instantiable
 #define proj_create internal_proj_create
+#define proj_create_approximation internal_proj_create_approximation
+#define proj_create_approximation_from_file internal_proj_create_approximation_from_file
 #define proj_create_argv internal_proj_create_argv
 #define proj_create_cartesian_2D_cs internal_proj_create_cartesian_2D_cs
 #define proj_create_compound_crs internal_proj_create_compound_crs
@@ -227,6 +239,7 @@
 #define proj_errno_string internal_proj_errno_string
 #define proj_factors internal_proj_factors
 #define proj_geod internal_proj_geod
+#define proj_geod_array internal_proj_geod_array
 #define proj_get_area_of_use internal_proj_get_area_of_use
 #define proj_get_authorities_from_database internal_proj_get_authorities_from_database
 #define proj_get_codes_from_database internal_proj_get_codes_from_database
@@ -266,6 +279,7 @@
 #define proj_operation_factory_context_set_grid_availability_use internal_proj_operation_factory_context_set_grid_availability_use
 #define proj_operation_factory_context_set_spatial_criterion internal_proj_operation_factory_context_set_spatial_criterion
 #define proj_operation_factory_context_set_use_proj_alternative_grid_names internal_proj_operation_factory_context_set_use_proj_alternative_grid_names
+#define proj_pipeline_step_counts internal_proj_pipeline_step_counts
 #define proj_pj_info internal_proj_pj_info
 #define proj_prime_meridian_get_parameters internal_proj_prime_meridian_get_parameters
 #define proj_query_geodetic_crs_from_datum internal_proj_query_geodetic_crs_from_datum
@@ -277,6 +291,7 @@
 #define proj_trans internal_proj_trans
 #define proj_trans_array internal_proj_trans_array
 #define proj_trans_generic internal_proj_trans_generic
+#define proj_trans_grid internal_proj_trans_grid
 #define proj_uom_get_info_from_database internal_proj_uom_get_info_from_database
 #define proj_xy_dist internal_proj_xy_dist
 #define proj_xyz_dist internal_proj_xyz_dist
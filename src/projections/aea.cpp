@@ -67,6 +67,42 @@ static double phi1_(double qs, double Te, double Tone_es) {
 }
 
 
+/* phi1_() of the qs[i] where iterate[i] is set, iterating all of them in */
+/* lockstep: a point is no longer updated once it converged               */
+static void phi1_array(size_t n, const double *qs, const unsigned char *iterate,
+                       double Te, double Tone_es, double *phi) {
+    double qn[PJ_BATCH_SIZE] = {};
+    unsigned char done[PJ_BATCH_SIZE];
+    const double halfe_inv = .5 / Te;
+    size_t i, left = 0;
+    int iter;
+
+    for (i = 0;  i < n;  i++) {
+        phi[i] = asin (.5 * qs[i]);
+        qn[i] = qs[i] / Tone_es;
+        done[i] = !iterate[i];
+        left += iterate[i];
+    }
+    if (Te < EPSILON)
+        return;
+
+    for (iter = N_ITER;  iter && left;  iter--) {
+        left = 0;
+        for (i = 0;  i < n;  i++) {
+            const double sinpi = sin (phi[i]), cospi = cos (phi[i]);
+            const double con = Te * sinpi, com = 1. - con * con;
+            const double dphi = .5 * com * com / cospi * (qn[i] -
+                sinpi / com + halfe_inv * log ((1. - con) / (1. + con)));
+            phi[i] = done[i] ? phi[i] : phi[i] + dphi;
+            done[i] |= !(fabs(dphi) > TOL);
+            left += !done[i];
+        }
+    }
+    for (i = 0;  i < n;  i++)
+        phi[i] = done[i] ? phi[i] : HUGE_VAL;
+}
+
+
 namespace { // anonymous namespace
 struct pj_opaque {
     double  ec;
@@ -114,6 +150,30 @@ static PJ_XY e_forward (PJ_LP lp, PJ *P) {   /* Ellipsoid/spheroid, forward */
 }
 
 
+static void fwd_batch (PJ *P, size_t n, double *lam, double *phi) {
+    struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
+    double sinphi[PJ_BATCH_SIZE] = {}, q[PJ_BATCH_SIZE] = {};
+    size_t i;
+
+    for (i = 0;  i < n;  i++)
+        sinphi[i] = sin(phi[i]);
+    if (Q->ellips)
+        pj_qsfn_array(n, sinphi, P->e, P->one_es, q);
+
+    for (i = 0;  i < n;  i++) {
+        double rho = Q->c - (Q->ellips ? Q->n * q[i] : Q->n2 * sinphi[i]), a;
+        if (rho < 0.) {
+            proj_errno_set(P, PJD_ERR_TOLERANCE_CONDITION);
+            continue;
+        }
+        rho = Q->dd * sqrt(rho);
+        a = lam[i] * Q->n;
+        lam[i] = rho * sin(a);
+        phi[i] = Q->rho0 - rho * cos(a);
+    }
+}
+
+
 static PJ_LP e_inverse (PJ_XY xy, PJ *P) {   /* Ellipsoid/spheroid, inverse */
     PJ_LP lp = {0.0,0.0};
     struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
@@ -147,6 +207,50 @@ static PJ_LP e_inverse (PJ_XY xy, PJ *P) {   /* Ellipsoid/spheroid, inverse */
 
 
 
+static void inv_batch (PJ *P, size_t n, double *x, double *y) {
+    struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
+    double qs[PJ_BATCH_SIZE] = {}, phi[PJ_BATCH_SIZE] = {};
+    unsigned char apex[PJ_BATCH_SIZE] = {}, iterate[PJ_BATCH_SIZE] = {};
+    const double sign = Q->n < 0. ? -1. : 1.;
+    const double apex_phi = Q->n > 0. ? M_HALFPI : - M_HALFPI;
+    size_t i;
+    int failed = 0;
+
+    for (i = 0;  i < n;  i++) {
+        const double u = x[i], v = Q->rho0 - y[i];
+        const double rho = hypot(u, v), r = sign * rho / Q->dd;
+        apex[i] = rho == 0.0;
+        qs[i] = Q->c - r * r;
+        x[i] = apex[i] ? 0. : atan2(sign * u, sign * v) / Q->n;
+    }
+
+    if (!Q->ellips) {
+        for (i = 0;  i < n;  i++) {
+            const double s = qs[i] / Q->n2;
+            const double pole = s < 0. ? -M_HALFPI : M_HALFPI;
+            y[i] = apex[i] ? apex_phi : fabs(s) <= 1. ? asin(s) : pole;
+        }
+        return;
+    }
+
+    for (i = 0;  i < n;  i++) {
+        qs[i] /= Q->n;
+        iterate[i] = !apex[i] && fabs(Q->ec - fabs(qs[i])) > TOL7;
+    }
+    phi1_array(n, qs, iterate, P->e, P->one_es, phi);
+    for (i = 0;  i < n;  i++) {
+        const double pole = qs[i] < 0. ? -M_HALFPI : M_HALFPI;
+        const int bad = iterate[i] && phi[i] == HUGE_VAL;
+        y[i] = apex[i] ? apex_phi : iterate[i] ? phi[i] : pole;
+        x[i] = bad ? 0. : x[i];
+        failed |= bad;
+    }
+    if (failed)
+        proj_errno_set(P, PJD_ERR_TOLERANCE_CONDITION);
+}
+
+
+
 static PJ *setup(PJ *P) {
     double cosphi, sinphi;
     int secant;
@@ -154,6 +258,8 @@ static PJ *setup(PJ *P) {
 
     P->inv = e_inverse;
     P->fwd = e_forward;
+    P->inv_batch = inv_batch;
+    P->fwd_batch = fwd_batch;
 
     if (fabs(Q->phi1 + Q->phi2) < EPS10)
         return destructor(P, PJD_ERR_CONIC_LAT_EQUAL);
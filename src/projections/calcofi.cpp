@@ -55,7 +55,7 @@ static PJ_XY e_forward (PJ_LP lp, PJ *P) {          /* Ellipsoidal, forward */
     l1 = (xy.y - oy) * tan(ROTATION_ANGLE);
     l2 = -xy.x - l1 + PT_O_LAMBDA;
     ry = l2 * cos(ROTATION_ANGLE) * sin(ROTATION_ANGLE) + xy.y;
-    ry = pj_phi2(P->ctx, exp(-ry), P->e); /*inverse Mercator*/
+    ry = pj_phi2(P, exp(-ry)); /*inverse Mercator*/
     xy.x = PT_O_LINE - RAD_TO_DEG *
         (ry - PT_O_PHI) * DEG_TO_LINE / cos(ROTATION_ANGLE);
     xy.y = PT_O_STATION + RAD_TO_DEG *
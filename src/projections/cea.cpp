@@ -33,6 +33,34 @@ static PJ_XY s_forward (PJ_LP lp, PJ *P) {           /* Spheroidal, forward */
 }
 
 
+/* Fill the lattice row by row, y only depends on the latitude */
+static void lattice (PJ *P, const double *lam, size_t nlam,
+                     const double *phi, size_t nphi, PJ_COORD *out, int ellps) {
+    size_t i, j;
+    for (j = 0;  j < nphi;  j++) {
+        PJ_COORD *row = out + j*nlam;
+        double y = ellps ? 0.5 * pj_qsfn (sin (phi[j]), P->e, P->one_es) / P->k0 :
+                           sin(phi[j]) / P->k0;
+        for (i = 0;  i < nlam;  i++) {
+            row[i].xy.x = P->k0 * lam[i];
+            row[i].xy.y = y;
+        }
+    }
+}
+
+
+static void e_lattice (PJ *P, const double *lam, size_t nlam,
+                       const double *phi, size_t nphi, PJ_COORD *out) {
+    lattice (P, lam, nlam, phi, nphi, out, 1);
+}
+
+
+static void s_lattice (PJ *P, const double *lam, size_t nlam,
+                       const double *phi, size_t nphi, PJ_COORD *out) {
+    lattice (P, lam, nlam, phi, nphi, out, 0);
+}
+
+
 static PJ_LP e_inverse (PJ_XY xy, PJ *P) {          /* Ellipsoidal, inverse */
     PJ_LP lp = {0.0,0.0};
     lp.phi = pj_authlat(asin( 2. * xy.y * P->k0 / static_cast<struct pj_opaque*>(P->opaque)->qp), static_cast<struct pj_opaque*>(P->opaque)->apa);
@@ -94,9 +122,11 @@ PJ *PROJECTION(cea) {
         Q->qp = pj_qsfn(1., P->e, P->one_es);
         P->inv = e_inverse;
         P->fwd = e_forward;
+        P->fwd_lattice = e_lattice;
     } else {
         P->inv = s_inverse;
         P->fwd = s_forward;
+        P->fwd_lattice = s_lattice;
     }
 
     return P;
@@ -27,6 +27,32 @@ static PJ_XY s_forward (PJ_LP lp, PJ *P) {           /* Spheroidal, forward */
 }
 
 
+static void s_lattice (PJ *P, const double *lam, size_t nlam,
+                       const double *phi, size_t nphi, PJ_COORD *out) {
+    struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
+    size_t i, j;
+
+    for (j = 0;  j < nphi;  j++) {
+        PJ_COORD *row = out + j*nlam;
+        double y = phi[j] - P->phi0;
+        for (i = 0;  i < nlam;  i++) {
+            row[i].xy.x = Q->rc * lam[i];
+            row[i].xy.y = y;
+        }
+    }
+}
+
+
+static void s_fwd_batch (PJ *P, size_t n, double *lam, double *phi) {
+    struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
+
+    for (size_t i = 0;  i < n;  i++) {
+        lam[i] = Q->rc * lam[i];
+        phi[i] = phi[i] - P->phi0;
+    }
+}
+
+
 static PJ_LP s_inverse (PJ_XY xy, PJ *P) {           /* Spheroidal, inverse */
     PJ_LP lp = {0.0,0.0};
     struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
@@ -38,6 +64,16 @@ static PJ_LP s_inverse (PJ_XY xy, PJ *P) {           /* Spheroidal, inverse */
 }
 
 
+static void s_inv_batch (PJ *P, size_t n, double *x, double *y) {
+    struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
+
+    for (size_t i = 0;  i < n;  i++) {
+        x[i] = x[i] / Q->rc;
+        y[i] = y[i] + P->phi0;
+    }
+}
+
+
 PJ *PROJECTION(eqc) {
     struct pj_opaque *Q = static_cast<struct pj_opaque*>(pj_calloc (1, sizeof (struct pj_opaque)));
     if (nullptr==Q)
@@ -48,6 +84,9 @@ PJ *PROJECTION(eqc) {
         return pj_default_destructor (P, PJD_ERR_LAT_TS_LARGER_THAN_90);
     P->inv = s_inverse;
     P->fwd = s_forward;
+    P->fwd_lattice = s_lattice;
+    P->inv_batch = s_inv_batch;
+    P->fwd_batch = s_fwd_batch;
     P->es = 0.;
 
     return P;
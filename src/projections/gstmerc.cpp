@@ -47,7 +47,7 @@ static PJ_LP s_inverse (PJ_XY xy, PJ *P) {           /* Spheroidal, inverse */
     sinC = sin((xy.y * P->a - Q->YS) / Q->n2) / cosh((xy.x * P->a - Q->XS) / Q->n2);
     LC = log(pj_tsfn(-1.0 * asin(sinC), 0.0, 0.0));
     lp.lam = L / Q->n1;
-    lp.phi = -1.0 * pj_phi2(P->ctx, exp((LC - Q->c) / Q->n1), P->e);
+    lp.phi = -1.0 * pj_phi2(P, exp((LC - Q->c) / Q->n1));
 
     return lp;
 }
@@ -32,15 +32,14 @@ struct pj_opaque {
 
 #define EPS10   1.e-10
 
-static PJ_XY e_forward (PJ_LP lp, PJ *P) {          /* Ellipsoidal, forward */
+/* Ellipsoidal forward, given q = pj_qsfn() of the latitude */
+static PJ_XY e_forward_q (PJ_LP lp, double q, PJ *P) {
     PJ_XY xy = {0.0,0.0};
     struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
-    double coslam, sinlam, sinphi, q, sinb=0.0, cosb=0.0, b=0.0;
+    double coslam, sinlam, sinb=0.0, cosb=0.0, b=0.0;
 
     coslam = cos(lp.lam);
     sinlam = sin(lp.lam);
-    sinphi = sin(lp.phi);
-    q = pj_qsfn(sinphi, P->e, P->one_es);
 
     if (Q->mode == OBLIQ || Q->mode == EQUIT) {
         sinb = q / Q->qp;
@@ -94,6 +93,31 @@ eqcon:
 }
 
 
+static PJ_XY e_forward (PJ_LP lp, PJ *P) {          /* Ellipsoidal, forward */
+    return e_forward_q (lp, pj_qsfn(sin(lp.phi), P->e, P->one_es), P);
+}
+
+
+static void e_fwd_batch (PJ *P, size_t n, double *lam, double *phi) {
+    double sinphi[PJ_BATCH_SIZE] = {}, q[PJ_BATCH_SIZE];
+    size_t i;
+
+    for (i = 0;  i < n;  i++)
+        sinphi[i] = sin(phi[i]);
+    pj_qsfn_array(n, sinphi, P->e, P->one_es, q);
+
+    for (i = 0;  i < n;  i++) {
+        PJ_LP lp;
+        PJ_XY xy;
+        lp.lam = lam[i];
+        lp.phi = phi[i];
+        xy = e_forward_q (lp, q[i], P);
+        lam[i] = xy.x;
+        phi[i] = xy.y;
+    }
+}
+
+
 static PJ_XY s_forward (PJ_LP lp, PJ *P) {           /* Spheroidal, forward */
     PJ_XY xy = {0.0,0.0};
     struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
@@ -136,10 +160,13 @@ oblcon:
 }
 
 
-static PJ_LP e_inverse (PJ_XY xy, PJ *P) {          /* Ellipsoidal, inverse */
-    PJ_LP lp = {0.0,0.0};
+/* Ellipsoidal inverse, up to the sine ab of the authalic latitude. Returns */
+/* 0 where lp is complete without it.                                      */
+static int e_inverse_ab (PJ_XY xy, PJ *P, PJ_LP *lp, double *ab) {
     struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
-    double cCe, sCe, q, rho, ab=0.0;
+    double cCe, sCe, q, rho;
+
+    *ab = 0.0;
 
     switch (Q->mode) {
     case EQUIT:
@@ -148,19 +175,19 @@ static PJ_LP e_inverse (PJ_XY xy, PJ *P) {          /* Ellipsoidal, inverse */
         xy.y *=  Q->dd;
         rho = hypot(xy.x, xy.y);
         if (rho < EPS10) {
-            lp.lam = 0.;
-            lp.phi = P->phi0;
-            return lp;
+            lp->lam = 0.;
+            lp->phi = P->phi0;
+            return 0;
         }
         sCe = 2. * asin(.5 * rho / Q->rq);
         cCe = cos(sCe);
         sCe = sin(sCe);
         xy.x *= sCe;
         if (Q->mode == OBLIQ) {
-            ab = cCe * Q->sinb1 + xy.y * sCe * Q->cosb1 / rho;
+            *ab = cCe * Q->sinb1 + xy.y * sCe * Q->cosb1 / rho;
             xy.y = rho * Q->cosb1 * cCe - xy.y * Q->sinb1 * sCe;
         } else {
-            ab = xy.y * sCe / rho;
+            *ab = xy.y * sCe / rho;
             xy.y = rho * cCe;
         }
         break;
@@ -170,21 +197,54 @@ static PJ_LP e_inverse (PJ_XY xy, PJ *P) {          /* Ellipsoidal, inverse */
     case S_POLE:
         q = (xy.x * xy.x + xy.y * xy.y);
         if (q == 0.0) {
-            lp.lam = 0.;
-            lp.phi = P->phi0;
-            return (lp);
+            lp->lam = 0.;
+            lp->phi = P->phi0;
+            return 0;
         }
-        ab = 1. - q / Q->qp;
+        *ab = 1. - q / Q->qp;
         if (Q->mode == S_POLE)
-            ab = - ab;
+            *ab = - *ab;
         break;
     }
-    lp.lam = atan2(xy.x, xy.y);
-    lp.phi = pj_authlat(asin(ab), Q->apa);
+    lp->lam = atan2(xy.x, xy.y);
+    return 1;
+}
+
+
+static PJ_LP e_inverse (PJ_XY xy, PJ *P) {          /* Ellipsoidal, inverse */
+    PJ_LP lp = {0.0,0.0};
+    double ab;
+
+    if (e_inverse_ab (xy, P, &lp, &ab))
+        lp.phi = pj_authlat(asin(ab), static_cast<struct pj_opaque*>(P->opaque)->apa);
     return lp;
 }
 
 
+static void e_inv_batch (PJ *P, size_t n, double *x, double *y) {
+    double beta[PJ_BATCH_SIZE] = {}, authlat[PJ_BATCH_SIZE];
+    unsigned char authalic[PJ_BATCH_SIZE];
+    size_t i;
+
+    for (i = 0;  i < n;  i++) {
+        PJ_XY xy;
+        PJ_LP lp = {0.0,0.0};
+        double ab;
+        xy.x = x[i];
+        xy.y = y[i];
+        authalic[i] = static_cast<unsigned char>(e_inverse_ab (xy, P, &lp, &ab));
+        beta[i] = authalic[i] ? asin(ab) : 0.;
+        x[i] = lp.lam;
+        y[i] = lp.phi;
+    }
+
+    pj_authlat_array(n, beta, static_cast<struct pj_opaque*>(P->opaque)->apa, authlat);
+    for (i = 0;  i < n;  i++)
+        if (authalic[i])
+            y[i] = authlat[i];
+}
+
+
 static PJ_LP s_inverse (PJ_XY xy, PJ *P) {           /* Spheroidal, inverse */
     PJ_LP lp = {0.0,0.0};
     struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
@@ -286,6 +346,8 @@ PJ *PROJECTION(laea) {
         }
         P->inv = e_inverse;
         P->fwd = e_forward;
+        P->inv_batch = e_inv_batch;
+        P->fwd_batch = e_fwd_batch;
     } else {
         if (Q->mode == OBLIQ) {
             Q->sinb1 = sin(P->phi0);
@@ -1,5 +1,9 @@
 #define PJ_LIB__
 #include <errno.h>
+
+#include <new>
+#include <vector>
+
 #include "proj.h"
 #include "proj_internal.h"
 #include "proj_math.h"
@@ -43,6 +47,83 @@ static PJ_XY e_forward (PJ_LP lp, PJ *P) {          /* Ellipsoidal, forward */
 }
 
 
+static void e_fwd_batch (PJ *P, size_t n, double *lam, double *phi) {
+    struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
+    double sinphi[PJ_BATCH_SIZE] = {}, ts[PJ_BATCH_SIZE] = {};
+    size_t i;
+
+    if (P->es != 0.) {
+        for (i = 0;  i < n;  i++)
+            sinphi[i] = sin(phi[i]);
+        pj_tsfn_array(n, phi, sinphi, P->e, ts);
+    }
+
+    for (i = 0;  i < n;  i++) {
+        double rho, a;
+        if (fabs(fabs(phi[i]) - M_HALFPI) < EPS10) {
+            if ((phi[i] * Q->n) <= 0.) {
+                proj_errno_set(P, PJD_ERR_TOLERANCE_CONDITION);
+                continue;
+            }
+            rho = 0.;
+        } else {
+            rho = Q->c * (P->es != 0. ?
+                          pow(ts[i], Q->n) :
+                          pow(tan(M_FORTPI + .5 * phi[i]), -Q->n));
+        }
+        a = lam[i] * Q->n;
+        lam[i] = P->k0 * (rho * sin(a));
+        phi[i] = P->k0 * (Q->rho0 - rho * cos(a));
+    }
+}
+
+
+/* rho only depends on the latitude, and the angle on the longitude */
+static void e_lattice (PJ *P, const double *lam, size_t nlam,
+                       const double *phi, size_t nphi, PJ_COORD *out) {
+    struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
+    std::vector<double> s, c;
+    size_t i, j;
+
+    try {
+        s.resize (nlam);
+        c.resize (nlam);
+    } catch (const std::bad_alloc &) {
+        proj_errno_set(P, ENOMEM);
+        for (i = 0;  i < nlam*nphi;  i++)
+            out[i] = proj_coord_error();
+        return;
+    }
+    for (i = 0;  i < nlam;  i++) {
+        double a = lam[i] * Q->n;
+        s[i] = sin(a);
+        c[i] = cos(a);
+    }
+
+    for (j = 0;  j < nphi;  j++) {
+        PJ_COORD *row = out + j*nlam;
+        double rho;
+        if (fabs(fabs(phi[j]) - M_HALFPI) < EPS10) {
+            if ((phi[j] * Q->n) <= 0.) {
+                proj_errno_set(P, PJD_ERR_TOLERANCE_CONDITION);
+                for (i = 0;  i < nlam;  i++)
+                    row[i] = proj_coord_error();
+                continue;
+            }
+            rho = 0.;
+        } else {
+            rho = Q->c * (P->es != 0. ?
+                          pow(pj_tsfn(phi[j], sin(phi[j]), P->e), Q->n) :
+                          pow(tan(M_FORTPI + .5 * phi[j]), -Q->n));
+        }
+        for (i = 0;  i < nlam;  i++) {
+            row[i].xy.x = P->k0 * (rho * s[i]);
+            row[i].xy.y = P->k0 * (Q->rho0 - rho * c[i]);
+        }
+    }
+}
+
+
 static PJ_LP e_inverse (PJ_XY xy, PJ *P) {          /* Ellipsoidal, inverse */
     PJ_LP lp = {0., 0.};
     struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
@@ -60,7 +141,7 @@ static PJ_LP e_inverse (PJ_XY xy, PJ *P) {          /* Ellipsoidal, inverse */
             xy.y = -xy.y;
         }
         if (P->es != 0.) {
-            lp.phi = pj_phi2(P->ctx, pow(rho / Q->c, 1./Q->n), P->e);
+            lp.phi = pj_phi2(P, pow(rho / Q->c, 1./Q->n));
             if (lp.phi == HUGE_VAL) {
                 proj_errno_set(P, PJD_ERR_TOLERANCE_CONDITION);
                 return lp;
@@ -77,6 +158,49 @@ static PJ_LP e_inverse (PJ_XY xy, PJ *P) {          /* Ellipsoidal, inverse */
 }
 
 
+static void e_inv_batch (PJ *P, size_t n, double *x, double *y) {
+    struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
+    double ts[PJ_BATCH_SIZE] = {}, phi[PJ_BATCH_SIZE];
+    unsigned char apex[PJ_BATCH_SIZE];
+    size_t i;
+
+    for (i = 0;  i < n;  i++) {
+        double rho, u = x[i] / P->k0, v = y[i] / P->k0;
+
+        v = Q->rho0 - v;
+        rho = hypot(u, v);
+        ts[i] = 1.;
+        apex[i] = rho == 0.;
+        if (apex[i]) {
+            x[i] = 0.;
+            y[i] = Q->n > 0. ? M_HALFPI : -M_HALFPI;
+            continue;
+        }
+        if (Q->n < 0.) {
+            rho = -rho;
+            u = -u;
+            v = -v;
+        }
+        if (P->es != 0.)
+            ts[i] = pow(rho / Q->c, 1./Q->n);
+        else
+            y[i] = 2. * atan(pow(Q->c / rho, 1./Q->n)) - M_HALFPI;
+        x[i] = atan2(u, v) / Q->n;
+    }
+
+    if (P->es == 0.)
+        return;
+    pj_phi2_array(P, n, ts, phi);
+    for (i = 0;  i < n;  i++) {
+        if (apex[i])
+            continue;
+        if (phi[i] == HUGE_VAL)
+            proj_errno_set(P, PJD_ERR_TOLERANCE_CONDITION);
+        y[i] = phi[i];
+    }
+}
+
+
 PJ *PROJECTION(lcc) {
     double cosphi, sinphi;
     int secant;
@@ -125,6 +249,9 @@ PJ *PROJECTION(lcc) {
 
     P->inv = e_inverse;
     P->fwd = e_forward;
+    P->fwd_lattice = e_lattice;
+    P->fwd_batch = e_fwd_batch;
+    P->inv_batch = e_inv_batch;
 
     return P;
 }
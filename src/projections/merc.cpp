@@ -44,9 +44,73 @@ static PJ_XY s_forward (PJ_LP lp, PJ *P) {           /* Spheroidal, forward */
 }
 
 
+static void e_fwd_batch (PJ *P, size_t n, double *lam, double *phi) {
+    double sinphi[PJ_BATCH_SIZE] = {}, ts[PJ_BATCH_SIZE];
+    size_t i;
+
+    for (i = 0;  i < n;  i++)
+        sinphi[i] = sin(phi[i]);
+    pj_tsfn_array(n, phi, sinphi, P->e, ts);
+
+    for (i = 0;  i < n;  i++) {
+        if (fabs(fabs(phi[i]) - M_HALFPI) <= EPS10)
+            proj_errno_set(P, PJD_ERR_TOLERANCE_CONDITION);
+        lam[i] = P->k0 * lam[i];
+        phi[i] = - P->k0 * log(ts[i]);
+    }
+}
+
+
+static void s_fwd_batch (PJ *P, size_t n, double *lam, double *phi) {
+    for (size_t i = 0;  i < n;  i++) {
+        if (fabs(fabs(phi[i]) - M_HALFPI) <= EPS10)
+            proj_errno_set(P, PJD_ERR_TOLERANCE_CONDITION);
+        lam[i] = P->k0 * lam[i];
+        phi[i] = P->k0 * logtanpfpim1(phi[i]);
+    }
+}
+
+
+/* Fill the lattice row by row, y only depends on the latitude */
+static void lattice (PJ *P, const double *lam, size_t nlam,
+                     const double *phi, size_t nphi, PJ_COORD *out, int ellps) {
+    size_t i, j;
+    for (j = 0;  j < nphi;  j++) {
+        PJ_COORD *row = out + j*nlam;
+        double y;
+        if (fabs(fabs(phi[j]) - M_HALFPI) <= EPS10) {
+            proj_errno_set(P, PJD_ERR_TOLERANCE_CONDITION);
+            for (i = 0;  i < nlam;  i++)
+                row[i] = proj_coord_error();
+            continue;
+        }
+        if (ellps)
+            y = - P->k0 * log(pj_tsfn(phi[j], sin(phi[j]), P->e));
+        else
+            y = P->k0 * logtanpfpim1(phi[j]);
+        for (i = 0;  i < nlam;  i++) {
+            row[i].xy.x = P->k0 * lam[i];
+            row[i].xy.y = y;
+        }
+    }
+}
+
+
+static void e_lattice (PJ *P, const double *lam, size_t nlam,
+                       const double *phi, size_t nphi, PJ_COORD *out) {
+    lattice (P, lam, nlam, phi, nphi, out, 1);
+}
+
+
+static void s_lattice (PJ *P, const double *lam, size_t nlam,
+                       const double *phi, size_t nphi, PJ_COORD *out) {
+    lattice (P, lam, nlam, phi, nphi, out, 0);
+}
+
+
 static PJ_LP e_inverse (PJ_XY xy, PJ *P) {          /* Ellipsoidal, inverse */
     PJ_LP lp = {0.0,0.0};
-    if ((lp.phi = pj_phi2(P->ctx, exp(- xy.y / P->k0), P->e)) == HUGE_VAL) {
+    if ((lp.phi = pj_phi2(P, exp(- xy.y / P->k0))) == HUGE_VAL) {
         proj_errno_set(P, PJD_ERR_TOLERANCE_CONDITION);
         return lp;
 }
@@ -63,6 +127,30 @@ static PJ_LP s_inverse (PJ_XY xy, PJ *P) {           /* Spheroidal, inverse */
 }
 
 
+static void e_inv_batch (PJ *P, size_t n, double *x, double *y) {
+    double ts[PJ_BATCH_SIZE] = {};
+    size_t i;
+
+    for (i = 0;  i < n;  i++)
+        ts[i] = exp(- y[i] / P->k0);
+    pj_phi2_array(P, n, ts, y);
+
+    for (i = 0;  i < n;  i++) {
+        if (y[i] == HUGE_VAL)
+            proj_errno_set(P, PJD_ERR_TOLERANCE_CONDITION);
+        x[i] = x[i] / P->k0;
+    }
+}
+
+
+static void s_inv_batch (PJ *P, size_t n, double *x, double *y) {
+    for (size_t i = 0;  i < n;  i++) {
+        y[i] = atan(sinh(y[i] / P->k0));
+        x[i] = x[i] / P->k0;
+    }
+}
+
+
 PJ *PROJECTION(merc) {
     double phits=0.0;
     int is_phits;
@@ -78,6 +166,9 @@ PJ *PROJECTION(merc) {
             P->k0 = pj_msfn(sin(phits), cos(phits), P->es);
         P->inv = e_inverse;
         P->fwd = e_forward;
+        P->fwd_lattice = e_lattice;
+        P->inv_batch = e_inv_batch;
+        P->fwd_batch = e_fwd_batch;
     }
 
     else { /* sphere */
@@ -85,6 +176,9 @@ PJ *PROJECTION(merc) {
             P->k0 = cos(phits);
         P->inv = s_inverse;
         P->fwd = s_forward;
+        P->fwd_lattice = s_lattice;
+        P->inv_batch = s_inv_batch;
+        P->fwd_batch = s_fwd_batch;
     }
 
     return P;
@@ -97,5 +191,8 @@ PJ *PROJECTION(webmerc) {
 
     P->inv = s_inverse;
     P->fwd = s_forward;
+    P->fwd_lattice = s_lattice;
+    P->inv_batch = s_inv_batch;
+    P->fwd_batch = s_fwd_batch;
     return P;
 }
@@ -106,7 +106,7 @@ static PJ_LP e_inverse (PJ_XY xy, PJ *P) {          /* Ellipsoidal, inverse */
         lp.phi = Up < 0. ? -M_HALFPI : M_HALFPI;
     } else {
         lp.phi = Q->E / sqrt((1. + Up) / (1. - Up));
-        if ((lp.phi = pj_phi2(P->ctx, pow(lp.phi, 1. / Q->B), P->e)) == HUGE_VAL) {
+        if ((lp.phi = pj_phi2(P, pow(lp.phi, 1. / Q->B))) == HUGE_VAL) {
             proj_errno_set(P, PJD_ERR_TOLERANCE_CONDITION);
             return lp;
         }
@@ -41,16 +41,30 @@ static double ssfn_ (double phit, double sinphi, double eccen) {
 }
 
 
-static PJ_XY e_forward (PJ_LP lp, PJ *P) {          /* Ellipsoidal, forward */
+/* The latitude dependent factor of the ellipsoidal forward: ssfn_() for */
+/* the oblique and equatorial aspects, pj_tsfn() for the polar ones      */
+static double e_factor (double phi, double sinphi, PJ *P) {
+    switch (static_cast<struct pj_opaque*>(P->opaque)->mode) {
+    case S_POLE:
+        return pj_tsfn (-phi, -sinphi, P->e);
+    case N_POLE:
+        return pj_tsfn (phi, sinphi, P->e);
+    default:
+        return ssfn_(phi, sinphi, P->e);
+    }
+}
+
+
+/* Ellipsoidal forward, given t = e_factor() of the latitude */
+static PJ_XY e_forward_t (PJ_LP lp, double t, PJ *P) {
     PJ_XY xy = {0.0,0.0};
     struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
-    double coslam, sinlam, sinX = 0.0, cosX = 0.0, X, A = 0.0, sinphi;
+    double coslam, sinlam, sinX = 0.0, cosX = 0.0, X, A = 0.0;
 
     coslam = cos (lp.lam);
     sinlam = sin (lp.lam);
-    sinphi = sin (lp.phi);
     if (Q->mode == OBLIQ || Q->mode == EQUIT) {
-        sinX = sin (X = 2. * atan(ssfn_(lp.phi, sinphi, P->e)) - M_HALFPI);
+        sinX = sin (X = 2. * atan(t) - M_HALFPI);
         cosX = cos (X);
     }
 
@@ -74,12 +88,10 @@ xmul:
         break;
 
     case S_POLE:
-        lp.phi = -lp.phi;
         coslam = - coslam;
-        sinphi = -sinphi;
         /*-fallthrough*/
     case N_POLE:
-        xy.x = Q->akm1 * pj_tsfn (lp.phi, sinphi, P->e);
+        xy.x = Q->akm1 * t;
         xy.y = - xy.x * coslam;
         break;
     }
@@ -89,6 +101,48 @@ xmul:
 }
 
 
+static PJ_XY e_forward (PJ_LP lp, PJ *P) {          /* Ellipsoidal, forward */
+    return e_forward_t (lp, e_factor (lp.phi, sin (lp.phi), P), P);
+}
+
+
+static void e_fwd_batch (PJ *P, size_t n, double *lam, double *phi) {
+    double sinphi[PJ_BATCH_SIZE] = {}, t[PJ_BATCH_SIZE] = {};
+    size_t i;
+
+    for (i = 0;  i < n;  i++)
+        sinphi[i] = sin (phi[i]);
+    switch (static_cast<struct pj_opaque*>(P->opaque)->mode) {
+    case N_POLE:
+        pj_tsfn_array (n, phi, sinphi, P->e, t);
+        break;
+    case S_POLE: {
+        double mphi[PJ_BATCH_SIZE] = {};
+        for (i = 0;  i < n;  i++) {
+            mphi[i] = -phi[i];
+            sinphi[i] = -sinphi[i];
+        }
+        pj_tsfn_array (n, mphi, sinphi, P->e, t);
+        break;
+    }
+    default:
+        for (i = 0;  i < n;  i++)
+            t[i] = ssfn_(phi[i], sinphi[i], P->e);
+        break;
+    }
+
+    for (i = 0;  i < n;  i++) {
+        PJ_LP lp;
+        PJ_XY xy;
+        lp.lam = lam[i];
+        lp.phi = phi[i];
+        xy = e_forward_t (lp, t[i], P);
+        lam[i] = xy.x;
+        phi[i] = xy.y;
+    }
+}
+
+
 static PJ_XY s_forward (PJ_LP lp, PJ *P) {           /* Spheroidal, forward */
     PJ_XY xy = {0.0,0.0};
     struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
@@ -181,6 +235,68 @@ static PJ_LP e_inverse (PJ_XY xy, PJ *P) {          /* Ellipsoidal, inverse */
 }
 
 
+/* e_inverse() with the iterations of all points run in lockstep: a point */
+/* is no longer updated once it converged                                 */
+static void e_inv_batch (PJ *P, size_t n, double *x, double *y) {
+    struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
+    double tp[PJ_BATCH_SIZE] = {}, phi_l[PJ_BATCH_SIZE] = {};
+    unsigned char done[PJ_BATCH_SIZE] = {};
+    double halfe, halfpi;
+    size_t i, left = n;
+    int iter, failed = 0;
+
+    switch (Q->mode) {
+    case OBLIQ:
+    case EQUIT:
+        for (i = 0;  i < n;  i++) {
+            const double rho = hypot (x[i], y[i]);
+            const double c = 2. * atan2 (rho * Q->cosX1, Q->akm1);
+            const double cosphi = cos (c), sinphi = sin (c);
+            const double a = cosphi * Q->sinX1;
+            const double phi = asin (rho == 0.0 ? a : a + (y[i] * sinphi * Q->cosX1 / rho));
+            tp[i] = tan (.5 * (M_HALFPI + phi));
+            phi_l[i] = phi;
+            x[i] *= sinphi;
+            y[i] = rho * Q->cosX1 * cosphi - y[i] * Q->sinX1* sinphi;
+        }
+        halfpi = M_HALFPI;
+        halfe = .5 * P->e;
+        break;
+    default:
+        for (i = 0;  i < n;  i++) {
+            const double rho = hypot (x[i], y[i]);
+            y[i] = Q->mode == N_POLE ? -y[i] : y[i];
+            tp[i] = - rho / Q->akm1;
+            phi_l[i] = M_HALFPI - 2. * atan (tp[i]);
+        }
+        halfpi = -M_HALFPI;
+        halfe = -.5 * P->e;
+        break;
+    }
+
+    for (iter = NITER;  iter && left;  iter--) {
+        left = 0;
+        for (i = 0;  i < n;  i++) {
+            const double sinphi = P->e * sin (phi_l[i]);
+            const double phi = 2. * atan (tp[i] * pow ((1.+sinphi)/(1.-sinphi), halfe)) - halfpi;
+            const int converged = fabs (phi_l[i] - phi) < CONV;
+            phi_l[i] = done[i] ? phi_l[i] : phi;
+            done[i] |= converged;
+            left += !done[i];
+        }
+    }
+
+    for (i = 0;  i < n;  i++) {
+        const double lam = (x[i] == 0. && y[i] == 0.) ? 0. : atan2 (x[i], y[i]);
+        x[i] = done[i] ? lam : 0.;
+        y[i] = done[i] && Q->mode == S_POLE ? -phi_l[i] : phi_l[i];
+        failed |= !done[i];
+    }
+    if (failed)
+        proj_errno_set(P, PJD_ERR_TOLERANCE_CONDITION);
+}
+
+
 static PJ_LP s_inverse (PJ_XY xy, PJ *P) {           /* Spheroidal, inverse */
     PJ_LP lp = {0.0,0.0};
     struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
@@ -260,6 +376,8 @@ static PJ *setup(PJ *P) {                   /* general initialization */
         }
         P->inv = e_inverse;
         P->fwd = e_forward;
+        P->inv_batch = e_inv_batch;
+        P->fwd_batch = e_fwd_batch;
     } else {
         switch (Q->mode) {
         case OBLIQ:
@@ -81,6 +81,38 @@ static PJ_LP e_inverse (PJ_XY xy, PJ *P) {          /* Ellipsoidal, inverse */
 }
 
 
+static void e_fwd_batch (PJ *P, size_t n, double *lam, double *phi) {
+    struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
+    const double kR2 = P->k0 * Q->R2;
+
+    pj_gauss_array(n, lam, phi, Q->en);
+    for (size_t i = 0; i < n; i++) {
+        const double sinc = sin(phi[i]), cosc = cos(phi[i]);
+        const double cosl = cos(lam[i]);
+        const double k = kR2 / (1. + Q->sinc0 * sinc + Q->cosc0 * cosc * cosl);
+        lam[i] = k * cosc * sin(lam[i]);
+        phi[i] = k * (Q->cosc0 * sinc - Q->sinc0 * cosc * cosl);
+    }
+}
+
+
+static void e_inv_batch (PJ *P, size_t n, double *x, double *y) {
+    struct pj_opaque *Q = static_cast<struct pj_opaque*>(P->opaque);
+
+    for (size_t i = 0; i < n; i++) {
+        const double u = x[i] / P->k0, v = y[i] / P->k0;
+        const double rho = hypot (u, v);
+        const double c = 2. * atan2 (rho, Q->R2);
+        const double sinc = sin (c), cosc = cos (c);
+        const double phi = asin (cosc * Q->sinc0 + v * sinc * Q->cosc0 / rho);
+        const double lam = atan2 (u * sinc, rho * Q->cosc0 * cosc - v * Q->sinc0 * sinc);
+        x[i] = rho != 0.0 ? lam : 0.;
+        y[i] = rho != 0.0 ? phi : Q->phic0;
+    }
+    pj_inv_gauss_array(P->ctx, n, x, y, Q->en);
+}
+
+
 static PJ *destructor (PJ *P, int errlev) {
     if (nullptr==P)
         return nullptr;
@@ -111,6 +143,8 @@ PJ *PROJECTION(sterea) {
 
     P->inv = e_inverse;
     P->fwd = e_forward;
+    P->inv_batch = e_inv_batch;
+    P->fwd_batch = e_fwd_batch;
     P->destructor = destructor;
 
     return P;
@@ -255,42 +255,42 @@ static PJ *setup_approx(PJ *P) {
 /*****************************************************************************/
 
 /* Helper functios for "exact" transverse mercator */
+/* The caller provides cos(2*B) and sin(2*B), as they can generally be derived */
+/* from quantities it has already computed, without calling cos() and sin().   */
 #ifdef _GNU_SOURCE
     inline
 #endif
-static double gatg(double *p1, int len_p1, double B) {
-    double *p;
-    double h = 0, h1, h2 = 0, cos_2B;
+static double gatg(const double *p1, int len_p1, double B,
+                   double cos_2B, double sin_2B) {
+    const double *p;
+    double h = 0, h1, h2 = 0;
 
-    cos_2B = 2*cos(2*B);
+    const double two_cos_2B = 2*cos_2B;
     p = p1 + len_p1;
     h1 = *--p;
     while (p - p1) {
-        h = -h2 + cos_2B*h1 + *--p;
+        h = -h2 + two_cos_2B*h1 + *--p;
         h2 = h1;
         h1 = h;
     }
-    return (B + h*sin(2*B));
+    return (B + h*sin_2B);
 }
 
 /* Complex Clenshaw summation */
+/* The sine/cosine of the real part and hyperbolic sine/cosine of the */
+/* imaginary part of the argument are provided by the caller.         */
 #ifdef _GNU_SOURCE
     inline
 #endif
-static double clenS(double *a, int size, double arg_r, double arg_i, double *R, double *I) {
-    double      *p, r, i, hr, hr1, hr2, hi, hi1, hi2;
-    double      sin_arg_r, cos_arg_r, sinh_arg_i, cosh_arg_i;
+static double clenS(const double *a, int size,
+                    double sin_arg_r, double cos_arg_r,
+                    double sinh_arg_i, double cosh_arg_i,
+                    double *R, double *I) {
+    const double *p;
+    double      r, i, hr, hr1, hr2, hi, hi1, hi2;
 
     /* arguments */
     p = a + size;
-#ifdef _GNU_SOURCE
-    sincos(arg_r, &sin_arg_r, &cos_arg_r);
-#else
-    sin_arg_r  = sin(arg_r);
-    cos_arg_r  = cos(arg_r);
-#endif
-    sinh_arg_i = sinh(arg_i);
-    cosh_arg_i = cosh(arg_i);
     r          =  2*cos_arg_r*cosh_arg_i;
     i          = -2*sin_arg_r*sinh_arg_i;
 
@@ -315,8 +315,9 @@ static double clenS(double *a, int size, double arg_r, double arg_i, double *R,
 
 
 /* Real Clenshaw summation */
-static double clens(double *a, int size, double arg_r) {
-    double      *p, r, hr, hr1, hr2, cos_arg_r;
+static double clens(const double *a, int size, double arg_r) {
+    const double *p;
+    double      r, hr, hr1, hr2, cos_arg_r;
 
     p = a + size;
     cos_arg_r  = cos(arg_r);
@@ -334,31 +335,62 @@ static double clens(double *a, int size, double arg_r) {
 }
 
 /* Ellipsoidal, forward */
+/*
+ * The successive rotations of the Poder/Engsager algorithm are expressed with
+ * trigonometric identities, so that besides the sine/cosine of the input
+ * coordinates and of the Gaussian latitude, a single atan2() and asinh() are
+ * needed per point:
+ *
+ *   denom       = sin_Cn^2 + (cos_Cn*cos_Ce)^2
+ *   tan(Ce')    = sin_Ce*cos_Cn / sqrt(denom)
+ *   sin(2*Cn')  = 2*sin_Cn*cos_Cn*cos_Ce / denom
+ *   cos(2*Cn')  = 2*(cos_Cn*cos_Ce)^2 / denom - 1
+ *   sinh(2*Ce") = 2*sin_Ce*cos_Cn / denom    where Ce" = asinh(tan(Ce'))
+ *   cosh(2*Ce") = 2 / denom - 1
+ */
 static PJ_XY exact_e_fwd (PJ_LP lp, PJ *P) {
     PJ_XY xy = {0.0,0.0};
     struct pj_opaque_exact *Q = static_cast<struct pj_opaque_exact*>(P->opaque);
-    double sin_Cn, cos_Cn, cos_Ce, sin_Ce, dCn, dCe;
-    double Cn = lp.phi, Ce = lp.lam;
+    double sin_phi, cos_phi, sin_Cn, cos_Cn, cos_Ce, sin_Ce, dCn, dCe;
+    double Cn, Ce;
+
+#ifdef _GNU_SOURCE
+    sincos (lp.phi, &sin_phi, &cos_phi);
+#else
+    sin_phi = sin (lp.phi);
+    cos_phi = cos (lp.phi);
+#endif
 
     /* ell. LAT, LNG -> Gaussian LAT, LNG */
-    Cn  = gatg (Q->cbg, PROJ_ETMERC_ORDER, Cn);
+    Cn  = gatg (Q->cbg, PROJ_ETMERC_ORDER, lp.phi,
+                cos_phi*cos_phi - sin_phi*sin_phi, 2*sin_phi*cos_phi);
     /* Gaussian LAT, LNG -> compl. sph. LAT */
 #ifdef _GNU_SOURCE
     sincos (Cn, &sin_Cn, &cos_Cn);
-    sincos (Ce, &sin_Ce, &cos_Ce);
+    sincos (lp.lam, &sin_Ce, &cos_Ce);
 #else
     sin_Cn = sin (Cn);
     cos_Cn = cos (Cn);
-    sin_Ce = sin (Ce);
-    cos_Ce = cos (Ce);
+    sin_Ce = sin (lp.lam);
+    cos_Ce = cos (lp.lam);
 #endif
 
-    Cn     = atan2 (sin_Cn, cos_Ce*cos_Cn);
-    Ce     = atan2 (sin_Ce*cos_Cn,  hypot (sin_Cn, cos_Cn*cos_Ce));
+    const double cos_Cn_cos_Ce = cos_Cn*cos_Ce;
+    const double sin_Ce_cos_Cn = sin_Ce*cos_Cn;
+    const double denom = sin_Cn*sin_Cn + cos_Cn_cos_Ce*cos_Cn_cos_Ce;
+    const double two_inv_denom = 2 / denom;
+
+    Cn     = atan2 (sin_Cn, cos_Cn_cos_Ce);
 
     /* compl. sph. N, E -> ell. norm. N, E */
-    Ce  = asinh ( tan (Ce) );     /* Replaces: Ce  = log(tan(FORTPI + Ce*0.5)); */
-    Cn += clenS (Q->gtu, PROJ_ETMERC_ORDER, 2*Cn, 2*Ce, &dCn, &dCe);
+    /* Replaces: Ce = asinh(tan(atan2(sin_Ce*cos_Cn, sqrt(denom)))) */
+    Ce  = asinh (sin_Ce_cos_Cn / sqrt (denom));
+    Cn += clenS (Q->gtu, PROJ_ETMERC_ORDER,
+                 sin_Cn * cos_Cn_cos_Ce * two_inv_denom,
+                 cos_Cn_cos_Ce * cos_Cn_cos_Ce * two_inv_denom - 1,
+                 sin_Ce_cos_Cn * two_inv_denom,
+                 two_inv_denom - 1,
+                 &dCn, &dCe);
     Ce += dCe;
     if (fabs (Ce) <= 2.623395162778) {
         xy.y  = Q->Qn * Cn + Q->Zb;  /* Northing */
@@ -370,10 +402,20 @@ static PJ_XY exact_e_fwd (PJ_LP lp, PJ *P) {
 
 
 /* Ellipsoidal, inverse */
+/*
+ * As in the forward direction, the rotations are expressed with
+ * trigonometric identities. With sinh_Ce = sinh(Ce) and
+ * cosh_Ce = sqrt(1 + sinh_Ce^2):
+ *
+ *   lam         = atan2(sinh_Ce, cos_Cn)
+ *   phi_gauss   = atan2(sin_Cn, hypot(sinh_Ce, cos_Cn))
+ *   sin(2*phi_gauss) = 2*sin_Cn*hypot(sinh_Ce, cos_Cn) / cosh_Ce^2
+ *   cos(2*phi_gauss) = (sinh_Ce^2 + cos_Cn^2 - sin_Cn^2) / cosh_Ce^2
+ */
 static PJ_LP exact_e_inv (PJ_XY xy, PJ *P) {
     PJ_LP lp = {0.0,0.0};
     struct pj_opaque_exact *Q = static_cast<struct pj_opaque_exact*>(P->opaque);
-    double sin_Cn, cos_Cn, cos_Ce, sin_Ce, dCn, dCe;
+    double sin_Cn, cos_Cn, sin_2Cn, cos_2Cn, dCn, dCe;
     double Cn = xy.y, Ce = xy.x;
 
     /* normalize N, E */
@@ -382,23 +424,34 @@ static PJ_LP exact_e_inv (PJ_XY xy, PJ *P) {
 
     if (fabs(Ce) <= 2.623395162778) { /* 150 degrees */
         /* norm. N, E -> compl. sph. LAT, LNG */
-        Cn += clenS(Q->utg, PROJ_ETMERC_ORDER, 2*Cn, 2*Ce, &dCn, &dCe);
+#ifdef _GNU_SOURCE
+        sincos (2*Cn, &sin_2Cn, &cos_2Cn);
+#else
+        sin_2Cn = sin (2*Cn);
+        cos_2Cn = cos (2*Cn);
+#endif
+        const double sinh_2Ce = sinh (2*Ce);
+        const double cosh_2Ce = sqrt (1 + sinh_2Ce*sinh_2Ce);
+        Cn += clenS(Q->utg, PROJ_ETMERC_ORDER, sin_2Cn, cos_2Cn,
+                    sinh_2Ce, cosh_2Ce, &dCn, &dCe);
         Ce += dCe;
-        Ce = atan (sinh (Ce)); /* Replaces: Ce = 2*(atan(exp(Ce)) - FORTPI); */
         /* compl. sph. LAT -> Gaussian LAT, LNG */
+        /* Replaces: Ce = atan (sinh (Ce)), followed by the rotation */
 #ifdef _GNU_SOURCE
         sincos (Cn, &sin_Cn, &cos_Cn);
-        sincos (Ce, &sin_Ce, &cos_Ce);
 #else
         sin_Cn = sin (Cn);
         cos_Cn = cos (Cn);
-        sin_Ce = sin (Ce);
-        cos_Ce = cos (Ce);
 #endif
-        Ce     = atan2 (sin_Ce, cos_Ce*cos_Cn);
-        Cn     = atan2 (sin_Cn*cos_Ce,  hypot (sin_Ce, cos_Ce*cos_Cn));
+        const double sinh_Ce = sinh (Ce);
+        const double cosh2_Ce = 1 + sinh_Ce*sinh_Ce;
+        const double hyp = hypot (sinh_Ce, cos_Cn);
+        Ce     = atan2 (sinh_Ce, cos_Cn);
+        Cn     = atan2 (sin_Cn, hyp);
         /* Gaussian LAT, LNG -> ell. LAT, LNG */
-        lp.phi = gatg (Q->cgb,  PROJ_ETMERC_ORDER, Cn);
+        lp.phi = gatg (Q->cgb, PROJ_ETMERC_ORDER, Cn,
+                       (hyp*hyp - sin_Cn*sin_Cn) / cosh2_Ce,
+                       2*sin_Cn*hyp / cosh2_Ce);
         lp.lam = Ce;
     }
     else
@@ -483,7 +536,8 @@ static PJ *setup_exact(PJ *P) {
     Q->gtu[5] = np*(212378941/319334400.0);
 
     /* Gaussian latitude value of the origin latitude */
-    Z = gatg (Q->cbg, PROJ_ETMERC_ORDER, P->phi0);
+    Z = gatg (Q->cbg, PROJ_ETMERC_ORDER, P->phi0,
+              cos (2*P->phi0), sin (2*P->phi0));
 
     /* Origin northing minus true northing at the origin latitude */
     /* i.e. true northing = N - P->Zb                         */
@@ -21,3 +21,26 @@ double pj_qsfn(double sinphi, double e, double one_es) {
     } else
         return (sinphi + sinphi);
 }
+
+
+/* Same operations as pj_qsfn(), with the zero division check as a select */
+void pj_qsfn_array(size_t n, const double *sinphi, double e, double one_es, double *q) {
+    double halfe_inv;
+    size_t i;
+
+    if (e < EPSILON) {
+        for (i = 0;  i < n;  i++)
+            q[i] = sinphi[i] + sinphi[i];
+        return;
+    }
+
+    halfe_inv = .5 / e;
+    for (i = 0;  i < n;  i++) {
+        const double con = e * sinphi[i];
+        const double div1 = 1.0 - con * con;
+        const double div2 = 1.0 + con;
+        const double v = one_es * (sinphi[i] / div1 - halfe_inv * log ((1. - con) / div2));
+        /* div2 can only be zero where div1 is */
+        q[i] = div1 == 0.0 ? HUGE_VAL : v;
+    }
+}
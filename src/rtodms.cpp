@@ -17,10 +17,9 @@
 RES = 1000.,
 RES60 = 60000.,
 CONV = 206264806.24709635516;
-	static char
-format[50] = "%dd%d'%.3f\"%c";
 	static int
-dolong = 0;
+dolong = 0,
+fract_digits = 3;
 	void
 set_rtodms(int fract, int con_w) {
 	int i;
@@ -32,14 +31,47 @@ set_rtodms(int fract, int con_w) {
 			RES *= 10.;
 		RES60 = RES * 60.;
 		CONV = 180. * 3600. * RES / M_PI;
-		if (! con_w)
-			(void)sprintf(format,"%%dd%%d'%%.%df\"%%c", fract);
-		else
-			(void)sprintf(format,"%%dd%%02d'%%0%d.%df\"%%c",
-				fract+2+(fract?1:0), fract);
+		fract_digits = fract;
 		dolong = con_w;
 	}
 }
+/* Integer, with at least ndigits digits, as "%0*d" */
+	static char *
+put_int(char *s, int v, int ndigits) {
+	char digits[12];
+	int n = 0;
+	unsigned u = (unsigned)v;
+
+	if (v < 0) {
+		*s++ = '-';
+		u = 0u - u;
+	}
+	do {
+		digits[n++] = (char)('0' + u % 10);
+		u /= 10;
+	} while (u > 0 || n < ndigits);
+	while (n > 0)
+		*s++ = digits[--n];
+	return s;
+}
+
+/* deg, min and sec as "%dd%d'%.3f\"%c", or "%dd%02d'%06.3f\"%c" with -W,
+   for the number of decimals given to set_rtodms() */
+	static char *
+dms_format(char *s, int deg, int min, double sec, int sign) {
+	s = put_int(s, deg, 1);
+	*s++ = 'd';
+	s = put_int(s, min, dolong ? 2 : 1);
+	*s++ = '\'';
+	/* sec < 60, so 16 characters are plenty */
+	s += pj_format_fixed(s, 16, sec, dolong ? fract_digits+2+(fract_digits?1:0) : 0,
+		fract_digits, dolong);
+	*s++ = '"';
+	*s++ = (char)sign;
+	*s = '\0';
+	return s;
+}
+
 	char *
 rtodms(char *s, double r, int pos, int neg) {
 	int deg, min, sign;
@@ -60,13 +92,13 @@ rtodms(char *s, double r, int pos, int neg) {
 	deg = (int)r;
 
 	if (dolong)
-		(void)sprintf(ss,format,deg,min,sec,sign);
+		(void)dms_format(ss,deg,min,sec,sign);
 	else if (sec != 0.0) {
 		char *p, *q;
 		/* double prime + pos/neg suffix (if included) + NUL */
 		size_t suffix_len = sign ? 3 : 2;
 
-		(void)sprintf(ss,format,deg,min,sec,sign);
+		(void)dms_format(ss,deg,min,sec,sign);
                 /* Replace potential decimal comma by decimal point for non C locale */
                 for( p = ss; *p != '\0'; ++p ) {
                     if( *p == ',' ) {
@@ -1,4 +1,5 @@
 #!/bin/sh
 
-gcc -g multistresstest.c .libs/libproj.so -lpthread -o multistresstest
-./multistresstest
+# Builds and runs multistresstest from the src directory of an autotools
+# build. Arguments are passed on, see "./multistresstest -h".
+make multistresstest && ./multistresstest "$@"
@@ -144,6 +144,127 @@ static int testinverse() {
   return result;
 }
 
+static int testbatch() {
+  double lat1[ncases], lon1[ncases], azi1[ncases], lat2[ncases], lon2[ncases],
+    s12[ncases], s12a[ncases], azi1a[ncases], azi2a[ncases],
+    lat2a[ncases], lon2a[ncases];
+  double s12b, azi1b, azi2b, lat2b, lon2b;
+  struct geod_geodesic g;
+  int i, result = 0;
+  geod_init(&g, wgs84_a, wgs84_f);
+  for (i = 0; i < ncases; ++i) {
+    lat1[i] = testcases[i][0]; lon1[i] = testcases[i][1];
+    azi1[i] = testcases[i][2]; lat2[i] = testcases[i][3];
+    lon2[i] = testcases[i][4]; s12[i] = testcases[i][6];
+  }
+  geod_inverse_batch(&g, lat1, lon1, lat2, lon2, ncases, s12a, azi1a, azi2a,
+                     2);
+  for (i = 0; i < ncases; ++i) {
+    geod_inverse(&g, lat1[i], lon1[i], lat2[i], lon2[i],
+                 &s12b, &azi1b, &azi2b);
+    result += s12a[i] == s12b ? 0 : 1;
+    result += azi1a[i] == azi1b ? 0 : 1;
+    result += azi2a[i] == azi2b ? 0 : 1;
+  }
+  /* Distances along one geodesic share its setup */
+  for (i = 0; i < ncases; ++i) {
+    lat1[i] = lat1[0]; lon1[i] = lon1[0]; azi1[i] = azi1[0];
+  }
+  geod_direct_batch(&g, lat1, lon1, azi1, s12, ncases, lat2a, lon2a, 0, 2);
+  for (i = 0; i < ncases; ++i) {
+    geod_direct(&g, lat1[i], lon1[i], azi1[i], s12[i], &lat2b, &lon2b, 0);
+    result += lat2a[i] == lat2b ? 0 : 1;
+    result += lon2a[i] == lon2b ? 0 : 1;
+  }
+  return result;
+}
+
+static int testbatchthreads() {
+  /* Several chunks of pseudo random geodesics, runs of 7 sharing a line */
+  enum { n = 1000 };
+  static double lat1[n], lon1[n], azi1[n], lat2[n], lon2[n], s12[n],
+    s12a[n], azi1a[n], azi2a[n];
+  double s12b, azi1b, azi2b, lat2b, lon2b, azi2b2;
+  struct geod_geodesic g;
+  int i, result = 0;
+  unsigned r = 54321;
+  geod_init(&g, wgs84_a, wgs84_f);
+  for (i = 0; i < n; ++i) {
+    r = r * 1103515245 + 12345; lat1[i] = (r >> 8) % 18001 / 100.0 - 90;
+    r = r * 1103515245 + 12345; lon1[i] = (r >> 8) % 36001 / 100.0 - 180;
+    r = r * 1103515245 + 12345; lat2[i] = (r >> 8) % 18001 / 100.0 - 90;
+    r = r * 1103515245 + 12345; lon2[i] = (r >> 8) % 36001 / 100.0 - 180;
+  }
+  geod_inverse_batch(&g, lat1, lon1, lat2, lon2, n, s12a, azi1a, azi2a, 4);
+  for (i = 0; i < n; ++i) {
+    geod_inverse(&g, lat1[i], lon1[i], lat2[i], lon2[i],
+                 &s12b, &azi1b, &azi2b);
+    result += s12a[i] == s12b ? 0 : 1;
+    result += azi1a[i] == azi1b ? 0 : 1;
+    result += azi2a[i] == azi2b ? 0 : 1;
+    lat1[i] = lat1[i - i % 7]; lon1[i] = lon1[i - i % 7];
+    azi1[i] = azi1a[i - i % 7]; s12[i] = s12a[i];
+  }
+  geod_direct_batch(&g, lat1, lon1, azi1, s12, n, lat2, lon2, azi2a, 0);
+  for (i = 0; i < n; ++i) {
+    geod_direct(&g, lat1[i], lon1[i], azi1[i], s12[i],
+                &lat2b, &lon2b, &azi2b2);
+    result += lat2[i] == lat2b ? 0 : 1;
+    result += lon2[i] == lon2b ? 0 : 1;
+    result += azi2a[i] == azi2b2 ? 0 : 1;
+  }
+  return result;
+}
+
+static int testmatrix() {
+  /* Pseudo random points, some of them coincident, near-antipodal or polar */
+  enum { n1 = 70, n2 = 131, k = 5 };
+  double lat1[n1], lon1[n1], lat2[n2], lon2[n2], s12[n1 * n2], s;
+  double s12k[n1 * k];
+  int idx[n1 * k], idx2[3];
+  struct geod_geodesic g;
+  int i, j, l, result = 0;
+  unsigned r = 12345;
+  geod_init(&g, wgs84_a, wgs84_f);
+  for (i = 0; i < n2; ++i) {
+    r = r * 1103515245 + 12345; lat2[i] = (r >> 8) % 18001 / 100.0 - 90;
+    r = r * 1103515245 + 12345; lon2[i] = (r >> 8) % 36001 / 100.0 - 180;
+  }
+  for (i = 0; i < n1; ++i) {
+    lat1[i] = i % 3 ? -lat2[i] + 0.5 : lat2[i];
+    lon1[i] = i % 3 ? lon2[i] + 179.5 : lon2[i];
+  }
+  lat1[1] = 90; lat2[2] = -90;
+  for (l = 1; l <= 4; l += 3) {
+    geod_distance_matrix(&g, lat1, lon1, n1, lat2, lon2, n2, s12, l);
+    for (i = 0; i < n1; ++i)
+      for (j = 0; j < n2; ++j) {
+        geod_inverse(&g, lat1[i], lon1[i], lat2[j], lon2[j], &s, 0, 0);
+        result += s12[i * n2 + j] == s ? 0 : 1;
+      }
+  }
+  /* The k nearest, by brute force on the matrix */
+  result += geod_knn(&g, lat2, lon2, n2, lat1, lon1, n1, k, idx, s12k, 2);
+  for (i = 0; i < n1; ++i) {
+    double last = -1;
+    for (l = 0; l < k; ++l) {
+      int closer = 0, m = idx[i * k + l];
+      s = s12k[i * k + l];
+      result += s == s12[i * n2 + m] ? 0 : 1;
+      result += s >= last ? 0 : 1;
+      last = s;
+      for (j = 0; j < n2; ++j)
+        closer += s12[i * n2 + j] < s;
+      result += closer <= l ? 0 : 1;
+    }
+  }
+  /* More neighbours than points */
+  result += geod_knn(&g, lat2, lon2, 2, lat1, lon1, 1, 3, idx2, s12k, 1);
+  result += idx2[2] == -1 && s12k[2] == HUGE_VAL ? 0 : 1;
+  result += idx2[0] >= 0 && idx2[1] >= 0 ? 0 : 1;
+  return result;
+}
+
 static int testdirect() {
   double lat1, lon1, azi1, lat2, lon2, azi2, s12, a12, m12, M12, M21, S12;
   double lat2a, lon2a, azi2a, a12a, m12a, M12a, M21a, S12a;
@@ -773,6 +894,81 @@ static int Planimeter0() {
   return result;
 }
 
+static int PlanimeterMerge() {
+  /* Splitting a ring anywhere and merging the pieces changes nothing */
+  double lats[] = {-72.9, -71.9, -74.9, -74.3, -77.5, -77.4, -71.7, -65.9,
+                   -65.7, -66.6, -66.9, -69.8, -70.0, -71.0, -77.3, -77.9,
+                   -74.7, 89, 89, 89},
+    lons[] = {-74, -102, -102, -131, -163, 163, 172, 140, 113,
+              88, 59, 25, -4, -14, -33, -46, -61, 0, 120, 240};
+  int offsets[] = {0, 17, 20, 20};
+  double A[3], P[3], A0, P0, A1, P1;
+  struct geod_geodesic g;
+  struct geod_polygon p, q, r;
+  int result = 0, i, j, k, n = 17;
+  geod_init(&g, wgs84_a, wgs84_f);
+
+  geod_polygonarea(&g, lats, lons, n, &A0, &P0);
+  for (i = 0; i <= n; ++i)
+    for (j = i; j <= n; ++j) {
+      geod_polygon_init(&p, 0); geod_polygon_init(&q, 0);
+      geod_polygon_init(&r, 0);
+      for (k = 0; k < i; ++k) geod_polygon_addpoint(&g, &p, lats[k], lons[k]);
+      for (; k < j; ++k) geod_polygon_addpoint(&g, &q, lats[k], lons[k]);
+      for (; k < n; ++k) geod_polygon_addpoint(&g, &r, lats[k], lons[k]);
+      geod_polygon_merge(&g, &p, &q);
+      geod_polygon_merge(&g, &p, &r);
+      result += p.num == (unsigned)n ? 0 : 1;
+      geod_polygon_compute(&g, &p, 0, 1, &A1, &P1);
+      result += checkEquals(A1, A0, 1e-3);
+      result += checkEquals(P1, P0, 1e-8);
+    }
+
+  /* Around the pole: the crossings of the prime meridian add up too */
+  geod_polygon_init(&p, 0); geod_polygon_init(&q, 0);
+  geod_polygon_addpoint(&g, &p, 89, 0);
+  geod_polygon_addpoint(&g, &p, 89, 90);
+  geod_polygon_addpoint(&g, &q, 89, 180);
+  geod_polygon_addpoint(&g, &q, 89, 270);
+  geod_polygon_merge(&g, &p, &q);
+  geod_polygon_compute(&g, &p, 0, 1, &A1, &P1);
+  result += checkEquals(P1, 631819.8745, 1e-4);
+  result += checkEquals(A1, 24952305678.0, 1);
+
+  /* Many polygons at once, one of them empty */
+  result += geod_polygonarea_batch(&g, lats, lons, offsets, 3, A, P, 2);
+  result += checkEquals(A[0], A0, 1e-3);
+  result += checkEquals(P[0], P0, 1e-8);
+  geod_polygonarea(&g, lats + 17, lons + 17, 3, &A1, &P1);
+  result += checkEquals(A[1], A1, 1e-3);
+  result += checkEquals(P[1], P1, 1e-8);
+  result += A[2] == 0 && P[2] == 0 ? 0 : 1;
+  return result;
+}
+
+static int PlanimeterBatch() {
+  /* A ring of many vertices, which is cut into pieces */
+  enum { n = 20000 };
+  static double lats[n], lons[n];
+  double A, P, A0, P0;
+  int offsets[2] = {0, n};
+  struct geod_geodesic g;
+  int result = 0, i;
+  geod_init(&g, wgs84_a, wgs84_f);
+  for (i = 0; i < n; ++i) {
+    double t = 2 * 3.14159265358979323846 * i / n;
+    lats[i] = 30 * sin(t) + 0.01 * (i % 7);
+    lons[i] = 170 + 50 * cos(t);
+  }
+  geod_polygonarea(&g, lats, lons, n, &A0, &P0);
+  result += geod_polygonarea_batch(&g, lats, lons, offsets, 1, &A, &P, 3);
+  result += checkEquals(A, A0, 1e-2);
+  result += checkEquals(P, P0, 1e-6);
+  result += geod_polygonarea_batch(&g, lats, lons, offsets, 1, &A, 0, 1);
+  result += checkEquals(A, A0, 1e-2);
+  return result;
+}
+
 static int Planimeter5() {
   /* Check fix for Planimeter pole crossing bug found 2011-06-24 */
   double points[3][2] = {{89, 0.1}, {89, 90.1}, {89, -179.9}};
@@ -1026,6 +1222,10 @@ int main() {
   if ((i = testinverse())) {++n; printf("testinverse fail: %d\n", i);}
   if ((i = testdirect())) {++n; printf("testdirect fail: %d\n", i);}
   if ((i = testarcdirect())) {++n; printf("testarcdirect fail: %d\n", i);}
+  if ((i = testbatch())) {++n; printf("testbatch fail: %d\n", i);}
+  if ((i = testbatchthreads()))
+    {++n; printf("testbatchthreads fail: %d\n", i);}
+  if ((i = testmatrix())) {++n; printf("testmatrix fail: %d\n", i);}
   if ((i = GeodSolve0())) {++n; printf("GeodSolve0 fail: %d\n", i);}
   if ((i = GeodSolve1())) {++n; printf("GeodSolve1 fail: %d\n", i);}
   if ((i = GeodSolve2())) {++n; printf("GeodSolve2 fail: %d\n", i);}
@@ -1054,6 +1254,8 @@ int main() {
   if ((i = GeodSolve78())) {++n; printf("GeodSolve78 fail: %d\n", i);}
   if ((i = GeodSolve80())) {++n; printf("GeodSolve80 fail: %d\n", i);}
   if ((i = Planimeter0())) {++n; printf("Planimeter0 fail: %d\n", i);}
+  if ((i = PlanimeterMerge())) {++n; printf("PlanimeterMerge fail: %d\n", i);}
+  if ((i = PlanimeterBatch())) {++n; printf("PlanimeterBatch fail: %d\n", i);}
   if ((i = Planimeter5())) {++n; printf("Planimeter5 fail: %d\n", i);}
   if ((i = Planimeter6())) {++n; printf("Planimeter6 fail: %d\n", i);}
   if ((i = Planimeter12())) {++n; printf("Planimeter12 fail: %d\n", i);}
@@ -26,452 +26,490 @@
  * DEALINGS IN THE SOFTWARE.
  *****************************************************************************/
 
+/*****************************************************************************
+
+    Each workload is run on 1, 2, 4, ... threads up to the maximum, every
+    thread doing the same amount of work, so that the wall time stays
+    flat as long as PROJ scales. The workloads are
+
+        transform        transformations of blocks of points, each thread
+                         with its own context and PJ objects
+        default_context  the same, the PJ objects of all threads sharing
+                         the default context
+        shared_grid      a pipeline of hgridshift and vgridshift, all
+                         threads reading the same grids
+        reinit           creation and destruction of PJ objects which load
+                         grids, and a transformation with each
+        crs_to_crs       bursts of proj_create_crs_to_crs() between EPSG
+                         codes, which needs proj.db
+
+    For every thread count it reports the operations per second, points or
+    objects created, the speedup over one thread, and how often and how
+    long threads waited for the lock of pj_acquire_lock(), as counted by
+    pj_lock_statistics().
+
+    Every result is also compared with the one computed before the threads
+    are started: the program exits with status 1 on any difference.
+
+*****************************************************************************/
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-#ifndef ACCEPT_USE_OF_DEPRECATED_PROJ_API_H
-#define ACCEPT_USE_OF_DEPRECATED_PROJ_API_H
-#endif
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
 
-#include "proj_api.h"
+#include "proj_internal.h"
+#include "synthetic_grids.h"
 
-#ifdef _WIN32
-    #include <windows.h>
-#else
-    #include <pthread.h>
-    #include <unistd.h>
-#endif
+#define HGRID "./multistresstest_hgrid.ct2"
+#define VGRID "./multistresstest_vgrid.gtx"
 
-#define num_threads    10
-static int num_iterations = 1000000;
-static int reinit_every_iteration=0;
+#define BLOCK 256
 
 typedef struct {
-    const char *src_def;
-    const char *dst_def;
-
-    double  src_x, src_y, src_z;
-    double  dst_x, dst_y, dst_z;
-
-    int     dst_error;
-    int     skip;
-} TestItem;
-
-static TestItem test_list[] = {
-    {
-        "+proj=utm +zone=11 +datum=WGS84",
-        "+proj=latlong +datum=WGS84",
-        150000.0, 3000000.0, 0.0,
-        0.0, 0.0, 0.0,
-        0, 0
-    },
-    {
-        "+proj=utm +zone=11 +datum=NAD83",
-        "+proj=latlong +datum=NAD27",
-        150000.0, 3000000.0, 0.0,
-        0.0, 0.0, 0.0,
-        0, 0
-    },
-    {
-        "+proj=utm +zone=11 +datum=NAD83",
-        "+proj=latlong +nadgrids=@null +ellps=WGS84",
-        150000.0, 3000000.0, 0.0,
-        0.0, 0.0, 0.0,
-        0, 0
-    },
-    {
-        "+proj=utm +zone=11 +datum=WGS84",
-        "+proj=merc +datum=potsdam",
-        150000.0, 3000000.0, 0.0,
-        0.0, 0.0, 0.0,
-        0, 0
-    },
-    {
-        "+proj=latlong +nadgrids=nzgd2kgrid0005.gsb",
-        "+proj=latlong +datum=WGS84",
-        150000.0, 3000000.0, 0.0,
-        0.0, 0.0, 0.0,
-        0, 0
-    },
-    {
-        "+proj=latlong +nadgrids=nzgd2kgrid0005.gsb",
-        "+proj=latlong +datum=WGS84",
-        170 * DEG_TO_RAD, -40 * DEG_TO_RAD, 0.0,
-        0.0, 0.0, 0.0,
-        0, 0
-    },
-    {
-        "+proj=latlong +ellps=GRS80 +towgs84=2,3,5",
-        "+proj=latlong +ellps=intl +towgs84=10,12,15",
-        170 * DEG_TO_RAD, -40 * DEG_TO_RAD, 0.0,
-        0.0, 0.0, 0.0,
-        0, 0
-    },
-    {
-        "+proj=eqc +lat_0=11 +lon_0=12 +x_0=100000 +y_0=200000 +datum=WGS84 ",
-        "+proj=stere +lat_0=11 +lon_0=12 +x_0=100000 +y_0=200000 +datum=WGS84 ",
-        150000.0, 250000.0, 0.0,
-        0.0, 0.0, 0.0,
-        0, 0
-    },
-    {
-        "+proj=cea +lat_ts=11 +lon_0=12 +y_0=200000 +datum=WGS84 ",
-        "+proj=merc +lon_0=12 +k=0.999 +x_0=100000 +y_0=200000 +datum=WGS84 ",
-        150000.0, 250000.0, 0.0,
-        0.0, 0.0, 0.0,
-        0, 0
-    },
-    {
-        "+proj=bonne +lat_1=11 +lon_0=12 +y_0=200000 +datum=WGS84 ",
-        "+proj=cass +lat_0=11 +lon_0=12 +x_0=100000 +y_0=200000 +datum=WGS84 ",
-        150000.0, 250000.0, 0.0,
-        0.0, 0.0, 0.0,
-        0, 0
-    },
-    {
-        "+proj=nzmg +lat_0=11 +lon_0=12 +y_0=200000 +datum=WGS84 ",
-        "+proj=gnom +lat_0=11 +lon_0=12 +x_0=100000 +y_0=200000 +datum=WGS84 ",
-        150000.0, 250000.0, 0.0,
-        0.0, 0.0, 0.0,
-        0, 0
-    },
-    {
-        "+proj=ortho +lat_0=11 +lon_0=12 +y_0=200000 +datum=WGS84 ",
-        "+proj=laea +lat_0=11 +lon_0=12 +x_0=100000 +y_0=200000 +datum=WGS84 ",
-        150000.0, 250000.0, 0.0,
-        0.0, 0.0, 0.0,
-        0, 0
-    },
-    {
-        "+proj=aeqd +lat_0=11 +lon_0=12 +y_0=200000 +datum=WGS84 ",
-        "+proj=eqdc +lat_1=20 +lat_2=5 +lat_0=11 +lon_0=12 +x_0=100000 +y_0=200000 +datum=WGS84 ",
-        150000.0, 250000.0, 0.0,
-        0.0, 0.0, 0.0,
-        0, 0
-    },
-    {
-        "+proj=mill +lat_0=11 +lon_0=12 +y_0=200000 +datum=WGS84 ",
-        "+proj=moll +lon_0=12 +x_0=100000 +y_0=200000 +datum=WGS84 ",
-        150000.0, 250000.0, 0.0,
-        0.0, 0.0, 0.0,
-        0, 0
-    },
-    {
-        "+init=epsg:3309",
-        "+init=epsg:4326",
-        150000.0, 30000.0, 0.0,
-        0.0, 0.0, 0.0,
-        0, 0
-    },
-    {
-        /* Bad projection (invalid ellipsoid parameter +R_A=0) */
-        "+proj=utm +zone=11 +datum=WGS84",
-        "+proj=merc +datum=potsdam +R_A=0",
-        150000.0, 3000000.0, 0.0,
-        0.0, 0.0, 0.0,
-        0, 0
-    }
+    const char *definition;
+    double x, y; /* input around which the points of a block are spread */
+    double spread;
+} Operation;
+
+/* The definitions of the historical test list, as proj.h pipelines */
+static const Operation transforms[] = {
+    {"+proj=pipeline +step +inv +proj=utm +zone=11 +ellps=WGS84",
+     150000, 3000000, 10000},
+    {"+proj=pipeline +step +inv +proj=utm +zone=11 +ellps=GRS80 "
+     "+step +proj=cart +ellps=GRS80 "
+     "+step +proj=helmert +x=-8 +y=160 +z=176 "
+     "+step +inv +proj=cart +ellps=clrk66",
+     150000, 3000000, 10000},
+    {"+proj=pipeline +step +inv +proj=utm +zone=11 +ellps=WGS84 "
+     "+step +proj=merc +ellps=bessel",
+     150000, 3000000, 10000},
+    {"+proj=pipeline +step +inv +proj=eqc +lat_0=11 +lon_0=12 +x_0=100000 "
+     "+y_0=200000 +ellps=WGS84 +step +proj=stere +lat_0=11 +lon_0=12 "
+     "+x_0=100000 +y_0=200000 +ellps=WGS84",
+     150000, 250000, 10000},
+    {"+proj=pipeline +step +inv +proj=cea +lat_ts=11 +lon_0=12 +y_0=200000 "
+     "+ellps=WGS84 +step +proj=merc +lon_0=12 +k=0.999 +x_0=100000 "
+     "+y_0=200000 +ellps=WGS84",
+     150000, 250000, 10000},
+    {"+proj=pipeline +step +inv +proj=bonne +lat_1=11 +lon_0=12 +y_0=200000 "
+     "+ellps=WGS84 +step +proj=cass +lat_0=11 +lon_0=12 +x_0=100000 "
+     "+y_0=200000 +ellps=WGS84",
+     150000, 250000, 10000},
+    {"+proj=pipeline +step +inv +proj=ortho +lat_0=11 +lon_0=12 +y_0=200000 "
+     "+ellps=WGS84 +step +proj=laea +lat_0=11 +lon_0=12 +x_0=100000 "
+     "+y_0=200000 +ellps=WGS84",
+     150000, 250000, 10000},
+    {"+proj=pipeline +step +inv +proj=aeqd +lat_0=11 +lon_0=12 +y_0=200000 "
+     "+ellps=WGS84 +step +proj=eqdc +lat_1=20 +lat_2=5 +lat_0=11 +lon_0=12 "
+     "+x_0=100000 +y_0=200000 +ellps=WGS84",
+     150000, 250000, 10000},
+    {"+proj=pipeline +step +inv +proj=mill +lat_0=11 +lon_0=12 +y_0=200000 "
+     "+ellps=WGS84 +step +proj=moll +lon_0=12 +x_0=100000 +y_0=200000 "
+     "+ellps=WGS84",
+     150000, 250000, 10000},
 };
 
-static volatile int active_thread_count = 0;
-
-static projPJ custom_pj_init_plus_ctx(projCtx ctx, const char* def)
-{
-    return pj_init_plus_ctx(ctx, def);
-}
+/* Input in radians, within the synthetic grids */
+static const Operation grid_shifts[] = {
+    {"+proj=pipeline +step +proj=hgridshift +grids=" HGRID
+     " +step +proj=vgridshift +grids=" VGRID,
+     0.17453292519943295, 0.87266462599716477, 0.1},
+};
 
-/************************************************************************/
-/*                             TestThread()                             */
-/************************************************************************/
+static const char *const crs_pairs[][2] = {
+    {"EPSG:4326", "EPSG:3857"},  {"EPSG:4326", "EPSG:32632"},
+    {"EPSG:4258", "EPSG:25832"}, {"EPSG:4267", "EPSG:4269"},
+    {"EPSG:27700", "EPSG:4326"}, {"EPSG:2056", "EPSG:4326"},
+};
 
-static void TestThread()
+#define NTRANSFORMS (sizeof(transforms) / sizeof(transforms[0]))
+#define NGRID_SHIFTS (sizeof(grid_shifts) / sizeof(grid_shifts[0]))
+#define NCRS_PAIRS (sizeof(crs_pairs) / sizeof(crs_pairs[0]))
 
-{
-    int i, test_count = sizeof(test_list) / sizeof(TestItem);
-    int repeat_count = num_iterations;
-    int i_iter;
+/* ------------------------------------------------------------------------ */
+/*      Workloads                                                           */
+/* ------------------------------------------------------------------------ */
 
-/* -------------------------------------------------------------------- */
-/*      Initialize coordinate system definitions.                       */
-/* -------------------------------------------------------------------- */
-    projPJ *src_pj_list, *dst_pj_list;
-    projCtx ctx = pj_ctx_alloc();
+enum Kind { TRANSFORM, DEFAULT_CONTEXT, SHARED_GRID, REINIT, CRS_TO_CRS };
 
-    src_pj_list = (projPJ *) calloc(test_count,sizeof(projPJ));
-    dst_pj_list = (projPJ *) calloc(test_count,sizeof(projPJ));
+typedef struct {
+    const char *name;
+    Kind kind;
+    int iterations; /* per thread, times the -n scale */
+} Workload;
+
+static const Workload workloads[] = {
+    {"transform", TRANSFORM, 200},   {"default_context", DEFAULT_CONTEXT, 200},
+    {"shared_grid", SHARED_GRID, 1000}, {"reinit", REINIT, 200},
+    {"crs_to_crs", CRS_TO_CRS, 5},
+};
 
-    if(!reinit_every_iteration)
-    {
-        for( i = 0; i < test_count; i++ )
-        {
-            TestItem *test = test_list + i;
+/* The operations a workload runs */
+static void operations(Kind kind, const Operation **ops, size_t *n) {
+    if (SHARED_GRID == kind || REINIT == kind) {
+        *ops = grid_shifts;
+        *n = NGRID_SHIFTS;
+    } else {
+        *ops = transforms;
+        *n = NTRANSFORMS;
+    }
+}
 
-            src_pj_list[i] = custom_pj_init_plus_ctx( ctx, test->src_def );
-            dst_pj_list[i] = custom_pj_init_plus_ctx( ctx, test->dst_def );
-        }
+/* The points of a block: a regular pattern around the input of op */
+static void fill_block(const Operation &op, PJ_COORD *block) {
+    for (int i = 0; i < BLOCK; i++) {
+        double u = (i % 16) / 15.0 - 0.5, v = (i / 16) / 15.0 - 0.5;
+        block[i] = proj_coord(op.x + u * op.spread, op.y + v * op.spread, 0, 0);
     }
+}
 
-/* -------------------------------------------------------------------- */
-/*      Perform tests - over and over.                                  */
-/* -------------------------------------------------------------------- */
-
-    for( i_iter = 0; i_iter < repeat_count; i_iter++ )
-    {
-        for( i = 0; i < test_count; i++ )
-        {
-            TestItem *test = test_list + i;
-            double x, y, z;
-            int error;
-
-            x = test->src_x;
-            y = test->src_y;
-            z = test->src_z;
-
-            if( reinit_every_iteration )
-            {
-                src_pj_list[i] = custom_pj_init_plus_ctx( ctx, test->src_def );
-                dst_pj_list[i] = custom_pj_init_plus_ctx( ctx, test->dst_def );
-
-                {
-                    int skipTest = (src_pj_list[i] == nullptr || dst_pj_list[i] == nullptr);
-
-                    if ( skipTest != test->skip )
-                        fprintf( stderr, "Threaded projection initialization does not match unthreaded initialization\n" );
-
-                    if (skipTest)
-                    {
-                        pj_free( src_pj_list[i] );
-                        pj_free( dst_pj_list[i] );
-                        continue;
-                    }
-                }
-            }
+/* One point transformed with the operation between a pair of CRS */
+static PJ_COORD crs_to_crs_point(PJ *P) {
+    PJ_COORD c = proj_coord(0, 0, 0, 0);
+    if (nullptr == P)
+        return proj_coord(HUGE_VAL, HUGE_VAL, HUGE_VAL, HUGE_VAL);
+    if (proj_angular_input(P, PJ_FWD))
+        c = proj_coord(proj_torad(8), proj_torad(50), 0, 0);
+    else
+        c = proj_coord(500000, 5000000, 0, 0);
+    return proj_trans(P, PJ_FWD, c);
+}
 
-            if ( test->skip )
-                continue;
+/* Errors are expected, for instance without proj.db: they are not logged */
+static void quiet(void *, int, const char *) {}
 
-            error = pj_transform( src_pj_list[i], dst_pj_list[i], 1, 0,
-                                  &x, &y, &z );
+static PJ_CONTEXT *quiet_context() {
+    PJ_CONTEXT *ctx = proj_context_create();
+    proj_log_func(ctx, nullptr, quiet);
+    return ctx;
+}
 
+static bool same(const PJ_COORD *a, const PJ_COORD *b, size_t n) {
+    return 0 == memcmp(a, b, n * sizeof(PJ_COORD));
+}
 
-            if( error != test->dst_error )
-            {
-                fprintf( stderr, "Got error %d, expected %d\n",
-                         error, test->dst_error );
-            }
+/* ------------------------------------------------------------------------ */
+/*      Threads                                                             */
+/* ------------------------------------------------------------------------ */
 
-            if( x != test->dst_x || y != test->dst_y || z != test->dst_z )
-            {
-                fprintf( stderr,
-                         "Got %.15g,%.15g,%.15g\n"
-                         "Expected %.15g,%.15g,%.15g\n"
-                         "Diff %.15g,%.15g,%.15g\n",
-                         x, y, z,
-                         test->dst_x, test->dst_y, test->dst_z,
-                         x-test->dst_x, y-test->dst_y, z-test->dst_z);
+typedef struct {
+    const Workload *workload;
+    int iterations;
+    std::vector<PJ_COORD> expected; /* BLOCK points per operation */
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::atomic<long> operations{0};
+    std::atomic<long> mismatches{0};
+} Run;
+
+/* What one thread does once it is given the go */
+static void work(Run &run, PJ_CONTEXT *ctx, std::vector<PJ *> &pjs) {
+    const Kind kind = run.workload->kind;
+    const Operation *ops;
+    size_t nops;
+    long count = 0, wrong = 0;
+    PJ_COORD block[BLOCK];
+
+    operations(kind, &ops, &nops);
+    run.ready++;
+    while (!run.go)
+        std::this_thread::yield();
+
+    for (int it = 0; it < run.iterations; it++) {
+        if (CRS_TO_CRS == kind) {
+            for (size_t i = 0; i < NCRS_PAIRS; i++) {
+                PJ *P = proj_create_crs_to_crs(ctx, crs_pairs[i][0],
+                                               crs_pairs[i][1], nullptr);
+                PJ_COORD c = crs_to_crs_point(P);
+                wrong += !same(&c, &run.expected[i], 1);
+                proj_destroy(P);
+                count++;
             }
+            continue;
+        }
 
-            if( reinit_every_iteration )
-            {
-                pj_free( src_pj_list[i] );
-                pj_free( dst_pj_list[i] );
+        for (size_t i = 0; i < nops; i++) {
+            const PJ_COORD *expected = &run.expected[i * BLOCK];
+            fill_block(ops[i], block);
+            if (REINIT == kind) {
+                PJ *P = proj_create(ctx, ops[i].definition);
+                if (P)
+                    proj_trans_array(P, PJ_FWD, 1, block);
+                wrong += nullptr == P || !same(block, expected, 1);
+                proj_destroy(P);
+                count++;
+                continue;
             }
+            proj_trans_array(pjs[i], PJ_FWD, BLOCK, block);
+            wrong += !same(block, expected, BLOCK);
+            count += BLOCK;
         }
     }
+    run.operations += count;
+    run.mismatches += wrong;
+}
 
-/* -------------------------------------------------------------------- */
-/*      Cleanup                                                         */
-/* -------------------------------------------------------------------- */
-    if( !reinit_every_iteration )
-    {
-        for( i = 0; i < test_count; i++ )
-        {
-            pj_free( src_pj_list[i] );
-            pj_free( dst_pj_list[i] );
+typedef struct {
+    std::string workload;
+    int threads;
+    double seconds;
+    long operations;
+    double per_second;
+    double speedup;
+    unsigned long long acquisitions, contended;
+    double wait_seconds;
+    long mismatches;
+} Result;
+
+/* The results every thread should get, computed on this one */
+static bool reference(const Workload &w, std::vector<PJ_COORD> &expected) {
+    const Operation *ops;
+    size_t nops;
+    bool ok = true;
+    PJ_CONTEXT *ctx = quiet_context();
+
+    operations(w.kind, &ops, &nops);
+    expected.clear();
+    if (CRS_TO_CRS == w.kind) {
+        for (size_t i = 0; i < NCRS_PAIRS; i++) {
+            PJ *P = proj_create_crs_to_crs(ctx, crs_pairs[i][0],
+                                           crs_pairs[i][1], nullptr);
+            ok = ok && nullptr != P;
+            expected.push_back(crs_to_crs_point(P));
+            proj_destroy(P);
+        }
+    } else {
+        for (size_t i = 0; i < nops; i++) {
+            PJ_COORD block[BLOCK];
+            PJ *P = proj_create(ctx, ops[i].definition);
+            ok = ok && nullptr != P;
+            fill_block(ops[i], block);
+            if (P)
+                proj_trans_array(P, PJ_FWD, BLOCK, block);
+            expected.insert(expected.end(), block, block + BLOCK);
+            proj_destroy(P);
         }
     }
-
-    free( src_pj_list );
-    free( dst_pj_list );
-
-    pj_ctx_free( ctx );
-
-    printf( "%d iterations of the %d tests complete in thread X\n",
-            repeat_count, test_count );
-
-    active_thread_count--;
+    proj_context_destroy(ctx);
+    return ok;
 }
 
-#ifdef _WIN32
-/************************************************************************/
-/*                             WinTestThread()                        */
-/************************************************************************/
-
-static DWORD WINAPI WinTestThread( LPVOID lpParameter )
+static Result run_threads(const Workload &w, int nthreads, double scale,
+                          const std::vector<PJ_COORD> &expected) {
+    Run run;
+    const Operation *ops;
+    size_t nops;
+    std::vector<PJ_CONTEXT *> contexts(nthreads, nullptr);
+    std::vector<std::vector<PJ *>> pjs(nthreads);
+    std::vector<std::thread> threads;
+
+    run.workload = &w;
+    run.iterations = static_cast<int>(w.iterations * scale + 0.5);
+    if (run.iterations < 1)
+        run.iterations = 1;
+    run.expected = expected;
+
+    /* Contexts and PJ objects are set up here, untimed. Those of the  */
+    /* default context must be: it may only be used by one thread at a */
+    /* time to create objects                                          */
+    operations(w.kind, &ops, &nops);
+    for (int t = 0; t < nthreads; t++) {
+        if (DEFAULT_CONTEXT != w.kind)
+            contexts[t] = quiet_context();
+        if (TRANSFORM == w.kind || DEFAULT_CONTEXT == w.kind ||
+            SHARED_GRID == w.kind) {
+            for (size_t i = 0; i < nops; i++)
+                pjs[t].push_back(proj_create(contexts[t], ops[i].definition));
+        }
+    }
 
-{
-    TestThread();
+    for (int t = 0; t < nthreads; t++)
+        threads.emplace_back(work, std::ref(run), contexts[t],
+                             std::ref(pjs[t]));
+    while (run.ready < nthreads)
+        std::this_thread::yield();
+
+    Result r;
+    pj_lock_statistics(nullptr, nullptr, nullptr, 1);
+    auto start = std::chrono::steady_clock::now();
+    run.go = true;
+    for (auto &thread : threads)
+        thread.join();
+    r.seconds = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+    pj_lock_statistics(&r.acquisitions, &r.contended, &r.wait_seconds, 0);
+
+    for (int t = 0; t < nthreads; t++) {
+        for (PJ *P : pjs[t])
+            proj_destroy(P);
+        if (contexts[t])
+            proj_context_destroy(contexts[t]);
+    }
 
-    return 0;
+    r.workload = w.name;
+    r.threads = nthreads;
+    r.operations = run.operations;
+    r.per_second = r.operations / r.seconds;
+    r.speedup = 1;
+    r.mismatches = run.mismatches;
+    return r;
 }
 
-#else
-/************************************************************************/
-/*                             PosixTestThread()                        */
-/************************************************************************/
-
-static void *PosixTestThread( void *pData )
+/* ------------------------------------------------------------------------ */
+/*      Main                                                                */
+/* ------------------------------------------------------------------------ */
+
+static void write_json(FILE *f, const std::vector<Result> &results,
+                       const std::vector<std::string> &skipped) {
+    fprintf(f, "{\n  \"proj_version\": \"%s\",\n  \"results\": [",
+            proj_info().version);
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result &r = results[i];
+        fprintf(f,
+                "%s\n    {\"workload\": \"%s\", \"threads\": %d, "
+                "\"seconds\": %.6f, \"operations\": %ld, "
+                "\"operations_per_sec\": %.1f, \"speedup\": %.3f, "
+                "\"lock_acquisitions\": %llu, \"lock_contended\": %llu, "
+                "\"lock_wait_seconds\": %.6f, \"mismatches\": %ld}",
+                i ? "," : "", r.workload.c_str(), r.threads, r.seconds,
+                r.operations, r.per_second, r.speedup, r.acquisitions,
+                r.contended, r.wait_seconds, r.mismatches);
+    }
+    fprintf(f, "\n  ],\n  \"skipped\": [");
+    for (size_t i = 0; i < skipped.size(); i++)
+        fprintf(f, "%s\"%s\"", i ? ", " : "", skipped[i].c_str());
+    fprintf(f, "]\n}\n");
+}
 
-{
-    (void)pData;
-    TestThread();
-    return nullptr;
+static void print_result(const Result &r) {
+    printf("%-16s %7d %9.3f %12.0f %8.2f %11llu %10llu %10.3f %10ld\n",
+           r.workload.c_str(), r.threads, r.seconds, r.per_second, r.speedup,
+           r.acquisitions, r.contended, 1000 * r.wait_seconds, r.mismatches);
+    fflush(stdout);
 }
-#endif
-
-/************************************************************************/
-/*                                main()                                */
-/************************************************************************/
-#ifdef _WIN32
-static DWORD WINAPI do_main( LPVOID unused )
-#else
-static int do_main(void)
-#endif
-{
-/* -------------------------------------------------------------------- */
-/*      Our first pass is to establish the correct answers for all      */
-/*      the tests.                                                      */
-/* -------------------------------------------------------------------- */
-    int i, test_count = sizeof(test_list) / sizeof(TestItem);
-
-    for( i = 0; i < test_count; i++ )
-    {
-        TestItem *test = test_list + i;
-
-        projPJ src_pj, dst_pj;
-
-        src_pj = custom_pj_init_plus_ctx( pj_get_default_ctx(), test->src_def );
-        dst_pj = custom_pj_init_plus_ctx( pj_get_default_ctx(), test->dst_def );
-
-        if( src_pj == nullptr )
-        {
-            printf( "Unable to translate:\n%s\n", test->src_def );
-            test->skip = 1;
-            pj_free (dst_pj);
-            continue;
-        }
 
-        if( dst_pj == nullptr )
-        {
-            printf( "Unable to translate:\n%s\n", test->dst_def );
-            test->skip = 1;
-            pj_free (src_pj);
-            continue;
+static const char usage[] = {
+    "Usage: %s [options]\n"
+    "\n"
+    "Runs each workload on 1, 2, 4, ... threads, reporting the throughput,\n"
+    "the waits on the PROJ lock, and results differing from those of a\n"
+    "single thread.\n"
+    "\n"
+    "    -t threads     Largest number of threads (default: the number of\n"
+    "                   hardware threads, at least 2)\n"
+    "    -n scale       Multiplies the work of each thread (default 1)\n"
+    "    -w workload    Only the given workload: transform, default_context,\n"
+    "                   shared_grid, reinit or crs_to_crs. May be repeated\n"
+    "    -j file        Also write the results as JSON to file, '-' for\n"
+    "                   standard output instead of the table\n"
+    "    -h             This help\n"};
+
+int main(int argc, char **argv) {
+    int max_threads = static_cast<int>(std::thread::hardware_concurrency());
+    double scale = 1;
+    std::vector<std::string> selected;
+    const char *json = nullptr;
+
+    if (max_threads < 2)
+        max_threads = 2;
+    for (int i = 1; i < argc; i++) {
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (0 == strcmp(argv[i], "-h") || 0 == strcmp(argv[i], "--help")) {
+            printf(usage, argv[0]);
+            return 0;
+        } else if (value && 0 == strcmp(argv[i], "-t")) {
+            max_threads = atoi(value);
+            i++;
+        } else if (value && 0 == strcmp(argv[i], "-n")) {
+            scale = atof(value);
+            i++;
+        } else if (value && 0 == strcmp(argv[i], "-w")) {
+            selected.push_back(value);
+            i++;
+        } else if (value && 0 == strcmp(argv[i], "-j")) {
+            json = value;
+            i++;
+        } else {
+            fprintf(stderr, usage, argv[0]);
+            return 1;
         }
-
-        test->dst_x = test->src_x;
-        test->dst_y = test->src_y;
-        test->dst_z = test->src_z;
-
-        test->dst_error = pj_transform( src_pj, dst_pj, 1, 0,
-                                        &(test->dst_x),
-                                        &(test->dst_y),
-                                        &(test->dst_z) );
-
-        pj_free( src_pj );
-        pj_free( dst_pj );
-
-        test->skip = 0;
-
-#ifdef notdef
-        printf( "Test %d - output %.14g,%.14g,%g\n", i, test->dst_x, test->dst_y, test->dst_z );
-#endif
     }
-
-    printf( "%d tests initialized.\n", test_count );
-
-/* -------------------------------------------------------------------- */
-/*      Now launch a bunch of threads to repeat the tests.              */
-/* -------------------------------------------------------------------- */
-#ifdef _WIN32
-
-    { //Scoped to workaround lack of c99 support in VS
-        HANDLE ahThread[num_threads];
-
-        for( i = 0; i < num_threads; i++ )
-        {
-            active_thread_count++;
-
-            ahThread[i] = CreateThread(NULL, 0, WinTestThread, NULL, 0, NULL);
-
-            if (ahThread[i] == 0)
-            {
-                printf( "Thread creation failed.");
-                return 1;
-            }
-        }
-
-        printf( "%d test threads launched.\n", num_threads );
-
-        WaitForMultipleObjects(num_threads, ahThread, TRUE, INFINITE);
+    if (max_threads < 1 || !(scale > 0)) {
+        fprintf(stderr, "%s: -t and -n must be positive\n", argv[0]);
+        return 1;
     }
 
-#else
-    {
-    pthread_t ahThread[num_threads];
-    pthread_attr_t hThreadAttr;
-
-    pthread_attr_init( &hThreadAttr );
-    pthread_attr_setdetachstate( &hThreadAttr, PTHREAD_CREATE_DETACHED );
-
-    for( i = 0; i < num_threads; i++ )
-    {
-        active_thread_count++;
-
-        pthread_create( &(ahThread[i]), &hThreadAttr,
-            PosixTestThread, nullptr );
+    FILE *json_file = nullptr;
+    if (json) {
+        json_file = strcmp(json, "-") ? fopen(json, "w") : stdout;
+        if (nullptr == json_file) {
+            fprintf(stderr, "%s: Cannot open '%s'\n", argv[0], json);
+            return 1;
+        }
     }
 
-    printf( "%d test threads launched.\n", num_threads );
+    std::vector<int> counts;
+    for (int n = 1; n < max_threads; n *= 2)
+        counts.push_back(n);
+    counts.push_back(max_threads);
+
+    if (!(write_hgrid(HGRID) && write_vgrid(VGRID)))
+        fprintf(stderr, "%s: Cannot write the grids in the current directory\n",
+                argv[0]);
+    proj_log_func(nullptr, nullptr, quiet);
+
+    if (stdout != json_file)
+        printf("%-16s %7s %9s %12s %8s %11s %10s %10s %10s\n", "workload",
+               "threads", "seconds", "ops/s", "speedup", "lock acq",
+               "contended", "wait ms", "mismatch");
+
+    std::vector<Result> results;
+    std::vector<std::string> skipped;
+    long mismatches = 0;
+    for (const Workload &w : workloads) {
+        bool wanted = selected.empty();
+        for (const auto &name : selected)
+            wanted = wanted || name == w.name;
+        if (!wanted)
+            continue;
 
-    while( active_thread_count > 0 )
-        sleep( 1 );
+        std::vector<PJ_COORD> expected;
+        if (!reference(w, expected)) {
+            skipped.push_back(w.name);
+            continue;
+        }
+        double base = 0;
+        for (int n : counts) {
+            Result r = run_threads(w, n, scale, expected);
+            if (1 == n)
+                base = r.per_second;
+            r.speedup = base > 0 ? r.per_second / base : 0;
+            mismatches += r.mismatches;
+            results.push_back(r);
+            if (stdout != json_file)
+                print_result(r);
+        }
     }
-#endif
 
-    printf( "all tests complete.\n" );
-
-    return 0;
-}
+    remove(HGRID);
+    remove(VGRID);
 
-
-int main( int argc, char **argv )
-{
-    int i;
-    for(i=0;i<argc;i++)
-    {
-        if( strcmp(argv[i], "-reinit") == 0 )
-            reinit_every_iteration = 1;
-        else if( strcmp(argv[i], "-num_iterations") == 0 && i+1 < argc )
-        {
-            num_iterations = atoi(argv[i+1]);
-            i++;
-        }
+    if (json_file) {
+        write_json(json_file, results, skipped);
+        if (stdout != json_file)
+            fclose(json_file);
     }
-
-#ifdef _WIN32
-    /* This is an incredible weirdness but with mingw cross-compiler */
-    /* 1. - b/a; where double a = 6378206.4; and double b = 6356583.8; */
-    /* does not evaluate the same in the main thread or in a thread forked */
-    /* by CreateThread(), so run the main in a thread... */
-    {
-        HANDLE thread = CreateThread(NULL, 0, do_main, NULL, 0, NULL);
-        WaitForSingleObject(thread, INFINITE);
-        CloseHandle( thread );
+    if (stdout != json_file) {
+        for (const auto &name : skipped)
+            printf("skipped: %s: cannot create its operations\n",
+                   name.c_str());
     }
-#else
-    do_main();
-#endif
-    return 0;
+    return mismatches ? 1 : 0;
 }
@@ -0,0 +1,1042 @@
+/******************************************************************************
+ *
+ * Project:  PROJ
+ * Purpose:  Throughput benchmarks of transformations: a fixed matrix of
+ *           operations run on synthetic points, reported as a table or JSON.
+ *
+ ******************************************************************************
+ * Copyright (c) 2018, PROJ contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *****************************************************************************/
+
+/*****************************************************************************
+
+    proj_bench runs every operation of a fixed matrix on the same synthetic
+    points, through proj_trans() a point at a time, proj_trans_array() and
+    proj_trans_generic(), forward and, where there is one, inverse. The
+    matrix has five groups:
+
+        projection      every projection known to proj_list_operations(),
+                        with the parameters those need
+        transformation  the conversions and transformations of
+                        src/conversions and src/transformations
+        gridshift       hgridshift, vgridshift and deformation, on small
+                        grids written to the current directory for the run
+        crs_to_crs      proj_create_crs_to_crs() between common EPSG codes,
+                        which needs proj.db
+        geodesic        geod_distance_matrix(), geod_knn() and the brute
+                        force search it replaces, and geod_polygonarea_batch(),
+                        on the WGS84 ellipsoid with the threads of -t
+
+    The points of an operation are drawn from a region suited to it with a
+    fixed seed, and only those which transform both ways are kept, so that
+    failures do not cut proj_trans_array() short. Each measurement is the
+    median of several repetitions. The time of the geodesic group is per
+    distance for geod_distance_matrix(), per query point for geod_knn() and
+    the brute force search, and per vertex for geod_polygonarea_batch().
+
+    Allocations are counted through malloc() with the GNU C library, and
+    through operator new elsewhere.
+
+*****************************************************************************/
+
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "geodesic.h"
+#include "proj.h"
+#include "synthetic_grids.h"
+
+/* ------------------------------------------------------------------------ */
+/*      Allocation counting                                                 */
+/* ------------------------------------------------------------------------ */
+
+static std::atomic<long> allocations(0);
+
+#if defined(__GLIBC__) && !defined(PROJ_BENCH_NO_MALLOC_HOOK)
+#define COUNT_MALLOC
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *p, size_t size);
+void __libc_free(void *p);
+
+void *malloc(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(n, size);
+}
+
+void *realloc(void *p, size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(p, size);
+}
+
+void free(void *p) { __libc_free(p); }
+}
+#endif
+
+void *operator new(size_t size) {
+#ifndef COUNT_MALLOC
+    allocations.fetch_add(1, std::memory_order_relaxed);
+#endif
+    void *p = malloc(size ? size : 1);
+    if (nullptr == p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void *p) noexcept { free(p); }
+
+void operator delete[](void *p) noexcept { free(p); }
+
+/* ------------------------------------------------------------------------ */
+/*      The matrix                                                          */
+/* ------------------------------------------------------------------------ */
+
+/* What the input points of an operation are */
+enum Input {
+    LONLAT, /* longitude, latitude in degrees, radians if the operation
+               takes angles, and height */
+    LATLON, /* latitude, longitude in degrees, and height: EPSG order */
+    CART,   /* geocentric cartesian coordinates, GRS80 */
+    PLANE   /* easting, northing and height */
+};
+
+typedef struct {
+    const char *group;
+    const char *name;
+    const char *definition; /* or source CRS for crs_to_crs */
+    const char *target;     /* target CRS for crs_to_crs */
+    Input input;
+    double x0, y0; /* centre of the input region, degrees or meters */
+    double dx, dy; /* and its half widths */
+} Entry;
+
+#define HGRID "./proj_bench_hgrid.ct2"
+#define VGRID "./proj_bench_vgrid.gtx"
+
+/* Projections which need parameters, or a region of their own */
+static const Entry projection_setup[] = {
+    {"projection", "aea", "+lat_1=30 +lat_2=60", nullptr, LONLAT, 0, 45, 20, 15},
+    {"projection", "alsk", "", nullptr, LONLAT, -150, 60, 10, 5},
+    {"projection", "bonne", "+lat_1=45", nullptr, LONLAT, 0, 45, 20, 15},
+    {"projection", "calcofi", "", nullptr, LONLAT, -120, 34, 5, 5},
+    {"projection", "ccon", "+lat_1=45", nullptr, LONLAT, 0, 45, 10, 10},
+    {"projection", "chamb",
+     "+lat_1=10 +lon_1=-10 +lat_2=10 +lon_2=10 +lat_3=40 +lon_3=0", nullptr,
+     LONLAT, 0, 20, 15, 15},
+    {"projection", "eqdc", "+lat_1=30 +lat_2=60", nullptr, LONLAT, 0, 45, 20,
+     15},
+    {"projection", "euler", "+lat_1=30 +lat_2=60", nullptr, LONLAT, 0, 45, 20,
+     15},
+    {"projection", "geos", "+h=35785831", nullptr, LONLAT, 0, 0, 50, 50},
+    {"projection", "gn_sinu", "+m=2 +n=3", nullptr, LONLAT, 0, 0, 40, 40},
+    {"projection", "gs48", "", nullptr, LONLAT, -100, 40, 20, 10},
+    {"projection", "gs50", "", nullptr, LONLAT, -110, 45, 30, 15},
+    {"projection", "imw_p", "+lat_1=30 +lat_2=40", nullptr, LONLAT, 0, 35, 3,
+     3},
+    {"projection", "krovak", "", nullptr, LONLAT, 15, 49.5, 3, 2},
+    {"projection", "labrd", "+lat_0=-18 +lon_0=46", nullptr, LONLAT, 46, -18,
+     3, 5},
+    {"projection", "lcc", "+lat_1=30 +lat_2=60", nullptr, LONLAT, 0, 45, 20,
+     15},
+    {"projection", "lcca", "+lat_0=45", nullptr, LONLAT, 0, 45, 10, 10},
+    {"projection", "lsat", "+lsat=5 +path=100", nullptr, LONLAT, 0, 0, 40, 40},
+    {"projection", "misrsom", "+path=100", nullptr, LONLAT, 0, 0, 40, 40},
+    {"projection", "murd1", "+lat_1=30 +lat_2=60", nullptr, LONLAT, 0, 45, 20,
+     15},
+    {"projection", "murd2", "+lat_1=30 +lat_2=60", nullptr, LONLAT, 0, 45, 20,
+     15},
+    {"projection", "murd3", "+lat_1=30 +lat_2=60", nullptr, LONLAT, 0, 45, 20,
+     15},
+    {"projection", "nsper", "+h=3000000", nullptr, LONLAT, 0, 0, 20, 20},
+    {"projection", "nzmg", "", nullptr, LONLAT, 173, -41, 4, 5},
+    {"projection", "ob_tran", "+o_proj=moll +o_lat_p=45 +o_lon_p=-90",
+     nullptr, LONLAT, 0, 0, 40, 40},
+    {"projection", "oea", "+m=1 +n=2", nullptr, LONLAT, 0, 0, 40, 40},
+    {"projection", "omerc", "+lat_1=45 +lon_1=-5 +lat_2=50 +lon_2=5", nullptr,
+     LONLAT, 0, 47, 10, 5},
+    {"projection", "pconic", "+lat_1=30 +lat_2=60", nullptr, LONLAT, 0, 45, 20,
+     15},
+    {"projection", "sch", "+plat_0=40 +plon_0=-100 +phdg_0=20", nullptr,
+     LONLAT, -100, 40, 5, 5},
+    {"projection", "tissot", "+lat_1=30 +lat_2=60", nullptr, LONLAT, 0, 45, 20,
+     15},
+    {"projection", "tpeqd", "+lat_1=40 +lon_1=-10 +lat_2=50 +lon_2=10",
+     nullptr, LONLAT, 0, 45, 20, 15},
+    {"projection", "tpers", "+h=3000000 +tilt=10 +azi=20", nullptr, LONLAT, 0,
+     0, 20, 20},
+    {"projection", "ups", "", nullptr, LONLAT, 0, 85, 180, 5},
+    {"projection", "urm5", "+n=0.5", nullptr, LONLAT, 0, 0, 40, 40},
+    {"projection", "urmfps", "+n=0.5", nullptr, LONLAT, 0, 0, 40, 40},
+    {"projection", "utm", "+zone=32", nullptr, LONLAT, 9, 50, 3, 20},
+    {"projection", "vitk1", "+lat_1=30 +lat_2=60", nullptr, LONLAT, 0, 45, 20,
+     15},
+};
+
+/* Operations of the list which are not projections */
+static const char *const not_projections[] = {
+    "affine",      "axisswap",   "cart",       "deformation", "geoc",
+    "geocent",     "geogoffset", "helmert",    "hgridshift",  "horner",
+    "latlon",      "latlong",    "lonlat",     "longlat",     "molobadekas",
+    "molodensky",  "pipeline",   "pop",        "push",        "unitconvert",
+    "vgridshift",  nullptr};
+
+static const Entry transformations[] = {
+    {"transformation", "affine",
+     "+proj=affine +xoff=100 +yoff=200 +zoff=10 +s11=0.99 +s12=0.01 "
+     "+s21=-0.01 +s22=0.99",
+     nullptr, PLANE, 500000, 5000000, 100000, 100000},
+    {"transformation", "axisswap", "+proj=axisswap +order=2,1,-3", nullptr,
+     PLANE, 500000, 5000000, 100000, 100000},
+    {"transformation", "cart", "+proj=cart +ellps=GRS80", nullptr, LONLAT, 0,
+     0, 180, 85},
+    {"transformation", "geoc", "+proj=geoc +ellps=GRS80", nullptr, LONLAT, 0,
+     0, 180, 85},
+    {"transformation", "geocent", "+proj=geocent +ellps=GRS80", nullptr,
+     LONLAT, 0, 0, 180, 85},
+    {"transformation", "geogoffset", "+proj=geogoffset +dlat=10 +dlon=-5 +dh=1",
+     nullptr, LONLAT, 0, 0, 170, 80},
+    {"transformation", "helmert",
+     "+proj=helmert +x=-81.07 +y=-89.36 +z=-115.75 +rx=0.485 +ry=0.024 "
+     "+rz=0.413 +s=-0.54 +convention=position_vector",
+     nullptr, CART, 0, 0, 180, 85},
+    {"transformation", "helmert_time",
+     "+proj=helmert +x=0.0127 +y=0.0065 +z=-0.0209 +s=0.00195 +rx=-0.00039 "
+     "+ry=0.0008 +rz=-0.00114 +dx=-0.0029 +dy=-0.0002 +dz=-0.0006 "
+     "+ds=0.00001 +drx=-0.00011 +dry=-0.00019 +drz=0.00007 +t_epoch=1988.0 "
+     "+convention=coordinate_frame",
+     nullptr, CART, 0, 0, 180, 85},
+    {"transformation", "horner",
+     "+proj=horner +ellps=intl +range=500000 "
+     "+fwd_origin=877605.269066,6125810.306769 "
+     "+inv_origin=877605.760036,6125811.281773 +deg=4 "
+     "+fwd_v=6.1258112678e+06,9.9999971567e-01,1.5372750011e-10,5."
+     "9300860915e-15,2.2609497633e-19,4.3188227445e-05,2.8225130416e-10,7."
+     "8740007114e-16,-1.7453997279e-19,1.6877465415e-10,-1.1234649773e-14,-1."
+     "7042333358e-18,-7.9303467953e-15,-5.2906832535e-19,3.9984284847e-19 "
+     "+fwd_u=8.7760574982e+05,9.9999752475e-01,2.8817299305e-10,5."
+     "5641310680e-15,-1.5544700949e-18,-4.1357045890e-05,4.2106213519e-11,2."
+     "8525551629e-14,-1.9107771273e-18,3.3615590093e-10,2.4380247154e-14,-2."
+     "0241230315e-18,1.2429019719e-15,5.3886155968e-19,-1.0167505000e-18 "
+     "+inv_v=6.1258103208e+06,1.0000002826e+00,-1.5372762184e-10,-5."
+     "9304261011e-15,-2.2612705361e-19,-4.3188331419e-05,-2.8225549995e-10,-"
+     "7.8529116371e-16,1.7476576773e-19,-1.6875687989e-10,1.1236475299e-14,1."
+     "7042518057e-18,7.9300735257e-15,5.2881862699e-19,-3.9990736798e-19 "
+     "+inv_u=8.7760527928e+05,1.0000024735e+00,-2.8817540032e-10,-5."
+     "5627059451e-15,1.5543637570e-18,4.1357152105e-05,-4.2114813612e-11,-2."
+     "8523713454e-14,1.9109017837e-18,-3.3616407783e-10,-2.4382678126e-14,2."
+     "0245020199e-18,-1.2441377565e-15,-5.3885232238e-19,1.0167203661e-18",
+     nullptr, PLANE, 877605, 6125810, 100000, 100000},
+    {"transformation", "molobadekas",
+     "+proj=molobadekas +convention=coordinate_frame +x=-270.933 +y=115.599 "
+     "+z=-360.226 +rx=-5.266 +ry=-1.238 +rz=2.381 +s=-5.109 +px=2464351.59 "
+     "+py=-5783466.61 +pz=974809.81",
+     nullptr, CART, -67, 9, 5, 5},
+    {"transformation", "molodensky",
+     "+proj=molodensky +a=6378160 +rf=298.25 +da=-23 +df=-8.120449e-8 "
+     "+dx=-134 +dy=-48 +dz=149",
+     nullptr, LONLAT, 145, -37, 10, 10},
+    {"transformation", "molodensky_abridged",
+     "+proj=molodensky +a=6378160 +rf=298.25 +da=-23 +df=-8.120449e-8 "
+     "+dx=-134 +dy=-48 +dz=149 +abridged",
+     nullptr, LONLAT, 145, -37, 10, 10},
+    {"transformation", "unitconvert",
+     "+proj=unitconvert +xy_in=m +xy_out=us-ft +z_in=m +z_out=km "
+     "+t_in=decimalyear +t_out=gps_week",
+     nullptr, PLANE, 500000, 5000000, 100000, 100000},
+    {"transformation", "pipeline_utm",
+     "+proj=pipeline +step +proj=axisswap +order=2,1 "
+     "+step +proj=unitconvert +xy_in=deg +xy_out=rad "
+     "+step +proj=utm +zone=32 +ellps=GRS80",
+     nullptr, LATLON, 9, 50, 3, 20},
+    {"transformation", "pipeline_datum_shift",
+     "+proj=pipeline +step +proj=push +v_3 +step +proj=cart +ellps=GRS80 "
+     "+step +proj=helmert +x=-81.07 +y=-89.36 +z=-115.75 +rx=0.485 +ry=0.024 "
+     "+rz=0.413 +s=-0.54 +convention=position_vector "
+     "+step +inv +proj=cart +ellps=intl +step +proj=pop +v_3",
+     nullptr, LONLAT, 0, 0, 180, 85},
+};
+
+static const Entry gridshifts[] = {
+    {"gridshift", "hgridshift", "+proj=hgridshift +grids=" HGRID, nullptr,
+     LONLAT, 10, 50, 9, 9},
+    {"gridshift", "vgridshift", "+proj=vgridshift +grids=" VGRID, nullptr,
+     LONLAT, 10, 50, 9, 9},
+    {"gridshift", "deformation",
+     "+proj=deformation +xy_grids=" HGRID " +z_grids=" VGRID
+     " +t_epoch=2010 +ellps=GRS80",
+     nullptr, CART, 10, 50, 9, 9},
+    {"gridshift", "pipeline_grids",
+     "+proj=pipeline +step +proj=hgridshift +grids=" HGRID
+     " +step +proj=vgridshift +grids=" VGRID,
+     nullptr, LONLAT, 10, 50, 9, 9},
+};
+
+static const Entry crs_pairs[] = {
+    {"crs_to_crs", "4326_3857", "EPSG:4326", "EPSG:3857", LATLON, 0, 0, 180,
+     80},
+    {"crs_to_crs", "4326_32632", "EPSG:4326", "EPSG:32632", LATLON, 9, 50, 3,
+     20},
+    {"crs_to_crs", "4258_25832", "EPSG:4258", "EPSG:25832", LATLON, 9, 55, 3,
+     10},
+    {"crs_to_crs", "4326_3035", "EPSG:4326", "EPSG:3035", LATLON, 10, 52, 20,
+     15},
+    {"crs_to_crs", "4326_4978", "EPSG:4326", "EPSG:4978", LATLON, 0, 0, 180,
+     85},
+    {"crs_to_crs", "4267_4269", "EPSG:4267", "EPSG:4269", LATLON, -95, 40, 20,
+     10},
+    {"crs_to_crs", "27700_4326", "EPSG:27700", "EPSG:4326", PLANE, 400000,
+     400000, 200000, 300000},
+    {"crs_to_crs", "2056_4326", "EPSG:2056", "EPSG:4326", PLANE, 2660000,
+     1190000, 100000, 60000},
+};
+
+/* Their region is that of the points, or of the centres of the polygons */
+static const Entry geodesics[] = {
+    {"geodesic", "distance_matrix", "geod_distance_matrix +ellps=WGS84",
+     nullptr, LONLAT, 0, 0, 180, 80},
+    {"geodesic", "knn", "geod_knn +k=10 +ellps=WGS84", nullptr, LONLAT, 0, 0,
+     180, 80},
+    {"geodesic", "polygonarea",
+     "geod_polygonarea_batch +vertices=1000 +ellps=WGS84", nullptr, LONLAT, 0,
+     0, 170, 70},
+};
+
+#define KNN_K 10
+#define POLYGON_VERTICES 1000
+
+/* ------------------------------------------------------------------------ */
+/*      Points                                                              */
+/* ------------------------------------------------------------------------ */
+
+/* xorshift64*: the same points for the same seed everywhere */
+static double uniform(uint64_t &state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return static_cast<double>((state * UINT64_C(2685821657736338717)) >> 11) /
+           9007199254740992.0;
+}
+
+static PJ_COORD random_point(PJ *P, PJ *cart, const Entry &e,
+                             uint64_t &state) {
+    double u = 2 * uniform(state) - 1;
+    double v = 2 * uniform(state) - 1;
+    double h = 1000 * uniform(state);
+    double x = e.x0 + e.dx * u, y = e.y0 + e.dy * v;
+    PJ_COORD c;
+
+    switch (e.input) {
+    case LONLAT:
+        if (proj_angular_input(P, PJ_FWD))
+            return proj_coord(proj_torad(x), proj_torad(y), h, 2020);
+        return proj_coord(x, y, h, 2020);
+    case LATLON:
+        return proj_coord(y, x, h, 2020);
+    case CART:
+        c = proj_coord(proj_torad(x), proj_torad(y), h, 2020);
+        return proj_trans(cart, PJ_FWD, c);
+    case PLANE:
+        break;
+    }
+    return proj_coord(x, y, h, 2020);
+}
+
+/* n points of the region of e which transform forward, and back if the */
+/* operation has an inverse. Fewer if they are hard to find             */
+static void make_points(PJ *P, PJ *cart, const Entry &e, size_t n,
+                        uint64_t seed, bool inverse,
+                        std::vector<PJ_COORD> &fwd,
+                        std::vector<PJ_COORD> &inv) {
+    uint64_t state = seed * UINT64_C(0x9E3779B97F4A7C15) + 1;
+    fwd.clear();
+    inv.clear();
+    for (size_t tries = 0; fwd.size() < n && tries < 20 * n; tries++) {
+        PJ_COORD a = random_point(P, cart, e, state);
+        PJ_COORD b = proj_trans(P, PJ_FWD, a);
+        if (HUGE_VAL == b.xyzt.x)
+            continue;
+        if (inverse && HUGE_VAL == proj_trans(P, PJ_INV, b).xyzt.x)
+            continue;
+        fwd.push_back(a);
+        inv.push_back(b);
+    }
+    proj_errno_reset(P);
+}
+
+/* ------------------------------------------------------------------------ */
+/*      Measurements                                                        */
+/* ------------------------------------------------------------------------ */
+
+typedef struct {
+    const char *api;
+    double ns_per_point;
+    double allocations_per_call;
+} Measure;
+
+typedef struct {
+    std::string group, name, definition, direction;
+    size_t points;
+    Measure m;
+} Result;
+
+typedef struct {
+    std::string group, name, definition, reason;
+} Skipped;
+
+static double now_ns() {
+    return static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+static double median(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    size_t k = v.size() / 2;
+    return v.size() % 2 ? v[k] : (v[k - 1] + v[k]) / 2;
+}
+
+static Measure run_trans(PJ *P, PJ_DIRECTION dir,
+                         const std::vector<PJ_COORD> &in,
+                         std::vector<PJ_COORD> &out, int reps) {
+    std::vector<double> times;
+    long count = 0;
+    const size_t n = in.size();
+
+    times.reserve(reps);
+    for (int r = 0; r < reps; r++) {
+        long a = allocations.load();
+        double t = now_ns();
+        for (size_t i = 0; i < n; i++)
+            out[i] = proj_trans(P, dir, in[i]);
+        times.push_back(now_ns() - t);
+        count += allocations.load() - a;
+    }
+    Measure m = {"proj_trans", median(times) / n,
+                 static_cast<double>(count) / (static_cast<double>(reps) * n)};
+    return m;
+}
+
+static Measure run_array(PJ *P, PJ_DIRECTION dir,
+                         const std::vector<PJ_COORD> &in,
+                         std::vector<PJ_COORD> &out, int reps) {
+    std::vector<double> times;
+    long count = 0;
+    const size_t n = in.size();
+
+    times.reserve(reps);
+    for (int r = 0; r < reps; r++) {
+        std::copy(in.begin(), in.end(), out.begin());
+        long a = allocations.load();
+        double t = now_ns();
+        proj_trans_array(P, dir, n, out.data());
+        times.push_back(now_ns() - t);
+        count += allocations.load() - a;
+    }
+    Measure m = {"proj_trans_array", median(times) / n,
+                 static_cast<double>(count) / reps};
+    return m;
+}
+
+static Measure run_generic(PJ *P, PJ_DIRECTION dir,
+                           const std::vector<PJ_COORD> &in, int reps) {
+    std::vector<double> times, x(in.size()), y(in.size()), z(in.size()),
+        t(in.size());
+    const size_t n = in.size(), s = sizeof(double);
+    long count = 0;
+
+    times.reserve(reps);
+    for (int r = 0; r < reps; r++) {
+        for (size_t i = 0; i < n; i++) {
+            x[i] = in[i].xyzt.x;
+            y[i] = in[i].xyzt.y;
+            z[i] = in[i].xyzt.z;
+            t[i] = in[i].xyzt.t;
+        }
+        long a = allocations.load();
+        double t0 = now_ns();
+        proj_trans_generic(P, dir, x.data(), s, n, y.data(), s, n, z.data(), s,
+                           n, t.data(), s, n);
+        times.push_back(now_ns() - t0);
+        count += allocations.load() - a;
+    }
+    Measure m = {"proj_trans_generic", median(times) / n,
+                 static_cast<double>(count) / reps};
+    return m;
+}
+
+/* ------------------------------------------------------------------------ */
+/*      Geodesics                                                           */
+/* ------------------------------------------------------------------------ */
+
+/* The query points of geod_distance_matrix() and geod_knn(): few enough */
+/* that a repetition stays near a million geodesics                      */
+static size_t geodesic_queries(size_t npoints) {
+    return std::max<size_t>(1, std::min<size_t>(100, 1000000 / npoints));
+}
+
+static void geodesic_points(const Entry &e, size_t n, uint64_t &state,
+                            std::vector<double> &lat,
+                            std::vector<double> &lon) {
+    lat.resize(n);
+    lon.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        lon[i] = e.x0 + e.dx * (2 * uniform(state) - 1);
+        lat[i] = e.y0 + e.dy * (2 * uniform(state) - 1);
+    }
+}
+
+static Measure run_distance_matrix(const geod_geodesic &g,
+                                   const std::vector<double> &qlat,
+                                   const std::vector<double> &qlon,
+                                   const std::vector<double> &lat,
+                                   const std::vector<double> &lon,
+                                   std::vector<double> &s12, int reps,
+                                   int nthreads) {
+    std::vector<double> times;
+    long count = 0;
+    const int nq = static_cast<int>(qlat.size());
+    const int n = static_cast<int>(lat.size());
+
+    times.reserve(reps);
+    for (int r = 0; r < reps; r++) {
+        long a = allocations.load();
+        double t = now_ns();
+        geod_distance_matrix(&g, qlat.data(), qlon.data(), nq, lat.data(),
+                             lon.data(), n, s12.data(), nthreads);
+        times.push_back(now_ns() - t);
+        count += allocations.load() - a;
+    }
+    Measure m = {"geod_distance_matrix",
+                 median(times) / (static_cast<double>(nq) * n),
+                 static_cast<double>(count) / reps};
+    return m;
+}
+
+static Measure run_knn(const geod_geodesic &g, const std::vector<double> &qlat,
+                       const std::vector<double> &qlon,
+                       const std::vector<double> &lat,
+                       const std::vector<double> &lon, std::vector<int> &idx,
+                       std::vector<double> &s12, int reps, int nthreads) {
+    std::vector<double> times;
+    long count = 0;
+    const int nq = static_cast<int>(qlat.size());
+    const int n = static_cast<int>(lat.size());
+
+    times.reserve(reps);
+    for (int r = 0; r < reps; r++) {
+        long a = allocations.load();
+        double t = now_ns();
+        geod_knn(&g, lat.data(), lon.data(), n, qlat.data(), qlon.data(), nq,
+                 KNN_K, idx.data(), s12.data(), nthreads);
+        times.push_back(now_ns() - t);
+        count += allocations.load() - a;
+    }
+    Measure m = {"geod_knn", median(times) / nq,
+                 static_cast<double>(count) / reps};
+    return m;
+}
+
+/* What geod_knn() saves: all the distances, then the k smallest of each */
+/* row, in the order of geod_knn()                                       */
+static Measure run_brute_force(const geod_geodesic &g,
+                               const std::vector<double> &qlat,
+                               const std::vector<double> &qlon,
+                               const std::vector<double> &lat,
+                               const std::vector<double> &lon,
+                               std::vector<int> &idx, std::vector<double> &s12,
+                               int reps, int nthreads) {
+    std::vector<double> times, d(qlat.size() * lat.size());
+    std::vector<int> order(lat.size());
+    long count = 0;
+    const int nq = static_cast<int>(qlat.size());
+    const int n = static_cast<int>(lat.size());
+    const int k = std::min(KNN_K, n);
+
+    times.reserve(reps);
+    for (int r = 0; r < reps; r++) {
+        long a = allocations.load();
+        double t = now_ns();
+        geod_distance_matrix(&g, qlat.data(), qlon.data(), nq, lat.data(),
+                             lon.data(), n, d.data(), nthreads);
+        for (int i = 0; i < nq; i++) {
+            const double *row = d.data() + static_cast<size_t>(i) * n;
+            for (int j = 0; j < n; j++)
+                order[j] = j;
+            std::partial_sort(order.begin(), order.begin() + k, order.end(),
+                              [row](int u, int v) {
+                                  return row[u] < row[v] ||
+                                         (row[u] == row[v] && u < v);
+                              });
+            for (int j = 0; j < KNN_K; j++) {
+                idx[i * KNN_K + j] = j < k ? order[j] : -1;
+                s12[i * KNN_K + j] = j < k ? row[order[j]] : HUGE_VAL;
+            }
+        }
+        times.push_back(now_ns() - t);
+        count += allocations.load() - a;
+    }
+    Measure m = {"brute_force", median(times) / nq,
+                 static_cast<double>(count) / reps};
+    return m;
+}
+
+static Measure run_polygonarea(const geod_geodesic &g,
+                               const std::vector<double> &lat,
+                               const std::vector<double> &lon,
+                               const std::vector<int> &offsets,
+                               std::vector<double> &A, int reps,
+                               int nthreads) {
+    std::vector<double> times, P(A.size());
+    long count = 0;
+    const int n = static_cast<int>(A.size());
+
+    times.reserve(reps);
+    for (int r = 0; r < reps; r++) {
+        long a = allocations.load();
+        double t = now_ns();
+        geod_polygonarea_batch(&g, lat.data(), lon.data(), offsets.data(), n,
+                               A.data(), P.data(), nthreads);
+        times.push_back(now_ns() - t);
+        count += allocations.load() - a;
+    }
+    Measure m = {"geod_polygonarea_batch", median(times) / lat.size(),
+                 static_cast<double>(count) / reps};
+    return m;
+}
+
+/* Runs the geodesic entry e, into m and the points of each measure. */
+/* Returns false, and why in reason, if it cannot be run or geod_knn */
+/* and the brute force disagree                                      */
+static bool run_geodesic(const Entry &e, size_t npoints, uint64_t seed,
+                         int reps, int nthreads, std::vector<Measure> &m,
+                         std::vector<size_t> &points, std::string &reason) {
+    uint64_t state = seed * UINT64_C(0x9E3779B97F4A7C15) + 1;
+    geod_geodesic g;
+    std::vector<double> lat, lon, qlat, qlon;
+
+    m.clear();
+    points.clear();
+    if (npoints > static_cast<size_t>(INT32_MAX) / KNN_K) {
+        reason = "too many points for the geodesic functions";
+        return false;
+    }
+    geod_init(&g, 6378137, 1 / 298.257223563);
+
+    if (0 == strcmp(e.name, "polygonarea")) {
+        /* Star shaped rings of random radii around random centres */
+        const size_t npolygons =
+            std::max<size_t>(1, npoints / POLYGON_VERTICES);
+        std::vector<int> offsets(1, 0);
+        std::vector<double> A(npolygons);
+        for (size_t i = 0; i < npolygons; i++) {
+            double clon = e.x0 + e.dx * (2 * uniform(state) - 1);
+            double clat = e.y0 + e.dy * (2 * uniform(state) - 1);
+            for (int j = 0; j < POLYGON_VERTICES; j++) {
+                double plat, plon;
+                geod_direct(&g, clat, clon, j * 360.0 / POLYGON_VERTICES,
+                            10000 + 90000 * uniform(state), &plat, &plon,
+                            nullptr);
+                lat.push_back(plat);
+                lon.push_back(plon);
+            }
+            offsets.push_back(static_cast<int>(lat.size()));
+        }
+        m.push_back(run_polygonarea(g, lat, lon, offsets, A, reps, nthreads));
+        points.push_back(lat.size());
+        return true;
+    }
+
+    geodesic_points(e, npoints, state, lat, lon);
+    geodesic_points(e, geodesic_queries(npoints), state, qlat, qlon);
+    const size_t nq = qlat.size();
+
+    if (0 == strcmp(e.name, "distance_matrix")) {
+        std::vector<double> s12(nq * npoints);
+        m.push_back(
+            run_distance_matrix(g, qlat, qlon, lat, lon, s12, reps, nthreads));
+        points.push_back(nq * npoints);
+        return true;
+    }
+
+    std::vector<int> idx(nq * KNN_K), brute_idx(nq * KNN_K);
+    std::vector<double> s12(nq * KNN_K), brute_s12(nq * KNN_K);
+    m.push_back(run_knn(g, qlat, qlon, lat, lon, idx, s12, reps, nthreads));
+    m.push_back(run_brute_force(g, qlat, qlon, lat, lon, brute_idx, brute_s12,
+                                reps, nthreads));
+    points.push_back(nq);
+    points.push_back(nq);
+    for (size_t i = 0; i < idx.size(); i++) {
+        if (idx[i] != brute_idx[i] || s12[i] != brute_s12[i]) {
+            char buf[100];
+            snprintf(buf, sizeof(buf),
+                     "geod_knn disagrees with the brute force at query %lu",
+                     static_cast<unsigned long>(i / KNN_K));
+            reason = buf;
+            return false;
+        }
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------ */
+/*      Output                                                              */
+/* ------------------------------------------------------------------------ */
+
+static void json_string(FILE *f, const std::string &s) {
+    fputc('"', f);
+    for (size_t i = 0; i < s.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        if ('"' == c || '\\' == c)
+            fprintf(f, "\\%c", c);
+        else if (c < 0x20)
+            fprintf(f, "\\u%04x", c);
+        else
+            fputc(c, f);
+    }
+    fputc('"', f);
+}
+
+static void write_json(FILE *f, const std::vector<Result> &results,
+                       const std::vector<Skipped> &skipped, size_t npoints,
+                       int reps, unsigned long seed, int nthreads) {
+    fprintf(f, "{\n  \"proj_version\": ");
+    json_string(f, proj_info().version);
+    fprintf(f,
+            ",\n  \"points\": %lu,\n  \"repetitions\": %d,\n"
+            "  \"seed\": %lu,\n  \"threads\": %d,\n",
+            static_cast<unsigned long>(npoints), reps, seed, nthreads);
+#ifdef COUNT_MALLOC
+    fprintf(f, "  \"allocations_counted\": \"malloc\",\n");
+#else
+    fprintf(f, "  \"allocations_counted\": \"operator new\",\n");
+#endif
+
+    fprintf(f, "  \"results\": [");
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result &r = results[i];
+        fprintf(f, "%s\n    {\"group\": ", i ? "," : "");
+        json_string(f, r.group);
+        fprintf(f, ", \"name\": ");
+        json_string(f, r.name);
+        fprintf(f, ", \"definition\": ");
+        json_string(f, r.definition);
+        fprintf(f, ", \"direction\": ");
+        json_string(f, r.direction);
+        fprintf(f,
+                ", \"api\": \"%s\", \"points\": %lu, "
+                "\"ns_per_point\": %.3f, \"points_per_sec\": %.0f, "
+                "\"allocations_per_call\": %.3f}",
+                r.m.api, static_cast<unsigned long>(r.points),
+                r.m.ns_per_point, 1e9 / r.m.ns_per_point,
+                r.m.allocations_per_call);
+    }
+    fprintf(f, "\n  ],\n  \"skipped\": [");
+    for (size_t i = 0; i < skipped.size(); i++) {
+        const Skipped &s = skipped[i];
+        fprintf(f, "%s\n    {\"group\": ", i ? "," : "");
+        json_string(f, s.group);
+        fprintf(f, ", \"name\": ");
+        json_string(f, s.name);
+        fprintf(f, ", \"definition\": ");
+        json_string(f, s.definition);
+        fprintf(f, ", \"reason\": ");
+        json_string(f, s.reason);
+        fprintf(f, "}");
+    }
+    fprintf(f, "\n  ]\n}\n");
+}
+
+/* Keeps the first error logged, as the reason an entry is skipped */
+static void keep_error(void *app_data, int level, const char *msg) {
+    std::string *error = static_cast<std::string *>(app_data);
+    if (PJ_LOG_ERROR == level && error->empty())
+        *error = msg;
+}
+
+static void print_result(const Result &r) {
+    printf("%-15s %-22s %-4s %-22s %10.1f %12.0f %8.2f\n", r.group.c_str(),
+           r.name.c_str(), r.direction.c_str(), r.m.api, r.m.ns_per_point,
+           1e9 / r.m.ns_per_point, r.m.allocations_per_call);
+    fflush(stdout);
+}
+
+/* ------------------------------------------------------------------------ */
+/*      Main                                                                */
+/* ------------------------------------------------------------------------ */
+
+static const char usage[] = {
+    "Usage: %s [options]\n"
+    "\n"
+    "Runs the operations of the benchmark matrix on synthetic points through\n"
+    "proj_trans, proj_trans_array and proj_trans_generic, and the geodesic\n"
+    "batch functions, and reports the time and allocations they take.\n"
+    "\n"
+    "    -n points      Points per operation (default 100000)\n"
+    "    -r reps        Repetitions, of which the median is taken "
+    "(default 3)\n"
+    "    -s seed        Seed of the synthetic points (default 1)\n"
+    "    -g group       Only the given group: projection, transformation,\n"
+    "                   gridshift, crs_to_crs or geodesic. May be repeated\n"
+    "    -t, --threads threads\n"
+    "                   Threads of the geodesic group, 0 for one per\n"
+    "                   hardware thread (default 1)\n"
+    "    -f text        Only operations whose name contains text\n"
+    "    -j, --json file\n"
+    "                   Also write the results as JSON to file, '-' for\n"
+    "                   standard output instead of the table\n"
+    "    -l             List the operations and exit\n"
+    "    -h             This help\n"};
+
+int main(int argc, char **argv) {
+    size_t npoints = 100000;
+    int reps = 3, nthreads = 1;
+    unsigned long seed = 1;
+    std::vector<std::string> groups;
+    const char *filter = nullptr, *json = nullptr;
+    bool list = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (0 == strcmp(arg, "-l"))
+            list = true;
+        else if (0 == strcmp(arg, "-h") || 0 == strcmp(arg, "--help")) {
+            printf(usage, argv[0]);
+            return 0;
+        } else if (nullptr != value && 0 == strcmp(arg, "-n")) {
+            npoints = strtoul(value, nullptr, 10);
+            i++;
+        } else if (nullptr != value && 0 == strcmp(arg, "-r")) {
+            reps = atoi(value);
+            i++;
+        } else if (nullptr != value && 0 == strcmp(arg, "-s")) {
+            seed = strtoul(value, nullptr, 10);
+            i++;
+        } else if (nullptr != value && 0 == strcmp(arg, "-g")) {
+            groups.push_back(value);
+            i++;
+        } else if (nullptr != value &&
+                   (0 == strcmp(arg, "-t") || 0 == strcmp(arg, "--threads"))) {
+            nthreads = atoi(value);
+            i++;
+        } else if (nullptr != value && 0 == strcmp(arg, "-f")) {
+            filter = value;
+            i++;
+        } else if (nullptr != value &&
+                   (0 == strcmp(arg, "-j") || 0 == strcmp(arg, "--json"))) {
+            json = value;
+            i++;
+        } else {
+            fprintf(stderr, usage, argv[0]);
+            return 1;
+        }
+    }
+    if (0 == npoints || reps < 1) {
+        fprintf(stderr, "%s: -n and -r must be positive\n", argv[0]);
+        return 1;
+    }
+    if (nthreads < 0) {
+        fprintf(stderr, "%s: -t must not be negative\n", argv[0]);
+        return 1;
+    }
+
+    /* The matrix */
+    std::vector<Entry> matrix;
+    std::vector<std::string> definitions;
+    for (const PJ_OPERATIONS *op = proj_list_operations(); op->id; op++) {
+        bool skip = false;
+        for (const char *const *p = not_projections; *p; p++)
+            skip = skip || 0 == strcmp(*p, op->id);
+        if (skip)
+            continue;
+        Entry e = {"projection", op->id, "", nullptr, LONLAT, 0, 0, 40, 40};
+        for (const Entry &s : projection_setup)
+            if (0 == strcmp(s.name, op->id))
+                e = s;
+        matrix.push_back(e);
+    }
+    matrix.insert(matrix.end(), std::begin(transformations),
+                  std::end(transformations));
+    matrix.insert(matrix.end(), std::begin(gridshifts), std::end(gridshifts));
+    matrix.insert(matrix.end(), std::begin(crs_pairs), std::end(crs_pairs));
+    matrix.insert(matrix.end(), std::begin(geodesics), std::end(geodesics));
+
+    std::vector<Entry> selected;
+    for (const Entry &e : matrix) {
+        if (!groups.empty() &&
+            std::find(groups.begin(), groups.end(), e.group) == groups.end())
+            continue;
+        if (filter && nullptr == strstr(e.name, filter))
+            continue;
+        selected.push_back(e);
+        if (0 == strcmp(e.group, "projection"))
+            definitions.push_back(std::string("+proj=") + e.name +
+                                  " +ellps=GRS80" +
+                                  (*e.definition ? " " : "") + e.definition);
+        else if (nullptr != e.target)
+            definitions.push_back(std::string(e.definition) + " -> " +
+                                  e.target);
+        else
+            definitions.push_back(e.definition);
+    }
+
+    if (list) {
+        for (size_t i = 0; i < selected.size(); i++)
+            printf("%-15s %-22s %s\n", selected[i].group, selected[i].name,
+                   definitions[i].c_str());
+        return 0;
+    }
+
+    FILE *json_file = nullptr;
+    if (json) {
+        json_file = strcmp(json, "-") ? fopen(json, "w") : stdout;
+        if (nullptr == json_file) {
+            fprintf(stderr, "%s: Cannot open '%s'\n", argv[0], json);
+            return 1;
+        }
+    }
+
+    bool grids = false;
+    for (const Entry &e : selected)
+        grids = grids || 0 == strcmp(e.group, "gridshift");
+    if (grids && !(write_hgrid(HGRID) && write_vgrid(VGRID)))
+        fprintf(stderr, "%s: Cannot write the grids in the current directory\n",
+                argv[0]);
+
+    std::string first_error;
+    PJ_CONTEXT *ctx = proj_context_create();
+    proj_log_level(ctx, PJ_LOG_ERROR);
+    proj_log_func(ctx, &first_error, keep_error);
+    PJ *cart = proj_create(ctx, "+proj=cart +ellps=GRS80");
+
+    if (stdout != json_file)
+        printf("%-15s %-22s %-4s %-22s %10s %12s %8s\n", "group", "name",
+               "dir", "api", "ns/point", "points/s", "allocs");
+
+    std::vector<Result> results;
+    std::vector<Skipped> skipped;
+    std::vector<PJ_COORD> fwd, inv, out(npoints);
+
+    for (size_t k = 0; k < selected.size(); k++) {
+        const Entry &e = selected[k];
+        PJ *P;
+
+        if (0 == strcmp(e.group, "geodesic")) {
+            std::vector<Measure> m;
+            std::vector<size_t> points;
+            std::string reason;
+            if (!run_geodesic(e, npoints, seed, reps, nthreads, m, points,
+                              reason)) {
+                Skipped s = {e.group, e.name, definitions[k], reason};
+                skipped.push_back(s);
+            }
+            for (size_t i = 0; i < m.size(); i++) {
+                Result r = {e.group, e.name, definitions[k], "inv", points[i],
+                            m[i]};
+                results.push_back(r);
+                if (stdout != json_file)
+                    print_result(r);
+            }
+            continue;
+        }
+
+        first_error.clear();
+        if (nullptr != e.target)
+            P = proj_create_crs_to_crs(ctx, e.definition, e.target, nullptr);
+        else
+            P = proj_create(ctx, definitions[k].c_str());
+        if (nullptr == P) {
+            int err = proj_context_errno(ctx);
+            if (first_error.empty())
+                first_error =
+                    err ? proj_errno_string(err) : "cannot be instantiated";
+            Skipped s = {e.group, e.name, definitions[k], first_error};
+            skipped.push_back(s);
+            continue;
+        }
+
+        bool inverse = proj_pj_info(P).has_inverse != 0;
+        make_points(P, cart, e, npoints, seed, inverse, fwd, inv);
+        if (fwd.empty()) {
+            Skipped s = {e.group, e.name, definitions[k],
+                         "no point of its region transforms"};
+            skipped.push_back(s);
+            proj_destroy(P);
+            continue;
+        }
+
+        for (int d = 0; d < (inverse ? 2 : 1); d++) {
+            PJ_DIRECTION dir = d ? PJ_INV : PJ_FWD;
+            const std::vector<PJ_COORD> &in = d ? inv : fwd;
+            Measure m[3] = {run_trans(P, dir, in, out, reps),
+                            run_array(P, dir, in, out, reps),
+                            run_generic(P, dir, in, reps)};
+            for (const Measure &mi : m) {
+                Result r = {e.group, e.name, definitions[k],
+                            d ? "inv" : "fwd", in.size(), mi};
+                results.push_back(r);
+                if (stdout != json_file)
+                    print_result(r);
+            }
+        }
+        proj_destroy(P);
+    }
+
+    proj_destroy(cart);
+    proj_context_destroy(ctx);
+    if (grids) {
+        remove(HGRID);
+        remove(VGRID);
+    }
+
+    if (json_file) {
+        write_json(json_file, results, skipped, npoints, reps, seed, nthreads);
+        if (stdout != json_file)
+            fclose(json_file);
+    }
+    if (stdout != json_file) {
+        for (const Skipped &s : skipped)
+            printf("skipped: %s %s: %s\n", s.group.c_str(), s.name.c_str(),
+                   s.reason.c_str());
+    }
+    return 0;
+}
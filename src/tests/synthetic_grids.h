@@ -0,0 +1,131 @@
+/******************************************************************************
+ *
+ * Project:  PROJ
+ * Purpose:  Small synthetic grids, in CTable2 and GTX formats, for the
+ *           benchmark programs.
+ *
+ ******************************************************************************
+ * Copyright (c) 2018, PROJ contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ *****************************************************************************/
+
+/*****************************************************************************
+
+    write_hgrid(name) writes a CTable2 grid of horizontal shifts, and
+    write_vgrid(name) a GTX grid of geoid heights, both covering longitudes
+    GRID_LON0 to GRID_LON0 + 20 and latitudes GRID_LAT0 to GRID_LAT0 + 20
+    degrees, so that the programs which need grids do not depend on those
+    installed. Names should start with "./" to be found in the current
+    directory, and GTX ones end in "gtx".
+
+*****************************************************************************/
+
+#ifndef SYNTHETIC_GRIDS_H
+#define SYNTHETIC_GRIDS_H
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define GRID_LON0 0.0
+#define GRID_LAT0 40.0
+#define GRID_STEP 0.25
+#define GRID_SIZE 81
+
+static void put_le(unsigned char *p, uint64_t v, int n) {
+    for (int i = 0; i < n; i++, v >>= 8)
+        p[i] = static_cast<unsigned char>(v);
+}
+
+static void put_be(unsigned char *p, uint64_t v, int n) {
+    for (int i = n - 1; i >= 0; i--, v >>= 8)
+        p[i] = static_cast<unsigned char>(v);
+}
+
+static uint64_t double_bits(double d) {
+    uint64_t v;
+    memcpy(&v, &d, 8);
+    return v;
+}
+
+static uint64_t float_bits(float f) {
+    uint32_t v;
+    memcpy(&v, &f, 4);
+    return v;
+}
+
+/* Horizontal shifts of a few seconds of arc, varying across the grid */
+static bool write_hgrid(const char *name) {
+    unsigned char header[160] = {0};
+    const double d = 3.14159265358979323846 / 180;
+    FILE *f = fopen(name, "wb");
+    if (nullptr == f)
+        return false;
+
+    memcpy(header, "CTABLE V2.0     ", 16);
+    memcpy(header + 16, "PROJ synthetic test grid", 24);
+    put_le(header + 96, double_bits(GRID_LON0 * d), 8);
+    put_le(header + 104, double_bits(GRID_LAT0 * d), 8);
+    put_le(header + 112, double_bits(GRID_STEP * d), 8);
+    put_le(header + 120, double_bits(GRID_STEP * d), 8);
+    put_le(header + 128, GRID_SIZE, 4);
+    put_le(header + 132, GRID_SIZE, 4);
+    bool ok = fwrite(header, 1, sizeof(header), f) == sizeof(header);
+
+    for (int row = 0; row < GRID_SIZE && ok; row++) {
+        for (int col = 0; col < GRID_SIZE && ok; col++) {
+            unsigned char v[8];
+            double s = 4.8e-6 * (1 + sin(0.1 * row) * cos(0.07 * col));
+            put_le(v, float_bits(static_cast<float>(s)), 4);
+            put_le(v + 4, float_bits(static_cast<float>(-0.5 * s)), 4);
+            ok = fwrite(v, 1, sizeof(v), f) == sizeof(v);
+        }
+    }
+    return 0 == fclose(f) && ok;
+}
+
+/* Geoid heights of some tens of meters */
+static bool write_vgrid(const char *name) {
+    unsigned char header[40];
+    FILE *f = fopen(name, "wb");
+    if (nullptr == f)
+        return false;
+
+    put_be(header, double_bits(GRID_LAT0), 8);
+    put_be(header + 8, double_bits(GRID_LON0), 8);
+    put_be(header + 16, double_bits(GRID_STEP), 8);
+    put_be(header + 24, double_bits(GRID_STEP), 8);
+    put_be(header + 32, GRID_SIZE, 4);
+    put_be(header + 36, GRID_SIZE, 4);
+    bool ok = fwrite(header, 1, sizeof(header), f) == sizeof(header);
+
+    for (int row = 0; row < GRID_SIZE && ok; row++) {
+        for (int col = 0; col < GRID_SIZE && ok; col++) {
+            unsigned char v[4];
+            double h = 40 + 10 * sin(0.05 * row) + 5 * cos(0.09 * col);
+            put_be(v, float_bits(static_cast<float>(h)), 4);
+            ok = fwrite(v, 1, sizeof(v), f) == sizeof(v);
+        }
+    }
+    return 0 == fclose(f) && ok;
+}
+
+#endif /* SYNTHETIC_GRIDS_H */
@@ -110,6 +110,52 @@ static PJ_LP reverse_2d(PJ_XY xy, PJ *P) {
     return reverse_4d(point, P).lp;
 }
 
+static int get_affine_map(PJ *P, PJ_DIRECTION direction, PJ_AFFINE_MAP *A) {
+    const struct pj_opaque_affine *Q = (const struct pj_opaque_affine *) P->opaque;
+    const double off[3] = { Q->xoff, Q->yoff, Q->zoff };
+    int i, j;
+
+    /* The kernels sum terms, so a zero comes out as +0, but for a reverse */
+    /* time shift by zero                                                 */
+    pj_affine_map_set_identity (A);
+    for (i = 0;  i < 4;  i++)
+        A->zero_sign[i] = 1;
+    if (direction == PJ_FWD) {
+        const struct pj_affine_coeffs *C = &(Q->forward);
+        const double m[3][3] = { { C->s11, C->s12, C->s13 },
+                                 { C->s21, C->s22, C->s23 },
+                                 { C->s31, C->s32, C->s33 } };
+        for (i = 0;  i < 3;  i++) {
+            for (j = 0;  j < 3;  j++)
+                A->m[i][j] = m[i][j];
+            A->offset[i] = off[i];
+        }
+        A->m[3][3] = C->tscale;
+        A->offset[3] = Q->toff;
+        return 1;
+    }
+
+    if (nullptr==P->inv4d)
+        return 0;
+
+    /* reverse_4d de-offsets before applying the reverse coefficients */
+    const struct pj_affine_coeffs *C = &(Q->reverse);
+    const double m[3][3] = { { C->s11, C->s12, C->s13 },
+                             { C->s21, C->s22, C->s23 },
+                             { C->s31, C->s32, C->s33 } };
+    for (i = 0;  i < 3;  i++) {
+        A->offset[i] = 0.0;
+        for (j = 0;  j < 3;  j++) {
+            A->m[i][j] = m[i][j];
+            A->offset[i] -= m[i][j] * off[j];
+        }
+    }
+    A->m[3][3] = C->tscale;
+    A->offset[3] = -C->tscale * Q->toff;
+    A->zero_sign[3] = (Q->toff != 0.0);
+    return 1;
+}
+
 static struct pj_opaque_affine * initQ() {
     struct pj_opaque_affine *Q = static_cast<struct pj_opaque_affine *>(pj_calloc(1, sizeof(struct pj_opaque_affine)));
     if (nullptr==Q)
@@ -186,6 +232,7 @@ PJ *TRANSFORMATION(affine,0 /* no need for ellipsoid */) {
     P->inv3d  = reverse_3d;
     P->fwd    = forward_2d;
     P->inv    = reverse_2d;
+    P->get_affine_map = get_affine_map;
 
     P->left   = PJ_IO_UNITS_WHATEVER;
     P->right  = PJ_IO_UNITS_WHATEVER;
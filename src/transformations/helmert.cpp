@@ -473,6 +473,79 @@ static PJ_COORD helmert_reverse_4d (PJ_COORD point, PJ *P) {
     return point;
 }
 
+/***********************************************************************/
+static int helmert_get_affine_map (PJ *P, PJ_DIRECTION direction, PJ_AFFINE_MAP *A) {
+/***********************************************************************/
+    struct pj_opaque_helmert *Q = (struct pj_opaque_helmert *) P->opaque;
+    double scale;
+    int i, j;
+
+    /* Only the time independent transformation is a constant map */
+    if (Q->dxyz.x != 0 || Q->dxyz.y != 0 || Q->dxyz.z != 0 ||
+        Q->dopk.o != 0 || Q->dopk.p != 0 || Q->dopk.k != 0 ||
+        Q->dscale != 0 || Q->dtheta != 0)
+        return 0;
+
+    pj_affine_map_set_identity (A);
+
+    /* The kernels sum terms, except for a reverse translation by zero */
+    for (i = 0;  i < (Q->fourparam ? 2 : 3);  i++)
+        A->zero_sign[i] = 1;
+
+    if (Q->fourparam) {
+        double cr = cos(Q->theta), sr = sin(Q->theta);
+        if (direction == PJ_FWD) {
+            cr *= Q->scale;
+            sr *= Q->scale;
+            A->m[0][0] =  cr;  A->m[0][1] = sr;  A->offset[0] = Q->xyz_0.x;
+            A->m[1][0] = -sr;  A->m[1][1] = cr;  A->offset[1] = Q->xyz_0.y;
+        } else {
+            cr /= Q->scale;
+            sr /= Q->scale;
+            A->m[0][0] = cr;  A->m[0][1] = -sr;
+            A->m[1][0] = sr;  A->m[1][1] =  cr;
+            A->offset[0] = -(cr * Q->xyz_0.x - sr * Q->xyz_0.y);
+            A->offset[1] = -(sr * Q->xyz_0.x + cr * Q->xyz_0.y);
+        }
+        return 1;
+    }
+
+    if (Q->no_rotation) {
+        const double sign = (direction == PJ_FWD) ? 1 : -1;
+        A->offset[0] = sign * Q->xyz.x;
+        A->offset[1] = sign * Q->xyz.y;
+        A->offset[2] = sign * Q->xyz.z;
+        if (direction == PJ_INV)
+            for (i = 0;  i < 3;  i++)
+                A->zero_sign[i] = (A->offset[i] != 0.0);
+        return 1;
+    }
+
+    const double xyz[3]  = { Q->xyz.x,  Q->xyz.y,  Q->xyz.z  };
+    const double refp[3] = { Q->refp.x, Q->refp.y, Q->refp.z };
+    scale = 1 + Q->scale * 1e-6;
+    if (direction == PJ_FWD) {
+        /* scale * R * (X - refp) + xyz */
+        for (i = 0;  i < 3;  i++) {
+            for (j = 0;  j < 3;  j++)
+                A->m[i][j] = scale * Q->R[i][j];
+            A->offset[i] = xyz[i] - (A->m[i][0] * refp[0] +
+                                     A->m[i][1] * refp[1] +
+                                     A->m[i][2] * refp[2]);
+        }
+    } else {
+        /* transpose(R) * (x - xyz) / scale + refp */
+        for (i = 0;  i < 3;  i++) {
+            for (j = 0;  j < 3;  j++)
+                A->m[i][j] = Q->R[j][i] / scale;
+            A->offset[i] = refp[i] - (A->m[i][0] * xyz[0] +
+                                      A->m[i][1] * xyz[1] +
+                                      A->m[i][2] * xyz[2]);
+        }
+    }
+    return 1;
+}
+
 /* Arcsecond to radians */
 #define ARCSEC_TO_RAD (DEG_TO_RAD / 3600.0)
 
@@ -575,6 +648,7 @@ PJ *TRANSFORMATION(helmert, 0) {
     P->inv3d  = helmert_reverse_3d;
     P->fwd    = helmert_forward;
     P->inv    = helmert_reverse;
+    P->get_affine_map = helmert_get_affine_map;
 
     Q = (struct pj_opaque_helmert *)P->opaque;
 
@@ -701,6 +775,7 @@ PJ *TRANSFORMATION(molobadekas, 0) {
 
     P->fwd3d  = helmert_forward_3d;
     P->inv3d  = helmert_reverse_3d;
+    P->get_affine_map = helmert_get_affine_map;
 
     Q = (struct pj_opaque_helmert *)P->opaque;
 
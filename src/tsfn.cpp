@@ -15,3 +15,17 @@ double pj_tsfn(double phi, double sinphi, double e) {
     return (tan (.5 * (M_HALFPI - phi)) /
             pow((1. - sinphi) / (denominator), .5 * e));
 }
+
+
+/* Same operations as pj_tsfn(), with the zero division check as a select */
+void pj_tsfn_array(size_t n, const double *phi, const double *sinphi, double e, double *ts) {
+    const double halfe = .5 * e;
+
+    for (size_t i = 0;  i < n;  i++) {
+        const double esinphi = e * sinphi[i];
+        const double denominator = 1.0 + esinphi;
+        const double t = tan (.5 * (M_HALFPI - phi[i])) /
+                         pow((1. - esinphi) / denominator, halfe);
+        ts[i] = denominator == 0.0 ? HUGE_VAL : t;
+    }
+}
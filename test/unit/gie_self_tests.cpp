@@ -36,7 +36,12 @@
 // clang-format on
 
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <vector>
 
 namespace {
 
@@ -551,6 +556,827 @@ static void test_time(const char *args, double tol, double t_in, double t_exp) {
 
 // ---------------------------------------------------------------------------
 
+TEST(gie, io_plan) {
+    PJ *P = proj_create(PJ_DEFAULT_CTX, "+proj=merc +ellps=GRS80");
+    ASSERT_TRUE(P != nullptr);
+    PJ *Q = proj_create(PJ_DEFAULT_CTX, "+proj=merc +ellps=GRS80 +over");
+    ASSERT_TRUE(Q != nullptr);
+
+    /* Over-ranging drops both longitude wrapping stages */
+    EXPECT_EQ(pj_fwd_plan(P)->n_prepare, pj_fwd_plan(Q)->n_prepare + 2);
+    EXPECT_EQ(pj_inv_plan(P)->n_finalize, pj_inv_plan(Q)->n_finalize + 1);
+
+    PJ_COORD a = proj_coord(proj_torad(190), proj_torad(55), 0, 0);
+    PJ_COORD b = proj_trans(P, PJ_FWD, a);
+    PJ_COORD c = proj_trans(Q, PJ_FWD, a);
+    EXPECT_NEAR(b.xy.x, -18924313.434856508, 1e-6);
+    EXPECT_NEAR(c.xy.x, 21150703.250721980, 1e-6);
+    EXPECT_NEAR(b.xy.y, c.xy.y, 1e-9);
+
+    /* Invalid input stops the plan and is reported as an error */
+    a.xy.x = HUGE_VAL;
+    b = proj_trans(P, PJ_INV, a);
+    EXPECT_EQ(b.lp.lam, HUGE_VAL);
+    EXPECT_NE(proj_errno(P), 0);
+
+    /* Zero offsets are still added, which turns -0 into 0 */
+    a = proj_coord(-0.0, -0.0, -0.0, 0);
+    b = proj_trans(P, PJ_FWD, a);
+    EXPECT_FALSE(std::signbit(b.xy.x));
+    EXPECT_FALSE(std::signbit(b.xyz.z));
+    b = proj_trans(P, PJ_INV, a);
+    EXPECT_FALSE(std::signbit(b.lp.lam));
+
+    proj_destroy(Q);
+    proj_destroy(P);
+
+    /* A pipeline leaves preparation and finalization to its steps */
+    P = proj_create(PJ_DEFAULT_CTX, "+proj=pipeline +step +proj=merc "
+                                    "+step +proj=axisswap +order=2,1");
+    ASSERT_TRUE(P != nullptr);
+    EXPECT_EQ(pj_fwd_plan(P)->n_prepare, 0);
+    EXPECT_EQ(pj_fwd_plan(P)->n_finalize, 0);
+    EXPECT_EQ(pj_inv_plan(P)->n_prepare, 0);
+    EXPECT_EQ(pj_inv_plan(P)->n_finalize, 0);
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, pipeline_optimization) {
+    /* Axis swaps and unit conversions cancelling out are dropped */
+    PJ *P = proj_create(PJ_DEFAULT_CTX,
+                        "+proj=pipeline "
+                        "+step +proj=axisswap +order=2,-1 "
+                        "+step +proj=unitconvert +xy_in=m +xy_out=km "
+                        "+step +proj=axisswap +order=-2,1 "
+                        "+step +proj=unitconvert +xy_in=km +xy_out=m");
+    ASSERT_TRUE(P != nullptr);
+    int steps, optimized_steps;
+    proj_pipeline_step_counts(P, &steps, &optimized_steps);
+    EXPECT_EQ(steps, 4);
+    EXPECT_EQ(optimized_steps, 0);
+
+    PJ_COORD a = proj_coord(12.5, -55.25, 100, HUGE_VAL);
+    PJ_COORD b = proj_trans(P, PJ_FWD, a);
+    EXPECT_EQ(b.v[0], a.v[0]);
+    EXPECT_EQ(b.v[1], a.v[1]);
+    EXPECT_EQ(b.v[2], a.v[2]);
+    EXPECT_EQ(b.v[3], a.v[3]);
+    proj_destroy(P);
+
+    /* Two Helmerts around a pivot datum are fused into one step, which */
+    /* is in turn fused with the cart steps into a geodetic datum shift  */
+    const char *cart = "+proj=cart +ellps=GRS80";
+    const char *helmert1 = "+proj=helmert +x=-81.07 +y=-89.36 +z=-115.75 "
+                           "+rx=0.485 +ry=0.024 +rz=0.413 +s=-0.54 "
+                           "+convention=position_vector";
+    const char *helmert2 = "+proj=helmert +x=0.041 +y=0.041 +z=-0.049 "
+                           "+rx=0.0015 +ry=0.0011 +rz=0.0014 +s=0.0031 "
+                           "+convention=coordinate_frame";
+    std::string def("+proj=pipeline +step ");
+    def += cart;
+    def += " +step ";
+    def += helmert1;
+    def += " +step ";
+    def += helmert2;
+    def += " +step +inv ";
+    def += cart;
+    P = proj_create(PJ_DEFAULT_CTX, def.c_str());
+    ASSERT_TRUE(P != nullptr);
+    proj_pipeline_step_counts(P, &steps, &optimized_steps);
+    EXPECT_EQ(steps, 4);
+    EXPECT_EQ(optimized_steps, 1);
+
+    PJ *C = proj_create(PJ_DEFAULT_CTX, cart);
+    PJ *H1 = proj_create(PJ_DEFAULT_CTX, helmert1);
+    PJ *H2 = proj_create(PJ_DEFAULT_CTX, helmert2);
+    ASSERT_TRUE(C != nullptr && H1 != nullptr && H2 != nullptr);
+
+    a = proj_coord(proj_torad(12), proj_torad(55), 100, 0);
+    b = proj_trans(P, PJ_FWD, a);
+    PJ_COORD c = proj_trans(C, PJ_FWD, a);
+    c = proj_trans(H1, PJ_FWD, c);
+    c = proj_trans(H2, PJ_FWD, c);
+    c = proj_trans(C, PJ_INV, c);
+    EXPECT_NEAR(b.lpz.lam, c.lpz.lam, 1e-14);
+    EXPECT_NEAR(b.lpz.phi, c.lpz.phi, 1e-14);
+    EXPECT_NEAR(b.lpz.z, c.lpz.z, 1e-8);
+
+    c = proj_trans(C, PJ_FWD, b);
+    c = proj_trans(H2, PJ_INV, c);
+    c = proj_trans(H1, PJ_INV, c);
+    c = proj_trans(C, PJ_INV, c);
+    b = proj_trans(P, PJ_INV, b);
+    EXPECT_NEAR(b.lpz.lam, c.lpz.lam, 1e-14);
+    EXPECT_NEAR(b.lpz.phi, c.lpz.phi, 1e-14);
+    EXPECT_NEAR(b.lpz.z, c.lpz.z, 1e-8);
+
+    /* The batch form gives the same results as proj_trans() */
+    PJ_COORD coord[3] = {proj_coord(proj_torad(12), proj_torad(55), 100, 0),
+                         proj_coord(proj_torad(-75), proj_torad(-89.9999999),
+                                    -20, 0),
+                         proj_coord(proj_torad(179), proj_torad(0), 0, 0)};
+    for (auto dir : {PJ_FWD, PJ_INV}) {
+        PJ_COORD expected[3];
+        for (int i = 0; i < 3; i++)
+            expected[i] = proj_trans(P, dir, coord[i]);
+        EXPECT_EQ(proj_trans_array(P, dir, 3, coord), 0);
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 4; j++)
+                EXPECT_EQ(coord[i].v[j], expected[i].v[j]);
+    }
+
+    /* Also over several chunks, and in a chunk with a failing coordinate */
+    std::vector<PJ_COORD> track, expected;
+    for (int i = 0; i < 700; i++)
+        track.push_back(proj_coord(proj_torad(-180 + 0.51 * i),
+                                   proj_torad(-89 + 0.253 * i), i - 300, 0));
+    for (auto dir : {PJ_FWD, PJ_INV}) {
+        std::vector<PJ_COORD> in(track);
+        expected.clear();
+        for (const PJ_COORD &t : track)
+            expected.push_back(proj_trans(P, dir, t));
+        EXPECT_EQ(proj_trans_array(P, dir, in.size(), in.data()), 0);
+        for (size_t i = 0; i < in.size(); i++)
+            for (int j = 0; j < 4; j++)
+                EXPECT_EQ(in[i].v[j], expected[i].v[j]);
+    }
+    std::vector<PJ_COORD> in(track);
+    in[400].lpz.z = HUGE_VAL;
+    proj_trans_array(P, PJ_FWD, in.size(), in.data());
+    for (size_t i = 0; i < 400; i++)
+        for (int j = 0; j < 4; j++)
+            EXPECT_EQ(in[i].v[j], proj_trans(P, PJ_FWD, track[i]).v[j]);
+    EXPECT_EQ(in[400].v[0], HUGE_VAL);
+    proj_errno_reset(P);
+
+    /* So does the 3D entry point, which runs the same steps */
+    a = proj_coord(proj_torad(12), proj_torad(55), 100, 0);
+    for (auto dir : {PJ_FWD, PJ_INV}) {
+        b = proj_trans(P, dir, a);
+        c = pj_approx_3D_trans(P, dir, a);
+        for (int j = 0; j < 3; j++)
+            EXPECT_EQ(c.v[j], b.v[j]);
+    }
+
+    proj_destroy(H2);
+    proj_destroy(H1);
+    proj_destroy(C);
+    proj_destroy(P);
+
+    /* A plain change of ellipsoid is a geodetic shift as well */
+    P = proj_create(PJ_DEFAULT_CTX, "+proj=pipeline "
+                                    "+step +proj=cart +ellps=GRS80 "
+                                    "+step +inv +proj=cart +ellps=intl");
+    ASSERT_TRUE(P != nullptr);
+    proj_pipeline_step_counts(P, &steps, &optimized_steps);
+    EXPECT_EQ(optimized_steps, 1);
+    a = proj_coord(proj_torad(12), proj_torad(55), 100, 0);
+    b = proj_trans(P, PJ_FWD, a);
+    EXPECT_NEAR(b.lpz.lam, a.lpz.lam, 1e-15);
+    EXPECT_NE(b.lpz.phi, a.lpz.phi);
+    b = proj_trans(P, PJ_INV, b);
+    EXPECT_NEAR(b.lpz.phi, a.lpz.phi, 1e-14);
+    EXPECT_NEAR(b.lpz.z, a.lpz.z, 1e-8);
+    proj_destroy(P);
+
+    /* Affine steps cancelling out are kept as one step, which still */
+    /* rejects HUGE_VAL, and signs zeros as the steps one by one do   */
+    const char *affines = "+proj=pipeline "
+                          "+step +proj=affine +xoff=1 "
+                          "+step +proj=affine +xoff=-1";
+    P = proj_create(PJ_DEFAULT_CTX, affines);
+    ASSERT_TRUE(P != nullptr);
+    proj_pipeline_step_counts(P, &steps, &optimized_steps);
+    EXPECT_EQ(optimized_steps, 1);
+    a = proj_coord(-0.0, -0.0, -0.0, -0.0);
+    b = proj_trans(P, PJ_FWD, a);
+    for (int j = 0; j < 4; j++)
+        EXPECT_FALSE(std::signbit(b.v[j]));
+    b = proj_trans(P, PJ_INV, a);
+    for (int j = 0; j < 3; j++)
+        EXPECT_FALSE(std::signbit(b.v[j]));
+    EXPECT_TRUE(std::signbit(b.v[3]));
+    proj_errno_reset(P);
+    b = proj_trans(P, PJ_INV, proj_coord(1, 2, HUGE_VAL, 0));
+    EXPECT_EQ(b.v[0], HUGE_VAL);
+    EXPECT_NE(proj_errno(P), 0);
+    proj_destroy(P);
+
+    P = proj_create(PJ_DEFAULT_CTX, "+proj=pipeline "
+                                    "+step +proj=affine +s11=2 "
+                                    "+step +proj=axisswap +order=-2,1");
+    ASSERT_TRUE(P != nullptr);
+    b = proj_trans(P, PJ_FWD, a);
+    EXPECT_TRUE(std::signbit(b.xy.x));
+    EXPECT_FALSE(std::signbit(b.xy.y));
+    a = proj_coord(1.5, -2.25, 0, 0);
+    for (auto dir : {PJ_FWD, PJ_INV}) {
+        b = proj_trans(P, dir, a);
+        c = pj_approx_2D_trans(P, dir, a);
+        EXPECT_EQ(c.xy.x, b.xy.x);
+        EXPECT_EQ(c.xy.y, b.xy.y);
+    }
+    proj_destroy(P);
+
+    /* Time dependent Helmerts are left alone */
+    P = proj_create(PJ_DEFAULT_CTX,
+                    "+proj=pipeline "
+                    "+step +proj=helmert +x=1 +dx=0.1 +t_epoch=2010 "
+                    "+step +proj=helmert +x=-1");
+    ASSERT_TRUE(P != nullptr);
+    proj_pipeline_step_counts(P, &steps, &optimized_steps);
+    EXPECT_EQ(optimized_steps, 2);
+    proj_destroy(P);
+
+    proj_pipeline_step_counts(nullptr, &steps, &optimized_steps);
+    EXPECT_EQ(steps, 0);
+    EXPECT_EQ(optimized_steps, 0);
+
+    P = proj_create(PJ_DEFAULT_CTX, "+proj=merc +ellps=GRS80");
+    ASSERT_TRUE(P != nullptr);
+    proj_pipeline_step_counts(P, &steps, &optimized_steps);
+    EXPECT_EQ(steps, 1);
+    EXPECT_EQ(optimized_steps, 1);
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, approximation) {
+    PJ *P = proj_create(PJ_DEFAULT_CTX, "+proj=utm +zone=32 +ellps=GRS80");
+    ASSERT_TRUE(P != nullptr);
+
+    const double xmin = proj_torad(6), ymin = proj_torad(50);
+    const double xmax = proj_torad(12), ymax = proj_torad(60);
+    PJ *A = proj_create_approximation(PJ_DEFAULT_CTX, P, PJ_FWD, xmin, ymin,
+                                      xmax, ymax, 1e-4);
+    ASSERT_TRUE(A != nullptr);
+    EXPECT_GT(proj_approximation_max_error(A), 0);
+    EXPECT_LE(proj_approximation_max_error(A), 1e-4);
+    EXPECT_EQ(proj_approximation_max_error(P), -1);
+    EXPECT_TRUE(proj_angular_input(A, PJ_FWD));
+    EXPECT_FALSE(proj_angular_output(A, PJ_FWD));
+
+    /* Off the fitting nodes and check points */
+    double x[100], y[100], z[100];
+    for (int i = 0; i < 100; i++) {
+        x[i] = xmin + (xmax - xmin) * ((i * 37) % 100 + 0.31) / 100;
+        y[i] = ymin + (ymax - ymin) * ((i * 61) % 100 + 0.77) / 100;
+        z[i] = i;
+    }
+    double ax[100], ay[100], az[100];
+    for (int i = 0; i < 100; i++) {
+        ax[i] = x[i];
+        ay[i] = y[i];
+        az[i] = z[i];
+    }
+    EXPECT_EQ(proj_trans_generic(A, PJ_FWD, ax, sizeof(double), 100, ay,
+                                 sizeof(double), 100, az, sizeof(double), 100,
+                                 nullptr, 0, 0),
+              100U);
+    PJ_COORD coord[100];
+    for (int i = 0; i < 100; i++) {
+        PJ_COORD exact = proj_trans(P, PJ_FWD, proj_coord(x[i], y[i], 0, 0));
+        EXPECT_LE(hypot(ax[i] - exact.xy.x, ay[i] - exact.xy.y), 2e-4);
+        EXPECT_EQ(az[i], z[i]);
+        coord[i] = proj_coord(x[i], y[i], z[i], 0);
+    }
+
+    /* The batch form agrees with the per coordinate one */
+    EXPECT_EQ(proj_trans_array(A, PJ_FWD, 100, coord), 0);
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(coord[i].xy.x, ax[i]);
+        EXPECT_EQ(coord[i].xy.y, ay[i]);
+    }
+
+    /* Also on a dense grid, with runs of points in the same cell, and up */
+    /* to a point outside the box where the transformation stops         */
+    std::vector<PJ_COORD> grid, expected;
+    for (int i = 0; i < 600; i++) {
+        PJ_COORD g = proj_coord(xmin + (xmax - xmin) * (i % 30) / 29.5,
+                                ymin + (ymax - ymin) * (i / 30) / 19.5, i, 0);
+        grid.push_back(g);
+        expected.push_back(proj_trans(A, PJ_FWD, g));
+    }
+    EXPECT_EQ(proj_trans_array(A, PJ_FWD, grid.size(), grid.data()), 0);
+    for (size_t i = 0; i < grid.size(); i++)
+        for (int j = 0; j < 4; j++)
+            EXPECT_EQ(grid[i].v[j], expected[i].v[j]);
+    for (size_t i = 0; i < grid.size(); i++)
+        grid[i] = proj_coord(xmin + (xmax - xmin) * (i % 30) / 29.5,
+                             ymin + (ymax - ymin) * (i / 30) / 19.5, i, 0);
+    grid[300].xy.x = xmax + 1;
+    EXPECT_NE(proj_trans_array(A, PJ_FWD, grid.size(), grid.data()), 0);
+    for (size_t i = 0; i < 300; i++)
+        EXPECT_EQ(grid[i].xy.x, expected[i].xy.x);
+    EXPECT_EQ(grid[300].xy.x, HUGE_VAL);
+    EXPECT_EQ(grid[301].xy.x, xmin + (xmax - xmin) * 1 / 29.5);
+    proj_errno_reset(A);
+
+    /* Only the box is covered, and only forward */
+    PJ_COORD a = proj_trans(A, PJ_FWD, proj_coord(xmax + 1e-9, ymin, 0, 0));
+    EXPECT_EQ(a.xy.x, HUGE_VAL);
+    proj_errno_reset(A);
+    a = proj_trans(A, PJ_INV, proj_coord(500000, 6000000, 0, 0));
+    EXPECT_EQ(a.xy.x, HUGE_VAL);
+    proj_errno_reset(A);
+
+    /* Round trip through a file */
+    const char *temp_dir = getenv("TEMP");
+    if (!temp_dir)
+        temp_dir = getenv("TMP");
+    if (!temp_dir)
+        temp_dir = "/tmp";
+    std::string filename(temp_dir);
+    filename += "/proj_approximation_test.bin";
+    if (proj_approximation_write(A, filename.c_str())) {
+        PJ *B = proj_create_approximation_from_file(PJ_DEFAULT_CTX,
+                                                    filename.c_str());
+        ASSERT_TRUE(B != nullptr);
+        EXPECT_EQ(proj_approximation_max_error(B),
+                  proj_approximation_max_error(A));
+        for (int i = 0; i < 100; i++) {
+            a = proj_trans(B, PJ_FWD, proj_coord(x[i], y[i], z[i], 0));
+            EXPECT_EQ(a.xy.x, ax[i]);
+            EXPECT_EQ(a.xy.y, ay[i]);
+        }
+        proj_destroy(B);
+
+        /* A truncated file is rejected */
+        std::vector<char> bytes(4096);
+        FILE *f = fopen(filename.c_str(), "rb");
+        ASSERT_TRUE(f != nullptr);
+        size_t size = fread(bytes.data(), 1, bytes.size(), f);
+        fclose(f);
+        f = fopen(filename.c_str(), "wb");
+        ASSERT_TRUE(f != nullptr);
+        EXPECT_EQ(fwrite(bytes.data(), 1, size / 2, f), size / 2);
+        fclose(f);
+        EXPECT_EQ(proj_create_approximation_from_file(PJ_DEFAULT_CTX,
+                                                      filename.c_str()),
+                  nullptr);
+        std::remove(filename.c_str());
+    }
+    EXPECT_EQ(proj_create_approximation_from_file(PJ_DEFAULT_CTX,
+                                                  filename.c_str()),
+              nullptr);
+
+    /* A fit needs a box and a tolerance */
+    EXPECT_EQ(proj_create_approximation(PJ_DEFAULT_CTX, P, PJ_FWD, xmax, ymin,
+                                        xmin, ymax, 1e-4),
+              nullptr);
+    EXPECT_EQ(proj_create_approximation(PJ_DEFAULT_CTX, P, PJ_FWD, xmin, ymin,
+                                        xmax, ymax, 0),
+              nullptr);
+
+    /* A tolerance which cannot be met is an error */
+    proj_context_errno_set(PJ_DEFAULT_CTX, 0);
+    EXPECT_EQ(proj_create_approximation(PJ_DEFAULT_CTX, P, PJ_FWD, xmin, ymin,
+                                        xmax, ymax, 1e-300),
+              nullptr);
+    EXPECT_EQ(proj_context_errno(PJ_DEFAULT_CTX), PJD_ERR_TOLERANCE_CONDITION);
+    proj_context_errno_set(PJ_DEFAULT_CTX, 0);
+    proj_errno_reset(P);
+
+    proj_destroy(A);
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+static void check_batch(const char *def, double phi0, double phi1) {
+    PJ *P = proj_create(PJ_DEFAULT_CTX, def);
+    ASSERT_TRUE(P != nullptr) << def;
+
+    /* More than two chunks of the batch kernels */
+    const size_t n = 600;
+    std::vector<PJ_COORD> in(n), out(n), back(n);
+    for (size_t i = 0; i < n; i++) {
+        in[i] = proj_coord(-0.3 + 0.6 * ((i * 37) % n) / n,
+                           phi0 + (phi1 - phi0) * ((i * 61) % n) / n, 0, 0);
+        out[i] = in[i];
+    }
+    ASSERT_EQ(proj_trans_array(P, PJ_FWD, n, out.data()), 0) << def;
+    for (size_t i = 0; i < n; i++) {
+        PJ_COORD a = proj_trans(P, PJ_FWD, in[i]);
+        EXPECT_EQ(out[i].xy.x, a.xy.x) << def << " " << i;
+        EXPECT_EQ(out[i].xy.y, a.xy.y) << def << " " << i;
+        back[i] = out[i];
+    }
+
+    ASSERT_EQ(proj_trans_array(P, PJ_INV, n, back.data()), 0) << def;
+    for (size_t i = 0; i < n; i++) {
+        PJ_COORD a = proj_trans(P, PJ_INV, out[i]);
+        EXPECT_EQ(back[i].lp.lam, a.lp.lam) << def << " " << i;
+        EXPECT_EQ(back[i].lp.phi, a.lp.phi) << def << " " << i;
+    }
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+/* The inverse batch kernels where the scalar code takes its special cases */
+static void check_batch_inv(const char *def, const std::vector<PJ_XY> &xy) {
+    PJ *P = proj_create(PJ_DEFAULT_CTX, def);
+    ASSERT_TRUE(P != nullptr) << def;
+
+    for (const auto &p : xy) {
+        PJ_COORD c[2] = {proj_coord(p.x, p.y, 0, 0), proj_coord(p.x, p.y, 0, 0)};
+        proj_errno_reset(P);
+        PJ_COORD a = proj_trans(P, PJ_INV, c[0]);
+        const int err = proj_errno(P);
+        proj_errno_reset(P);
+        EXPECT_EQ(proj_trans_array(P, PJ_INV, 2, c) != 0, err != 0) << def;
+        EXPECT_EQ(proj_errno(P), err) << def;
+        EXPECT_EQ(c[0].lp.lam, a.lp.lam) << def << " " << p.x << " " << p.y;
+        EXPECT_EQ(c[0].lp.phi, a.lp.phi) << def << " " << p.x << " " << p.y;
+    }
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, batch_projections) {
+    check_batch("+proj=lcc +ellps=GRS80 +lat_1=44 +lat_2=49 +lat_0=46.5 "
+                "+lon_0=3 +x_0=700000 +y_0=6600000",
+                0.6, 1.2);
+    check_batch("+proj=lcc +R=6400000 +lat_1=30 +lat_2=60", 0.2, 1.4);
+    check_batch("+proj=lcc +ellps=GRS80 +lat_1=-30 +lat_2=-60", -1.4, -0.2);
+    check_batch("+proj=aea +ellps=GRS80 +lat_1=29.5 +lat_2=45.5", 0.3, 1.1);
+    check_batch("+proj=aea +R=6400000 +lat_1=29.5 +lat_2=45.5", 0.3, 1.1);
+    check_batch("+proj=leac +ellps=GRS80 +lat_1=45", 0.3, 1.1);
+    check_batch("+proj=laea +ellps=GRS80 +lat_0=52 +lon_0=10 "
+                "+x_0=4321000 +y_0=3210000",
+                0.6, 1.2);
+    check_batch("+proj=laea +ellps=GRS80", -0.8, 0.8);
+    check_batch("+proj=laea +ellps=GRS80 +lat_0=90", 0.6, 1.5);
+    check_batch("+proj=laea +ellps=GRS80 +lat_0=-90", -1.5, -0.6);
+    check_batch("+proj=stere +ellps=GRS80 +lat_0=45", 0.3, 1.3);
+    check_batch("+proj=stere +ellps=GRS80 +lat_0=0", -0.8, 0.8);
+    check_batch("+proj=ups +ellps=GRS80", 1.2, 1.5);
+    check_batch("+proj=ups +south +ellps=GRS80", -1.5, -1.2);
+    check_batch("+proj=sterea +ellps=bessel +lat_0=52.15616055555555 "
+                "+lon_0=5.38763888888889 +k=0.9999079 +x_0=155000 "
+                "+y_0=463000",
+                0.8, 1.0);
+
+    /* Poles, origins and points off the projections, in the inverses */
+    PJ *A = proj_create(PJ_DEFAULT_CTX,
+                        "+proj=aea +ellps=GRS80 +lat_1=29.5 +lat_2=45.5");
+    ASSERT_TRUE(A != nullptr);
+    const double north = proj_trans(A, PJ_FWD, proj_coord(0, M_HALFPI, 0, 0)).xy.y;
+    const double south = proj_trans(A, PJ_FWD, proj_coord(0, -M_HALFPI, 0, 0)).xy.y;
+    proj_destroy(A);
+    check_batch_inv("+proj=aea +ellps=GRS80 +lat_1=29.5 +lat_2=45.5",
+                    {{0, north}, {0, south}, {1e5, 2e7}, {0, 0}});
+    check_batch_inv("+proj=aea +R=6400000 +lat_1=29.5 +lat_2=45.5",
+                    {{0, north}, {1e5, 2e7}, {0, -2e7}, {0, 0}});
+    check_batch_inv("+proj=stere +ellps=GRS80 +lat_0=45",
+                    {{0, 0}, {1e6, -1e6}, {1e9, 0}});
+    check_batch_inv("+proj=ups +south +ellps=GRS80",
+                    {{2e6, 2e6}, {2e6, 3e6}, {1e9, 1e9}});
+    check_batch_inv("+proj=sterea +ellps=bessel +lat_0=52 +lon_0=5",
+                    {{0, 0}, {1e5, 1e5}, {1e9, 0}});
+
+    /* As a pipeline step, after the axis order and units are handled */
+    check_batch("+proj=pipeline +step +proj=unitconvert +xy_in=rad "
+                "+xy_out=deg +step +proj=axisswap +order=2,1 +step "
+                "+proj=axisswap +order=2,1 +step +proj=unitconvert "
+                "+xy_in=deg +xy_out=rad +step +proj=laea +ellps=GRS80 "
+                "+lat_0=52 +lon_0=10 +step +proj=unitconvert +xy_in=m "
+                "+xy_out=km",
+                0.6, 1.2);
+
+    /* The batch stops at the first failing coordinate, as before */
+    PJ *P = proj_create(PJ_DEFAULT_CTX,
+                        "+proj=lcc +ellps=GRS80 +lat_1=44 +lat_2=49");
+    ASSERT_TRUE(P != nullptr);
+    const size_t n = 500, bad = 300;
+    std::vector<PJ_COORD> coord(n);
+    for (size_t i = 0; i < n; i++)
+        coord[i] = proj_coord(0.1, 0.5 + i * 1e-3, 0, 0);
+    coord[bad].lp.phi = -M_HALFPI;
+    EXPECT_NE(proj_trans_array(P, PJ_FWD, n, coord.data()), 0);
+    proj_errno_reset(P);
+    for (size_t i = 0; i < bad; i++) {
+        PJ_COORD a =
+            proj_trans(P, PJ_FWD, proj_coord(0.1, 0.5 + i * 1e-3, 0, 0));
+        EXPECT_EQ(coord[i].xy.x, a.xy.x);
+        EXPECT_EQ(coord[i].xy.y, a.xy.y);
+    }
+    EXPECT_EQ(coord[bad].xy.x, HUGE_VAL);
+    EXPECT_EQ(coord[bad + 1].lp.phi, 0.5 + (bad + 1) * 1e-3);
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, batch_web_mercator) {
+    check_batch("+proj=webmerc +ellps=WGS84", -1.4, 1.4);
+    check_batch("+proj=merc +a=6378137 +b=6378137", -1.4, 1.4);
+    check_batch("+proj=merc +ellps=WGS84 +lat_ts=30 +x_0=1000", -1.4, 1.4);
+    check_batch("+proj=eqc +lat_ts=30 +lon_0=5 +ellps=WGS84", -1.4, 1.4);
+
+    /* EPSG:4326 to EPSG:3857, and to plate carree, with lat/long in degrees */
+    check_batch("+proj=pipeline +step +proj=axisswap +order=2,1 +step "
+                "+proj=unitconvert +xy_in=deg +xy_out=rad +step "
+                "+proj=webmerc +ellps=WGS84",
+                -80, 80);
+    check_batch("+proj=pipeline +step +proj=axisswap +order=2,1 +step "
+                "+proj=unitconvert +xy_in=deg +xy_out=rad +step "
+                "+proj=eqc +ellps=WGS84",
+                -80, 80);
+
+    PJ *P = proj_create(PJ_DEFAULT_CTX,
+                        "+proj=pipeline +step +proj=axisswap +order=2,1 "
+                        "+step +proj=unitconvert +xy_in=deg +xy_out=rad "
+                        "+step +proj=webmerc +ellps=WGS84");
+    ASSERT_TRUE(P != nullptr);
+    int steps, optimized_steps;
+    proj_pipeline_step_counts(P, &steps, &optimized_steps);
+    EXPECT_EQ(optimized_steps, 2);
+
+    /* A pole stops the batch where proj_trans fails */
+    PJ_COORD coord[3] = {proj_coord(45, 10, 0, 0), proj_coord(90, 10, 0, 0),
+                         proj_coord(45, 20, 0, 0)};
+    EXPECT_NE(proj_trans_array(P, PJ_FWD, 3, coord), 0);
+    proj_errno_reset(P);
+    EXPECT_NEAR(coord[0].xy.x, 1113194.91, 1e-2);
+    EXPECT_EQ(coord[1].xy.x, HUGE_VAL);
+    EXPECT_EQ(coord[2].v[0], 45);
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+static void check_batch_cart(const char *def) {
+    PJ *P = proj_create(PJ_DEFAULT_CTX, def);
+    ASSERT_TRUE(P != nullptr) << def;
+
+    /* Poles, equator, deep below and high above the ellipsoid */
+    const size_t n = 600;
+    std::vector<PJ_COORD> in(n), out(n), back(n);
+    for (size_t i = 0; i < n; i++) {
+        double phi = -M_HALFPI + M_PI * ((i * 61) % (n + 1)) / n;
+        double h = -5e6 + 4e7 * ((i * 37) % n) / n;
+        in[i] = proj_coord(-3 + 6.0 * ((i * 17) % n) / n, phi, h, 0);
+        out[i] = in[i];
+    }
+    in[0] = out[0] = proj_coord(0, M_HALFPI, 0, 0);
+    in[1] = out[1] = proj_coord(1, -M_HALFPI, 100, 0);
+    in[2] = out[2] = proj_coord(2, 0, -6300000, 0);
+
+    ASSERT_EQ(proj_trans_array(P, PJ_FWD, n, out.data()), 0) << def;
+    for (size_t i = 0; i < n; i++) {
+        PJ_COORD a = proj_trans(P, PJ_FWD, in[i]);
+        EXPECT_EQ(out[i].xyz.x, a.xyz.x) << def << " " << i;
+        EXPECT_EQ(out[i].xyz.y, a.xyz.y) << def << " " << i;
+        EXPECT_EQ(out[i].xyz.z, a.xyz.z) << def << " " << i;
+        back[i] = out[i];
+    }
+
+    ASSERT_EQ(proj_trans_array(P, PJ_INV, n, back.data()), 0) << def;
+    for (size_t i = 0; i < n; i++) {
+        PJ_COORD a = proj_trans(P, PJ_INV, out[i]);
+        EXPECT_EQ(back[i].lpz.lam, a.lpz.lam) << def << " " << i;
+        EXPECT_EQ(back[i].lpz.phi, a.lpz.phi) << def << " " << i;
+        EXPECT_EQ(back[i].lpz.z, a.lpz.z) << def << " " << i;
+
+        /* The closed form inverse round trips to well below a micrometre */
+        EXPECT_NEAR(back[i].lpz.phi, in[i].lpz.phi, 1e-13) << def << " " << i;
+        EXPECT_NEAR(back[i].lpz.z, in[i].lpz.z, 1e-7) << def << " " << i;
+        if (fabs(in[i].lpz.phi) < M_HALFPI - 1e-9) {
+            EXPECT_NEAR(back[i].lpz.lam, in[i].lpz.lam, 1e-13) << def << " "
+                                                               << i;
+        }
+    }
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, batch_cart) {
+    check_batch_cart("+proj=cart +ellps=GRS80");
+    check_batch_cart("+proj=cart +ellps=bessel");
+    check_batch_cart("+proj=cart +R=6400000");
+
+    /* The pole, which the former inverse had to special case */
+    PJ *P = proj_create(PJ_DEFAULT_CTX, "+proj=cart +ellps=GRS80");
+    ASSERT_TRUE(P != nullptr);
+    PJ_COORD c = proj_coord(0, 0, 6356752.314140347, 0);
+    c = proj_trans(P, PJ_INV, c);
+    EXPECT_NEAR(c.lpz.phi, M_HALFPI, 1e-15);
+    EXPECT_NEAR(c.lpz.z, 0, 1e-8);
+    c = proj_coord(0, 0, -6356852.314140347, 0);
+    c = proj_trans(P, PJ_INV, c);
+    EXPECT_NEAR(c.lpz.phi, -M_HALFPI, 1e-15);
+    EXPECT_NEAR(c.lpz.z, 100, 1e-8);
+    proj_destroy(P);
+
+    /* A geodetic shift pipeline, through the batch form of its steps */
+    P = proj_create(PJ_DEFAULT_CTX,
+                    "+proj=pipeline +step +proj=cart +ellps=GRS80 "
+                    "+step +proj=helmert +x=10 +y=-20 +z=30 +rx=1 +ry=2 +rz=3 "
+                    "+s=1.5 +convention=position_vector "
+                    "+step +proj=cart +inv +ellps=intl");
+    ASSERT_TRUE(P != nullptr);
+    const size_t n = 300;
+    std::vector<PJ_COORD> in(n), out(n);
+    for (size_t i = 0; i < n; i++)
+        in[i] = out[i] = proj_coord(0.01 * i - 1.5, 0.01 * i - 1.5, i, 0);
+    ASSERT_EQ(proj_trans_array(P, PJ_FWD, n, out.data()), 0);
+    for (size_t i = 0; i < n; i++) {
+        PJ_COORD a = proj_trans(P, PJ_FWD, in[i]);
+        EXPECT_NEAR(out[i].lpz.lam, a.lpz.lam, 1e-15) << i;
+        EXPECT_NEAR(out[i].lpz.phi, a.lpz.phi, 1e-15) << i;
+        EXPECT_NEAR(out[i].lpz.z, a.lpz.z, 1e-8) << i;
+    }
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, proj_geod_array) {
+    PJ *P = proj_create(PJ_DEFAULT_CTX, "+proj=longlat +ellps=GRS80");
+    ASSERT_TRUE(P != nullptr);
+
+    /* The legs of a track, more than two chunks of them */
+    const size_t n = 600;
+    std::vector<PJ_COORD> track(n + 1), out(n);
+    for (size_t i = 0; i <= n; i++)
+        track[i] = proj_coord(proj_torad(-170 + 0.55 * i + (i % 7)),
+                              proj_torad(-80 + 0.27 * i - (i % 5)), 0, 0);
+    ASSERT_EQ(proj_geod_array(P, n, track.data(), track.data() + 1,
+                              out.data(), 4),
+              0);
+    for (size_t i = 0; i < n; i++) {
+        PJ_COORD a = proj_geod(P, track[i], track[i + 1]);
+        EXPECT_EQ(out[i].v[0], a.v[0]) << i;
+        EXPECT_EQ(out[i].v[1], a.v[1]) << i;
+        EXPECT_EQ(out[i].v[2], a.v[2]) << i;
+        EXPECT_EQ(out[i].v[0], proj_lp_dist(P, track[i], track[i + 1])) << i;
+    }
+
+    /* In place, also over the track itself, whatever the threads */
+    std::vector<PJ_COORD> legs(track.begin(), track.end() - 1);
+    ASSERT_EQ(proj_geod_array(P, n, legs.data(), track.data() + 1,
+                              legs.data(), 0),
+              0);
+    EXPECT_EQ(legs[n - 1].v[0], out[n - 1].v[0]);
+    ASSERT_EQ(proj_geod_array(P, n, track.data(), track.data() + 1,
+                              track.data(), 4),
+              0);
+    for (size_t i = 0; i < n; i++) {
+        EXPECT_EQ(track[i].v[0], out[i].v[0]) << i;
+        EXPECT_EQ(track[i].v[1], out[i].v[1]) << i;
+    }
+
+    EXPECT_EQ(proj_geod_array(nullptr, n, track.data(), track.data() + 1,
+                              out.data(), 1),
+              EINVAL);
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+static void check_trans_grid(const char *def, PJ_DIRECTION dir, double x0,
+                             double dx, size_t nx, double y0, double dy,
+                             size_t ny, bool ok) {
+    PJ *P = proj_create(PJ_DEFAULT_CTX, def);
+    ASSERT_TRUE(P != nullptr);
+    std::vector<PJ_COORD> out(nx * ny);
+    int err = proj_trans_grid(P, dir, x0, dx, nx, y0, dy, ny, out.data());
+    EXPECT_EQ(err == 0, ok) << def;
+    EXPECT_EQ(proj_errno(P), err) << def;
+    proj_errno_reset(P);
+
+    for (size_t j = 0; j < ny; j++) {
+        for (size_t i = 0; i < nx; i++) {
+            PJ_COORD a =
+                proj_trans(P, dir, proj_coord(x0 + i * dx, y0 + j * dy, 0, 0));
+            proj_errno_reset(P);
+            EXPECT_EQ(out[j * nx + i].v[0], a.v[0]) << def;
+            EXPECT_EQ(out[j * nx + i].v[1], a.v[1]) << def;
+        }
+    }
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, trans_grid) {
+    const double d = proj_torad(1);
+
+    /* Separable projections, with results identical to proj_trans */
+    check_trans_grid("+proj=merc +ellps=GRS80", PJ_FWD, -10 * d, 0.7 * d, 31,
+                     -80 * d, 1.3 * d, 17, true);
+    check_trans_grid("+proj=webmerc +ellps=WGS84", PJ_FWD, -10 * d, 0.7 * d,
+                     31, -80 * d, 1.3 * d, 17, true);
+    check_trans_grid("+proj=eqc +lat_ts=30 +lon_0=5", PJ_FWD, -10 * d, 0.7 * d,
+                     31, -80 * d, 1.3 * d, 17, true);
+    check_trans_grid("+proj=cea +ellps=GRS80 +lat_ts=30", PJ_FWD, -10 * d,
+                     0.7 * d, 31, -80 * d, 1.3 * d, 17, true);
+    check_trans_grid("+proj=lcc +ellps=GRS80 +lat_1=45 +lat_2=55 +lon_0=3",
+                     PJ_FWD, -10 * d, 0.7 * d, 31, 20 * d, 1.3 * d, 17, true);
+
+    /* Poles fail without stopping the other rows */
+    check_trans_grid("+proj=merc +ellps=GRS80", PJ_FWD, -10 * d, 5 * d, 5,
+                     -90 * d, 45 * d, 5, false);
+    check_trans_grid("+proj=lcc +ellps=GRS80 +lat_1=45 +lat_2=55", PJ_FWD,
+                     -10 * d, 5 * d, 5, -90 * d, 45 * d, 5, false);
+
+    /* Inverse, non separable projections, and batch kernels */
+    check_trans_grid("+proj=merc +ellps=GRS80", PJ_INV, -1e6, 1e4, 20, -1e6,
+                     2e4, 10, true);
+    check_trans_grid("+proj=utm +zone=32 +ellps=GRS80", PJ_FWD, 6 * d, 0.1 * d,
+                     20, 50 * d, 0.1 * d, 10, true);
+    check_trans_grid("+proj=pipeline +step +proj=cart +ellps=GRS80 "
+                     "+step +proj=helmert +x=100 +y=50 +z=-20 "
+                     "+step +proj=cart +inv +ellps=GRS80",
+                     PJ_FWD, 6 * d, 0.1 * d, 30, 50 * d, 0.1 * d, 20, true);
+    check_trans_grid("+proj=merc +ellps=GRS80 +inv", PJ_INV, -10 * d, 0.7 * d,
+                     31, -80 * d, 1.3 * d, 17, true);
+
+    EXPECT_EQ(proj_trans_grid(nullptr, PJ_FWD, 0, 1, 1, 0, 1, 1, nullptr),
+              EINVAL);
+
+    PJ *P = proj_create(PJ_DEFAULT_CTX, "+proj=merc +ellps=GRS80");
+    ASSERT_TRUE(P != nullptr);
+    PJ_COORD c[4];
+
+    /* A grid with more nodes than size_t can count */
+    EXPECT_EQ(proj_trans_grid(P, PJ_FWD, 0, 1, SIZE_MAX / 2, 0, 1, 3, c),
+              EINVAL);
+    EXPECT_EQ(proj_errno(P), EINVAL);
+
+    /* The identity leaves an earlier error in place */
+    proj_errno_set(P, PJD_ERR_TOLERANCE_CONDITION);
+    EXPECT_EQ(proj_trans_grid(P, PJ_IDENT, 0, 1, 2, 0, 1, 2, c), 0);
+    EXPECT_EQ(proj_errno(P), PJD_ERR_TOLERANCE_CONDITION);
+    EXPECT_EQ(c[3].v[0], 1);
+    EXPECT_EQ(c[3].v[1], 1);
+    proj_destroy(P);
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(gie, number_parsing_and_formatting) {
+    /* pj_strtod() gives what strtod() gives, bit for bit, fast path or not */
+    const char *const numbers[] = {
+        "0",           "-0",
+        "1.5",         "  +12.25e-3xyz",
+        "0.1",         "9007199254740993",
+        "1e23",        "2.2250738585072011e-308",
+        "4.9e-324",    "1.7976931348623157e308",
+        "1e400",       "123456789012345678901234567890",
+        "3.14159e",    "2.5e+",
+        ".5",          "5.",
+        "0x1p3",       "inf",
+        "nan",         "-",
+        "57.29577951308232", "0.000000000000000000000000000000001"};
+    for (const char *s : numbers) {
+        char *end1, *end2;
+        double a = strtod(s, &end1);
+        double b = pj_strtod(s, &end2);
+        EXPECT_EQ(end1, end2) << s;
+        if (std::isnan(a)) {
+            EXPECT_TRUE(std::isnan(b)) << s;
+        } else {
+            EXPECT_EQ(memcmp(&a, &b, sizeof(a)), 0) << s;
+        }
+    }
+
+    /* pj_format_double() gives what snprintf() gives */
+    const char *const formats[] = {"%.3f",   "%f",    "%.0f",   "%14.6f",
+                                   "%012.3f", "%.19f", "%.10f", "%.2e",
+                                   "%g",     "%5.1f"};
+    const double values[] = {0,        -0.0,     0.5,      1.5,      2.5,
+                             -2.5,     0.125,    1e-7,     0.0005,   1e15,
+                             1e20,     -1e300,   HUGE_VAL, -HUGE_VAL, 123.4567,
+                             6378137, 2.675,    1.0 / 3};
+    for (const char *f : formats) {
+        for (double x : values) {
+            char a[512], b[512];
+            snprintf(a, sizeof(a), f, x);
+            EXPECT_EQ(pj_format_double(b, sizeof(b), f, x),
+                      static_cast<int>(strlen(a)))
+                << f << " " << a;
+            EXPECT_STREQ(a, b) << f;
+        }
+    }
+
+    /* Truncation as for snprintf() */
+    char s[6];
+    EXPECT_EQ(pj_format_fixed(s, sizeof(s), -1234.5678, 0, 3, 0), 9);
+    EXPECT_STREQ(s, "-1234");
+    EXPECT_EQ(pj_format_fixed(s, sizeof(s), -1.5, 6, 1, 1), 6);
+    EXPECT_STREQ(s, "-001.");
+}
+
+// ---------------------------------------------------------------------------
+
 TEST(gie, unitconvert_selftest) {
 
     char args1[] = "+proj=unitconvert +t_in=decimalyear +t_out=decimalyear";
@@ -82,4 +82,34 @@ TEST(PjPhi2Test, AvoidUndefinedBehavior) {
     EXPECT_TRUE(std::isnan(pj_phi2(ctx, -inf, -inf)));
 }
 
+TEST(PjPhi2Test, ConformalSeries) {
+    auto P = proj_create(PJ_DEFAULT_CTX, "+proj=merc +ellps=WGS84");
+    ASSERT_TRUE(P != nullptr);
+    // The series applies to the WGS84 ellipsoid
+    EXPECT_EQ(P->conformal_e, P->e);
+
+    for (int i = -900; i <= 900; i++) {
+        const double phi = i / 10. * M_PI / 180;
+        const double ts = pj_tsfn(phi, sin(phi), P->e);
+        EXPECT_NEAR(phi, pj_phi2(P, ts), 1e-14) << i;
+        EXPECT_NEAR(pj_phi2(P->ctx, ts, P->e), pj_phi2(P, ts), 1e-11) << i;
+    }
+
+    const auto inf = std::numeric_limits<double>::infinity();
+    const auto nan = std::numeric_limits<double>::quiet_NaN();
+    EXPECT_DOUBLE_EQ(M_PI_2, pj_phi2(P, 0.0));
+    EXPECT_DOUBLE_EQ(-M_PI_2, pj_phi2(P, inf));
+    EXPECT_TRUE(std::isnan(pj_phi2(P, nan)));
+    proj_destroy(P);
+
+    // Too flattened for the series: fallback to the iterative method
+    P = proj_create(PJ_DEFAULT_CTX, "+proj=merc +a=6378137 +rf=30");
+    ASSERT_TRUE(P != nullptr);
+    EXPECT_NE(P->conformal_e, P->e);
+    const double phi = 0.75;
+    const double ts = pj_tsfn(phi, sin(phi), P->e);
+    EXPECT_EQ(pj_phi2(P->ctx, ts, P->e), pj_phi2(P, ts));
+    proj_destroy(P);
+}
+
 } // namespace
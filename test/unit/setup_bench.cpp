@@ -0,0 +1,703 @@
+/******************************************************************************
+ *
+ * Project:  PROJ
+ * Purpose:  Benchmark of the setup costs: creation of CRS and coordinate
+ *           operations, WKT and PROJ string export and parsing, and
+ *           identification.
+ *
+ ******************************************************************************
+ * Copyright (c) 2018, PROJ contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+// The sections of the benchmark, each timed cold, the first time an object
+// is built, and warm, when the same thing is done again right after:
+//
+//  startup       opening the database, and a first proj_create()
+//  proj_create   proj_create("EPSG:xxxx") for every CRS code
+//  factory       AuthorityFactory::createCoordinateReferenceSystem(), split
+//                into the time spent in SQLite and the rest, building the
+//                objects
+//  proj_string   exportToPROJString() of each CRS, and pj_init() of the
+//                string through proj_create()
+//  wkt1, wkt2,   exportToWKT() of each CRS as WKT1_GDAL, WKT2_2018 and
+//  esri          WKT1_ESRI, and WKTParser::createFromWKT() of the result
+//  identify      CRS::identify() of each CRS
+//  crs_to_crs    proj_create_crs_to_crs() for a list of pairs, and the same
+//                through the C++ API split into SQL, operation search,
+//                PROJ string export and pj_init()
+//
+// SQL time is what SQLite reports for the statements it runs, through a
+// profile trace on the handle of the database context.
+//
+// Without proj.db the sections which need it are skipped, and the others
+// run on a built-in set of CRS defined by PROJ strings.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "proj.h"
+#include "proj/common.hpp"
+#include "proj/coordinateoperation.hpp"
+#include "proj/crs.hpp"
+#include "proj/io.hpp"
+#include "proj/util.hpp"
+
+#include <sqlite3.h>
+
+using namespace osgeo::proj::crs;
+using namespace osgeo::proj::io;
+using namespace osgeo::proj::operation;
+using namespace osgeo::proj::util;
+
+namespace {
+
+// ---------------------------------------------------------------------------
+
+struct Row {
+    std::string section;
+    std::string phase;
+    std::string temperature;
+    std::vector<double> us;
+    size_t failures = 0;
+};
+
+struct Skip {
+    std::string section;
+    std::string reason;
+};
+
+struct Bench {
+    std::vector<std::string> sections{};
+    size_t max_objects = 0;
+    std::vector<Row> rows{};
+    std::vector<Skip> skipped{};
+
+    bool wants(const char *section) const {
+        return sections.empty() ||
+               std::find(sections.begin(), sections.end(), section) !=
+                   sections.end();
+    }
+
+    Row &row(const std::string &section, const std::string &phase,
+             const std::string &temperature) {
+        for (auto &r : rows) {
+            if (r.section == section && r.phase == phase &&
+                r.temperature == temperature) {
+                return r;
+            }
+        }
+        rows.emplace_back();
+        rows.back().section = section;
+        rows.back().phase = phase;
+        rows.back().temperature = temperature;
+        return rows.back();
+    }
+
+    void skip(const std::string &section, const std::string &reason) {
+        skipped.push_back(Skip{section, reason});
+    }
+};
+
+// ---------------------------------------------------------------------------
+
+double now_us() {
+    return std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Nanoseconds spent by SQLite in statements, as reported by its profile
+// trace.
+sqlite3_int64 sql_ns = 0;
+
+int profile_trace(unsigned type, void *, void *, void *x) {
+    if (type == SQLITE_TRACE_PROFILE) {
+        sql_ns += *static_cast<sqlite3_int64 *>(x);
+    }
+    return 0;
+}
+
+double sql_us() { return sql_ns / 1000.0; }
+
+// A context whose messages, such as a missing proj.db, are not printed.
+PJ_CONTEXT *quiet_context() {
+    PJ_CONTEXT *ctx = proj_context_create();
+    proj_log_func(ctx, nullptr, [](void *, int, const char *) {});
+    return ctx;
+}
+
+// Runs f() twice, cold then warm, adding its duration to the rows of phase
+// of section.
+template <class F>
+void cold_and_warm(Bench &bench, const char *section, const char *phase,
+                   F f) {
+    for (const char *temperature : {"cold", "warm"}) {
+        auto &row = bench.row(section, phase, temperature);
+        double t = now_us();
+        bool ok = f();
+        t = now_us() - t;
+        if (ok) {
+            row.us.push_back(t);
+        } else {
+            row.failures++;
+        }
+    }
+}
+
+// At most max of the items, evenly spread over them.
+template <class T> std::vector<T> sample(const std::vector<T> &v, size_t max) {
+    if (max == 0 || v.size() <= max) {
+        return v;
+    }
+    std::vector<T> res;
+    for (size_t i = 0; i < max; i++) {
+        res.push_back(v[i * v.size() / max]);
+    }
+    return res;
+}
+
+// ---------------------------------------------------------------------------
+
+// CRS used when there is no database.
+const char *const builtin_crs[] = {
+    "+proj=longlat +datum=WGS84 +type=crs",
+    "+proj=longlat +ellps=GRS80 +towgs84=0,0,0 +type=crs",
+    "+proj=geocent +datum=WGS84 +units=m +type=crs",
+    "+proj=merc +a=6378137 +b=6378137 +lat_ts=0 +lon_0=0 +x_0=0 +y_0=0 +k=1 "
+    "+units=m +nadgrids=@null +wktext +no_defs +type=crs",
+    "+proj=lcc +lat_1=49 +lat_2=44 +lat_0=46.5 +lon_0=3 +x_0=700000 "
+    "+y_0=6600000 +ellps=GRS80 +towgs84=0,0,0,0,0,0,0 +units=m +type=crs",
+    "+proj=laea +lat_0=52 +lon_0=10 +x_0=4321000 +y_0=3210000 +ellps=GRS80 "
+    "+units=m +type=crs",
+    "+proj=aea +lat_1=29.5 +lat_2=45.5 +lat_0=23 +lon_0=-96 +x_0=0 +y_0=0 "
+    "+datum=NAD83 +units=m +type=crs",
+    "+proj=stere +lat_0=90 +lat_ts=70 +lon_0=-45 +k=1 +x_0=0 +y_0=0 "
+    "+datum=WGS84 +units=m +type=crs",
+    "+proj=sterea +lat_0=52.15616055555555 +lon_0=5.38763888888889 "
+    "+k=0.9999079 +x_0=155000 +y_0=463000 +ellps=bessel "
+    "+towgs84=565.417,50.3319,465.552,-0.398957,0.343988,-1.8774,4.0725 "
+    "+units=m +type=crs",
+    "+proj=tmerc +lat_0=49 +lon_0=-2 +k=0.9996012717 +x_0=400000 "
+    "+y_0=-100000 +ellps=airy "
+    "+towgs84=446.448,-125.157,542.06,0.15,0.247,0.842,-20.489 +units=m "
+    "+type=crs",
+    "+proj=somerc +lat_0=46.95240555555556 +lon_0=7.439583333333333 +k_0=1 "
+    "+x_0=2600000 +y_0=1200000 +ellps=bessel +towgs84=674.374,15.056,405.346 "
+    "+units=m +type=crs",
+    "+proj=krovak +lat_0=49.5 +lon_0=24.83333333333333 +alpha=30.28813972222222 "
+    "+k=0.9999 +x_0=0 +y_0=0 +ellps=bessel +units=m +type=crs",
+    "+proj=omerc +lat_0=4 +lonc=102.25 +alpha=323.0257905 +k=0.99984 "
+    "+x_0=804671 +y_0=0 +no_uoff +gamma=323.1301023611111 +ellps=GRS80 "
+    "+units=m +type=crs",
+};
+
+std::vector<CRSNNPtr> builtin_corpus() {
+    std::vector<std::string> defs(std::begin(builtin_crs),
+                                  std::end(builtin_crs));
+    for (int zone = 1; zone <= 60; zone++) {
+        defs.push_back("+proj=utm +zone=" + std::to_string(zone) +
+                       (zone % 2 ? "" : " +south") +
+                       " +datum=WGS84 +units=m +type=crs");
+    }
+
+    std::vector<CRSNNPtr> corpus;
+    for (const auto &def : defs) {
+        auto crs = nn_dynamic_pointer_cast<CRS>(createFromUserInput(def, nullptr));
+        if (crs) {
+            corpus.push_back(NN_NO_CHECK(crs));
+        }
+    }
+    return corpus;
+}
+
+// ---------------------------------------------------------------------------
+
+void bench_startup(Bench &bench, double open_us) {
+    bench.row("startup", "database open", "cold").us.push_back(open_us);
+
+    double t = now_us();
+    PJ_CONTEXT *ctx = quiet_context();
+    PJ *P = proj_create(ctx, "EPSG:4326");
+    proj_destroy(P);
+    proj_context_destroy(ctx);
+    auto &row = bench.row("startup", "context + EPSG:4326", "cold");
+    if (P) {
+        row.us.push_back(now_us() - t);
+    } else {
+        row.failures++;
+    }
+}
+
+void bench_proj_create(Bench &bench, const std::vector<std::string> &codes) {
+    PJ_CONTEXT *ctx = quiet_context();
+    for (const auto &code : codes) {
+        const std::string id = "EPSG:" + code;
+        cold_and_warm(bench, "proj_create", "total", [&]() {
+            PJ *P = proj_create(ctx, id.c_str());
+            proj_destroy(P);
+            return P != nullptr;
+        });
+    }
+    proj_context_destroy(ctx);
+}
+
+void bench_factory(Bench &bench, const AuthorityFactoryNNPtr &factory,
+                   const std::vector<std::string> &codes,
+                   std::vector<CRSNNPtr> &corpus) {
+    for (const auto &code : codes) {
+        for (const char *temperature : {"cold", "warm"}) {
+            double sql = sql_us();
+            double t = now_us();
+            try {
+                auto crs = factory->createCoordinateReferenceSystem(code);
+                t = now_us() - t;
+                sql = sql_us() - sql;
+                bench.row("factory", "total", temperature).us.push_back(t);
+                bench.row("factory", "sql", temperature).us.push_back(sql);
+                bench.row("factory", "construction", temperature)
+                    .us.push_back(t - sql);
+                if (strcmp(temperature, "cold") == 0) {
+                    corpus.push_back(crs);
+                }
+            } catch (const std::exception &) {
+                bench.row("factory", "total", temperature).failures++;
+            }
+        }
+    }
+}
+
+void bench_proj_string(Bench &bench, const DatabaseContextPtr &db,
+                       const std::vector<CRSNNPtr> &corpus) {
+    PJ_CONTEXT *ctx = quiet_context();
+    for (const auto &crs : corpus) {
+        auto exportable =
+            nn_dynamic_pointer_cast<IPROJStringExportable>(crs);
+        if (!exportable) {
+            continue;
+        }
+        std::string str;
+        cold_and_warm(bench, "proj_string", "export", [&]() {
+            try {
+                str = exportable->exportToPROJString(
+                    PROJStringFormatter::create(
+                        PROJStringFormatter::Convention::PROJ_5, db)
+                        .get());
+                return true;
+            } catch (const std::exception &) {
+                return false;
+            }
+        });
+        if (str.empty()) {
+            continue;
+        }
+
+        // Without +type=crs, proj_create() goes through pj_init()
+        auto pos = str.find(" +type=crs");
+        if (pos != std::string::npos) {
+            str.erase(pos, strlen(" +type=crs"));
+        }
+        cold_and_warm(bench, "proj_string", "pj_init", [&]() {
+            PJ *P = proj_create(ctx, str.c_str());
+            proj_destroy(P);
+            return P != nullptr;
+        });
+    }
+    proj_context_destroy(ctx);
+}
+
+void bench_wkt(Bench &bench, const DatabaseContextPtr &db,
+               const std::vector<CRSNNPtr> &corpus) {
+    const struct {
+        const char *section;
+        WKTFormatter::Convention convention;
+    } formats[] = {
+        {"wkt1", WKTFormatter::Convention::WKT1_GDAL},
+        {"wkt2", WKTFormatter::Convention::WKT2_2018},
+        {"esri", WKTFormatter::Convention::WKT1_ESRI},
+    };
+
+    for (const auto &format : formats) {
+        if (!bench.wants(format.section)) {
+            continue;
+        }
+        for (const auto &crs : corpus) {
+            std::string wkt;
+            cold_and_warm(bench, format.section, "export", [&]() {
+                try {
+                    wkt = crs->exportToWKT(
+                        WKTFormatter::create(format.convention, db).get());
+                    return true;
+                } catch (const std::exception &) {
+                    return false;
+                }
+            });
+            if (wkt.empty()) {
+                continue;
+            }
+            cold_and_warm(bench, format.section, "parse", [&]() {
+                try {
+                    WKTParser().attachDatabaseContext(db).createFromWKT(wkt);
+                    return true;
+                } catch (const std::exception &) {
+                    return false;
+                }
+            });
+        }
+    }
+}
+
+void bench_identify(Bench &bench, const AuthorityFactoryNNPtr &factory,
+                    const std::vector<CRSNNPtr> &corpus) {
+    for (const auto &crs : corpus) {
+        for (const char *temperature : {"cold", "warm"}) {
+            double sql = sql_us();
+            double t = now_us();
+            try {
+                crs->identify(factory.as_nullable());
+                t = now_us() - t;
+                sql = sql_us() - sql;
+                bench.row("identify", "total", temperature).us.push_back(t);
+                bench.row("identify", "sql", temperature).us.push_back(sql);
+            } catch (const std::exception &) {
+                bench.row("identify", "total", temperature).failures++;
+            }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+
+const char *const crs_pairs[][2] = {
+    {"EPSG:4326", "EPSG:3857"},  {"EPSG:4326", "EPSG:32632"},
+    {"EPSG:4258", "EPSG:25832"}, {"EPSG:4326", "EPSG:3035"},
+    {"EPSG:4326", "EPSG:4978"},  {"EPSG:4267", "EPSG:4269"},
+    {"EPSG:27700", "EPSG:4326"}, {"EPSG:2056", "EPSG:4326"},
+    {"EPSG:4230", "EPSG:4326"},  {"EPSG:4979", "EPSG:5773"},
+};
+
+void bench_crs_to_crs(Bench &bench, const DatabaseContextNNPtr &db,
+                      const AuthorityFactoryNNPtr &factory) {
+    PJ_CONTEXT *ctx = quiet_context();
+    for (const auto &pair : crs_pairs) {
+        cold_and_warm(bench, "crs_to_crs", "proj_create_crs_to_crs", [&]() {
+            PJ *P = proj_create_crs_to_crs(ctx, pair[0], pair[1], nullptr);
+            proj_destroy(P);
+            return P != nullptr;
+        });
+    }
+
+    // The same steps through the C++ API
+    auto epsg = AuthorityFactory::create(db, "EPSG");
+    for (const auto &pair : crs_pairs) {
+        CRSPtr src, dst;
+        try {
+            src = epsg->createCoordinateReferenceSystem(pair[0] + 5)
+                      .as_nullable();
+            dst = epsg->createCoordinateReferenceSystem(pair[1] + 5)
+                      .as_nullable();
+        } catch (const std::exception &) {
+            bench.row("crs_to_crs", "search", "cold").failures++;
+            continue;
+        }
+
+        for (const char *temperature : {"cold", "warm"}) {
+            auto context = CoordinateOperationContext::create(
+                factory.as_nullable(), nullptr, 0.0);
+            context->setSpatialCriterion(
+                CoordinateOperationContext::SpatialCriterion::
+                    PARTIAL_INTERSECTION);
+            context->setGridAvailabilityUse(
+                CoordinateOperationContext::GridAvailabilityUse::
+                    DISCARD_OPERATION_IF_MISSING_GRID);
+
+            double sql = sql_us();
+            double t = now_us();
+            std::vector<CoordinateOperationNNPtr> ops;
+            try {
+                ops = CoordinateOperationFactory::create()->createOperations(
+                    NN_NO_CHECK(src), NN_NO_CHECK(dst), context);
+            } catch (const std::exception &) {
+            }
+            t = now_us() - t;
+            sql = sql_us() - sql;
+            if (ops.empty()) {
+                bench.row("crs_to_crs", "search", temperature).failures++;
+                continue;
+            }
+            bench.row("crs_to_crs", "sql", temperature).us.push_back(sql);
+            bench.row("crs_to_crs", "search", temperature)
+                .us.push_back(t - sql);
+
+            std::string str;
+            t = now_us();
+            try {
+                str = ops.front()->exportToPROJString(
+                    PROJStringFormatter::create(
+                        PROJStringFormatter::Convention::PROJ_5, db)
+                        .get());
+            } catch (const std::exception &) {
+            }
+            t = now_us() - t;
+            if (str.empty()) {
+                bench.row("crs_to_crs", "proj_string", temperature)
+                    .failures++;
+                continue;
+            }
+            bench.row("crs_to_crs", "proj_string", temperature)
+                .us.push_back(t);
+
+            t = now_us();
+            PJ *P = proj_create(ctx, str.c_str());
+            t = now_us() - t;
+            proj_destroy(P);
+            auto &row = bench.row("crs_to_crs", "pj_init", temperature);
+            if (P) {
+                row.us.push_back(t);
+            } else {
+                row.failures++;
+            }
+        }
+    }
+    proj_context_destroy(ctx);
+}
+
+// ---------------------------------------------------------------------------
+
+struct Stats {
+    double total_ms, mean_us, median_us, p90_us, max_us;
+};
+
+Stats stats(std::vector<double> v) {
+    Stats s{0, 0, 0, 0, 0};
+    if (v.empty()) {
+        return s;
+    }
+    std::sort(v.begin(), v.end());
+    double sum = 0;
+    for (double x : v) {
+        sum += x;
+    }
+    s.total_ms = sum / 1000;
+    s.mean_us = sum / v.size();
+    s.median_us = v[v.size() / 2];
+    s.p90_us = v[std::min(v.size() - 1, v.size() * 9 / 10)];
+    s.max_us = v.back();
+    return s;
+}
+
+void print_table(const Bench &bench) {
+    printf("%-12s %-24s %-5s %7s %5s %11s %10s %10s %10s %11s\n", "section",
+           "phase", "temp", "n", "fail", "total ms", "mean us", "median us",
+           "p90 us", "max us");
+    for (const auto &r : bench.rows) {
+        auto s = stats(r.us);
+        printf("%-12s %-24s %-5s %7lu %5lu %11.1f %10.1f %10.1f %10.1f "
+               "%11.1f\n",
+               r.section.c_str(), r.phase.c_str(), r.temperature.c_str(),
+               static_cast<unsigned long>(r.us.size()),
+               static_cast<unsigned long>(r.failures), s.total_ms, s.mean_us,
+               s.median_us, s.p90_us, s.max_us);
+    }
+    for (const auto &s : bench.skipped) {
+        printf("skipped: %s: %s\n", s.section.c_str(), s.reason.c_str());
+    }
+}
+
+void write_json(FILE *f, const Bench &bench) {
+    fprintf(f, "{\n  \"proj_version\": \"%s\",\n  \"results\": [",
+            proj_info().version);
+    bool first = true;
+    for (const auto &r : bench.rows) {
+        auto s = stats(r.us);
+        fprintf(f,
+                "%s\n    {\"section\": \"%s\", \"phase\": \"%s\", "
+                "\"temperature\": \"%s\", \"count\": %lu, \"failures\": %lu, "
+                "\"total_ms\": %.3f, \"mean_us\": %.3f, \"median_us\": %.3f, "
+                "\"p90_us\": %.3f, \"max_us\": %.3f}",
+                first ? "" : ",", r.section.c_str(), r.phase.c_str(),
+                r.temperature.c_str(), static_cast<unsigned long>(r.us.size()),
+                static_cast<unsigned long>(r.failures), s.total_ms, s.mean_us,
+                s.median_us, s.p90_us, s.max_us);
+        first = false;
+    }
+    fprintf(f, "\n  ],\n  \"skipped\": [");
+    first = true;
+    for (const auto &s : bench.skipped) {
+        // Reasons are exception messages: keep them valid JSON strings
+        std::string reason;
+        for (char c : s.reason) {
+            if (c == '"' || c == '\\') {
+                reason += '\\';
+            }
+            reason += (static_cast<unsigned char>(c) < 0x20) ? ' ' : c;
+        }
+        fprintf(f, "%s\n    {\"section\": \"%s\", \"reason\": \"%s\"}",
+                first ? "" : ",", s.section.c_str(), reason.c_str());
+        first = false;
+    }
+    fprintf(f, "\n  ]\n}\n");
+}
+
+const char usage[] =
+    "Usage: %s [options]\n"
+    "\n"
+    "Times the creation of CRS and coordinate operations, WKT and PROJ\n"
+    "string export and parsing, and CRS identification, cold and warm.\n"
+    "\n"
+    "    -n count       At most count CRS, spread over the EPSG codes "
+    "(default all)\n"
+    "    -s section     Only the given section: startup, proj_create,\n"
+    "                   factory, proj_string, wkt1, wkt2, esri, identify or\n"
+    "                   crs_to_crs. May be repeated\n"
+    "    -j file        Also write the results as JSON to file, '-' for\n"
+    "                   standard output instead of the table\n"
+    "    -h             This help\n";
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+
+int main(int argc, char **argv) {
+    Bench bench;
+    const char *json = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
+            printf(usage, argv[0]);
+            return 0;
+        } else if (value && strcmp(argv[i], "-n") == 0) {
+            bench.max_objects = strtoul(value, nullptr, 10);
+            i++;
+        } else if (value && strcmp(argv[i], "-s") == 0) {
+            bench.sections.push_back(value);
+            i++;
+        } else if (value && strcmp(argv[i], "-j") == 0) {
+            json = value;
+            i++;
+        } else {
+            fprintf(stderr, usage, argv[0]);
+            return 1;
+        }
+    }
+
+    // The startup section comes first, while nothing is cached
+    DatabaseContextPtr db;
+    std::string no_db;
+    double open_us = now_us();
+    try {
+        db = DatabaseContext::create().as_nullable();
+    } catch (const std::exception &e) {
+        no_db = e.what();
+    }
+    open_us = now_us() - open_us;
+    if (bench.wants("startup")) {
+        if (db) {
+            bench_startup(bench, open_us);
+        } else {
+            bench.skip("startup", no_db);
+        }
+    }
+
+    std::vector<CRSNNPtr> corpus;
+    if (db) {
+        auto dbnn = NN_NO_CHECK(db);
+        sqlite3_trace_v2(static_cast<sqlite3 *>(dbnn->getSqliteHandle()),
+                         SQLITE_TRACE_PROFILE, profile_trace, nullptr);
+        auto factory = AuthorityFactory::create(dbnn, "EPSG");
+        std::vector<std::string> codes;
+        for (const auto &code : factory->getAuthorityCodes(
+                 AuthorityFactory::ObjectType::CRS, false)) {
+            codes.push_back(code);
+        }
+        codes = sample(codes, bench.max_objects);
+
+        if (bench.wants("proj_create")) {
+            bench_proj_create(bench, codes);
+        }
+
+        // The factory section also gathers the CRS of the later ones
+        bool need_corpus = false;
+        for (const char *section : {"factory", "proj_string", "wkt1", "wkt2",
+                                    "esri", "identify"}) {
+            need_corpus = need_corpus || bench.wants(section);
+        }
+        if (need_corpus) {
+            bench_factory(bench, factory, codes, corpus);
+        }
+        if (!bench.wants("factory")) {
+            bench.rows.erase(
+                std::remove_if(bench.rows.begin(), bench.rows.end(),
+                               [](const Row &r) {
+                                   return r.section == "factory";
+                               }),
+                bench.rows.end());
+        }
+
+        if (bench.wants("proj_string")) {
+            bench_proj_string(bench, db, corpus);
+        }
+        bench_wkt(bench, db, corpus);
+        if (bench.wants("identify")) {
+            bench_identify(bench, factory, corpus);
+        }
+        if (bench.wants("crs_to_crs")) {
+            bench_crs_to_crs(bench, dbnn, factory);
+        }
+    } else {
+        for (const char *section :
+             {"proj_create", "factory", "identify", "crs_to_crs"}) {
+            if (bench.wants(section)) {
+                bench.skip(section, no_db);
+            }
+        }
+        corpus = sample(builtin_corpus(), bench.max_objects);
+        if (bench.wants("proj_string")) {
+            bench_proj_string(bench, db, corpus);
+        }
+        bench_wkt(bench, db, corpus);
+    }
+
+    FILE *f = nullptr;
+    if (json) {
+        f = strcmp(json, "-") == 0 ? stdout : fopen(json, "w");
+        if (!f) {
+            fprintf(stderr, "%s: Cannot open '%s'\n", argv[0], json);
+            return 1;
+        }
+        write_json(f, bench);
+        if (f != stdout) {
+            fclose(f);
+        }
+    }
+    if (f != stdout) {
+        print_table(bench);
+    }
+    return 0;
+}
@@ -317,6 +317,74 @@ TEST_F(CApi, proj_create_from_wkt) {
 
 // ---------------------------------------------------------------------------
 
+TEST_F(CApi, proj_context_set_user_input_cache_size) {
+    size_t hits = 0;
+    size_t misses = 0;
+    EXPECT_TRUE(proj_context_get_user_input_cache_stats(m_ctxt, &hits, &misses));
+    EXPECT_EQ(hits, 0U);
+    EXPECT_EQ(misses, 0U);
+
+    ASSERT_TRUE(proj_context_set_user_input_cache_size(m_ctxt, 10));
+
+    const char *wkt = "PROJCS[\"test\",\n"
+                      "  GEOGCS[\"WGS 84\",\n"
+                      "    DATUM[\"WGS_1984\",\n"
+                      "        SPHEROID[\"WGS 84\",6378137,298.257223563,"
+                      "\"unused\"]],\n"
+                      "    PRIMEM[\"Greenwich\",0],\n"
+                      "    UNIT[\"degree\",0.0174532925199433]],\n"
+                      "  PROJECTION[\"Transverse_Mercator\"],\n"
+                      "  PARAMETER[\"latitude_of_origin\",31],\n"
+                      "  UNIT[\"metre\",1]]";
+    const char *const options[] = {"STRICT=NO", nullptr};
+    for (int i = 0; i < 2; i++) {
+        PROJ_STRING_LIST errorList = nullptr;
+        auto obj =
+            proj_create_from_wkt(m_ctxt, wkt, options, nullptr, &errorList);
+        ObjectKeeper keeper(obj);
+        EXPECT_NE(obj, nullptr);
+        // Grammar errors must be reported on cache hits too
+        EXPECT_NE(errorList, nullptr);
+        proj_string_list_destroy(errorList);
+    }
+    EXPECT_TRUE(proj_context_get_user_input_cache_stats(m_ctxt, &hits, &misses));
+    EXPECT_EQ(hits, 1U);
+    EXPECT_EQ(misses, 1U);
+
+    // Strict parsing is keyed separately, and fails
+    EXPECT_EQ(proj_create_from_wkt(m_ctxt, wkt, nullptr, nullptr, nullptr),
+              nullptr);
+    EXPECT_TRUE(proj_context_get_user_input_cache_stats(m_ctxt, &hits, &misses));
+    EXPECT_EQ(hits, 1U);
+    EXPECT_EQ(misses, 2U);
+
+    {
+        auto obj1 = proj_create(m_ctxt, "+proj=longlat +ellps=GRS80");
+        ObjectKeeper keeper1(obj1);
+        ASSERT_NE(obj1, nullptr);
+        auto obj2 = proj_create(m_ctxt, "+proj=longlat +ellps=GRS80");
+        ObjectKeeper keeper2(obj2);
+        ASSERT_NE(obj2, nullptr);
+        EXPECT_TRUE(proj_is_equivalent_to(obj1, obj2, PJ_COMP_STRICT));
+    }
+    EXPECT_TRUE(proj_context_get_user_input_cache_stats(m_ctxt, &hits, &misses));
+    EXPECT_EQ(hits, 2U);
+    EXPECT_EQ(misses, 3U);
+
+    // Disabling the cache resets the statistics
+    ASSERT_TRUE(proj_context_set_user_input_cache_size(m_ctxt, 0));
+    {
+        auto obj = proj_create(m_ctxt, "+proj=longlat +ellps=GRS80");
+        ObjectKeeper keeper(obj);
+        ASSERT_NE(obj, nullptr);
+    }
+    EXPECT_TRUE(proj_context_get_user_input_cache_stats(m_ctxt, nullptr,
+                                                        &misses));
+    EXPECT_EQ(misses, 0U);
+}
+
+// ---------------------------------------------------------------------------
+
 TEST_F(CApi, proj_as_wkt) {
     auto obj = proj_create_from_wkt(
         m_ctxt,
@@ -2160,6 +2160,48 @@ TEST(crs, projectedCRS_identify_db) {
 
 // ---------------------------------------------------------------------------
 
+TEST(crs, projectedCRS_identify_db_repeated) {
+    auto dbContext = DatabaseContext::create();
+    auto factoryEPSG = AuthorityFactory::create(dbContext, "EPSG");
+    const char *wkt = "PROJCS[\"WGS_1984_UTM_Zone_31N\","
+                      "GEOGCS[\"GCS_WGS_1984\","
+                      "DATUM[\"D_WGS_1984\","
+                      "SPHEROID[\"WGS_1984\",6378137.0,298.257223563]],"
+                      "PRIMEM[\"Greenwich\",0.0],"
+                      "UNIT[\"Degree\",0.0174532925199433]],"
+                      "PROJECTION[\"Transverse_Mercator\"],"
+                      "PARAMETER[\"False_Easting\",500000.0],"
+                      "PARAMETER[\"False_Northing\",0.0],"
+                      "PARAMETER[\"Central_Meridian\",3.0],"
+                      "PARAMETER[\"Scale_Factor\",0.9996],"
+                      "PARAMETER[\"Latitude_Of_Origin\",0.0],"
+                      "UNIT[\"Meter\",1.0]]";
+    auto crs1 = nn_dynamic_pointer_cast<ProjectedCRS>(
+        WKTParser().attachDatabaseContext(dbContext).createFromWKT(wkt));
+    ASSERT_TRUE(crs1 != nullptr);
+    auto res1 = crs1->identify(factoryEPSG);
+    ASSERT_EQ(res1.size(), 1U);
+    EXPECT_EQ(res1.front().first->getEPSGCode(), 32631);
+
+    // A distinct object with the same definition gets the same answer
+    auto crs2 = nn_dynamic_pointer_cast<ProjectedCRS>(
+        WKTParser().attachDatabaseContext(dbContext).createFromWKT(wkt));
+    ASSERT_TRUE(crs2 != nullptr);
+    auto res2 = crs2->identify(factoryEPSG);
+    ASSERT_EQ(res2.size(), 1U);
+    EXPECT_EQ(res2.front().first->getEPSGCode(), 32631);
+    EXPECT_EQ(res2.front().second, res1.front().second);
+
+    // But a different definition does not
+    auto crs3 = crs1->alterName("foo");
+    auto res3 = crs3->identify(factoryEPSG);
+    ASSERT_EQ(res3.size(), 1U);
+    EXPECT_EQ(res3.front().first->getEPSGCode(), 32631);
+    EXPECT_LT(res3.front().second, 100);
+}
+
+// ---------------------------------------------------------------------------
+
 TEST(crs, mercator_1SP_as_WKT1_ESRI) {
 
     auto obj = PROJStringParser().createFromPROJString(
@@ -466,6 +466,12 @@ TEST(factory, AuthorityFactory_createGeodeticCRS_geocentric) {
         crs->datum()->isEquivalentTo(factory->createDatum("6326").get()));
     EXPECT_TRUE(crs->coordinateSystem()->isEquivalentTo(
         factory->createCoordinateSystem("6500").get()));
+
+    // Same name as EPSG:4326 and EPSG:4979: the name is shared
+    EXPECT_EQ(crs->name().get(),
+              factory->createGeodeticCRS("4326")->name().get());
+    EXPECT_EQ(crs->name().get(),
+              factory->createGeodeticCRS("4979")->name().get());
 }
 
 // ---------------------------------------------------------------------------
@@ -564,6 +570,15 @@ TEST(factory, AuthorityFactory_createProjectedCRS) {
     auto extent = domain->domainOfValidity();
     ASSERT_TRUE(extent != nullptr);
     EXPECT_TRUE(extent->isEquivalentTo(factory->createExtent("2060").get()));
+
+    // Objects are shared once built
+    EXPECT_EQ(factory->createProjectedCRS("32631").get(), crs.get());
+    EXPECT_EQ(extent.get(), factory->createExtent("2060").get());
+    EXPECT_EQ(factory->createProjectedCRS("32632")
+                  ->domains()[0]
+                  ->domainOfValidity()
+                  .get(),
+              factory->createExtent("2061").get());
 }
 
 // ---------------------------------------------------------------------------
@@ -149,6 +149,41 @@ TEST(io, wkt_parsing_with_double_quotes_inside) {
 
 // ---------------------------------------------------------------------------
 
+TEST(io, appendToString) {
+    for (double val : {1.0, -0.5, 1e-20, 1.5e300, 0.1, 1.0 / 3, 2.0 / 3,
+                       6378137.0, 298.257223563, 0.0174532925199433}) {
+        std::string str("prefix");
+        appendToString(str, val);
+        EXPECT_EQ(str, "prefix" + toString(val));
+        str.clear();
+        appendToString(str, val, 8);
+        EXPECT_EQ(str, toString(val, 8));
+    }
+    // Check the %.14g fallback
+    std::string str;
+    appendToString(str, 1.99999999999999);
+    EXPECT_EQ(str, "2");
+}
+
+// ---------------------------------------------------------------------------
+
+TEST(io, wkt_export_quoted_string) {
+    auto crs = GeographicCRS::create(
+        PropertyMap().set(IdentifiedObject::NAME_KEY, "my \"crs\" \"\""),
+        GeodeticReferenceFrame::EPSG_6326,
+        EllipsoidalCS::createLatitudeLongitude(UnitOfMeasure::DEGREE));
+    auto wkt = crs->exportToWKT(WKTFormatter::create().get());
+    EXPECT_TRUE(wkt.find("GEODCRS[\"my \"\"crs\"\" \"\"\"\"\",") !=
+                std::string::npos)
+        << wkt;
+    auto obj =
+        nn_dynamic_pointer_cast<GeographicCRS>(WKTParser().createFromWKT(wkt));
+    ASSERT_TRUE(obj != nullptr);
+    EXPECT_EQ(obj->nameStr(), "my \"crs\" \"\"");
+}
+
+// ---------------------------------------------------------------------------
+
 TEST(io, wkt_parsing_with_printed_quotes) {
     static const std::string startPrintedQuote("\xE2\x80\x9C");
     static const std::string endPrintedQuote("\xE2\x80\x9D");